@@ -0,0 +1,140 @@
+#ifndef TARANTOOL_PERF_BENCH_COMMON_H_INCLUDED
+#define TARANTOOL_PERF_BENCH_COMMON_H_INCLUDED
+/*
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * @brief Minimal harness shared by the microbenchmarks in perf/.
+ *
+ * Every measured loop prints exactly one JSON object on a line of
+ * its own, so a whole run can be captured with a plain shell
+ * redirect and diffed between commits:
+ *
+ *     {"bench": "bps_tree/insert", "items": 1048576, ...}
+ *
+ * There is deliberately no dependency beyond libc: benchmarks
+ * link only the library they measure.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <time.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+static inline double
+bench_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/** One measured loop. Wrap it in bench_start()/bench_stop(). */
+struct bench {
+	/** Loop name as reported in the JSON record. */
+	const char *name;
+	/** Number of measured operations in the loop. */
+	size_t items;
+	/** Monotonic time the loop started at. */
+	double start;
+};
+
+static inline void
+bench_start(struct bench *b, const char *name, size_t items)
+{
+	b->name = name;
+	b->items = items;
+	b->start = bench_now();
+}
+
+static inline void
+bench_stop(struct bench *b)
+{
+	double elapsed = bench_now() - b->start;
+	printf("{\"bench\": \"%s\", \"items\": %zu, "
+	       "\"seconds\": %.6f, \"ns_per_item\": %.2f, "
+	       "\"items_per_sec\": %.0f}\n",
+	       b->name, b->items, elapsed,
+	       elapsed * 1e9 / b->items, b->items / elapsed);
+	fflush(stdout);
+}
+
+/**
+ * Consume a computed value so that the optimizer can not throw
+ * the measured work away.
+ */
+static inline void
+bench_blackhole(uintptr_t v)
+{
+	__asm__ volatile("" : : "r"(v) : "memory");
+}
+
+/**
+ * Deterministic pseudo-random sequence (xorshift64*), so that
+ * runs on different machines measure identical workloads.
+ */
+static inline uint64_t
+bench_rand_next(uint64_t *state)
+{
+	uint64_t x = *state;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*state = x;
+	return x * UINT64_C(2685821657736338717);
+}
+
+/**
+ * Item count for the benchmark: the first command line argument,
+ * or @a def when the benchmark is run without arguments.
+ */
+static inline size_t
+bench_arg_count(int argc, char **argv, size_t def)
+{
+	if (argc > 1) {
+		long long v = strtoll(argv[1], NULL, 10);
+		if (v > 0)
+			return (size_t)v;
+	}
+	return def;
+}
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* TARANTOOL_PERF_BENCH_COMMON_H_INCLUDED */
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * B+* tree microbenchmark: random insert, point lookup and full
+ * scan with the same block and extent geometry memtx uses for its
+ * TREE indexes.
+ */
+
+#include <stdint.h>
+#include <assert.h>
+
+#include "bench_common.h"
+
+static int
+compare(int64_t a, int64_t b)
+{
+	return a < b ? -1 : a > b ? 1 : 0;
+}
+
+#define BPS_TREE_NAME bench_tree
+#define BPS_TREE_BLOCK_SIZE 512
+#define BPS_TREE_EXTENT_SIZE (16 * 1024)
+#define BPS_TREE_IS_IDENTICAL(a, b) (a == b)
+#define BPS_TREE_COMPARE(a, b, arg) compare(a, b)
+#define BPS_TREE_COMPARE_KEY(a, b, arg) compare(a, b)
+#define bps_tree_elem_t int64_t
+#define bps_tree_key_t int64_t
+#define bps_tree_arg_t int
+#include "salad/bps_tree.h"
+
+static size_t extents_count = 0;
+
+static void *
+extent_alloc(void *ctx)
+{
+	size_t *p_extents_count = (size_t *)ctx;
+	++*p_extents_count;
+	return malloc(BPS_TREE_EXTENT_SIZE);
+}
+
+static void
+extent_free(void *ctx, void *extent)
+{
+	size_t *p_extents_count = (size_t *)ctx;
+	--*p_extents_count;
+	free(extent);
+}
+
+int
+main(int argc, char **argv)
+{
+	size_t count = bench_arg_count(argc, argv, 1 << 20);
+	int64_t *keys = (int64_t *)malloc(count * sizeof(*keys));
+	if (keys == NULL)
+		return 1;
+	uint64_t seed = 42;
+	for (size_t i = 0; i < count; i++)
+		keys[i] = (int64_t)bench_rand_next(&seed);
+
+	struct bench b;
+	struct bench_tree tree;
+	bench_tree_create(&tree, 0, extent_alloc, extent_free, &extents_count);
+
+	bench_start(&b, "bps_tree/insert", count);
+	for (size_t i = 0; i < count; i++)
+		bench_tree_insert(&tree, keys[i], NULL, NULL);
+	bench_stop(&b);
+
+	bench_start(&b, "bps_tree/find", count);
+	for (size_t i = 0; i < count; i++)
+		bench_blackhole((uintptr_t)bench_tree_find(&tree, keys[i]));
+	bench_stop(&b);
+
+	size_t size = bench_tree_size(&tree);
+	bench_start(&b, "bps_tree/iterate", size);
+	struct bench_tree_iterator it = bench_tree_iterator_first(&tree);
+	int64_t sum = 0;
+	while (!bench_tree_iterator_is_invalid(&it)) {
+		sum += *bench_tree_iterator_get_elem(&tree, &it);
+		bench_tree_iterator_next(&tree, &it);
+	}
+	bench_blackhole((uintptr_t)sum);
+	bench_stop(&b);
+
+	bench_tree_destroy(&tree);
+	free(keys);
+	assert(extents_count == 0);
+	return 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * Light hash table microbenchmark: random insert, point lookup
+ * and full iteration, with the extent size memtx uses for its
+ * HASH indexes.
+ */
+
+#include <stdint.h>
+#include <assert.h>
+
+#include "bench_common.h"
+
+static const size_t light_extent_size = 16 * 1024;
+static size_t extents_count = 0;
+
+static bool
+equal(uint64_t v1, uint64_t v2)
+{
+	return v1 == v2;
+}
+
+#define LIGHT_NAME
+#define LIGHT_DATA_TYPE uint64_t
+#define LIGHT_KEY_TYPE uint64_t
+#define LIGHT_CMP_ARG_TYPE int
+#define LIGHT_EQUAL(a, b, arg) equal(a, b)
+#define LIGHT_EQUAL_KEY(a, b, arg) equal(a, b)
+#include "salad/light.h"
+
+static void *
+light_bench_alloc(void *ctx)
+{
+	size_t *p_extents_count = (size_t *)ctx;
+	++*p_extents_count;
+	return malloc(light_extent_size);
+}
+
+static void
+light_bench_free(void *ctx, void *p)
+{
+	size_t *p_extents_count = (size_t *)ctx;
+	--*p_extents_count;
+	free(p);
+}
+
+static inline uint32_t
+value_hash(uint64_t value)
+{
+	/* The same 64->32 bit mix memtx uses for unsigned keys. */
+	return (uint32_t)(value ^ (value >> 32));
+}
+
+int
+main(int argc, char **argv)
+{
+	size_t count = bench_arg_count(argc, argv, 1 << 20);
+	uint64_t *keys = (uint64_t *)malloc(count * sizeof(*keys));
+	if (keys == NULL)
+		return 1;
+	uint64_t seed = 42;
+	for (size_t i = 0; i < count; i++)
+		keys[i] = bench_rand_next(&seed);
+
+	struct bench b;
+	struct light_core ht;
+	light_create(&ht, light_extent_size,
+		     light_bench_alloc, light_bench_free, &extents_count, 0);
+
+	bench_start(&b, "light/insert", count);
+	for (size_t i = 0; i < count; i++)
+		light_insert(&ht, value_hash(keys[i]), keys[i]);
+	bench_stop(&b);
+
+	bench_start(&b, "light/find", count);
+	for (size_t i = 0; i < count; i++)
+		bench_blackhole(light_find(&ht, value_hash(keys[i]), keys[i]));
+	bench_stop(&b);
+
+	bench_start(&b, "light/iterate", ht.count);
+	struct light_iterator it;
+	light_iterator_begin(&ht, &it);
+	uint64_t sum = 0;
+	uint64_t *pval;
+	while ((pval = light_iterator_get_and_next(&ht, &it)) != NULL)
+		sum += *pval;
+	bench_blackhole((uintptr_t)sum);
+	bench_stop(&b);
+
+	light_destroy(&ht);
+	free(keys);
+	assert(extents_count == 0);
+	return 0;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * MsgPack decode microbenchmark: mp_check() validation and
+ * mp_next() skipping over a buffer of tuple-shaped records
+ * (an array of two integers and a short string), the pattern
+ * iproto spends most of its decode time on.
+ */
+
+#include <string.h>
+
+#include <msgpuck.h>
+
+#include "bench_common.h"
+
+int
+main(int argc, char **argv)
+{
+	size_t count = bench_arg_count(argc, argv, 1 << 20);
+	/* Worst-case record size is well under 64 bytes. */
+	char *buf = malloc(count * 64);
+	if (buf == NULL)
+		return 1;
+	uint64_t seed = 42;
+	char *pos = buf;
+	for (size_t i = 0; i < count; i++) {
+		pos = mp_encode_array(pos, 3);
+		pos = mp_encode_uint(pos, bench_rand_next(&seed));
+		pos = mp_encode_uint(pos, bench_rand_next(&seed) % 1000);
+		pos = mp_encode_str(pos, "abcdefghijklmnop",
+				    bench_rand_next(&seed) % 16 + 1);
+	}
+	const char *end = pos;
+
+	struct bench b;
+	const char *rpos;
+
+	bench_start(&b, "msgpack/mp_check", count);
+	rpos = buf;
+	while (rpos != end) {
+		if (mp_check(&rpos, end) != 0)
+			return 1;
+	}
+	bench_stop(&b);
+
+	bench_start(&b, "msgpack/mp_next", count);
+	rpos = buf;
+	while (rpos != end)
+		mp_next(&rpos);
+	bench_blackhole((uintptr_t)rpos);
+	bench_stop(&b);
+
+	free(buf);
+	return 0;
+}
@@ -667,6 +667,17 @@ space_def_new_from_tuple(struct tuple *tuple, uint32_t errcode,
 			 "local space can't be synchronous");
 		return NULL;
 	}
+	if (opts.is_nolog && opts.is_sync) {
+		diag_set(ClientError, errcode, tt_cstr(name, name_len),
+			 "nolog space can't be synchronous");
+		return NULL;
+	}
+	if (opts.is_nolog &&
+	    strncasecmp(engine_name, "memtx", engine_name_len) != 0) {
+		diag_set(ClientError, ER_UNSUPPORTED, "engine",
+			 "nolog spaces");
+		return NULL;
+	}
 	struct space_def *def =
 		space_def_new(id, uid, exact_field_count, name, name_len,
 			      engine_name, engine_name_len, &opts, fields,
@@ -3299,6 +3310,8 @@ func_def_new_from_tuple(struct tuple *tuple)
 		return NULL;
 	}
 	auto def_guard = make_scoped_guard([=] { free(def); });
+	/* FIELD_TYPE_ANY until the param_list says otherwise. */
+	memset(def->param_types, 0, sizeof(def->param_types));
 	if (func_def_get_ids_from_tuple(tuple, &def->fid, &def->uid) != 0)
 		return NULL;
 	if (def->fid > BOX_FUNCTION_MAX) {
@@ -3420,11 +3433,15 @@ func_def_new_from_tuple(struct tuple *tuple)
 			}
 			uint32_t len;
 			const char *str = mp_decode_str(&param_list, &len);
-			if (STRN2ENUM(field_type, str, len) == field_type_MAX) {
+			enum field_type ptype = STRN2ENUM(field_type, str,
+							  len);
+			if (ptype == field_type_MAX) {
 				diag_set(ClientError, ER_CREATE_FUNCTION,
 					  def->name, "invalid argument type");
 				return NULL;
 			}
+			if (i < FUNC_PARAM_TYPES_MAX)
+				def->param_types[i] = ptype;
 		}
 		def->param_count = argc;
 		const char *opts = tuple_field(tuple, BOX_FUNC_FIELD_OPTS);
@@ -4426,6 +4443,7 @@ on_alter_sequence_rollback(struct trigger *trigger, void * /* event */)
 	assert(seq != NULL);
 	free(seq->def);
 	seq->def = def;
+	seq->cache_remaining = 0;
 	if (trigger_run(&on_alter_sequence, seq) != 0)
 		return -1;
 	return 0;
@@ -4523,6 +4541,11 @@ on_replace_dd_sequence(struct trigger * /* trigger */, void *event)
 		if (on_commit == NULL || on_rollback == NULL)
 			return -1;
 		seq->def = new_def;
+		/*
+		 * Values cached under the old definition may not
+		 * conform to the new step/min/max.
+		 */
+		seq->cache_remaining = 0;
 		txn_stmt_on_commit(stmt, on_commit);
 		txn_stmt_on_rollback(stmt, on_rollback);
 	}
@@ -34,6 +34,7 @@
 
 #include "xlog.h"
 #include "fiber.h"
+#include "memory.h"
 #include "fiber_cond.h"
 #include "coio.h"
 #include "coio_buf.h"
@@ -49,6 +50,7 @@
 #include "session.h"
 #include "cfg.h"
 #include "schema.h"
+#include "tuple.h"
 #include "txn.h"
 #include "box.h"
 #include "xrow.h"
@@ -229,40 +231,86 @@ applier_writer_f(va_list ap)
 	return 0;
 }
 
+/**
+ * The master streams only confirmed rows during join, so a
+ * transaction per snapshot row buys nothing but overhead. Rows
+ * are collected into batches of this size and each batch is
+ * applied in one multi-statement transaction.
+ */
+enum { JOIN_ROWS_PER_TXN = 64 };
+
 static int
-apply_snapshot_row(struct xrow_header *row)
+apply_snapshot_rows(struct xrow_header *rows, int n_rows)
 {
-	int rc;
-	struct request request;
-	if (xrow_decode_dml(row, &request, dml_request_key_map(row->type)) != 0)
-		return -1;
-	struct space *space = space_cache_find(request.space_id);
-	if (space == NULL)
-		return -1;
-	struct txn *txn = txn_begin();
-	if (txn == NULL)
-		return -1;
-	/*
-	 * Do not wait for confirmation when fetching a snapshot.
-	 * Master only sends confirmed rows during join.
-	 */
-	txn_set_flags(txn, TXN_FORCE_ASYNC);
-	if (txn_begin_stmt(txn, space, request.type) != 0)
-		goto rollback;
-	/* no access checks here - applier always works with admin privs */
-	struct tuple *unused;
-	if (space_execute_dml(space, txn, &request, &unused) != 0)
-		goto rollback_stmt;
-	if (txn_commit_stmt(txn, &request))
+	struct txn *txn = NULL;
+	for (int i = 0; i < n_rows; i++) {
+		struct xrow_header *row = &rows[i];
+		struct request request;
+		if (xrow_decode_dml(row, &request,
+				    dml_request_key_map(row->type)) != 0)
+			goto rollback;
+		struct space *space = space_cache_find(request.space_id);
+		if (space == NULL)
+			goto rollback;
+		/*
+		 * A system space row commits alone: the DDL done by
+		 * its commit triggers must be visible to the rows
+		 * which follow it in the stream.
+		 */
+		bool is_system = request.space_id < BOX_SYSTEM_ID_MAX;
+		if (is_system && txn != NULL) {
+			/*
+			 * No fiber_gc() until the whole batch is done:
+			 * the row bodies still to be applied live on
+			 * the gc region too.
+			 */
+			int rc = txn_commit(txn);
+			txn = NULL;
+			if (rc != 0)
+				return -1;
+		}
+		if (txn == NULL) {
+			txn = txn_begin();
+			if (txn == NULL)
+				return -1;
+			/*
+			 * Do not wait for confirmation when fetching a
+			 * snapshot. Master only sends confirmed rows
+			 * during join.
+			 */
+			txn_set_flags(txn, TXN_FORCE_ASYNC);
+		}
+		if (txn_begin_stmt(txn, space, request.type) != 0)
+			goto rollback;
+		/* no access checks here - applier always works with admin privs */
+		struct tuple *unused;
+		if (space_execute_dml(space, txn, &request, &unused) != 0)
+			goto rollback_stmt;
+		if (txn_commit_stmt(txn, &request))
+			goto rollback;
+		if (is_system) {
+			int rc = txn_commit(txn);
+			txn = NULL;
+			if (rc != 0)
+				return -1;
+		}
+		continue;
+rollback_stmt:
+		txn_rollback_stmt(txn);
 		goto rollback;
-	rc = txn_commit(txn);
+	}
+	if (txn != NULL) {
+		int rc = txn_commit(txn);
+		fiber_gc();
+		return rc;
+	}
 	fiber_gc();
-	return rc;
-rollback_stmt:
-	txn_rollback_stmt(txn);
+	return 0;
 rollback:
-	txn_rollback(txn);
-	fiber_gc();
+	if (txn != NULL) {
+		txn_rollback(txn);
+		fiber_gc();
+	}
 	return -1;
 }
 
@@ -438,12 +486,36 @@ applier_wait_snapshot(struct applier *applier)
 	 * Receive initial data.
 	 */
 	uint64_t row_count = 0;
+	struct xrow_header batch[JOIN_ROWS_PER_TXN];
+	int batch_size = 0;
 	while (true) {
 		coio_read_xrow(coio, ibuf, &row);
 		applier->last_row_time = ev_monotonic_now(loop());
 		if (iproto_type_is_dml(row.type)) {
-			if (apply_snapshot_row(&row) != 0)
-				diag_raise();
+			/*
+			 * The body points into the connection input
+			 * buffer, which the next read is free to
+			 * recycle. Copy it onto the gc region - it is
+			 * truncated when the batch commits.
+			 */
+			batch[batch_size] = row;
+			if (row.bodycnt == 1) {
+				size_t len = row.body[0].iov_len;
+				char *copy = (char *)region_alloc(
+						&fiber()->gc, len);
+				if (copy == NULL) {
+					tnt_raise(OutOfMemory, len,
+						  "region", "snapshot row");
+				}
+				memcpy(copy, row.body[0].iov_base, len);
+				batch[batch_size].body[0].iov_base = copy;
+			}
+			if (++batch_size == JOIN_ROWS_PER_TXN) {
+				if (apply_snapshot_rows(batch,
+							batch_size) != 0)
+					diag_raise();
+				batch_size = 0;
+			}
 			if (++row_count % ROWS_PER_LOG == 0)
 				say_info("%.1fM rows received", row_count / 1e6);
 		} else if (row.type == IPROTO_OK) {
@@ -465,6 +537,8 @@ applier_wait_snapshot(struct applier *applier)
 				  (uint32_t) row.type);
 		}
 	}
+	if (batch_size > 0 && apply_snapshot_rows(batch, batch_size) != 0)
+		diag_raise();
 
 	return row_count;
 }
@@ -502,6 +576,30 @@ struct applier_tx_row {
 	struct xrow_header row;
 };
 
+/**
+ * A transaction read ahead by the reader fiber and queued for
+ * the apply worker. Both the object and its rows live in
+ * applier->read_ahead_mem and are reclaimed once the worker
+ * reports the id applied.
+ */
+struct applier_tx {
+	/** Link in applier->pending_txs. */
+	struct stailq_entry next;
+	/** Allocation id of this transaction in read_ahead_mem. */
+	int64_t id;
+	/** The transaction rows. */
+	struct stailq rows;
+};
+
+enum {
+	/**
+	 * How much read-ahead memory queued transactions may
+	 * occupy before the reader blocks waiting for the apply
+	 * worker to catch up.
+	 */
+	APPLIER_READAHEAD_MEM_MAX = 512 * 1024,
+};
+
 static uint64_t
 applier_wait_register(struct applier *applier, uint64_t row_count)
 {
@@ -537,7 +635,14 @@ applier_wait_register(struct applier *applier, uint64_t row_count)
 		}
 		if (apply_final_join_tx(&rows) != 0)
 			diag_raise();
+		/*
+		 * Final join is applied synchronously, the rows are
+		 * dead as soon as the call returns.
+		 */
+		lsregion_gc(&applier->read_ahead_mem,
+			    applier->read_ahead_id);
 	}
+	lsregion_gc(&applier->read_ahead_mem, applier->read_ahead_id);
 
 	return row_count;
 }
@@ -582,7 +687,14 @@ applier_join(struct applier *applier)
 	struct xrow_header row;
 	uint64_t row_count;
 
-	xrow_encode_join_xc(&row, &INSTANCE_UUID);
+	/*
+	 * Advertise the local vclock: if this instance still has
+	 * data and the master keeps the WAL files covering the
+	 * rest, the master skips the snapshot and sends only the
+	 * missing rows. On plain bootstrap the vclock is empty
+	 * and the request looks the same as before.
+	 */
+	xrow_encode_join_xc(&row, &INSTANCE_UUID, &replicaset.vclock);
 	coio_write_xrow(coio, &row);
 
 	applier_set_state(applier, APPLIER_INITIAL_JOIN);
@@ -613,12 +725,14 @@ applier_read_tx_row(struct applier *applier, double timeout)
 {
 	struct ev_io *coio = &applier->io;
 	struct ibuf *ibuf = &applier->ibuf;
-	size_t size;
-	struct applier_tx_row *tx_row =
-		region_alloc_object(&fiber()->gc, typeof(*tx_row), &size);
-
+	struct applier_tx_row *tx_row = (struct applier_tx_row *)
+		lsregion_aligned_alloc(&applier->read_ahead_mem,
+				       sizeof(*tx_row),
+				       alignof(struct applier_tx_row),
+				       applier->read_ahead_id);
 	if (tx_row == NULL)
-		tnt_raise(OutOfMemory, size, "region_alloc_object", "tx_row");
+		tnt_raise(OutOfMemory, sizeof(*tx_row),
+			  "lsregion_aligned_alloc", "tx_row");
 
 	struct xrow_header *row = &tx_row->row;
 
@@ -630,7 +744,8 @@ applier_read_tx_row(struct applier *applier, double timeout)
 }
 
 static int64_t
-set_next_tx_row(struct stailq *rows, struct applier_tx_row *tx_row, int64_t tsn)
+set_next_tx_row(struct applier *applier, struct stailq *rows,
+		struct applier_tx_row *tx_row, int64_t tsn)
 {
 	struct xrow_header *row = &tx_row->row;
 
@@ -667,16 +782,20 @@ set_next_tx_row(struct stailq *rows, struct applier_tx_row *tx_row, int64_t tsn)
 	if (row->is_commit) {
 		/* Signal the caller that we've reached the tx end. */
 		tsn = 0;
-	} else if (row->bodycnt == 1) {
+	}
+	if (row->bodycnt == 1) {
 		/*
-		 * Save row body to gc region. Not done for single-statement
-		 * transactions and the last row of multi-statement transactions
-		 * knowing that the input buffer will not be used while the
-		 * transaction is applied.
+		 * Save row body to the read-ahead lsregion. The
+		 * input buffer is reused for the next reads while
+		 * the transaction waits in the read-ahead queue and
+		 * is applied, so every row, including the last one,
+		 * must leave it.
 		 */
-		void *new_base = region_alloc(&fiber()->gc, row->body->iov_len);
+		void *new_base = lsregion_alloc(&applier->read_ahead_mem,
+						row->body->iov_len,
+						applier->read_ahead_id);
 		if (new_base == NULL)
-			tnt_raise(OutOfMemory, row->body->iov_len, "region",
+			tnt_raise(OutOfMemory, row->body->iov_len, "lsregion",
 				  "xrow body");
 		memcpy(new_base, row->body->iov_base, row->body->iov_len);
 		/* Adjust row body pointers. */
@@ -689,10 +808,10 @@ set_next_tx_row(struct stailq *rows, struct applier_tx_row *tx_row, int64_t tsn)
 
 /**
  * Read one transaction from network using applier's input buffer.
- * Transaction rows are placed onto fiber gc region.
- * We could not use applier input buffer to store rows because
- * rpos is adjusted as xrow is decoded and the corresponding
- * network input space is reused for the next xrow.
+ * Transaction rows are placed into the read-ahead lsregion under
+ * a freshly assigned id. We could not use applier input buffer to
+ * store rows because rpos is adjusted as xrow is decoded and the
+ * corresponding network input space is reused for the next xrow.
  */
 static uint64_t
 applier_read_tx(struct applier *applier, struct stailq *rows, double timeout)
@@ -700,11 +819,17 @@ applier_read_tx(struct applier *applier, struct stailq *rows, double timeout)
 	int64_t tsn = 0;
 	uint64_t row_count = 0;
 
+	/*
+	 * Ids must never decrease, so the id of a transaction
+	 * aborted halfway through the read stays burnt; its blocks
+	 * are dropped on disconnect.
+	 */
+	++applier->read_ahead_id;
 	stailq_create(rows);
 	do {
 		struct applier_tx_row *tx_row = applier_read_tx_row(applier,
 								    timeout);
-		tsn = set_next_tx_row(rows, tx_row, tsn);
+		tsn = set_next_tx_row(applier, rows, tx_row, tsn);
 		++row_count;
 	} while (tsn != 0);
 	return row_count;
@@ -862,6 +987,128 @@ applier_handle_raft(struct applier *applier, struct xrow_header *row)
 	return box_raft_process(&req, applier->instance_id);
 }
 
+/**
+ * Return the @a fieldno field of a raw msgpack tuple, or NULL if
+ * there's no such field.
+ */
+static const char *
+applier_tuple_raw_field(const char *data, uint32_t fieldno)
+{
+	if (mp_typeof(*data) != MP_ARRAY)
+		return NULL;
+	uint32_t field_count = mp_decode_array(&data);
+	if (fieldno >= field_count)
+		return NULL;
+	for (uint32_t i = 0; i < fieldno; i++)
+		mp_next(&data);
+	return data;
+}
+
+/**
+ * Compare the conflict resolution fields of two tuples. Only
+ * numeric fields can be compared; for anything else the native
+ * policy gives up. Returns true and sets @a cmp on success.
+ */
+static bool
+applier_conflict_field_cmp(const char *a, const char *b, int *cmp)
+{
+	if (mp_typeof(*a) == MP_UINT && mp_typeof(*b) == MP_UINT) {
+		/* Compare 64 bit timestamps without precision loss. */
+		uint64_t ua = mp_decode_uint(&a);
+		uint64_t ub = mp_decode_uint(&b);
+		*cmp = ua < ub ? -1 : ua > ub;
+		return true;
+	}
+	double da, db;
+	if (mp_read_double(&a, &da) != 0 || mp_read_double(&b, &db) != 0)
+		return false;
+	*cmp = da < db ? -1 : da > db;
+	return true;
+}
+
+/**
+ * Try to resolve an ER_TUPLE_FOUND conflict natively, according
+ * to the conflict_resolution option of the target space. On
+ * success @a row is rewritten so that re-applying it enforces
+ * the winner: a REPLACE when the remote tuple wins, a NOP when
+ * the local one does. Returns -1 when the space has no policy or
+ * the winner can't be determined - the caller then falls back to
+ * replication_skip_conflict and the error path, where user
+ * before_replace triggers still apply as before.
+ */
+static int
+applier_resolve_conflict(struct xrow_header *row)
+{
+	struct request request;
+	if (xrow_decode_dml(row, &request, dml_request_key_map(row->type)) != 0)
+		return -1;
+	/*
+	 * Only INSERT conflicts on the primary key are covered:
+	 * for them the winner can be enforced with a plain
+	 * REPLACE of the same tuple.
+	 */
+	if (request.type != IPROTO_INSERT)
+		return -1;
+	struct space *space = space_cache_find(request.space_id);
+	if (space == NULL)
+		return -1;
+	enum conflict_resolution policy = space->def->opts.conflict_resolution;
+	if (policy == CONFLICT_RESOLUTION_NONE)
+		return -1;
+	struct index *pk = space_index(space, 0);
+	if (pk == NULL)
+		return -1;
+	uint32_t key_size;
+	const char *key = tuple_extract_key_raw(request.tuple,
+						request.tuple_end,
+						pk->def->key_def,
+						MULTIKEY_NONE, &key_size);
+	if (key == NULL)
+		return -1;
+	uint32_t part_count = mp_decode_array(&key);
+	struct tuple *old_tuple;
+	if (index_get(pk, key, part_count, &old_tuple) != 0 ||
+	    old_tuple == NULL)
+		return -1;
+	uint32_t fieldno = space->def->opts.conflict_field;
+	const char *remote_field = applier_tuple_raw_field(request.tuple,
+							   fieldno);
+	const char *local_field = tuple_field(old_tuple, fieldno);
+	if (remote_field == NULL || local_field == NULL)
+		return -1;
+	int cmp;
+	if (!applier_conflict_field_cmp(remote_field, local_field, &cmp))
+		return -1;
+	if (cmp == 0) {
+		/*
+		 * Equal resolution fields: break the tie on the
+		 * tuple contents, so that both masters pick the
+		 * same winner regardless of which side of the
+		 * conflict is local for them.
+		 */
+		uint32_t local_size;
+		const char *local_data = tuple_data_range(old_tuple,
+							  &local_size);
+		uint32_t remote_size = request.tuple_end - request.tuple;
+		cmp = memcmp(request.tuple, local_data,
+			     MIN(remote_size, local_size));
+		if (cmp == 0)
+			cmp = remote_size < local_size ? -1 :
+			      remote_size > local_size;
+	}
+	bool remote_wins = policy == CONFLICT_RESOLUTION_MIN ?
+			   cmp < 0 : cmp > 0;
+	if (remote_wins) {
+		row->type = IPROTO_REPLACE;
+	} else {
+		row->type = IPROTO_NOP;
+		row->bodycnt = 0;
+	}
+	say_debug("native conflict resolution in space %u: %s tuple wins",
+		  (unsigned)request.space_id, remote_wins ? "remote" : "local");
+	return 0;
+}
+
 static inline int
 apply_plain_tx(struct stailq *rows, bool skip_conflict, bool use_triggers)
 {
@@ -877,23 +1124,56 @@ apply_plain_tx(struct stailq *rows, bool skip_conflict, bool use_triggers)
 		 return -1;
 
 	stailq_foreach_entry(item, rows, next) {
-		struct xrow_header *row = &item->row;
+		/*
+		 * Copy the row and its body to the txn region. The
+		 * journal entry keeps referencing them until the WAL
+		 * write completes, which may outlive both the
+		 * read-ahead lsregion allocations, reclaimed as soon
+		 * as the transaction id is reported applied, and
+		 * this fiber's gc region.
+		 */
+		size_t size;
+		struct xrow_header *row =
+			region_alloc_object(&txn->region, typeof(*row), &size);
+		if (row == NULL) {
+			diag_set(OutOfMemory, size, "region_alloc_object",
+				 "row");
+			goto fail;
+		}
+		*row = item->row;
+		if (row->bodycnt == 1) {
+			void *body = region_alloc(&txn->region,
+						  row->body->iov_len);
+			if (body == NULL) {
+				diag_set(OutOfMemory, row->body->iov_len,
+					 "region_alloc", "body");
+				goto fail;
+			}
+			memcpy(body, row->body->iov_base, row->body->iov_len);
+			row->body->iov_base = body;
+		}
 		int res = apply_row(row);
-		if (res != 0 && skip_conflict) {
+		if (res != 0) {
 			struct error *e = diag_last_error(diag_get());
-			/*
-			 * In case of ER_TUPLE_FOUND error and enabled
-			 * replication_skip_conflict configuration
-			 * option, skip applying the foreign row and
-			 * replace it with NOP in the local write ahead
-			 * log.
-			 */
 			if (e->type == &type_ClientError &&
 			    box_error_code(e) == ER_TUPLE_FOUND) {
-				diag_clear(diag_get());
-				row->type = IPROTO_NOP;
-				row->bodycnt = 0;
-				res = apply_row(row);
+				/*
+				 * A native per-space resolution policy
+				 * takes precedence. Without one, if the
+				 * replication_skip_conflict option is
+				 * enabled, skip applying the foreign
+				 * row and replace it with NOP in the
+				 * local write ahead log.
+				 */
+				if (applier_resolve_conflict(row) == 0) {
+					diag_clear(diag_get());
+					res = apply_row(row);
+				} else if (skip_conflict) {
+					diag_clear(diag_get());
+					row->type = IPROTO_NOP;
+					row->bodycnt = 0;
+					res = apply_row(row);
+				}
 			}
 		}
 		if (res != 0)
@@ -1102,6 +1382,93 @@ finish:
 	return rc;
 }
 
+/**
+ * Start pulling the next queued transaction into the CPU cache
+ * while the current one is being applied. The row bodies were
+ * copied to the reader region when they were received and have
+ * likely been evicted by the time the worker reaches them, so
+ * the decoder stalls on DRAM right at the start of every
+ * transaction. Only addresses computable without dependent
+ * loads are touched - the msgpack bodies the decoder is about
+ * to scan; walking an index path instead would stall on every
+ * tree level and hide nothing.
+ */
+static void
+applier_prefetch_next_tx(struct applier *applier)
+{
+	if (stailq_empty(&applier->pending_txs))
+		return;
+	struct applier_tx *tx = stailq_first_entry(&applier->pending_txs,
+						   struct applier_tx, next);
+	struct applier_tx_row *item;
+	stailq_foreach_entry(item, &tx->rows, next) {
+		if (item->row.bodycnt != 1)
+			continue;
+		enum { CACHE_LINE = 64, PREFETCH_LINES = 4 };
+		const char *pos = (const char *)item->row.body->iov_base;
+		const char *end = pos + MIN(item->row.body->iov_len,
+					    PREFETCH_LINES * CACHE_LINE);
+		for (; pos < end; pos += CACHE_LINE)
+			prefetch(pos, 0);
+	}
+}
+
+/**
+ * The apply worker fiber: takes transactions the reader fetched
+ * ahead and applies them in the order they were received, so the
+ * network read of transaction N + 1 overlaps with applying
+ * transaction N instead of waiting for it. Commit order is fully
+ * preserved.
+ */
+static int
+applier_apply_f(va_list ap)
+{
+	struct applier *applier = va_arg(ap, struct applier *);
+	/*
+	 * Set correct session type for use in on_replace()
+	 * triggers.
+	 */
+	struct session *session = session_create_on_demand();
+	if (session == NULL)
+		return -1;
+	session_set_type(session, SESSION_TYPE_APPLIER);
+	while (!fiber_is_cancelled()) {
+		while (stailq_empty(&applier->pending_txs)) {
+			fiber_cond_wait(&applier->apply_cond);
+			if (fiber_is_cancelled())
+				return 0;
+		}
+		struct applier_tx *tx =
+			stailq_shift_entry(&applier->pending_txs,
+					   struct applier_tx, next);
+		applier_prefetch_next_tx(applier);
+		applier->is_applying = true;
+		int rc = applier_apply_tx(applier, &tx->rows);
+		applier->is_applying = false;
+		/*
+		 * The rows were copied to the txn region, so the tx
+		 * and everything it points into may be reclaimed the
+		 * moment the reader sees the published id. Do not
+		 * touch tx past this point.
+		 */
+		applier->applied_id = tx->id;
+		fiber_cond_signal(&applier->drain_cond);
+		if (rc != 0) {
+			/*
+			 * Propagate the error to the reader the same
+			 * way the WAL rollback trigger does.
+			 */
+			if (diag_is_empty(&applier->diag)) {
+				diag_set_error(&applier->diag,
+					       diag_last_error(diag_get()));
+			}
+			fiber_cancel(applier->reader);
+			return -1;
+		}
+	}
+	return 0;
+}
+
 /**
  * Notify the applier's write fiber that there are more ACKs to
  * send to master.
@@ -1164,7 +1531,9 @@ applier_subscribe(struct applier *applier)
 	 */
 	uint32_t id_filter = box_is_orphan() ? 0 : 1 << instance_id;
 	xrow_encode_subscribe_xc(&row, &REPLICASET_UUID, &INSTANCE_UUID,
-				 &vclock, replication_anon, id_filter);
+				 &vclock, replication_anon, id_filter,
+				 replication_space_filter,
+				 replication_space_filter_count);
 	coio_write_xrow(coio, &row);
 
 	/* Read SUBSCRIBE response */
@@ -1249,6 +1618,19 @@ applier_subscribe(struct applier *applier)
 		fiber_start(applier->writer, applier);
 	}
 
+	assert(applier->apply_worker == NULL);
+	assert(stailq_empty(&applier->pending_txs));
+	applier->is_applying = false;
+	{
+		char name[FIBER_NAME_MAX];
+		int pos = snprintf(name, sizeof(name), "applierapply/");
+		uri_format(name + pos, sizeof(name) - pos, &applier->uri,
+			   false);
+		applier->apply_worker = fiber_new_xc(name, applier_apply_f);
+		fiber_set_joinable(applier->apply_worker, true);
+		fiber_start(applier->apply_worker, applier);
+	}
+
 	applier->lag = TIMEOUT_INFINITY;
 
 	/*
@@ -1312,10 +1694,69 @@ applier_subscribe(struct applier *applier)
 					diag_raise();
 			}
 			applier_signal_ack(applier);
-		} else if (applier_apply_tx(applier, &rows) != 0) {
-			diag_raise();
+			/*
+			 * A heartbeat is consumed right here. If no
+			 * transactions are in flight its rows are the
+			 * newest allocation, so drop them at once -
+			 * otherwise they go together with the next
+			 * applied transaction.
+			 */
+			if (stailq_empty(&applier->pending_txs) &&
+			    !applier->is_applying) {
+				lsregion_gc(&applier->read_ahead_mem,
+					    applier->read_ahead_id);
+			}
+		} else {
+			/*
+			 * Hand the transaction over to the apply
+			 * worker and continue reading the stream:
+			 * fetching the next transaction overlaps with
+			 * applying this one. The worker keeps the
+			 * receive order, so commit order is intact.
+			 */
+			struct applier_tx *tx = (struct applier_tx *)
+				lsregion_aligned_alloc(
+					&applier->read_ahead_mem,
+					sizeof(*tx),
+					alignof(struct applier_tx),
+					applier->read_ahead_id);
+			if (tx == NULL) {
+				tnt_raise(OutOfMemory, sizeof(*tx),
+					  "lsregion_aligned_alloc", "tx");
+			}
+			tx->id = applier->read_ahead_id;
+			stailq_create(&tx->rows);
+			stailq_concat(&tx->rows, &rows);
+			stailq_add_tail(&applier->pending_txs, &tx->next);
+			fiber_cond_signal(&applier->apply_cond);
+			/*
+			 * Reclaim the applied prefix of the
+			 * read-ahead memory in one step.
+			 */
+			lsregion_gc(&applier->read_ahead_mem,
+				    applier->applied_id);
+			/*
+			 * The queue and the WAL pipeline give enough
+			 * slack; don't let a lagging worker turn the
+			 * read-ahead into unbounded memory growth.
+			 */
+			while (!stailq_empty(&applier->pending_txs) &&
+			       lsregion_used(&applier->read_ahead_mem) >
+			       APPLIER_READAHEAD_MEM_MAX) {
+				fiber_cond_wait(&applier->drain_cond);
+				if (fiber_is_cancelled())
+					tnt_raise(FiberIsCancelled);
+				lsregion_gc(&applier->read_ahead_mem,
+					    applier->applied_id);
+			}
 		}
 
+		/*
+		 * Read-ahead transactions no longer live on this
+		 * fiber's gc region, so it only carries transient
+		 * per-iteration scratch and may be trimmed freely.
+		 */
+		fiber_gc();
 		if (ibuf_used(ibuf) == 0)
 			ibuf_reset(ibuf);
 	}
@@ -1325,6 +1766,14 @@ static inline void
 applier_disconnect(struct applier *applier, enum applier_state state)
 {
 	applier_set_state(applier, state);
+	if (applier->apply_worker != NULL) {
+		fiber_cancel(applier->apply_worker);
+		fiber_join(applier->apply_worker);
+		applier->apply_worker = NULL;
+		/* Drop transactions the worker didn't get to. */
+		stailq_create(&applier->pending_txs);
+		applier->is_applying = false;
+	}
 	if (applier->writer != NULL) {
 		fiber_cancel(applier->writer);
 		fiber_join(applier->writer);
@@ -1334,6 +1783,8 @@ applier_disconnect(struct applier *applier, enum applier_state state)
 	coio_close_io(loop(), &applier->io);
 	/* Clear all unparsed input. */
 	ibuf_reinit(&applier->ibuf);
+	/* Free staged transactions regardless of how far they got. */
+	lsregion_gc(&applier->read_ahead_mem, INT64_MAX);
 	fiber_gc();
 }
 
@@ -1563,6 +2014,10 @@ applier_new(const char *uri)
 	rlist_create(&applier->on_state);
 	fiber_cond_create(&applier->resume_cond);
 	fiber_cond_create(&applier->writer_cond);
+	fiber_cond_create(&applier->apply_cond);
+	fiber_cond_create(&applier->drain_cond);
+	stailq_create(&applier->pending_txs);
+	lsregion_create(&applier->read_ahead_mem, &runtime);
 	diag_create(&applier->diag);
 
 	return applier;
@@ -1573,6 +2028,7 @@ applier_delete(struct applier *applier)
 {
 	assert(applier->reader == NULL && applier->writer == NULL);
 	ibuf_destroy(&applier->ibuf);
+	lsregion_destroy(&applier->read_ahead_mem);
 	assert(applier->io.fd == -1);
 	trigger_destroy(&applier->on_state);
 	diag_destroy(&applier->diag);
@@ -36,8 +36,10 @@
 #include <tarantool_ev.h>
 
 #include <small/ibuf.h>
+#include <small/lsregion.h>
 
 #include "fiber_cond.h"
+#include "salad/stailq.h"
 #include "trigger.h"
 #include "trivia/util.h"
 #include "uuid/tt_uuid.h"
@@ -87,6 +89,30 @@ struct applier {
 	 * condition variable is not enough.
 	 */
 	bool has_acks_to_send;
+	/**
+	 * Background fiber applying transactions which the reader
+	 * fiber fetched ahead, see applier_apply_f().
+	 */
+	struct fiber *apply_worker;
+	/** Signaled when a new transaction is read ahead. */
+	struct fiber_cond apply_cond;
+	/** Signaled when the worker makes progress draining. */
+	struct fiber_cond drain_cond;
+	/** Transactions read ahead and not yet applied. */
+	struct stailq pending_txs;
+	/** Set while the worker is applying a transaction. */
+	bool is_applying;
+	/**
+	 * Log-structured allocator backing the read-ahead queue.
+	 * Transactions, their rows and row bodies are appended here
+	 * with a monotonically growing transaction id and reclaimed
+	 * by a single lsregion_gc() once the id has been applied.
+	 */
+	struct lsregion read_ahead_mem;
+	/** Id assigned to the transaction being read. */
+	int64_t read_ahead_id;
+	/** Id of the last transaction applied by the worker. */
+	int64_t applied_id;
 	/** Finite-state machine */
 	enum applier_state state;
 	/** Local time of this replica when the last row has been received */
@@ -929,6 +929,51 @@ box_check_ro(void)
 	return ro;
 }
 
+static void
+box_check_replication_space_filter(void)
+{
+	int count = cfg_getarr_size("replication_space_filter");
+	for (int i = 0; i < count; i++) {
+		const char *elem =
+			cfg_getarr_elem("replication_space_filter", i);
+		char *end = NULL;
+		long long id = elem != NULL ? strtoll(elem, &end, 10) : -1;
+		if (elem == NULL || *end != '\0' || id < 0 ||
+		    id > BOX_SPACE_MAX) {
+			tnt_raise(ClientError, ER_CFG,
+				  "replication_space_filter",
+				  "the option must be an array of space ids");
+		}
+	}
+}
+
+/**
+ * Fill in replication_space_filter from the configuration. The
+ * option is not dynamic: the filter is sent to the master in
+ * SUBSCRIBE, so changing it would require a resubscribe.
+ */
+static void
+box_set_replication_space_filter(void)
+{
+	box_check_replication_space_filter();
+	uint32_t count = cfg_getarr_size("replication_space_filter");
+	uint32_t *filter = NULL;
+	if (count != 0) {
+		size_t size = count * sizeof(*filter);
+		filter = (uint32_t *) malloc(size);
+		if (filter == NULL)
+			tnt_raise(OutOfMemory, size, "malloc", "filter");
+		for (uint32_t i = 0; i < count; i++) {
+			const char *elem =
+				cfg_getarr_elem("replication_space_filter", i);
+			filter[i] = strtoll(elem, NULL, 10);
+		}
+	}
+	free(replication_space_filter);
+	replication_space_filter = filter;
+	replication_space_filter_count = count;
+}
+
 static bool
 box_check_replication_anon(void)
 {
@@ -991,6 +1036,19 @@ box_check_wal_cleanup_delay(void)
 	return value;
 }
 
+static double
+box_check_wal_consumer_timeout(void)
+{
+	double value = cfg_getd("wal_consumer_timeout");
+	if (value < 0) {
+		diag_set(ClientError, ER_CFG, "wal_consumer_timeout",
+			 "value must be >= 0");
+		return -1;
+	}
+
+	return value;
+}
+
 static void
 box_check_readahead(int readahead)
 {
@@ -1132,6 +1190,7 @@ box_check_config(void)
 	if (box_check_replication_synchro_timeout() < 0)
 		diag_raise();
 	box_check_replication_sync_timeout();
+	box_check_replication_space_filter();
 	box_check_readahead(cfg_geti("readahead"));
 	box_check_checkpoint_count(cfg_geti("checkpoint_count"));
 	box_check_wal_max_size(cfg_geti64("wal_max_size"));
@@ -1140,6 +1199,8 @@ box_check_config(void)
 		diag_raise();
 	if (box_check_wal_cleanup_delay() < 0)
 		diag_raise();
+	if (box_check_wal_consumer_timeout() < 0)
+		diag_raise();
 	if (box_check_memory_quota("memtx_memory") < 0)
 		diag_raise();
 	box_check_memtx_min_tuple_size(cfg_geti64("memtx_min_tuple_size"));
@@ -1793,6 +1854,16 @@ box_set_wal_cleanup_delay(void)
 	return 0;
 }
 
+int
+box_set_wal_consumer_timeout(void)
+{
+	double timeout = box_check_wal_consumer_timeout();
+	if (timeout < 0)
+		return -1;
+	gc_set_wal_consumer_timeout(timeout);
+	return 0;
+}
+
 void
 box_set_vinyl_memory(void)
 {
@@ -1839,6 +1910,12 @@ box_set_net_msg_max(void)
 				IPROTO_FIBER_POOL_SIZE_FACTOR);
 }
 
+void
+box_set_net_select_result_max(void)
+{
+	iproto_set_select_result_max(cfg_geti64("net_select_result_max"));
+}
+
 int
 box_set_prepared_stmt_cache_size(void)
 {
@@ -2296,10 +2373,23 @@ box_sequence_next(uint32_t seq_id, int64_t *result)
 	if (access_check_sequence(seq) != 0)
 		return -1;
 	int64_t value;
+	bool was_cached = seq->cache_remaining > 0;
 	if (sequence_next(seq, &value) != 0)
 		return -1;
-	if (sequence_data_update(seq_id, value) != 0)
-		return -1;
+	/*
+	 * A value served from the leased block is already covered
+	 * by the _sequence_data row written when the block was
+	 * taken out, so cached calls generate no row at all. When
+	 * a new block is leased, persist its end rather than the
+	 * value being served - that is one row per def->cache
+	 * values.
+	 */
+	if (!was_cached) {
+		int64_t persisted = seq->cache_remaining > 0 ?
+				    sequence_leased_end(seq) : value;
+		if (sequence_data_update(seq_id, persisted) != 0)
+			return -1;
+	}
 	*result = value;
 	return 0;
 }
@@ -2581,7 +2671,9 @@ box_process_join(struct ev_io *io, struct xrow_header *header)
 
 	/* Decode JOIN request */
 	struct tt_uuid instance_uuid = uuid_nil;
-	xrow_decode_join_xc(header, &instance_uuid);
+	struct vclock replica_vclock;
+	vclock_create(&replica_vclock);
+	xrow_decode_join_xc(header, &instance_uuid, &replica_vclock);
 
 	/* Check that bootstrap has been finished */
 	if (!is_box_configured)
@@ -2613,25 +2705,60 @@ box_process_join(struct ev_io *io, struct xrow_header *header)
 			  "wal_mode = 'none'");
 	}
 
+	/*
+	 * A replica that still has data advertises its vclock in
+	 * the JOIN request. If everything it is missing can be
+	 * found in our WAL files - which are guaranteed to be
+	 * kept starting from the oldest preserved checkpoint -
+	 * the snapshot transfer can be skipped entirely and the
+	 * missing range served by the final stage alone.
+	 * @sa box_process_register().
+	 */
+	vclock_reset(&replica_vclock, 0, vclock_get(&replicaset.vclock, 0));
+	struct gc_checkpoint *first_checkpoint = gc_first_checkpoint();
+	bool is_incremental = vclock_sum(&replica_vclock) > 0 &&
+		first_checkpoint != NULL &&
+		vclock_compare_ignore0(&first_checkpoint->vclock,
+				       &replica_vclock) <= 0;
+
 	/*
 	 * Register the replica as a WAL consumer so that
 	 * it can resume FINAL JOIN where INITIAL JOIN ends.
 	 */
-	struct gc_consumer *gc = gc_consumer_register(&replicaset.vclock,
+	struct gc_consumer *gc = gc_consumer_register(
+				is_incremental ? &replica_vclock :
+						 &replicaset.vclock,
 				"replica %s", tt_uuid_str(&instance_uuid));
 	if (gc == NULL)
 		diag_raise();
 	auto gc_guard = make_scoped_guard([&] { gc_consumer_unregister(gc); });
 
-	say_info("joining replica %s at %s",
-		 tt_uuid_str(&instance_uuid), sio_socketname(io->fd));
-
-	/*
-	 * Initial stream: feed replica with dirty data from engines.
-	 */
 	struct vclock start_vclock;
-	relay_initial_join(io->fd, header->sync, &start_vclock);
-	say_info("initial data sent.");
+	if (is_incremental) {
+		say_info("rejoining replica %s at %s incrementally",
+			 tt_uuid_str(&instance_uuid), sio_socketname(io->fd));
+		/*
+		 * The initial stage degenerates into an empty
+		 * stream: respond with the replica's own vclock
+		 * so that it keeps its data, the rows it lacks
+		 * follow in the final stage.
+		 */
+		vclock_copy(&start_vclock, &replica_vclock);
+		struct xrow_header start_row;
+		xrow_encode_vclock_xc(&start_row, &start_vclock);
+		start_row.sync = header->sync;
+		coio_write_xrow(io, &start_row);
+	} else {
+		say_info("joining replica %s at %s",
+			 tt_uuid_str(&instance_uuid), sio_socketname(io->fd));
+
+		/*
+		 * Initial stream: feed replica with dirty data
+		 * from engines.
+		 */
+		relay_initial_join(io->fd, header->sync, &start_vclock);
+		say_info("initial data sent.");
+	}
 
 	/**
 	 * Call the server-side hook which stores the replica uuid
@@ -2691,8 +2818,11 @@ box_process_subscribe(struct ev_io *io, struct xrow_header *header)
 	vclock_create(&replica_clock);
 	bool anon;
 	uint32_t id_filter;
+	uint32_t *space_filter;
+	uint32_t space_filter_count;
 	xrow_decode_subscribe_xc(header, NULL, &replica_uuid, &replica_clock,
-				 &replica_version_id, &anon, &id_filter);
+				 &replica_version_id, &anon, &id_filter,
+				 &space_filter, &space_filter_count);
 
 	/* Forbid connection to itself */
 	if (tt_uuid_is_equal(&replica_uuid, &INSTANCE_UUID))
@@ -2821,7 +2951,8 @@ box_process_subscribe(struct ev_io *io, struct xrow_header *header)
 	 * indefinitely).
 	 */
 	relay_subscribe(replica, io->fd, header->sync, &replica_clock,
-			replica_version_id, id_filter);
+			replica_version_id, id_filter, space_filter,
+			space_filter_count);
 }
 
 void
@@ -3348,6 +3479,7 @@ box_cfg_xc(void)
 	if (box_set_prepared_stmt_cache_size() != 0)
 		diag_raise();
 	box_set_net_msg_max();
+	box_set_net_select_result_max();
 	box_set_readahead();
 	box_set_too_long_threshold();
 	box_set_replication_timeout();
@@ -3361,6 +3493,7 @@ box_cfg_xc(void)
 	box_set_replication_sync_timeout();
 	box_set_replication_skip_conflict();
 	box_set_replication_anon();
+	box_set_replication_space_filter();
 
 	struct gc_checkpoint *checkpoint = gc_last_checkpoint();
 
@@ -3433,6 +3566,15 @@ box_cfg_xc(void)
 	replicaset_follow();
 
 	fiber_gc();
+	/*
+	 * Everything else the first requests need - spaces, tuple
+	 * formats, comparators - was built eagerly during recovery.
+	 * The tx worker fibers are the remaining lazy piece: spawn
+	 * a batch up front so early requests don't pay for stack
+	 * allocation.
+	 */
+	fiber_pool_prime(&tx_fiber_pool,
+			 IPROTO_MSG_MAX_MIN * IPROTO_FIBER_POOL_SIZE_FACTOR);
 	is_box_configured = true;
 	/*
 	 * Fill in leader election parameters after bootstrap. Before it is not
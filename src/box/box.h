@@ -244,6 +244,7 @@ void box_set_checkpoint_interval(void);
 void box_set_checkpoint_wal_threshold(void);
 int box_set_wal_queue_max_size(void);
 int box_set_wal_cleanup_delay(void);
+int box_set_wal_consumer_timeout(void);
 void box_set_memtx_memory(void);
 void box_set_memtx_max_tuple_size(void);
 void box_set_vinyl_memory(void);
@@ -263,6 +264,7 @@ void box_set_replication_sync_timeout(void);
 void box_set_replication_skip_conflict(void);
 void box_set_replication_anon(void);
 void box_set_net_msg_max(void);
+void box_set_net_select_result_max(void);
 int box_set_crash(void);
 
 int
@@ -31,6 +31,7 @@
 
 #include "box/call.h"
 #include "lua/call.h"
+#include "assoc.h"
 #include "schema.h"
 #include "session.h"
 #include "func.h"
@@ -43,8 +44,6 @@
 #include "small/obuf.h"
 #include "tt_static.h"
 
-static const struct port_vtab port_msgpack_vtab;
-
 void
 port_msgpack_create(struct port *base, const char *data, uint32_t data_sz)
 {
@@ -105,7 +104,7 @@ port_msgpack_set_plain(struct port *base, const char *plain, uint32_t len)
 	return 0;
 }
 
-static const struct port_vtab port_msgpack_vtab = {
+const struct port_vtab port_msgpack_vtab = {
 	.dump_msgpack = port_msgpack_dump_msgpack,
 	.dump_msgpack_16 = NULL,
 	.dump_lua = port_msgpack_dump_lua,
@@ -131,6 +130,38 @@ box_module_reload(const char *name)
 	return schema_module_reload(name, name + strlen(name));
 }
 
+/**
+ * Resolve a CALL target through the session cache. The cache is
+ * a tiny direct-mapped table in struct session: a workload doing
+ * hundreds of thousands of calls per second to a handful of
+ * functions pays for the mhash lookup in func_by_name() on every
+ * request, while DDL, which bumps schema_version and thereby
+ * drops the cache, is rare. Collisions simply evict the old
+ * slot, so misses cost one extra memcmp at worst.
+ */
+static struct func *
+session_func_find(const char *name, uint32_t name_len)
+{
+	struct session *session = current_session();
+	struct session_func_cache_entry *e = NULL;
+	if (name_len <= SESSION_FUNC_CACHE_NAME_MAX) {
+		uint32_t hash = mh_strn_hash(name, name_len);
+		e = &session->func_cache[hash % SESSION_FUNC_CACHE_SIZE];
+		if (e->schema_version == schema_version &&
+		    e->name_len == name_len &&
+		    memcmp(e->name, name, name_len) == 0)
+			return e->func;
+	}
+	struct func *func = func_by_name(name, name_len);
+	if (func != NULL && e != NULL) {
+		e->schema_version = schema_version;
+		e->name_len = name_len;
+		e->func = func;
+		memcpy(e->name, name, name_len);
+	}
+	return func;
+}
+
 int
 box_process_call(struct call_request *request, struct port *port)
 {
@@ -148,12 +179,12 @@ box_process_call(struct call_request *request, struct port *port)
 	struct port args;
 	port_msgpack_create(&args, request->args,
 			    request->args_end - request->args);
-	struct func *func = func_by_name(name, name_len);
+	struct func *func = session_func_find(name, name_len);
 	if (func != NULL) {
 		rc = func_call(func, &args, port);
 	} else if ((rc = access_check_universe_object(PRIV_X | PRIV_U,
 				SC_FUNCTION, tt_cstr(name, name_len))) == 0) {
-		rc = box_lua_call(name, name_len, &args, port);
+		rc = box_lua_call(name, name_len, NULL, &args, port);
 	}
 	if (rc != 0)
 		return -1;
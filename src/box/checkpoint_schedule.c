@@ -56,6 +56,22 @@ checkpoint_schedule_reset(struct checkpoint_schedule *sched, double now)
 	sched->start_time = now + sched->interval;
 }
 
+void
+checkpoint_schedule_stretch(struct checkpoint_schedule *sched,
+			    double now, double duration)
+{
+	if (sched->interval <= 0)
+		return;
+	/*
+	 * A quick checkpoint doesn't disturb the schedule. Only
+	 * when it ate up at least half of the interval is the
+	 * next checkpoint rescheduled to a full interval from
+	 * the end of this one.
+	 */
+	if (duration >= sched->interval / 2)
+		checkpoint_schedule_reset(sched, now);
+}
+
 double
 checkpoint_schedule_timeout(struct checkpoint_schedule *sched, double now)
 {
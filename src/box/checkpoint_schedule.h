@@ -69,6 +69,21 @@ checkpoint_schedule_cfg(struct checkpoint_schedule *sched,
 void
 checkpoint_schedule_reset(struct checkpoint_schedule *sched, double now);
 
+/**
+ * Account a completed checkpoint that took @duration seconds.
+ *
+ * Called when a scheduled checkpoint finishes. If writing took
+ * a substantial part of the interval (which means the checkpoint
+ * writer was throttled or the disk is saturated), the schedule
+ * is stretched so that the next checkpoint starts a full interval
+ * after this one ended, giving the disk a quiet period.
+ *
+ * @now is the current time.
+ */
+void
+checkpoint_schedule_stretch(struct checkpoint_schedule *sched,
+			    double now, double duration);
+
 /**
  * Return the time to the next scheduled checkpoint, in seconds.
  * If auto checkpointing is disabled, returns 0.
@@ -177,6 +177,567 @@ ck_constraint_program_run(struct ck_constraint *ck_constraint,
 	return sql_stmt_reset(ck_constraint->stmt);
 }
 
+enum {
+	/**
+	 * Hard cap on the native program length and thus on its
+	 * evaluation stack depth. Expressions which don't fit
+	 * are simply left to the VDBE.
+	 */
+	CK_NATIVE_MAX_OPS = 64,
+};
+
+/** Opcodes of the native predicate program. */
+enum ck_native_opcode {
+	/** Push an immediate integer. */
+	CK_NATIVE_INT,
+	/** Push SQL NULL. */
+	CK_NATIVE_NULL,
+	/** Push the value of a tuple field. */
+	CK_NATIVE_FIELD,
+	/* Binary arithmetics, pop two values, push the result. */
+	CK_NATIVE_ADD,
+	CK_NATIVE_SUB,
+	CK_NATIVE_MUL,
+	CK_NATIVE_DIV,
+	CK_NATIVE_REM,
+	/** Negate the top of the stack. */
+	CK_NATIVE_NEG,
+	/* Comparisons, pop two values, push a boolean. */
+	CK_NATIVE_LT,
+	CK_NATIVE_LE,
+	CK_NATIVE_GT,
+	CK_NATIVE_GE,
+	CK_NATIVE_EQ,
+	CK_NATIVE_NE,
+	/* Three-valued logic connectives. */
+	CK_NATIVE_AND,
+	CK_NATIVE_OR,
+	CK_NATIVE_NOT,
+	/** IS [NOT] NULL tests, always produce a boolean. */
+	CK_NATIVE_ISNULL,
+	CK_NATIVE_NOTNULL,
+};
+
+/** A single instruction of the native predicate program. */
+struct ck_native_op {
+	/** Opcode, see enum ck_native_opcode. */
+	uint8_t code;
+	/** Field number for CK_NATIVE_FIELD. */
+	uint32_t fieldno;
+	/** Immediate value for CK_NATIVE_INT. */
+	int64_t imm;
+};
+
+/**
+ * A check constraint expression compiled into flat postfix
+ * form. Evaluated with a small value stack, see
+ * ck_constraint_native_run().
+ */
+struct ck_native_program {
+	/** Number of instructions in ops. */
+	uint32_t op_count;
+	/** The instructions, in postfix order. */
+	struct ck_native_op ops[0];
+};
+
+/**
+ * Result of a native program run. The program bails out to the
+ * VDBE instead of guessing whenever it meets a condition whose
+ * SQL behavior it doesn't reproduce: a field of an unexpected
+ * type, integer overflow or division by zero.
+ */
+enum ck_native_status {
+	CK_NATIVE_OK,
+	CK_NATIVE_VIOLATED,
+	CK_NATIVE_FALLBACK,
+};
+
+/**
+ * A value on the native evaluation stack. Integers follow the
+ * VDBE representation: the num bit pattern is an int64 when
+ * is_neg is set and an uint64 otherwise, which covers the whole
+ * [-2^63, 2^64 - 1] range the SQL integer type has.
+ */
+struct ck_native_val {
+	int64_t num;
+	bool is_neg;
+	bool is_null;
+};
+
+/** Compare two non-NULL integer values, return -1, 0 or 1. */
+static int
+ck_native_cmp(const struct ck_native_val *a, const struct ck_native_val *b)
+{
+	if (a->is_neg != b->is_neg)
+		return a->is_neg ? -1 : 1;
+	if (a->is_neg) {
+		if (a->num != b->num)
+			return a->num < b->num ? -1 : 1;
+		return 0;
+	}
+	uint64_t ua = (uint64_t)a->num;
+	uint64_t ub = (uint64_t)b->num;
+	if (ua != ub)
+		return ua < ub ? -1 : 1;
+	return 0;
+}
+
+/** Append an instruction unless the program is full. */
+static int
+ck_native_emit(struct ck_native_op *ops, uint32_t *op_count, uint8_t code,
+	       uint32_t fieldno, int64_t imm)
+{
+	if (*op_count >= CK_NATIVE_MAX_OPS)
+		return -1;
+	ops[*op_count].code = code;
+	ops[*op_count].fieldno = fieldno;
+	ops[*op_count].imm = imm;
+	++*op_count;
+	return 0;
+}
+
+/**
+ * Static type of a value a native subexpression produces. The
+ * VDBE this machinery replaces is strictly typed: OP_Not, OP_If
+ * and OP_And raise ER_SQL_TYPE_MISMATCH on a non-boolean operand
+ * and arithmetics rejects booleans, so the compiler must track
+ * what each node yields and refuse mixtures instead of treating
+ * any integer as a truth value.
+ */
+enum ck_native_kind {
+	/** An integer: literals, fields, arithmetics. */
+	CK_NATIVE_KIND_INT,
+	/** A boolean: comparisons, IS [NOT] NULL, logic ops. */
+	CK_NATIVE_KIND_BOOL,
+	/** A NULL literal, acceptable in either position. */
+	CK_NATIVE_KIND_ANY,
+};
+
+static inline bool
+ck_native_kind_is_int(enum ck_native_kind kind)
+{
+	return kind != CK_NATIVE_KIND_BOOL;
+}
+
+static inline bool
+ck_native_kind_is_bool(enum ck_native_kind kind)
+{
+	return kind != CK_NATIVE_KIND_INT;
+}
+
+/**
+ * Emit postfix instructions for a resolved expression subtree
+ * and report the kind of value it produces via @a kind.
+ * @retval 0 On success.
+ * @retval -1 When the expression is outside of the supported
+ *            subset; no diag is set, the caller falls back to
+ *            the VDBE program.
+ */
+static int
+ck_constraint_native_emit_expr(const struct Expr *expr, uint32_t field_count,
+			       struct ck_native_op *ops, uint32_t *op_count,
+			       enum ck_native_kind *kind)
+{
+	if (expr == NULL)
+		return -1;
+	uint8_t code;
+	bool operands_are_bool;
+	enum ck_native_kind left;
+	enum ck_native_kind right;
+	switch (expr->op) {
+	case TK_INTEGER:
+		if ((expr->flags & EP_IntValue) == 0)
+			return -1;
+		*kind = CK_NATIVE_KIND_INT;
+		return ck_native_emit(ops, op_count, CK_NATIVE_INT, 0,
+				      expr->u.iValue);
+	case TK_NULL:
+		*kind = CK_NATIVE_KIND_ANY;
+		return ck_native_emit(ops, op_count, CK_NATIVE_NULL, 0, 0);
+	case TK_COLUMN_REF:
+		if (expr->iColumn < 0 ||
+		    (uint32_t)expr->iColumn >= field_count)
+			return -1;
+		*kind = CK_NATIVE_KIND_INT;
+		return ck_native_emit(ops, op_count, CK_NATIVE_FIELD,
+				      expr->iColumn, 0);
+	case TK_UMINUS:
+		/* Fold a negated integer literal. */
+		if (expr->pLeft != NULL && expr->pLeft->op == TK_INTEGER &&
+		    (expr->pLeft->flags & EP_IntValue) != 0) {
+			*kind = CK_NATIVE_KIND_INT;
+			return ck_native_emit(ops, op_count, CK_NATIVE_INT, 0,
+					      -(int64_t)expr->pLeft->u.iValue);
+		}
+		if (ck_constraint_native_emit_expr(expr->pLeft, field_count,
+						   ops, op_count, &left) != 0 ||
+		    !ck_native_kind_is_int(left))
+			return -1;
+		*kind = CK_NATIVE_KIND_INT;
+		return ck_native_emit(ops, op_count, CK_NATIVE_NEG, 0, 0);
+	case TK_NOT:
+		if (ck_constraint_native_emit_expr(expr->pLeft, field_count,
+						   ops, op_count, &left) != 0 ||
+		    !ck_native_kind_is_bool(left))
+			return -1;
+		*kind = CK_NATIVE_KIND_BOOL;
+		return ck_native_emit(ops, op_count, CK_NATIVE_NOT, 0, 0);
+	case TK_ISNULL:
+	case TK_NOTNULL:
+		/* The operand may be of any supported kind. */
+		if (ck_constraint_native_emit_expr(expr->pLeft, field_count,
+						   ops, op_count, &left) != 0)
+			return -1;
+		*kind = CK_NATIVE_KIND_BOOL;
+		return ck_native_emit(ops, op_count,
+				      expr->op == TK_ISNULL ?
+				      CK_NATIVE_ISNULL : CK_NATIVE_NOTNULL,
+				      0, 0);
+	case TK_PLUS:
+		code = CK_NATIVE_ADD;
+		operands_are_bool = false;
+		*kind = CK_NATIVE_KIND_INT;
+		break;
+	case TK_MINUS:
+		code = CK_NATIVE_SUB;
+		operands_are_bool = false;
+		*kind = CK_NATIVE_KIND_INT;
+		break;
+	case TK_STAR:
+		code = CK_NATIVE_MUL;
+		operands_are_bool = false;
+		*kind = CK_NATIVE_KIND_INT;
+		break;
+	case TK_SLASH:
+		code = CK_NATIVE_DIV;
+		operands_are_bool = false;
+		*kind = CK_NATIVE_KIND_INT;
+		break;
+	case TK_REM:
+		code = CK_NATIVE_REM;
+		operands_are_bool = false;
+		*kind = CK_NATIVE_KIND_INT;
+		break;
+	case TK_LT:
+		code = CK_NATIVE_LT;
+		operands_are_bool = false;
+		*kind = CK_NATIVE_KIND_BOOL;
+		break;
+	case TK_LE:
+		code = CK_NATIVE_LE;
+		operands_are_bool = false;
+		*kind = CK_NATIVE_KIND_BOOL;
+		break;
+	case TK_GT:
+		code = CK_NATIVE_GT;
+		operands_are_bool = false;
+		*kind = CK_NATIVE_KIND_BOOL;
+		break;
+	case TK_GE:
+		code = CK_NATIVE_GE;
+		operands_are_bool = false;
+		*kind = CK_NATIVE_KIND_BOOL;
+		break;
+	case TK_EQ:
+		code = CK_NATIVE_EQ;
+		operands_are_bool = false;
+		*kind = CK_NATIVE_KIND_BOOL;
+		break;
+	case TK_NE:
+		code = CK_NATIVE_NE;
+		operands_are_bool = false;
+		*kind = CK_NATIVE_KIND_BOOL;
+		break;
+	case TK_AND:
+		code = CK_NATIVE_AND;
+		operands_are_bool = true;
+		*kind = CK_NATIVE_KIND_BOOL;
+		break;
+	case TK_OR:
+		code = CK_NATIVE_OR;
+		operands_are_bool = true;
+		*kind = CK_NATIVE_KIND_BOOL;
+		break;
+	default:
+		return -1;
+	}
+	if (ck_constraint_native_emit_expr(expr->pLeft, field_count, ops,
+					   op_count, &left) != 0 ||
+	    ck_constraint_native_emit_expr(expr->pRight, field_count, ops,
+					   op_count, &right) != 0)
+		return -1;
+	if (operands_are_bool) {
+		if (!ck_native_kind_is_bool(left) ||
+		    !ck_native_kind_is_bool(right))
+			return -1;
+	} else {
+		if (!ck_native_kind_is_int(left) ||
+		    !ck_native_kind_is_int(right))
+			return -1;
+	}
+	return ck_native_emit(ops, op_count, code, 0, 0);
+}
+
+/**
+ * Try to compile a resolved check constraint expression into a
+ * native predicate program. This is a pure optimization: NULL
+ * is returned for expressions outside the supported subset (or
+ * on allocation failure) and the VDBE program stays the only
+ * evaluator then.
+ */
+static struct ck_native_program *
+ck_constraint_native_compile(const struct Expr *expr, uint32_t field_count)
+{
+	struct ck_native_op ops[CK_NATIVE_MAX_OPS];
+	uint32_t op_count = 0;
+	enum ck_native_kind kind;
+	if (ck_constraint_native_emit_expr(expr, field_count, ops,
+					   &op_count, &kind) != 0)
+		return NULL;
+	/*
+	 * OP_If raises ER_SQL_TYPE_MISMATCH when the constraint
+	 * expression yields a plain integer, so such expressions
+	 * must keep failing through the VDBE.
+	 */
+	if (!ck_native_kind_is_bool(kind))
+		return NULL;
+	assert(op_count > 0);
+	size_t size = sizeof(struct ck_native_program) +
+		      op_count * sizeof(ops[0]);
+	struct ck_native_program *program = malloc(size);
+	if (program == NULL)
+		return NULL;
+	program->op_count = op_count;
+	memcpy(program->ops, ops, op_count * sizeof(ops[0]));
+	return program;
+}
+
+/**
+ * Evaluate a native predicate program against a new tuple,
+ * reading fields directly from its msgpack.
+ * @retval CK_NATIVE_OK The check is passed (TRUE or NULL).
+ * @retval CK_NATIVE_VIOLATED The expression is FALSE.
+ * @retval CK_NATIVE_FALLBACK The row must be re-checked by the
+ *         VDBE program.
+ */
+static enum ck_native_status
+ck_constraint_native_run(const struct ck_native_program *program,
+			 struct tuple *new_tuple)
+{
+	struct ck_native_val stack[CK_NATIVE_MAX_OPS];
+	struct ck_native_val *top = stack;
+	for (uint32_t i = 0; i < program->op_count; i++) {
+		const struct ck_native_op *op = &program->ops[i];
+		struct ck_native_val *a;
+		struct ck_native_val *b;
+		switch (op->code) {
+		case CK_NATIVE_INT:
+			top->num = op->imm;
+			top->is_neg = op->imm < 0;
+			top->is_null = false;
+			top++;
+			break;
+		case CK_NATIVE_NULL:
+			top->is_null = true;
+			top++;
+			break;
+		case CK_NATIVE_FIELD: {
+			const char *field =
+				tuple_field(new_tuple, op->fieldno);
+			if (field == NULL)
+				return CK_NATIVE_FALLBACK;
+			switch (mp_typeof(*field)) {
+			case MP_NIL:
+				top->is_null = true;
+				break;
+			case MP_UINT:
+				top->num = (int64_t)mp_decode_uint(&field);
+				top->is_neg = false;
+				top->is_null = false;
+				break;
+			case MP_INT: {
+				int64_t num = mp_decode_int(&field);
+				top->num = num;
+				top->is_neg = num < 0;
+				top->is_null = false;
+				break;
+			}
+			default:
+				return CK_NATIVE_FALLBACK;
+			}
+			top++;
+			break;
+		}
+		case CK_NATIVE_NEG:
+			a = &top[-1];
+			if (a->is_null || a->num == 0)
+				break;
+			if (a->is_neg) {
+				a->num = (int64_t)(0 - (uint64_t)a->num);
+				a->is_neg = false;
+			} else if ((uint64_t)a->num <=
+				   (uint64_t)INT64_MAX + 1) {
+				a->num = (int64_t)(0 - (uint64_t)a->num);
+				a->is_neg = true;
+			} else {
+				/* Would overflow, the VDBE raises. */
+				return CK_NATIVE_FALLBACK;
+			}
+			break;
+		case CK_NATIVE_NOT:
+			a = &top[-1];
+			if (!a->is_null) {
+				a->num = a->num == 0;
+				a->is_neg = false;
+			}
+			break;
+		case CK_NATIVE_ISNULL:
+			a = &top[-1];
+			a->num = a->is_null;
+			a->is_neg = false;
+			a->is_null = false;
+			break;
+		case CK_NATIVE_NOTNULL:
+			a = &top[-1];
+			a->num = !a->is_null;
+			a->is_neg = false;
+			a->is_null = false;
+			break;
+		case CK_NATIVE_ADD:
+		case CK_NATIVE_SUB:
+		case CK_NATIVE_MUL:
+		case CK_NATIVE_DIV:
+		case CK_NATIVE_REM: {
+			top--;
+			a = &top[-1];
+			b = top;
+			if (a->is_null || b->is_null) {
+				a->is_null = true;
+				break;
+			}
+			int rc;
+			int64_t res;
+			bool is_neg;
+			switch (op->code) {
+			case CK_NATIVE_ADD:
+				rc = sql_add_int(a->num, a->is_neg, b->num,
+						 b->is_neg, &res, &is_neg);
+				break;
+			case CK_NATIVE_SUB:
+				rc = sql_sub_int(a->num, a->is_neg, b->num,
+						 b->is_neg, &res, &is_neg);
+				break;
+			case CK_NATIVE_MUL:
+				rc = sql_mul_int(a->num, a->is_neg, b->num,
+						 b->is_neg, &res, &is_neg);
+				break;
+			case CK_NATIVE_DIV:
+				if (b->num == 0)
+					return CK_NATIVE_FALLBACK;
+				rc = sql_div_int(a->num, a->is_neg, b->num,
+						 b->is_neg, &res, &is_neg);
+				break;
+			default:
+				if (b->num == 0)
+					return CK_NATIVE_FALLBACK;
+				rc = sql_rem_int(a->num, a->is_neg, b->num,
+						 b->is_neg, &res, &is_neg);
+				break;
+			}
+			if (rc != 0) {
+				/* Overflow, the VDBE raises. */
+				return CK_NATIVE_FALLBACK;
+			}
+			a->num = res;
+			a->is_neg = is_neg;
+			break;
+		}
+		case CK_NATIVE_LT:
+		case CK_NATIVE_LE:
+		case CK_NATIVE_GT:
+		case CK_NATIVE_GE:
+		case CK_NATIVE_EQ:
+		case CK_NATIVE_NE: {
+			top--;
+			a = &top[-1];
+			b = top;
+			if (a->is_null || b->is_null) {
+				a->is_null = true;
+				break;
+			}
+			int cmp = ck_native_cmp(a, b);
+			bool res;
+			switch (op->code) {
+			case CK_NATIVE_LT:
+				res = cmp < 0;
+				break;
+			case CK_NATIVE_LE:
+				res = cmp <= 0;
+				break;
+			case CK_NATIVE_GT:
+				res = cmp > 0;
+				break;
+			case CK_NATIVE_GE:
+				res = cmp >= 0;
+				break;
+			case CK_NATIVE_EQ:
+				res = cmp == 0;
+				break;
+			default:
+				res = cmp != 0;
+				break;
+			}
+			a->num = res;
+			a->is_neg = false;
+			break;
+		}
+		case CK_NATIVE_AND: {
+			top--;
+			a = &top[-1];
+			b = top;
+			bool a_false = !a->is_null && a->num == 0;
+			bool b_false = !b->is_null && b->num == 0;
+			if (a_false || b_false) {
+				a->num = 0;
+				a->is_neg = false;
+				a->is_null = false;
+			} else if (a->is_null || b->is_null) {
+				a->is_null = true;
+			} else {
+				a->num = 1;
+				a->is_neg = false;
+			}
+			break;
+		}
+		case CK_NATIVE_OR: {
+			top--;
+			a = &top[-1];
+			b = top;
+			bool a_true = !a->is_null && a->num != 0;
+			bool b_true = !b->is_null && b->num != 0;
+			if (a_true || b_true) {
+				a->num = 1;
+				a->is_neg = false;
+				a->is_null = false;
+			} else if (a->is_null || b->is_null) {
+				a->is_null = true;
+			} else {
+				a->num = 0;
+				a->is_neg = false;
+			}
+			break;
+		}
+		default:
+			unreachable();
+		}
+	}
+	assert(top == stack + 1);
+	/* As in the VDBE program, NULL passes the check. */
+	if (!stack[0].is_null && stack[0].num == 0)
+		return CK_NATIVE_VIOLATED;
+	return CK_NATIVE_OK;
+}
+
 int
 ck_constraint_on_replace_trigger(struct trigger *trigger, void *event)
 {
@@ -190,22 +751,47 @@ ck_constraint_on_replace_trigger(struct trigger *trigger, void *event)
 
 	struct space *space = stmt->space;
 	assert(space != NULL);
-	struct vdbe_field_ref *field_ref;
-	size_t size = sizeof(field_ref->slots[0]) * space->def->field_count +
-		      sizeof(*field_ref);
-	field_ref = (struct vdbe_field_ref *)
-		region_aligned_alloc(&fiber()->gc, size, alignof(*field_ref));
-	if (field_ref == NULL) {
-		diag_set(OutOfMemory, size, "region_aligned_alloc",
-			 "field_ref");
-		return -1;
-	}
-	vdbe_field_ref_prepare_tuple(field_ref, new_tuple);
+	/*
+	 * The vdbe_field_ref is only prepared when some
+	 * constraint actually reaches the VDBE: rows covered by
+	 * native programs don't pay for it.
+	 */
+	struct vdbe_field_ref *field_ref = NULL;
 
 	struct ck_constraint *ck_constraint;
 	rlist_foreach_entry(ck_constraint, &space->ck_constraint, link) {
-		if (ck_constraint->def->is_enabled &&
-		    ck_constraint_program_run(ck_constraint, field_ref) != 0)
+		if (!ck_constraint->def->is_enabled)
+			continue;
+		if (ck_constraint->native_program != NULL) {
+			enum ck_native_status status =
+				ck_constraint_native_run(
+					ck_constraint->native_program,
+					new_tuple);
+			if (status == CK_NATIVE_OK)
+				continue;
+			if (status == CK_NATIVE_VIOLATED) {
+				diag_set(ClientError, ER_CK_CONSTRAINT_FAILED,
+					 ck_constraint->def->name,
+					 ck_constraint->def->expr_str);
+				return -1;
+			}
+			/* CK_NATIVE_FALLBACK: re-check via VDBE. */
+		}
+		if (field_ref == NULL) {
+			size_t size = sizeof(field_ref->slots[0]) *
+				      space->def->field_count +
+				      sizeof(*field_ref);
+			field_ref = (struct vdbe_field_ref *)
+				region_aligned_alloc(&fiber()->gc, size,
+						     alignof(*field_ref));
+			if (field_ref == NULL) {
+				diag_set(OutOfMemory, size,
+					 "region_aligned_alloc", "field_ref");
+				return -1;
+			}
+			vdbe_field_ref_prepare_tuple(field_ref, new_tuple);
+		}
+		if (ck_constraint_program_run(ck_constraint, field_ref) != 0)
 			return -1;
 	}
 	return 0;
@@ -228,6 +814,7 @@ ck_constraint_new(struct ck_constraint_def *ck_constraint_def,
 	}
 	ck_constraint->def = NULL;
 	ck_constraint->stmt = NULL;
+	ck_constraint->native_program = NULL;
 	rlist_create(&ck_constraint->link);
 	struct Expr *expr =
 		sql_expr_compile(sql_get(), ck_constraint_def->expr_str,
@@ -239,6 +826,14 @@ ck_constraint_new(struct ck_constraint_def *ck_constraint_def,
 			 box_error_message(box_error_last()));
 		goto error;
 	}
+	/*
+	 * Try to also compile the expression natively, before
+	 * the VDBE code generator gets a chance to rewrite the
+	 * AST. There is nothing to do on failure: the VDBE
+	 * program covers every expression.
+	 */
+	ck_constraint->native_program =
+		ck_constraint_native_compile(expr, space_def->field_count);
 	ck_constraint->stmt =
 		ck_constraint_program_compile(ck_constraint_def, expr);
 	if (ck_constraint->stmt == NULL)
@@ -257,6 +852,7 @@ void
 ck_constraint_delete(struct ck_constraint *ck_constraint)
 {
 	sql_stmt_finalize(ck_constraint->stmt);
+	free(ck_constraint->native_program);
 	ck_constraint_def_delete(ck_constraint->def);
 	TRASH(ck_constraint);
 	free(ck_constraint);
@@ -43,6 +43,7 @@ struct space_def;
 struct sql_stmt;
 struct Expr;
 struct trigger;
+struct ck_native_program;
 
 /** Supported languages of ck constraint. */
 enum ck_constraint_language {
@@ -98,6 +99,17 @@ struct ck_constraint {
 	 * message when ck condition unsatisfied.
 	 */
 	struct sql_stmt *stmt;
+	/**
+	 * The expression compiled into a flat native predicate
+	 * program evaluated directly over raw msgpack fields of
+	 * a new tuple, without starting the VDBE. NULL when the
+	 * expression is outside of the supported subset. When
+	 * set, stmt is still kept around: the native program
+	 * refuses conditions it can't reproduce bit-for-bit
+	 * (unexpected field types, integer overflow, division
+	 * by zero) and such rows are re-checked by the VDBE.
+	 */
+	struct ck_native_program *native_program;
 	/**
 	 * Organize check constraint structs into linked list
 	 * with space::ck_constraint.
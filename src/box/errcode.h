@@ -277,6 +277,7 @@ struct errcode_record {
 	/*222 */_(ER_QUORUM_WAIT,		"Couldn't wait for quorum %d: %s") \
 	/*223 */_(ER_INTERFERING_PROMOTE,	"Instance with replica id %u was promoted first") \
 	/*224 */_(ER_RAFT_DISABLED,		"Elections were turned off while running box.ctl.promote()")\
+	/*225 */_(ER_SELECT_RESULT_TOO_BIG,	"Select result size %llu exceeds net_select_result_max %llu") \
 
 /*
  * !IMPORTANT! Please follow instructions at start of the file
@@ -123,3 +123,19 @@ field_map_build(struct field_map_builder *builder, char *buffer)
 	}
 	assert(extent_wptr == buffer + builder->extents_size);
 }
+
+void
+field_map_build_compact(struct field_map_builder *builder, char *buffer)
+{
+	/*
+	 * Same layout as field_map_build(), but with byte-wide
+	 * slots and no extents, see field_map_can_be_compact().
+	 */
+	uint8_t *field_map =
+		(uint8_t *)(buffer + field_map_build_size_compact(builder));
+	for (int32_t i = -1; i >= -(int32_t)builder->slot_count; i--) {
+		assert(!builder->slots[i].has_extent);
+		assert(builder->slots[i].offset <= UINT8_MAX);
+		field_map[i] = builder->slots[i].offset;
+	}
+}
@@ -31,6 +31,7 @@
  * SUCH DAMAGE.
  */
 #include <assert.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 #include "bit/bit.h"
@@ -146,12 +147,20 @@ struct field_map_builder_slot {
  * Get offset of the field in tuple data MessagePack using
  * tuple's field_map and required field's offset_slot.
  *
+ * When @a is_compact is set, the field map is stored in the
+ * compact layout: a sequence of 8-bit offsets instead of 32-bit
+ * ones. Compact maps are only used for tuples small enough for
+ * every offset to fit into a byte and never contain multikey
+ * extents (see field_map_can_be_compact()).
+ *
  * When a field is not in the data tuple, its offset is 0.
  */
 static inline uint32_t
 field_map_get_offset(const uint32_t *field_map, int32_t offset_slot,
-		     int multikey_idx)
+		     int multikey_idx, bool is_compact)
 {
+	if (is_compact)
+		return ((const uint8_t *)field_map)[offset_slot];
 	/*
 	 * Can not access field_map as a normal uint32 array
 	 * because its alignment may be < 4 bytes. Need to use
@@ -249,6 +258,28 @@ field_map_build_size(struct field_map_builder *builder)
 	       builder->extents_size;
 }
 
+/**
+ * Check whether the field map under construction may be stored
+ * in the compact layout: 8-bit offset slots and no multikey
+ * extents. Offsets point into the tuple's MessagePack data, so
+ * any tuple shorter than 256 bytes qualifies.
+ */
+static inline bool
+field_map_can_be_compact(struct field_map_builder *builder, uint32_t data_size)
+{
+	return builder->extents_size == 0 && data_size <= UINT8_MAX;
+}
+
+/**
+ * Calculate the size of a compact tuple field_map to be built.
+ */
+static inline uint32_t
+field_map_build_size_compact(struct field_map_builder *builder)
+{
+	assert(builder->extents_size == 0);
+	return builder->slot_count * sizeof(uint8_t);
+}
+
 /**
  * Write constructed field_map to the destination buffer field_map.
  *
@@ -257,4 +288,13 @@ field_map_build_size(struct field_map_builder *builder)
 void
 field_map_build(struct field_map_builder *builder, char *buffer);
 
+/**
+ * Write constructed field_map to the destination buffer in the
+ * compact layout. The builder must satisfy
+ * field_map_can_be_compact() and the buffer must have at least
+ * field_map_build_size_compact(builder) bytes.
+ */
+void
+field_map_build_compact(struct field_map_builder *builder, char *buffer);
+
 #endif /* TARANTOOL_BOX_FIELD_MAP_H_INCLUDED */
@@ -83,6 +83,10 @@ func_def_cmp(struct func_def *def1, struct func_def *def2)
 		return def1->aggregate - def2->aggregate;
 	if (def1->param_count != def2->param_count)
 		return def1->param_count - def2->param_count;
+	if (memcmp(def1->param_types, def2->param_types,
+		   sizeof(def1->param_types)) != 0)
+		return memcmp(def1->param_types, def2->param_types,
+			      sizeof(def1->param_types));
 	if ((def1->comment != NULL) != (def2->comment != NULL))
 		return def1->comment - def2->comment;
 	if (def1->comment != NULL && strcmp(def1->comment, def2->comment) != 0)
@@ -80,6 +80,14 @@ func_opts_create(struct func_opts *opts)
 	*opts = func_opts_default;
 }
 
+enum {
+	/**
+	 * How many leading parameters keep their declared type in
+	 * a function definition; the rest are treated as 'any'.
+	 */
+	FUNC_PARAM_TYPES_MAX = 16,
+};
+
 /**
  * Definition of a function. Function body is not stored
  * or replicated (yet).
@@ -111,6 +119,14 @@ struct func_def {
 	bool is_sandboxed;
 	/** The count of function's input arguments. */
 	int param_count;
+	/**
+	 * Declared types (enum field_type) of the first
+	 * FUNC_PARAM_TYPES_MAX arguments from the _func
+	 * param_list, FIELD_TYPE_ANY when not declared. Lets call
+	 * dispatch decode arguments with a specialized path
+	 * instead of the generic type switch.
+	 */
+	uint8_t param_types[FUNC_PARAM_TYPES_MAX];
 	/** The type of the value returned by function. */
 	enum field_type returns;
 	/** Function aggregate option. */
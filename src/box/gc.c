@@ -64,6 +64,8 @@ static int
 gc_cleanup_fiber_f(va_list);
 static int
 gc_checkpoint_fiber_f(va_list);
+static void
+gc_schedule_cleanup(void);
 
 /**
  * Comparator used for ordering gc_consumer objects
@@ -108,6 +110,7 @@ gc_init(void)
 	gc.min_checkpoint_count = INT_MAX;
 
 	gc.wal_cleanup_delay = TIMEOUT_INFINITY;
+	gc.wal_consumer_timeout = 0;
 	gc.delay_ref = 0;
 	gc.is_paused = true;
 	say_info("wal/engine cleanup is paused");
@@ -217,7 +220,15 @@ gc_run_cleanup(void)
 		run_wal_gc = true;
 	}
 
-	if (!run_engine_gc && !run_wal_gc)
+	/*
+	 * WAL files older than the oldest preserved checkpoint are
+	 * kept only for the sake of lagging consumers and may be
+	 * compacted, see below.
+	 */
+	bool run_wal_compaction =
+		vclock_sum(&min_vclock) < vclock_sum(&checkpoint->vclock);
+
+	if (!run_engine_gc && !run_wal_gc && !run_wal_compaction)
 		return; /* nothing to do */
 
 	/*
@@ -237,6 +248,48 @@ gc_run_cleanup(void)
 		engine_collect_garbage(&checkpoint->vclock);
 	if (run_wal_gc)
 		wal_collect_garbage(&min_vclock);
+	/*
+	 * Ask the WAL thread to rewrite the files held back by
+	 * consumers, dropping replica-local transactions that no
+	 * consumer will ever need. Runs after the deletion above
+	 * so that files about to be removed are not rewritten.
+	 */
+	if (run_wal_compaction)
+		wal_compact_garbage(&checkpoint->vclock);
+}
+
+/**
+ * Deactivate consumers which have not reported any progress for
+ * longer than box.cfg.wal_consumer_timeout, so that a dead
+ * replica can't pin WAL files forever. Schedules a cleanup round
+ * if anybody got expired.
+ */
+static void
+gc_expire_consumers(void)
+{
+	if (gc.wal_consumer_timeout <= 0)
+		return;
+	double now = ev_monotonic_now(loop());
+	bool expired = false;
+	struct gc_consumer *consumer = gc_tree_first(&gc.consumers);
+	while (consumer != NULL) {
+		struct gc_consumer *next = gc_tree_next(&gc.consumers,
+							consumer);
+		double idle = now - consumer->last_advance_time;
+		if (idle >= gc.wal_consumer_timeout) {
+			assert(!consumer->is_inactive);
+			consumer->is_inactive = true;
+			gc_tree_remove(&gc.consumers, consumer);
+			say_crit("deactivated WAL consumer %s at %s: "
+				 "no progress for %.1f seconds",
+				 consumer->name,
+				 vclock_to_string(&consumer->vclock), idle);
+			expired = true;
+		}
+		consumer = next;
+	}
+	if (expired)
+		gc_schedule_cleanup();
 }
 
 static int
@@ -292,10 +345,14 @@ gc_cleanup_fiber_f(va_list ap)
 		int64_t delta = gc.cleanup_scheduled - gc.cleanup_completed;
 		if (delta == 0) {
 			/* No pending garbage collection. */
-			fiber_sleep(TIMEOUT_INFINITY);
+			fiber_sleep(gc.wal_consumer_timeout > 0 ?
+				    gc.wal_consumer_timeout :
+				    TIMEOUT_INFINITY);
+			gc_expire_consumers();
 			continue;
 		}
 		assert(delta > 0);
+		gc_expire_consumers();
 		gc_run_cleanup();
 		gc.cleanup_completed += delta;
 		fiber_cond_signal(&gc.cleanup_cond);
@@ -317,6 +374,20 @@ gc_set_wal_cleanup_delay(double wal_cleanup_delay)
 		fiber_wakeup(gc.cleanup_fiber);
 }
 
+void
+gc_set_wal_consumer_timeout(double wal_consumer_timeout)
+{
+	gc.wal_consumer_timeout = wal_consumer_timeout;
+	/*
+	 * Wake the cleanup fiber so that a shorter timeout takes
+	 * effect right away - but never while it runs a cleanup
+	 * round, which may be blocked on a cbus exchange that
+	 * doesn't tolerate spurious wakeups.
+	 */
+	if (gc.is_paused || gc.cleanup_scheduled == gc.cleanup_completed)
+		fiber_wakeup(gc.cleanup_fiber);
+}
+
 void
 gc_delay_ref(void)
 {
@@ -612,8 +683,17 @@ gc_checkpoint_fiber_f(va_list ap)
 			 */
 			continue;
 		}
+		double checkpoint_start = ev_monotonic_now(loop());
 		if (gc_do_checkpoint(true) != 0)
 			diag_log();
+		/*
+		 * If the checkpoint was slow (e.g. because the
+		 * writer was throttled by snap_io_rate_limit),
+		 * give the disk a breather before the next one.
+		 */
+		checkpoint_schedule_stretch(sched, ev_monotonic_now(loop()),
+					    ev_monotonic_now(loop()) -
+					    checkpoint_start);
 	}
 	return 0;
 }
@@ -653,6 +733,7 @@ gc_consumer_register(const struct vclock *vclock, const char *format, ...)
 	va_end(ap);
 
 	vclock_copy(&consumer->vclock, vclock);
+	consumer->last_advance_time = ev_monotonic_now(loop());
 	gc_tree_insert(&gc.consumers, consumer);
 	return consumer;
 }
@@ -673,6 +754,13 @@ gc_consumer_advance(struct gc_consumer *consumer, const struct vclock *vclock)
 	if (consumer->is_inactive)
 		return;
 
+	/*
+	 * Even a no-op advancement is a life sign: a replica on an
+	 * idle master keeps acking the same vclock, which must not
+	 * look like inactivity.
+	 */
+	consumer->last_advance_time = ev_monotonic_now(loop());
+
 	int64_t signature = vclock_sum(vclock);
 	int64_t prev_signature = vclock_sum(&consumer->vclock);
 
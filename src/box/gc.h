@@ -97,6 +97,13 @@ struct gc_consumer {
 	 * deleted by the WAL thread on ENOSPC.
 	 */
 	bool is_inactive;
+	/**
+	 * Time of the last advancement, in terms of the monotonic
+	 * event loop clock. Used to expire consumers which have
+	 * not reported progress for box.cfg.wal_consumer_timeout
+	 * seconds.
+	 */
+	double last_advance_time;
 };
 
 typedef rb_tree(struct gc_consumer) gc_tree_t;
@@ -161,6 +168,12 @@ struct gc_state {
 	 * Delay timeout in seconds.
 	 */
 	double wal_cleanup_delay;
+	/**
+	 * Inactivity timeout in seconds after which a consumer is
+	 * deactivated so that it no longer pins WAL files. Zero
+	 * means consumers never expire.
+	 */
+	double wal_consumer_timeout;
 	/**
 	 * When set the cleanup fiber is paused.
 	 */
@@ -198,6 +211,20 @@ extern struct gc_state gc;
 #define gc_foreach_checkpoint_ref(ref, checkpoint) \
 	rlist_foreach_entry(ref, &(checkpoint)->refs, in_refs)
 
+/**
+ * Return the first (oldest) checkpoint known to the garbage
+ * collector. If there's no checkpoint, return NULL.
+ */
+static inline struct gc_checkpoint *
+gc_first_checkpoint(void)
+{
+	if (rlist_empty(&gc.checkpoints))
+		return NULL;
+
+	return rlist_first_entry(&gc.checkpoints, struct gc_checkpoint,
+				 in_checkpoints);
+}
+
 /**
  * Return the last (newest) checkpoint known to the garbage
  * collector. If there's no checkpoint, return NULL.
@@ -230,6 +257,12 @@ gc_free(void);
 void
 gc_set_wal_cleanup_delay(double wal_cleanup_delay);
 
+/**
+ * Set a new consumer inactivity timeout. Zero disables expiry.
+ */
+void
+gc_set_wal_consumer_timeout(double wal_consumer_timeout);
+
 /**
  * Increment a reference to delay counter.
  */
@@ -255,6 +255,64 @@ box_index_get(uint32_t space_id, uint32_t index_id, const char *key,
 	return 0;
 }
 
+int
+box_index_multi_get(uint32_t space_id, uint32_t index_id, const char *keys,
+		    const char *keys_end, box_tuple_t **results,
+		    uint32_t *count)
+{
+	assert(keys != NULL && keys_end != NULL && results != NULL);
+	assert(count != NULL);
+	mp_tuple_assert(keys, keys_end);
+	struct space *space;
+	struct index *index;
+	if (check_index(space_id, index_id, &space, &index) != 0)
+		return -1;
+	if (!index->def->opts.is_unique) {
+		diag_set(ClientError, ER_MORE_THAN_ONE_TUPLE);
+		return -1;
+	}
+	uint32_t key_count = mp_decode_array(&keys);
+	/*
+	 * Validate all keys upfront so the batch either starts
+	 * with well-formed input or fails without a partially
+	 * filled result.
+	 */
+	const char *key = keys;
+	for (uint32_t i = 0; i < key_count; i++) {
+		const char *validated = key;
+		uint32_t part_count = mp_decode_array(&validated);
+		if (exact_key_validate(index->def->key_def, validated,
+				       part_count) != 0)
+			return -1;
+		mp_next(&key);
+	}
+	/* Start one transaction in the engine for a whole batch. */
+	struct txn *txn;
+	struct txn_ro_savepoint svp;
+	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
+		return -1;
+	key = keys;
+	for (uint32_t i = 0; i < key_count; i++) {
+		const char *key_data = key;
+		uint32_t part_count = mp_decode_array(&key_data);
+		if (index_get(index, key_data, part_count,
+			      &results[i]) != 0) {
+			txn_rollback_stmt(txn);
+			return -1;
+		}
+		mp_next(&key);
+	}
+	txn_commit_ro_stmt(txn, &svp);
+	/* Count the whole batch in one go. */
+	rmean_collect(rmean_box, IPROTO_SELECT, key_count);
+	for (uint32_t i = 0; i < key_count; i++) {
+		if (results[i] != NULL)
+			tuple_bless(results[i]);
+	}
+	*count = key_count;
+	return 0;
+}
+
 int
 box_index_min(uint32_t space_id, uint32_t index_id, const char *key,
 	      const char *key_end, box_tuple_t **result)
@@ -412,6 +470,51 @@ box_iterator_free(box_iterator_t *it)
 
 /* }}} */
 
+/* {{{ box_index_read_view */
+
+struct box_index_read_view {
+	/** Engine snapshot iterator providing the frozen view. */
+	struct snapshot_iterator *iterator;
+};
+
+box_index_read_view_t *
+box_index_read_view_create(uint32_t space_id, uint32_t index_id)
+{
+	struct space *space;
+	struct index *index;
+	if (check_index(space_id, index_id, &space, &index) != 0)
+		return NULL;
+	struct box_index_read_view *rv =
+		(struct box_index_read_view *)malloc(sizeof(*rv));
+	if (rv == NULL) {
+		diag_set(OutOfMemory, sizeof(*rv), "malloc",
+			 "box_index_read_view");
+		return NULL;
+	}
+	rv->iterator = index_create_snapshot_iterator(index);
+	if (rv->iterator == NULL) {
+		free(rv);
+		return NULL;
+	}
+	return rv;
+}
+
+int
+box_index_read_view_next(box_index_read_view_t *rv, const char **data,
+			 uint32_t *size)
+{
+	return rv->iterator->next(rv->iterator, data, size);
+}
+
+void
+box_index_read_view_free(box_index_read_view_t *rv)
+{
+	rv->iterator->free(rv->iterator);
+	free(rv);
+}
+
+/* }}} */
+
 /* {{{ Other index functions */
 
 int
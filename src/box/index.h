@@ -147,6 +147,32 @@ int
 box_index_get(uint32_t space_id, uint32_t index_id, const char *key,
 	      const char *key_end, box_tuple_t **result);
 
+/**
+ * Get a batch of tuples from index by a batch of keys.
+ *
+ * All lookups are resolved in one pass over the index inside a
+ * single read-only statement, so a batch costs one fiber switch
+ * and one accounting round instead of one per key. Use it when
+ * the application does many point lookups per request.
+ *
+ * \param space_id space identifier
+ * \param index_id index identifier
+ * \param keys encoded keys in MsgPack Array format:
+ *        [[part1, part2, ...], ...]
+ * \param keys_end the end of encoded \a keys
+ * \param[out] results an array of tuples (NULL for misses), must
+ *             have room for as many entries as there are keys
+ * \param[out] count the number of keys resolved
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ * \pre keys != NULL
+ * \sa box_index_get()
+ */
+int
+box_index_multi_get(uint32_t space_id, uint32_t index_id, const char *keys,
+		    const char *keys_end, box_tuple_t **results,
+		    uint32_t *count);
+
 /**
  * Return a first (minimal) tuple matched the provided key.
  *
@@ -210,6 +236,47 @@ char *
 box_tuple_extract_key(box_tuple_t *tuple, uint32_t space_id,
 		      uint32_t index_id, uint32_t *key_size);
 
+/**
+ * A consistent read view of an index, based on the same engine
+ * snapshot machinery checkpointing uses. Unlike MVCC it has no
+ * per-tuple tracking cost: the view is frozen at creation and
+ * the scan returns raw msgpack tuple data. Intended for online
+ * analytical full scans and data export.
+ */
+typedef struct box_index_read_view box_index_read_view_t;
+
+/**
+ * Open a consistent read view of an index.
+ *
+ * \param space_id space identifier
+ * \param index_id index identifier
+ * \retval NULL on error (check box_error_last()), e.g. if the
+ *         engine does not support consistent read views
+ * \retval a read view handle on success, must be closed with
+ *         box_index_read_view_free()
+ */
+box_index_read_view_t *
+box_index_read_view_create(uint32_t space_id, uint32_t index_id);
+
+/**
+ * Get the next tuple from a read view scan.
+ *
+ * \param rv read view handle
+ * \param[out] data raw msgpack tuple data, NULL on EOF
+ * \param[out] size size of \a data
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ */
+int
+box_index_read_view_next(box_index_read_view_t *rv, const char **data,
+			 uint32_t *size);
+
+/**
+ * Close a read view and release the resources pinned by it.
+ */
+void
+box_index_read_view_free(box_index_read_view_t *rv);
+
 /** \endcond public */
 
 /**
@@ -49,6 +49,28 @@ enum index_type {
 
 extern const char *index_type_strs[];
 
+/** Vinyl LSM tree compaction policy. */
+enum vy_compaction_policy {
+	/**
+	 * Classic leveling: runs are organized in levels of
+	 * exponentially growing size and the last level is kept
+	 * as a single run. Low space and read amplification at
+	 * the cost of rewriting the biggest run on every major
+	 * compaction.
+	 */
+	VY_COMPACTION_LEVELED,
+	/**
+	 * Tiered: runs of similar size are merged together, but
+	 * the oldest run is never force-merged just to keep the
+	 * last level single. Much lower write amplification on
+	 * write-mostly spaces, higher space amplification.
+	 */
+	VY_COMPACTION_TIERED,
+	vy_compaction_policy_MAX
+};
+
+extern const char *vy_compaction_policy_strs[];
+
 enum rtree_index_distance_type {
 	 /* Euclid distance, sqrt(dx*dx + dy*dy) */
 	RTREE_INDEX_DISTANCE_TYPE_EUCLID,
@@ -151,6 +173,8 @@ struct index_opts {
 	 * previous one.
 	 */
 	double run_size_ratio;
+	/** Compaction policy of a vinyl LSM tree. */
+	enum vy_compaction_policy compaction_policy;
 	/* Bloom filter false positive rate. */
 	double bloom_fpr;
 	/**
@@ -211,6 +235,8 @@ index_opts_cmp(const struct index_opts *o1, const struct index_opts *o2)
 		       -1 : 1;
 	if (o1->run_size_ratio != o2->run_size_ratio)
 		return o1->run_size_ratio < o2->run_size_ratio ? -1 : 1;
+	if (o1->compaction_policy != o2->compaction_policy)
+		return o1->compaction_policy < o2->compaction_policy ? -1 : 1;
 	if (o1->bloom_fpr != o2->bloom_fpr)
 		return o1->bloom_fpr < o2->bloom_fpr ? -1 : 1;
 	if (o1->func_id != o2->func_id)
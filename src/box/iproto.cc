@@ -40,6 +40,7 @@
 
 #include "version.h"
 #include "fiber.h"
+#include "fiber_cond.h"
 #include "cbus.h"
 #include "say.h"
 #include "sio.h"
@@ -57,9 +58,13 @@
 #include "session.h"
 #include "xrow.h"
 #include "schema.h" /* schema_version */
+#include "txn.h" /* too_long_threshold */
 #include "replication.h" /* instance_uuid */
 #include "iproto_constants.h"
 #include "rmean.h"
+#include "histogram.h"
+#include "flightrec.h"
+#include "latency.h"
 #include "execute.h"
 #include "errinj.h"
 #include "tt_static.h"
@@ -139,10 +144,34 @@ struct iproto_thread {
 	 * List of stopped connections
 	 */
 	RLIST_HEAD(stopped_connections);
+	/**
+	 * All connections of this thread, walked by the periodic
+	 * idle input buffer trimming.
+	 */
+	RLIST_HEAD(connections);
+	/** Periodically trims input buffers of idle connections. */
+	struct ev_timer idle_trim_timer;
+	/**
+	 * Connections that accumulated responses during the
+	 * current event loop iteration. Drained by flush_prepare
+	 * with one output kick per connection, however many
+	 * messages the cbus batch delivered. See net_send_msg().
+	 */
+	RLIST_HEAD(flush_queue);
+	/** Drains flush_queue once per event loop iteration. */
+	struct ev_prepare flush_prepare;
 	/*
 	 * Iproto thread stat
 	 */
 	struct rmean *rmean;
+	/**
+	 * Per request type latency histograms, from the moment a
+	 * request is read off the socket to the moment its
+	 * response is queued for flush. Written only by the net
+	 * thread; tx reads them for box.stat.latency() the same
+	 * unlocked way it reads rmean counters.
+	 */
+	struct latency req_latency[IPROTO_TYPE_STAT_MAX];
 	/*
 	 * Iproto thread id
 	 */
@@ -155,6 +184,11 @@ struct iproto_thread {
 
 static struct iproto_thread *iproto_threads;
 static int iproto_threads_count;
+/**
+ * Scratch latency counter the tx thread merges the per-thread
+ * request histograms into when box.stat.latency() is queried.
+ */
+static struct latency iproto_merged_latency;
 
 /**
  * In Greek mythology, Kharon is the ferryman who carries souls
@@ -198,6 +232,45 @@ unsigned iproto_readahead = 16320;
 /* The maximal number of iproto messages in fly. */
 static int iproto_msg_max = IPROTO_MSG_MAX_MIN;
 
+enum {
+	/**
+	 * The maximal number of unflushed output bytes a single
+	 * connection may accumulate before box.session.push()
+	 * starts blocking the pushing fiber. Pushes are produced
+	 * without any request flow control, so a procedure
+	 * streaming faster than the peer reads would otherwise
+	 * grow the output buffers without bound.
+	 */
+	IPROTO_PUSH_OUTPUT_MAX = 1024 * 1024,
+};
+
+/**
+ * The maximal size in bytes of a single SELECT result,
+ * box.cfg.net_select_result_max. 0 means no limit. Both the
+ * reads and the updates happen in the tx thread, so unlike
+ * net_msg_max the option needs no cbus round trip to apply.
+ */
+static int64_t iproto_select_result_max = 0;
+
+enum {
+	/**
+	 * A single connection may occupy at most
+	 * 1 / IPROTO_CONNECTION_POOL_SHARE of the message pool.
+	 * Without the cap one bulk loader pumping pipelined
+	 * requests fills the whole pool and latency-sensitive
+	 * connections queue behind it until the global
+	 * stop-reading limit kicks in.
+	 */
+	IPROTO_CONNECTION_POOL_SHARE = 4,
+	/**
+	 * Seconds between the passes which release input buffers
+	 * of connections that have gone quiet. With tens of
+	 * thousands of mostly idle connections the buffers pinned
+	 * by a one-off burst dominate net thread memory.
+	 */
+	IPROTO_IBUF_TRIM_INTERVAL = 10,
+};
+
 /**
  * Address the iproto listens for, stored in TX
  * thread. Is kept in TX to be shown in box.info.
@@ -303,6 +376,22 @@ struct iproto_msg
 	 * and the connection must be closed.
 	 */
 	bool close_connection;
+	/**
+	 * Monotonic time the message was allocated at in the net
+	 * thread, i.e. right after the request was read off the
+	 * socket. Used to collect per request type latency when
+	 * the response is queued for flush.
+	 */
+	double receive_time;
+	/**
+	 * Monotonic time the tx thread picked the message up at.
+	 * Together with receive_time it splits a slow request
+	 * into time spent queued for tx (input queue plus cbus
+	 * transit) and time spent processing plus response
+	 * handoff. See the too_long_threshold check in
+	 * net_send_msg().
+	 */
+	double tx_begin_time;
 };
 
 static struct iproto_msg *
@@ -323,6 +412,7 @@ enum rmean_net_name {
 	IPROTO_RECEIVED,
 	IPROTO_CONNECTIONS,
 	IPROTO_REQUESTS,
+	IPROTO_INPUT_STOPS,
 	IPROTO_LAST,
 };
 
@@ -331,6 +421,7 @@ const char *rmean_net_strings[IPROTO_LAST] = {
 	"RECEIVED",
 	"CONNECTIONS",
 	"REQUESTS",
+	"INPUT_STOPS",
 };
 
 static void
@@ -478,6 +569,31 @@ struct iproto_connection
 	 * connections.
 	 */
 	int long_poll_count;
+	/**
+	 * Number of messages of this connection currently in
+	 * flight (enqueued to tx and not yet completed). Used to
+	 * cap the share of the message pool a single connection
+	 * may occupy, see iproto_check_connection_msg_max().
+	 */
+	int n_msgs_in_flight;
+	/**
+	 * Set when the last read filled the input buffer to the
+	 * brim - a hint that the peer streams data faster than
+	 * the buffer grows, see iproto_connection_input_buffer().
+	 */
+	bool input_full_read;
+	/**
+	 * Set on every successful read and cleared by the idle
+	 * buffer trimming timer. An input buffer is released back
+	 * to the slab cache only after a full timer interval
+	 * without any input, so active request/response traffic
+	 * never suffers a realloc.
+	 */
+	bool input_was_active;
+	/** Link in iproto_thread->connections. */
+	struct rlist in_connections;
+	/** Link in iproto_thread->flush_queue, empty if not queued. */
+	struct rlist in_flush_queue;
 	struct ev_io input;
 	struct ev_io output;
 	/** Logical session. */
@@ -543,6 +659,12 @@ struct iproto_connection
 		alignas(CACHELINE_SIZE)
 		/** Pointer to the current output buffer. */
 		struct obuf *p_obuf;
+		/**
+		 * Decaying high-water mark of flushed response
+		 * sizes, in bytes. Used to release obuf slabs
+		 * kept around after an unusually big response.
+		 */
+		size_t obuf_watermark;
 		/** True if Kharon is in use/travelling. */
 		bool is_push_sent;
 		/**
@@ -550,6 +672,19 @@ struct iproto_connection
 		 * return.
 		 */
 		bool is_push_pending;
+		/**
+		 * Set by tx_process_disconnect(): no more flush
+		 * progress will ever be reported, fibers blocked
+		 * on push_cond must bail out.
+		 */
+		bool is_disconnected;
+		/**
+		 * Signaled on every flush progress report from the
+		 * net thread and on disconnect. Fibers producing
+		 * out-of-band pushes wait on it when the connection
+		 * has accumulated too much unflushed output.
+		 */
+		struct fiber_cond push_cond;
 	} tx;
 	/** Authentication salt. */
 	char salt[IPROTO_SALT_SIZE];
@@ -568,10 +703,26 @@ iproto_check_msg_max(struct iproto_thread *iproto_thread)
 	return request_count > (size_t) iproto_msg_max;
 }
 
+/**
+ * Return true if the connection has used up its share of the
+ * message pool and its input must be stopped until some of its
+ * requests complete.
+ */
+static inline bool
+iproto_check_connection_msg_max(struct iproto_connection *con)
+{
+	int limit = iproto_msg_max / IPROTO_CONNECTION_POOL_SHARE;
+	if (limit < IPROTO_MSG_MAX_MIN)
+		limit = IPROTO_MSG_MAX_MIN;
+	return con->n_msgs_in_flight >= limit;
+}
+
 static inline void
 iproto_msg_delete(struct iproto_msg *msg)
 {
 	struct iproto_thread *iproto_thread = msg->connection->iproto_thread;
+	assert(msg->connection->n_msgs_in_flight > 0);
+	msg->connection->n_msgs_in_flight--;
 	mempool_free(&msg->connection->iproto_thread->iproto_msg_pool, msg);
 	iproto_resume(iproto_thread);
 }
@@ -594,6 +745,15 @@ iproto_msg_new(struct iproto_connection *con)
 	}
 	msg->close_connection = false;
 	msg->connection = con;
+	msg->receive_time = ev_monotonic_now(loop());
+	msg->tx_begin_time = msg->receive_time;
+	/*
+	 * The type is set when the header is decoded. Start from
+	 * IPROTO_OK so that a message failing to parse is not
+	 * attributed to a stale request type on latency collect.
+	 */
+	msg->header.type = IPROTO_OK;
+	con->n_msgs_in_flight++;
 	rmean_collect(con->iproto_thread->rmean, IPROTO_REQUESTS, 1);
 	return msg;
 }
@@ -645,6 +805,7 @@ iproto_connection_stop_msg_max_limit(struct iproto_connection *con)
 			     "net_msg_max limit is reached",
 			     sio_socketname(con->input.fd));
 	ev_io_stop(con->loop, &con->input);
+	rmean_collect(con->iproto_thread->rmean, IPROTO_INPUT_STOPS, 1);
 	/*
 	 * Important to add to tail and fetch from head to ensure
 	 * strict lifo order (fairness) for stopped connections.
@@ -653,6 +814,26 @@ iproto_connection_stop_msg_max_limit(struct iproto_connection *con)
 		       &con->in_stop_list);
 }
 
+/**
+ * Stop input when a single connection has used up its share of
+ * the message pool. Unlike the global net_msg_max stop, the
+ * input may be resumed only after some of *this* connection's
+ * requests complete, which is checked in iproto_resume().
+ */
+static inline void
+iproto_connection_stop_pool_share_limit(struct iproto_connection *con)
+{
+	assert(rlist_empty(&con->in_stop_list));
+
+	say_warn_ratelimited("stopping input on connection %s, "
+			     "message pool share is used up",
+			     sio_socketname(con->input.fd));
+	ev_io_stop(con->loop, &con->input);
+	rmean_collect(con->iproto_thread->rmean, IPROTO_INPUT_STOPS, 1);
+	rlist_add_tail(&con->iproto_thread->stopped_connections,
+		       &con->in_stop_list);
+}
+
 /**
  * Send a destroy message to TX thread in case all requests are
  * finished.
@@ -777,7 +958,20 @@ iproto_connection_input_buffer(struct iproto_connection *con)
 	 * (in only has unparsed content).
 	 */
 	if (ibuf_used(old_ibuf) == con->parse_size) {
-		ibuf_reserve_xc(old_ibuf, to_read);
+		size_t to_reserve = to_read;
+		/*
+		 * If the previous read filled the buffer to the brim,
+		 * the peer pumps data faster than the buffer grows.
+		 * Double the capacity instead of adding one request
+		 * worth of space at a time, so a bulk loader pays a
+		 * logarithmic number of reallocs on its way up to
+		 * the readahead limit instead of a linear one.
+		 */
+		if (con->input_full_read &&
+		    to_reserve < ibuf_capacity(old_ibuf) &&
+		    ibuf_capacity(old_ibuf) < iproto_max_input_size() / 2)
+			to_reserve = ibuf_capacity(old_ibuf);
+		ibuf_reserve_xc(old_ibuf, to_reserve);
 		return old_ibuf;
 	}
 
@@ -845,6 +1039,11 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 			cpipe_flush_input(&con->iproto_thread->tx_pipe);
 			return 0;
 		}
+		if (iproto_check_connection_msg_max(con)) {
+			iproto_connection_stop_pool_share_limit(con);
+			cpipe_flush_input(&con->iproto_thread->tx_pipe);
+			return 0;
+		}
 		const char *reqstart = in->wpos - con->parse_size;
 		const char *pos = reqstart;
 		/* Read request length. */
@@ -963,16 +1162,24 @@ iproto_connection_resume(struct iproto_connection *con)
 static void
 iproto_resume(struct iproto_thread *iproto_thread)
 {
-	while (!iproto_check_msg_max(iproto_thread) &&
-	       !rlist_empty(&iproto_thread->stopped_connections)) {
+	/*
+	 * Walk from list head to ensure strict FIFO (fairness)
+	 * for resumed connections. The safe iteration tolerates
+	 * a resumed connection stopping itself again and being
+	 * re-added to the list tail.
+	 */
+	struct iproto_connection *con, *tmp;
+	rlist_foreach_entry_safe(con, &iproto_thread->stopped_connections,
+				 in_stop_list, tmp) {
+		if (iproto_check_msg_max(iproto_thread))
+			break;
 		/*
-		 * Shift from list head to ensure strict FIFO
-		 * (fairness) for resumed connections.
+		 * A connection that has used up its pool share
+		 * can't make progress until its own requests
+		 * complete - skip it, but keep resuming others.
 		 */
-		struct iproto_connection *con =
-			rlist_first_entry(&iproto_thread->stopped_connections,
-					  struct iproto_connection,
-					  in_stop_list);
+		if (iproto_check_connection_msg_max(con))
+			continue;
 		iproto_connection_resume(con);
 	}
 }
@@ -1023,6 +1230,8 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 		/* Update the read position and connection state. */
 		in->wpos += nrd;
 		con->parse_size += nrd;
+		con->input_was_active = true;
+		con->input_full_read = ibuf_unused(in) == 0;
 		/* Enqueue all requests which are fully read up. */
 		if (iproto_enqueue_batch(con, in) != 0)
 			diag_raise();
@@ -1121,6 +1330,35 @@ iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
 	}
 }
 
+/**
+ * Kick the output of every connection that accumulated responses
+ * during this event loop iteration. The watcher runs right
+ * before the loop goes to sleep, when the whole cbus batch has
+ * been processed, so the responses of a pipelined client leave
+ * in a single writev instead of one flush attempt per message.
+ */
+static void
+iproto_flush_queue_cb(ev_loop *loop, struct ev_prepare *watcher,
+		      int /* revents */)
+{
+	struct iproto_thread *iproto_thread =
+		(struct iproto_thread *) watcher->data;
+	while (!rlist_empty(&iproto_thread->flush_queue)) {
+		struct iproto_connection *con =
+			rlist_shift_entry(&iproto_thread->flush_queue,
+					  struct iproto_connection,
+					  in_flush_queue);
+		/*
+		 * An active watcher means the socket is choked and
+		 * poll will resume the output; a missing fd means
+		 * the connection was closed after it was queued.
+		 */
+		if (!evio_has_fd(&con->output) || ev_is_active(&con->output))
+			continue;
+		iproto_connection_on_output(loop, &con->output, EV_WRITE);
+	}
+}
+
 static struct iproto_connection *
 iproto_connection_new(struct iproto_thread *iproto_thread, int fd)
 {
@@ -1143,18 +1381,26 @@ iproto_connection_new(struct iproto_thread *iproto_thread, int fd)
 		    iproto_readahead);
 	con->p_ibuf = &con->ibuf[0];
 	con->tx.p_obuf = &con->obuf[0];
+	con->tx.obuf_watermark = 0;
 	iproto_wpos_create(&con->wpos, con->tx.p_obuf);
 	iproto_wpos_create(&con->wend, con->tx.p_obuf);
 	con->parse_size = 0;
 	con->long_poll_count = 0;
+	con->n_msgs_in_flight = 0;
+	con->input_full_read = false;
+	con->input_was_active = false;
 	con->session = NULL;
 	rlist_create(&con->in_stop_list);
+	rlist_create(&con->in_flush_queue);
+	rlist_add_tail(&iproto_thread->connections, &con->in_connections);
 	/* It may be very awkward to allocate at close. */
 	cmsg_init(&con->destroy_msg, con->iproto_thread->destroy_route);
 	cmsg_init(&con->disconnect_msg, con->iproto_thread->disconnect_route);
 	con->state = IPROTO_CONNECTION_ALIVE;
 	con->tx.is_push_pending = false;
 	con->tx.is_push_sent = false;
+	con->tx.is_disconnected = false;
+	fiber_cond_create(&con->tx.push_cond);
 	rmean_collect(iproto_thread->rmean, IPROTO_CONNECTIONS, 1);
 	return con;
 }
@@ -1168,6 +1414,8 @@ iproto_connection_delete(struct iproto_connection *con)
 	assert(!evio_has_fd(&con->input));
 	assert(con->session == NULL);
 	assert(con->state == IPROTO_CONNECTION_DESTROYED);
+	rlist_del(&con->in_connections);
+	rlist_del(&con->in_flush_queue);
 	/*
 	 * The output buffers must have been deleted
 	 * in tx thread.
@@ -1338,6 +1586,8 @@ tx_process_disconnect(struct cmsg *m)
 			session_run_on_disconnect_triggers(con->session);
 		}
 	}
+	con->tx.is_disconnected = true;
+	fiber_cond_broadcast(&con->tx.push_cond);
 }
 
 static void
@@ -1368,6 +1618,7 @@ tx_process_destroy(struct cmsg *m)
 	 */
 	obuf_destroy(&con->obuf[0]);
 	obuf_destroy(&con->obuf[1]);
+	fiber_cond_destroy(&con->tx.push_cond);
 }
 
 /**
@@ -1435,6 +1686,28 @@ tx_discard_input(struct iproto_msg *msg)
  * @param wpos Last flushed write position, received from iproto
  *        thread.
  */
+/**
+ * An output buffer retains whatever it has ever grown to until
+ * the connection is closed, so a single big response pins that
+ * much memory in each of thousands of idle connections. Once a
+ * flushed buffer is being recycled, compare its allocated
+ * capacity against the decaying high-water mark of this
+ * connection's response sizes and release the slabs of a buffer
+ * which is way above what the connection actually needs.
+ */
+static void
+tx_obuf_shrink(struct iproto_connection *con, struct obuf *buf)
+{
+	size_t capacity = 0;
+	for (int i = 0; i < buf->n_iov; i++)
+		capacity += buf->capacity[i];
+	if (capacity <= (size_t)iproto_readahead ||
+	    capacity / 2 <= con->tx.obuf_watermark)
+		return;
+	obuf_destroy(buf);
+	obuf_create(buf, &con->iproto_thread->net_slabc, iproto_readahead);
+}
+
 static void
 tx_accept_wpos(struct iproto_connection *con, const struct iproto_wpos *wpos)
 {
@@ -1446,8 +1719,15 @@ tx_accept_wpos(struct iproto_connection *con, const struct iproto_wpos *wpos)
 		 * guaranteed to have been flushed first, since
 		 * buffers are never flushed out of order.
 		 */
-		if (obuf_size(prev) != 0)
+		if (obuf_size(prev) != 0) {
+			size_t size = obuf_size(prev);
+			con->tx.obuf_watermark -=
+				con->tx.obuf_watermark / 16;
+			if (size > con->tx.obuf_watermark)
+				con->tx.obuf_watermark = size;
 			obuf_reset(prev);
+			tx_obuf_shrink(con, prev);
+		}
 	}
 	if (obuf_size(con->tx.p_obuf) != 0 && obuf_size(prev) == 0) {
 		/*
@@ -1457,12 +1737,15 @@ tx_accept_wpos(struct iproto_connection *con, const struct iproto_wpos *wpos)
 		 */
 		con->tx.p_obuf = prev;
 	}
+	/* Let fibers blocked on a full output re-check the size. */
+	fiber_cond_broadcast(&con->tx.push_cond);
 }
 
 static inline struct iproto_msg *
 tx_accept_msg(struct cmsg *m)
 {
 	struct iproto_msg *msg = (struct iproto_msg *) m;
+	msg->tx_begin_time = ev_monotonic_now(loop());
 	tx_accept_wpos(msg->connection, &msg->wpos);
 	tx_fiber_init(msg->connection->session, msg->header.sync);
 	return msg;
@@ -1503,6 +1786,8 @@ tx_inject_delay(void)
 		if (rand() % 100 < 10)
 			fiber_sleep(0.001);
 	});
+	/* Chaos testing: stretch request processing, see errinj.h. */
+	DELAY_INJECT(ERRINJ_DELAY_IPROTO_TX);
 }
 
 static void
@@ -1551,6 +1836,23 @@ tx_process_select(struct cmsg *m)
 	if (rc < 0)
 		goto error;
 
+	if (iproto_select_result_max > 0) {
+		/*
+		 * Check the result size before it is copied into the
+		 * connection obuf: a runaway full scan is rejected
+		 * while it only holds tuple references, not after it
+		 * has already inflated the output buffer.
+		 */
+		size_t result_size = port_c_msgpack_size(&port);
+		if (result_size > (size_t)iproto_select_result_max) {
+			port_destroy(&port);
+			diag_set(ClientError, ER_SELECT_RESULT_TOO_BIG,
+				 (unsigned long long)result_size,
+				 (unsigned long long)iproto_select_result_max);
+			goto error;
+		}
+	}
+
 	out = msg->connection->tx.p_obuf;
 	if (iproto_prepare_select(out, &svp) != 0) {
 		port_destroy(&port);
@@ -1863,11 +2165,39 @@ net_send_msg(struct cmsg *m)
 	con->wend = msg->wpos;
 
 	if (evio_has_fd(&con->output)) {
-		if (! ev_is_active(&con->output))
-			ev_feed_event(con->loop, &con->output, EV_WRITE);
+		/*
+		 * Don't kick the write watcher per response: queue
+		 * the connection and let the prepare watcher flush
+		 * everything this cbus batch delivered in one go.
+		 */
+		if (rlist_empty(&con->in_flush_queue))
+			rlist_add_tail(&con->iproto_thread->flush_queue,
+				       &con->in_flush_queue);
 	} else if (iproto_connection_is_idle(con)) {
 		iproto_connection_close(con);
 	}
+	uint32_t type = msg->header.type;
+	if (type > IPROTO_OK && type < IPROTO_TYPE_STAT_MAX) {
+		double total = ev_monotonic_now(loop()) - msg->receive_time;
+		latency_collect(&con->iproto_thread->req_latency[type],
+				total);
+		flightrec_record(FLIGHTREC_REQUEST, type,
+				 iproto_type_is_dml(type) ?
+				 msg->dml.space_id : 0, total * 1e6);
+		if (total > too_long_threshold) {
+			double tx_wait = msg->tx_begin_time -
+					 msg->receive_time;
+			say_warn_ratelimited("too long %s request: %.3f sec "
+					     "(%.3f waiting for tx, %.3f in "
+					     "tx and response handoff), "
+					     "sync %llu, peer %s",
+					     iproto_type_name(type), total,
+					     tx_wait, total - tx_wait,
+					     (unsigned long long)
+					     msg->header.sync,
+					     sio_socketname(con->input.fd));
+		}
+	}
 	iproto_msg_delete(msg);
 }
 
@@ -2025,6 +2355,41 @@ iproto_on_accept(struct evio_service *service, int fd,
 	return 0;
 }
 
+/**
+ * Release the input buffers of connections that have read
+ * nothing for a full timer interval. An ibuf allocates its slab
+ * lazily, so after the trim a quiet connection holds no input
+ * memory at all, and the freed slabs return to the net thread
+ * slab cache where the usual slab statistics account for them.
+ * input_was_active gives every connection a grace interval, so a
+ * steady request/response client is never trimmed and never pays
+ * a realloc.
+ */
+static void
+iproto_trim_idle_inputs_cb(ev_loop *loop, struct ev_timer *watcher,
+			   int /* revents */)
+{
+	(void) loop;
+	struct iproto_thread *iproto_thread =
+		(struct iproto_thread *) watcher->data;
+	struct iproto_connection *con;
+	rlist_foreach_entry(con, &iproto_thread->connections, in_connections) {
+		if (con->input_was_active) {
+			con->input_was_active = false;
+			continue;
+		}
+		if (con->state != IPROTO_CONNECTION_ALIVE)
+			continue;
+		for (int i = 0; i < 2; i++) {
+			struct ibuf *ibuf = &con->ibuf[i];
+			if (ibuf_used(ibuf) != 0 || ibuf_capacity(ibuf) == 0)
+				continue;
+			ibuf_destroy(ibuf);
+			ibuf_create(ibuf, cord_slab_cache(), iproto_readahead);
+		}
+	}
+}
+
 /**
  * The network io thread main function:
  * begin serving the message bus.
@@ -2055,9 +2420,21 @@ net_cord_f(va_list  ap)
 	cpipe_create(&iproto_thread->tx_pipe, "tx");
 	cpipe_set_max_input(&iproto_thread->tx_pipe, iproto_msg_max / 2);
 
+	ev_timer_init(&iproto_thread->idle_trim_timer,
+		      iproto_trim_idle_inputs_cb, IPROTO_IBUF_TRIM_INTERVAL,
+		      IPROTO_IBUF_TRIM_INTERVAL);
+	iproto_thread->idle_trim_timer.data = iproto_thread;
+	ev_timer_start(loop(), &iproto_thread->idle_trim_timer);
+
+	ev_prepare_init(&iproto_thread->flush_prepare, iproto_flush_queue_cb);
+	iproto_thread->flush_prepare.data = iproto_thread;
+	ev_prepare_start(loop(), &iproto_thread->flush_prepare);
+
 	/* Process incomming messages. */
 	cbus_loop(&endpoint);
 
+	ev_prepare_stop(loop(), &iproto_thread->flush_prepare);
+	ev_timer_stop(loop(), &iproto_thread->idle_trim_timer);
 	cpipe_destroy(&iproto_thread->tx_pipe);
 	/*
 	 * Nothing to do in the fiber so far, the service
@@ -2143,6 +2520,24 @@ iproto_session_push(struct session *session, struct port *port)
 {
 	struct iproto_connection *con =
 		(struct iproto_connection *) session->meta.connection;
+	/*
+	 * Block while too much output awaits the flush. Waiting
+	 * makes sense only while Kharon is travelling: its return
+	 * is what reports flush progress and signals the cond. If
+	 * it is home and the limit is still exceeded, let the push
+	 * through - it will send Kharon on a new trip and the next
+	 * push will block.
+	 */
+	while (obuf_size(&con->obuf[0]) + obuf_size(&con->obuf[1]) >
+	       IPROTO_PUSH_OUTPUT_MAX && con->tx.is_push_sent &&
+	       !con->tx.is_disconnected) {
+		if (fiber_cond_wait(&con->tx.push_cond) != 0)
+			return -1;
+	}
+	if (con->tx.is_disconnected) {
+		diag_set(ClientError, ER_SESSION_CLOSED);
+		return -1;
+	}
 	struct obuf_svp svp;
 	if (iproto_prepare_select(con->tx.p_obuf, &svp) != 0)
 		return -1;
@@ -2236,6 +2631,14 @@ static inline int
 iproto_thread_init(struct iproto_thread *iproto_thread)
 {
 	iproto_thread_init_routes(iproto_thread);
+	/*
+	 * The list must be usable before the net cord starts its
+	 * idle trim timer.
+	 */
+	iproto_thread->connections =
+		RLIST_HEAD_INITIALIZER(iproto_thread->connections);
+	iproto_thread->flush_queue =
+		RLIST_HEAD_INITIALIZER(iproto_thread->flush_queue);
 	slab_cache_create(&iproto_thread->net_slabc, &runtime);
 	/* Init statistics counter */
 	iproto_thread->rmean = rmean_new(rmean_net_strings, IPROTO_LAST);
@@ -2245,6 +2648,17 @@ iproto_thread_init(struct iproto_thread *iproto_thread)
 			  "rmean_new", "struct rmean");
 		return -1;
 	}
+	for (int i = 0; i < IPROTO_TYPE_STAT_MAX; i++) {
+		if (latency_create(&iproto_thread->req_latency[i]) != 0) {
+			for (int j = 0; j < i; j++)
+				latency_destroy(&iproto_thread->req_latency[j]);
+			rmean_delete(iproto_thread->rmean);
+			slab_cache_destroy(&iproto_thread->net_slabc);
+			diag_set(OutOfMemory, sizeof(struct histogram),
+				 "latency_create", "latency histogram");
+			return -1;
+		}
+	}
 
 	return 0;
 }
@@ -2261,6 +2675,11 @@ iproto_init(int threads_count)
 	};
 
 
+	if (latency_create(&iproto_merged_latency) != 0) {
+		tnt_raise(OutOfMemory, sizeof(struct histogram),
+			  "latency_create", "latency histogram");
+	}
+
 	iproto_threads = (struct iproto_thread *)
 		calloc(threads_count, sizeof(struct iproto_thread));
 	if (iproto_threads == NULL) {
@@ -2278,6 +2697,8 @@ iproto_init(int threads_count)
 		if (cord_costart(&iproto_thread->net_cord, "iproto",
 				 net_cord_f, iproto_thread)) {
 			rmean_delete(iproto_thread->rmean);
+			for (int j = 0; j < IPROTO_TYPE_STAT_MAX; j++)
+				latency_destroy(&iproto_thread->req_latency[j]);
 			slab_cache_destroy(&iproto_thread->net_slabc);
 			goto fail;
 		}
@@ -2443,13 +2864,20 @@ iproto_send_stop_msg(void)
 }
 
 static inline void
-iproto_send_listen_msg(struct evio_service *binary)
+iproto_send_listen_msg_one(struct iproto_thread *iproto_thread,
+			   struct evio_service *binary)
 {
 	struct iproto_cfg_msg cfg_msg;
 	iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_LISTEN);
 	cfg_msg.binary = binary;
+	iproto_do_cfg(iproto_thread, &cfg_msg);
+}
+
+static inline void
+iproto_send_listen_msg(struct evio_service *binary)
+{
 	for (int i = 0; i < iproto_threads_count; i++)
-		iproto_do_cfg(&iproto_threads[i], &cfg_msg);
+		iproto_send_listen_msg_one(&iproto_threads[i], binary);
 }
 
 void
@@ -2461,14 +2889,39 @@ iproto_listen(const char *uri)
 	iproto_send_stop_msg();
 	if (uri != NULL) {
 		/*
-		 * Please note, we bind socket in main thread, and then
-		 * listen this socket in all iproto threads! With this
-		 * implementation, we rely on the Linux kernel to distribute
-		 * incoming connections across iproto threads.
+		 * With several iproto threads, bind a separate
+		 * SO_REUSEPORT socket for each of them, so that the
+		 * kernel shards incoming connections between the
+		 * threads by flow hash instead of having all threads
+		 * compete on a single accept queue.
 		 */
+#ifdef SO_REUSEPORT
+		binary.reuseport = iproto_threads_count > 1;
+#endif
 		if (evio_service_bind(&binary, uri) != 0)
 			diag_raise();
-		iproto_send_listen_msg(&binary);
+		if (binary.reuseport && binary.addr.sa_family != AF_UNIX) {
+			iproto_send_listen_msg_one(&iproto_threads[0],
+						   &binary);
+			for (int i = 1; i < iproto_threads_count; i++) {
+				struct evio_service service;
+				memset(&service, 0, sizeof(service));
+				if (evio_service_bind_dup(&service,
+							  &binary) != 0)
+					diag_raise();
+				iproto_send_listen_msg_one(&iproto_threads[i],
+							   &service);
+			}
+		} else {
+			/*
+			 * Unix sockets don't support SO_REUSEPORT:
+			 * bind the socket in the main thread and
+			 * listen on it in all iproto threads,
+			 * relying on the kernel to wake one of them
+			 * up per connection.
+			 */
+			iproto_send_listen_msg(&binary);
+		}
 	}
 
 	iproto_bound_address_storage = binary.addrstorage;
@@ -2541,8 +2994,11 @@ iproto_request_count(void)
 void
 iproto_reset_stat(void)
 {
-	for (int i = 0; i < iproto_threads_count; i++)
+	for (int i = 0; i < iproto_threads_count; i++) {
 		rmean_cleanup(iproto_threads[i].rmean);
+		for (int j = 0; j < IPROTO_TYPE_STAT_MAX; j++)
+			latency_reset(&iproto_threads[i].req_latency[j]);
+	}
 }
 
 void
@@ -2563,6 +3019,16 @@ iproto_set_msg_max(int new_iproto_msg_max)
 	}
 }
 
+void
+iproto_set_select_result_max(int64_t new_select_result_max)
+{
+	if (new_select_result_max < 0) {
+		tnt_raise(ClientError, ER_CFG, "net_select_result_max",
+			  "the value must not be negative");
+	}
+	iproto_select_result_max = new_select_result_max;
+}
+
 void
 iproto_free(void)
 {
@@ -2578,9 +3044,12 @@ iproto_free(void)
 			close(iproto_threads[i].binary.ev.fd);
 
 		rmean_delete(iproto_threads[i].rmean);
+		for (int j = 0; j < IPROTO_TYPE_STAT_MAX; j++)
+			latency_destroy(&iproto_threads[i].req_latency[j]);
 		slab_cache_destroy(&iproto_threads[i].net_slabc);
 	}
 	free(iproto_threads);
+	latency_destroy(&iproto_merged_latency);
 }
 
 int
@@ -2604,3 +3073,32 @@ iproto_rmean_foreach(void *cb, void *cb_ctx)
 	}
 	return 0;
 }
+
+int
+iproto_latency_foreach(iproto_latency_cb cb, void *cb_ctx)
+{
+	for (uint32_t type = IPROTO_SELECT; type < IPROTO_TYPE_STAT_MAX;
+	     type++) {
+		/* Sic: NOP is NULL to suppress box.stat() output. */
+		const char *name = iproto_type_strs[type];
+		if (name == NULL)
+			continue;
+		/*
+		 * The per-thread histograms share one bucket
+		 * layout, so aggregation is a sum of bucket
+		 * counters. Like iproto_rmean_foreach(), reads
+		 * the net thread counters without locks.
+		 */
+		struct latency *merged = &iproto_merged_latency;
+		latency_reset(merged);
+		for (int j = 0; j < iproto_threads_count; j++)
+			latency_merge(merged,
+				      &iproto_threads[j].req_latency[type]);
+		int rc = cb(name, latency_get(merged, 50),
+			    latency_get(merged, 90),
+			    latency_get(merged, 99), cb_ctx);
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
+}
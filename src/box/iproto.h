@@ -32,6 +32,7 @@
  */
 
 #include <stddef.h>
+#include <stdint.h>
 
 #if defined(__cplusplus)
 extern "C" {
@@ -90,6 +91,22 @@ iproto_bound_address(char *buf);
 int
 iproto_rmean_foreach(void *cb, void *cb_ctx);
 
+/**
+ * Callback for iproto_latency_foreach(). Receives the request
+ * type name and the 50th, 90th and 99th percentiles of its
+ * server-side latency in seconds.
+ */
+typedef int (*iproto_latency_cb)(const char *name, double p50, double p90,
+				 double p99, void *cb_ctx);
+
+/**
+ * Invoke @a cb for every request type with latency percentiles
+ * aggregated over all iproto threads. Stops and returns the
+ * callback result as soon as it is not 0.
+ */
+int
+iproto_latency_foreach(iproto_latency_cb cb, void *cb_ctx);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 
@@ -102,6 +119,9 @@ iproto_listen(const char *uri);
 void
 iproto_set_msg_max(int iproto_msg_max);
 
+void
+iproto_set_select_result_max(int64_t select_result_max);
+
 void
 iproto_free(void);
 
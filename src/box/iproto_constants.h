@@ -138,6 +138,12 @@ enum iproto_key {
 	 * both iproto (e.g. REPLICA_ID) and raft (RAFT_TERM) keys.
 	 */
 	IPROTO_TERM = 0x53,
+	/**
+	 * An array of space ids the replica subscribes to. When
+	 * present in a SUBSCRIBE request, rows of all other
+	 * non-system spaces are relayed as NOPs.
+	 */
+	IPROTO_SPACE_FILTER = 0x54,
 	/*
 	 * Be careful to not extend iproto_key values over 0x7f.
 	 * iproto_keys are encoded in msgpack as positive fixnum, which ends at
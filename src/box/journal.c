@@ -37,6 +37,7 @@ struct journal *current_journal = NULL;
 struct journal_queue journal_queue = {
 	.max_size = 16 * 1024 * 1024, /* 16 megabytes */
 	.size = 0,
+	.len = 0,
 	.waiters = RLIST_HEAD_INITIALIZER(journal_queue.waiters),
 	.waiter_count = 0,
 };
@@ -124,6 +124,8 @@ struct journal_queue {
 	int64_t max_size;
 	/** Current approximate size of journal queue. */
 	int64_t size;
+	/** Number of entries submitted and not yet completed. */
+	int64_t len;
 	/**
 	 * The fibers waiting for some space to free in journal queue.
 	 * Once some space is freed they will be waken up in the same order they
@@ -198,6 +200,7 @@ static inline void
 journal_queue_on_append(const struct journal_entry *entry)
 {
 	journal_queue.size += entry->approx_len;
+	journal_queue.len++;
 }
 
 /** Decrease queue size once write request is complete. */
@@ -205,7 +208,9 @@ static inline void
 journal_queue_on_complete(const struct journal_entry *entry)
 {
 	journal_queue.size -= entry->approx_len;
+	journal_queue.len--;
 	assert(journal_queue.size >= 0);
+	assert(journal_queue.len >= 0);
 }
 
 /**
@@ -263,6 +263,18 @@ struct key_def {
 	 * undefined otherwise.
 	*/
 	uint32_t multikey_fieldno;
+	/**
+	 * Epoch of the tuple format the multikey offset slot
+	 * cached below is valid for, see tuple_format::epoch.
+	 */
+	uint64_t multikey_format_epoch;
+	/**
+	 * Cached offset slot of the multikey root array field,
+	 * resolved against the format with the epoch above, so
+	 * counting keys in a tuple does not redo the JSON path
+	 * lookup. @sa key_part::offset_slot_cache.
+	 */
+	int32_t multikey_offset_slot_cache;
 	/** The size of the 'parts' array. */
 	uint32_t part_count;
 	/** Description of parts of a multipart index. */
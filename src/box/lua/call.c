@@ -316,8 +316,111 @@ struct execute_lua_ctx {
 	const char *name;
 	uint32_t name_len;
 	struct port *args;
+	/**
+	 * Definition of the called function when it is registered
+	 * in _func, NULL for eval and unregistered names. Used for
+	 * the declared parameter types.
+	 */
+	struct func_def *def;
 };
 
+/**
+ * Push arguments of a call from a msgpack port onto the Lua stack
+ * following the parameter types declared in the _func param_list,
+ * skipping the generic per-value type dispatch. Returns the
+ * number of pushed values, or -1 with diag set when a value
+ * contradicts its declaration.
+ */
+static int
+lua_push_args_typed(struct lua_State *L, struct port_msgpack *port,
+		    const struct func_def *def)
+{
+	const char *data = port->data;
+	uint32_t argc = mp_decode_array(&data);
+	for (uint32_t i = 0; i < argc; i++) {
+		enum field_type type = FIELD_TYPE_ANY;
+		if (i < (uint32_t)def->param_count &&
+		    i < FUNC_PARAM_TYPES_MAX)
+			type = def->param_types[i];
+		enum mp_type mtype = mp_typeof(*data);
+		switch (type) {
+		case FIELD_TYPE_UNSIGNED:
+			if (mtype != MP_UINT)
+				goto mismatch;
+			luaL_pushuint64(L, mp_decode_uint(&data));
+			break;
+		case FIELD_TYPE_STRING: {
+			if (mtype != MP_STR)
+				goto mismatch;
+			uint32_t len;
+			const char *str = mp_decode_str(&data, &len);
+			lua_pushlstring(L, str, len);
+			break;
+		}
+		case FIELD_TYPE_BOOLEAN:
+			if (mtype != MP_BOOL)
+				goto mismatch;
+			lua_pushboolean(L, mp_decode_bool(&data));
+			break;
+		case FIELD_TYPE_INTEGER:
+			if (mtype == MP_UINT)
+				luaL_pushuint64(L, mp_decode_uint(&data));
+			else if (mtype == MP_INT)
+				luaL_pushint64(L, mp_decode_int(&data));
+			else
+				goto mismatch;
+			break;
+		case FIELD_TYPE_NUMBER:
+		case FIELD_TYPE_DOUBLE:
+			if (mtype == MP_DOUBLE)
+				lua_pushnumber(L, mp_decode_double(&data));
+			else if (mtype == MP_FLOAT)
+				lua_pushnumber(L, mp_decode_float(&data));
+			else if (mtype == MP_UINT)
+				luaL_pushuint64(L, mp_decode_uint(&data));
+			else if (mtype == MP_INT)
+				luaL_pushint64(L, mp_decode_int(&data));
+			else
+				goto mismatch;
+			break;
+		default:
+			luamp_decode(L, luaL_msgpack_default, &data);
+			break;
+		}
+		continue;
+mismatch:
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 tt_sprintf("argument %u must be %s",
+				    (unsigned)i + 1,
+				    field_type_strs[type]));
+		return -1;
+	}
+	return argc;
+}
+
+/**
+ * Push call arguments, taking the typed fast path when the
+ * function declared its parameter types and the arguments arrived
+ * as raw msgpack (the iproto CALL case). Returns the number of
+ * pushed values; raises on declaration mismatch.
+ */
+static int
+lua_push_call_args(struct lua_State *L, struct execute_lua_ctx *ctx)
+{
+	struct port_msgpack *mp_port = (struct port_msgpack *)ctx->args;
+	if (ctx->def != NULL && ctx->def->param_count > 0 &&
+	    ctx->args->vtab == &port_msgpack_vtab &&
+	    mp_typeof(*mp_port->data) == MP_ARRAY) {
+		int arg_count = lua_push_args_typed(L, mp_port, ctx->def);
+		if (arg_count < 0)
+			luaT_error(L);
+		return arg_count;
+	}
+	int top = lua_gettop(L);
+	port_dump_lua(ctx->args, L, true);
+	return lua_gettop(L) - top;
+}
+
 /**
  * Find a lua function by name and execute it. Used for body-less
  * UDFs, which may not yet be defined when a function definition
@@ -340,9 +443,7 @@ execute_lua_call(lua_State *L)
 		return luaT_error(L);
 
 	/* Push the rest of args (a tuple). */
-	int top = lua_gettop(L);
-	port_dump_lua(ctx->args, L, true);
-	int arg_count = lua_gettop(L) - top;
+	int arg_count = lua_push_call_args(L, ctx);
 
 	lua_call(L, arg_count + oc - 1, LUA_MULTRET);
 	return lua_gettop(L);
@@ -362,9 +463,7 @@ execute_lua_call_by_ref(lua_State *L)
 	lua_rawgeti(L, LUA_REGISTRYINDEX, ctx->lua_ref);
 
 	/* Push the rest of args (a tuple). */
-	int top = lua_gettop(L);
-	port_dump_lua(ctx->args, L, true);
-	int arg_count = lua_gettop(L) - top;
+	int arg_count = lua_push_call_args(L, ctx);
 
 	lua_call(L, arg_count, LUA_MULTRET);
 	return lua_gettop(L);
@@ -593,13 +692,14 @@ box_process_lua(enum handlers handler, struct execute_lua_ctx *ctx,
 }
 
 int
-box_lua_call(const char *name, uint32_t name_len,
+box_lua_call(const char *name, uint32_t name_len, struct func_def *def,
 	     struct port *args, struct port *ret)
 {
 	struct execute_lua_ctx ctx;
 	ctx.name = name;
 	ctx.name_len = name_len;
 	ctx.args = args;
+	ctx.def = def;
 	return box_process_lua(HANDLER_CALL, &ctx, ret);
 }
 
@@ -611,6 +711,7 @@ box_lua_eval(const char *expr, uint32_t expr_len,
 	ctx.name = expr;
 	ctx.name_len = expr_len;
 	ctx.args = args;
+	ctx.def = NULL;
 	return box_process_lua(HANDLER_EVAL, &ctx, ret);
 }
 
@@ -792,7 +893,8 @@ func_lua_call(struct func *func, struct port *args, struct port *ret)
 {
 	assert(func != NULL && func->def->language == FUNC_LANGUAGE_LUA);
 	assert(func->vtab == &func_lua_vtab);
-	return box_lua_call(func->def->name, func->def->name_len, args, ret);
+	return box_lua_call(func->def->name, func->def->name_len, func->def,
+			    args, ret);
 }
 
 static struct func_vtab func_lua_vtab = {
@@ -827,6 +929,7 @@ func_persistent_lua_call(struct func *base, struct port *args, struct port *ret)
 	struct execute_lua_ctx ctx;
 	ctx.lua_ref = func->lua_ref;
 	ctx.args = args;
+	ctx.def = base->def;
 	return box_process_lua(HANDLER_CALL_BY_REF, &ctx, ret);
 
 }
@@ -48,10 +48,13 @@ struct func_def;
 
 /**
  * Invoke a Lua stored procedure from the binary protocol
- * (implementation of 'CALL' command code).
+ * (implementation of 'CALL' command code). @a def is the function
+ * definition when the function is registered in _func, or NULL;
+ * declared parameter types, when present, specialize argument
+ * decoding.
  */
 int
-box_lua_call(const char *name, uint32_t name_len,
+box_lua_call(const char *name, uint32_t name_len, struct func_def *def,
 	     struct port *args, struct port *ret);
 
 int
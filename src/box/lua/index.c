@@ -28,6 +28,8 @@
  * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
  * SUCH DAMAGE.
  */
+#include <string.h>
+
 #include "box/lua/index.h"
 #include "lua/utils.h"
 #include "lua/info.h"
@@ -135,6 +137,86 @@ lbox_index_delete(lua_State *L)
 	return luaT_pushtupleornil(L, result);
 }
 
+/**
+ * Execute a batch of operations against the primary index in a
+ * single Lua/C call: internal.batch(space_id, {{op, ...}, ...}).
+ * Each entry is {op, tuple} for insert/replace/upsert-like ops,
+ * {op, key} for get/delete and {op, key, ops} for update. The
+ * operations run in order and stop at the first failure. Returns
+ * a table with one slot per operation, holding the result tuple
+ * or nothing when the operation produced none.
+ */
+static int
+lbox_batch(lua_State *L)
+{
+	if (lua_gettop(L) != 2 || !lua_isnumber(L, 1) ||
+	    lua_type(L, 2) != LUA_TTABLE)
+		return luaL_error(L, "Usage space:batch({{op, ...}, ...})");
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	int count = lua_objlen(L, 2);
+	lua_createtable(L, count, 0);
+	const int res_idx = 3;
+	for (int i = 1; i <= count; i++) {
+		lua_rawgeti(L, 2, i);
+		int op_idx = lua_gettop(L);
+		if (lua_type(L, op_idx) != LUA_TTABLE)
+			return luaL_error(L, "batch: operation #%d is not "
+					  "a table", i);
+		lua_rawgeti(L, op_idx, 1);
+		const char *op = lua_tostring(L, -1);
+		if (op == NULL)
+			return luaL_error(L, "batch: operation #%d has no "
+					  "name", i);
+		lua_rawgeti(L, op_idx, 2);
+		size_t arg_len;
+		const char *arg = lbox_encode_tuple_on_gc(L, lua_gettop(L),
+							  &arg_len);
+		struct tuple *result = NULL;
+		int rc;
+		if (strcmp(op, "insert") == 0) {
+			rc = box_insert(space_id, arg, arg + arg_len,
+					&result);
+		} else if (strcmp(op, "replace") == 0) {
+			rc = box_replace(space_id, arg, arg + arg_len,
+					 &result);
+		} else if (strcmp(op, "get") == 0) {
+			rc = box_index_get(space_id, 0, arg, arg + arg_len,
+					   &result);
+		} else if (strcmp(op, "delete") == 0) {
+			rc = box_delete(space_id, 0, arg, arg + arg_len,
+					&result);
+		} else if (strcmp(op, "update") == 0 ||
+			   strcmp(op, "upsert") == 0) {
+			lua_rawgeti(L, op_idx, 3);
+			size_t ops_len;
+			const char *ops =
+				lbox_encode_tuple_on_gc(L, lua_gettop(L),
+							&ops_len);
+			if (op[2] == 'd') {
+				rc = box_update(space_id, 0, arg,
+						arg + arg_len, ops,
+						ops + ops_len, 1, &result);
+			} else {
+				rc = box_upsert(space_id, 0, arg,
+						arg + arg_len, ops,
+						ops + ops_len, 1, &result);
+			}
+		} else {
+			return luaL_error(L, "batch: unknown operation "
+					  "'%s'", op);
+		}
+		if (rc != 0)
+			return luaT_error(L);
+		lua_settop(L, op_idx - 1);
+		if (result != NULL) {
+			luaT_pushtuple(L, result);
+			lua_rawseti(L, res_idx, i);
+		}
+	}
+	return 1;
+}
+
 static int
 lbox_index_random(lua_State *L)
 {
@@ -284,6 +366,40 @@ lbox_iterator_next(lua_State *L)
 	return luaT_pushtupleornil(L, tuple);
 }
 
+/**
+ * Fetch up to @a count tuples from an iterator in one call:
+ * internal.iterator_next_chunk(state, count). Returns a table of
+ * tuples; getting back fewer than asked - an empty table included
+ * - means the iterator is exhausted.
+ */
+static int
+lbox_iterator_next_chunk(lua_State *L)
+{
+	if (lua_gettop(L) != 2 || lua_type(L, 1) != LUA_TCDATA ||
+	    !lua_isnumber(L, 2))
+		return luaL_error(L, "usage: next_chunk(state, count)");
+
+	assert(CTID_STRUCT_ITERATOR_REF != 0);
+	uint32_t ctypeid;
+	void *data = luaL_checkcdata(L, 1, &ctypeid);
+	if (ctypeid != (uint32_t) CTID_STRUCT_ITERATOR_REF)
+		return luaL_error(L, "usage: next_chunk(state, count)");
+
+	struct iterator *itr = *(struct iterator **) data;
+	int count = lua_tonumber(L, 2);
+	lua_createtable(L, count, 0);
+	for (int i = 1; i <= count; i++) {
+		struct tuple *tuple;
+		if (box_iterator_next(itr, &tuple) != 0)
+			return luaT_error(L);
+		if (tuple == NULL)
+			break;
+		luaT_pushtuple(L, tuple);
+		lua_rawseti(L, -2, i);
+	}
+	return 1;
+}
+
 /** Truncate a given space */
 static int
 lbox_truncate(struct lua_State *L)
@@ -355,6 +471,7 @@ box_lua_index_init(struct lua_State *L)
 		{"update", lbox_index_update},
 		{"upsert",  lbox_upsert},
 		{"delete",  lbox_index_delete},
+		{"batch", lbox_batch},
 		{"random", lbox_index_random},
 		{"get",  lbox_index_get},
 		{"min", lbox_index_min},
@@ -362,6 +479,7 @@ box_lua_index_init(struct lua_State *L)
 		{"count", lbox_index_count},
 		{"iterator", lbox_index_iterator},
 		{"iterator_next", lbox_iterator_next},
+		{"iterator_next_chunk", lbox_iterator_next_chunk},
 		{"truncate", lbox_truncate},
 		{"stat", lbox_index_stat},
 		{"compact", lbox_index_compact},
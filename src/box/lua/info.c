@@ -39,6 +39,7 @@
 #include "box/applier.h"
 #include "box/relay.h"
 #include "box/iproto.h"
+#include "box/journal.h"
 #include "box/wal.h"
 #include "box/replication.h"
 #include "info/info.h"
@@ -619,6 +620,28 @@ lbox_info_synchro(struct lua_State *L)
 	return 1;
 }
 
+static int
+lbox_info_wal(struct lua_State *L)
+{
+	lua_createtable(L, 0, 1);
+
+	/*
+	 * Requests submitted to the journal and not yet completed.
+	 * A growing queue is the earliest sign of a write overload,
+	 * cheap enough to sample from a monitoring fiber - e.g. to
+	 * disseminate cluster health via a SWIM payload.
+	 */
+	lua_createtable(L, 0, 3);
+	luaL_pushint64(L, journal_queue.size);
+	lua_setfield(L, -2, "size");
+	luaL_pushint64(L, journal_queue.max_size);
+	lua_setfield(L, -2, "max_size");
+	lua_pushinteger(L, journal_queue.waiter_count);
+	lua_setfield(L, -2, "waiters");
+	lua_setfield(L, -2, "queue");
+
+	return 1;
+}
 
 static const struct luaL_Reg lbox_info_dynamic_meta[] = {
 	{"id", lbox_info_id},
@@ -640,6 +663,7 @@ static const struct luaL_Reg lbox_info_dynamic_meta[] = {
 	{"listen", lbox_info_listen},
 	{"election", lbox_info_election},
 	{"synchro", lbox_info_synchro},
+	{"wal", lbox_info_wal},
 	{NULL, NULL}
 };
 
@@ -95,6 +95,8 @@ ffi.cdef[[
         struct port_c_entry *last;
         struct port_c_entry first_entry;
         int size;
+        struct port_c_entry_block *blocks;
+        int block_used;
     };
 
     void
@@ -420,6 +422,9 @@ box.schema.space.create = function(name, options)
         is_local = 'boolean',
         temporary = 'boolean',
         is_sync = 'boolean',
+        nolog = 'boolean',
+        conflict_resolution = 'string',
+        conflict_field = 'number',
     }
     local options_defaults = {
         engine = 'memtx',
@@ -464,7 +469,10 @@ box.schema.space.create = function(name, options)
     local space_options = setmap({
         group_id = options.is_local and 1 or nil,
         temporary = options.temporary and true or nil,
-        is_sync = options.is_sync
+        is_sync = options.is_sync,
+        nolog = options.nolog,
+        conflict_resolution = options.conflict_resolution,
+        conflict_field = options.conflict_field,
     })
     _space:insert{id, uid, name, options.engine, options.field_count,
         space_options, format}
@@ -557,6 +565,9 @@ local alter_space_template = {
     format = 'table',
     temporary = 'boolean',
     is_sync = 'boolean',
+    nolog = 'boolean',
+    conflict_resolution = 'string',
+    conflict_field = 'number',
     name = 'string',
 }
 
@@ -593,6 +604,18 @@ box.schema.space.alter = function(space_id, options)
         flags.is_sync = options.is_sync
     end
 
+    if options.nolog ~= nil then
+        flags.nolog = options.nolog
+    end
+
+    if options.conflict_resolution ~= nil then
+        flags.conflict_resolution = options.conflict_resolution
+    end
+
+    if options.conflict_field ~= nil then
+        flags.conflict_field = options.conflict_field
+    end
+
     local format
     if options.format ~= nil then
         format = update_format(options.format)
@@ -1062,6 +1085,7 @@ local index_options = {
     range_size = 'number',
     page_size = 'number',
     bloom_fpr = 'number',
+    compaction_policy = 'string',
     func = 'number, string',
     hint = 'boolean',
 }
@@ -1209,6 +1233,7 @@ box.schema.index.create = function(space_id, name, options)
             run_count_per_level = options.run_count_per_level,
             run_size_ratio = options.run_size_ratio,
             bloom_fpr = options.bloom_fpr,
+            compaction_policy = options.compaction_policy,
             func = options.func,
             hint = options.hint,
     }
@@ -1884,6 +1909,44 @@ base_index_mt.pairs_luac = function(index, key, opts)
     return fun.wrap(iterator_gen_luac, keybuf,
         ffi.gc(cdata, builtin.box_iterator_free))
 end
+-- Like :pairs(), but the Lua/C boundary is crossed once per
+-- chunk_size tuples instead of once per tuple: C materializes a
+-- chunk into one table and the for-loop consumes it locally.
+-- Yields (n, tuple) with n counting from 1 across chunks.
+base_index_mt.pairs_chunked = function(index, key, opts, chunk_size)
+    check_index_arg(index, 'pairs_chunked')
+    chunk_size = chunk_size or 1000
+    if type(chunk_size) ~= 'number' or chunk_size < 1 then
+        box.error(box.error.PROC_LUA,
+                  "Usage index:pairs_chunked(key, opts, chunk_size)")
+    end
+    key = keify(key)
+    local itype = check_iterator_type(opts, #key == 0)
+    local keymp = msgpack.encode(key)
+    local cdata = internal.iterator(index.space_id, index.id, itype, keymp)
+    ffi.gc(cdata, builtin.box_iterator_free)
+    -- Kept in one table so the closure holds both the iterator
+    -- and the key buffer it may point into alive.
+    local state = { it = cdata, key = keymp }
+    local chunk = internal.iterator_next_chunk(state.it, chunk_size)
+    local pos = 0
+    local total = 0
+    return function()
+        if pos >= #chunk then
+            if #chunk < chunk_size then
+                return nil
+            end
+            chunk = internal.iterator_next_chunk(state.it, chunk_size)
+            pos = 0
+            if #chunk == 0 then
+                return nil
+            end
+        end
+        pos = pos + 1
+        total = total + 1
+        return total, chunk[pos]
+    end
+end
 
 -- index subtree size
 base_index_mt.count_ffi = function(index, key, opts)
@@ -2091,6 +2154,17 @@ space_mt.delete = function(space, key)
     check_space_arg(space, 'delete')
     return check_primary_index(space):delete(key)
 end
+-- Run a list of operations against the primary index in a single
+-- C call, e.g. space:batch{{'replace', {1, 'a'}}, {'get', {2}}}.
+-- Returns a table with one result slot per operation.
+space_mt.batch = function(space, ops)
+    check_space_arg(space, 'batch')
+    if type(ops) ~= 'table' then
+        box.error(box.error.PROC_LUA,
+                  "Usage space:batch({{op, ...}, ...})")
+    end
+    return internal.batch(space.id, ops)
+end
 -- Assumes that spaceno has a TREE (NUM) primary key
 -- inserts a tuple after getting the next value of the
 -- primary key and returns it back to the user
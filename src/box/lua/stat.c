@@ -33,6 +33,11 @@
 
 #include <string.h>
 #include <rmean.h>
+#include <sampler.h>
+#include <alloc_profile.h>
+#include <backtrace.h>
+#include <flightrec.h>
+#include <hw_counters.h>
 
 #include <lua.h>
 #include <lauxlib.h>
@@ -40,6 +45,7 @@
 
 #include "box/box.h"
 #include "box/iproto.h"
+#include "box/wal.h"
 #include "box/engine.h"
 #include "box/vinyl.h"
 #include "box/sql.h"
@@ -200,6 +206,293 @@ lbox_stat_net_call(struct lua_State *L)
 	return 1;
 }
 
+/**
+ * Add {name = {p50 = ..., p90 = ..., p99 = ...}} to the table on
+ * top of the Lua stack. Latencies are in seconds.
+ */
+static int
+set_latency_item(const char *name, double p50, double p90, double p99,
+		 void *cb_ctx)
+{
+	struct lua_State *L = (struct lua_State *) cb_ctx;
+
+	lua_pushstring(L, name);
+	lua_newtable(L);
+	lua_pushstring(L, "p50");
+	lua_pushnumber(L, p50);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "p90");
+	lua_pushnumber(L, p90);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "p99");
+	lua_pushnumber(L, p99);
+	lua_rawset(L, -3);
+	lua_rawset(L, -3);
+
+	return 0;
+}
+
+/**
+ * Push a table of per request type latency percentiles, from
+ * iproto receive to response flush, to a Lua stack.
+ */
+static int
+lbox_stat_latency(struct lua_State *L)
+{
+	lua_newtable(L);
+	iproto_latency_foreach(set_latency_item, L);
+	return 1;
+}
+
+/**
+ * Push a table of WAL I/O statistics: current journal queue
+ * depth and the flush latency and batch size distributions of
+ * the WAL thread. Vinyl I/O statistics live in box.stat.vinyl().
+ */
+static int
+lbox_stat_io(struct lua_State *L)
+{
+	struct wal_io_stat stat;
+	wal_io_stat_get(&stat);
+
+	lua_newtable(L);
+
+	lua_pushstring(L, "queue");
+	lua_newtable(L);
+	lua_pushstring(L, "len");
+	lua_pushnumber(L, stat.queue_len);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "size");
+	lua_pushnumber(L, stat.queue_size);
+	lua_rawset(L, -3);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "wal");
+	lua_newtable(L);
+	lua_pushstring(L, "batches");
+	lua_pushnumber(L, stat.batches);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "bytes");
+	lua_pushnumber(L, stat.bytes);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "flush_latency");
+	lua_newtable(L);
+	lua_pushstring(L, "p50");
+	lua_pushnumber(L, stat.flush_p50);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "p90");
+	lua_pushnumber(L, stat.flush_p90);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "p99");
+	lua_pushnumber(L, stat.flush_p99);
+	lua_rawset(L, -3);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "batch_size");
+	lua_newtable(L);
+	lua_pushstring(L, "p50");
+	lua_pushnumber(L, stat.batch_size_p50);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "p90");
+	lua_pushnumber(L, stat.batch_size_p90);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "p99");
+	lua_pushnumber(L, stat.batch_size_p99);
+	lua_rawset(L, -3);
+	lua_rawset(L, -3);
+	lua_rawset(L, -3);
+
+	return 1;
+}
+
+#ifdef ENABLE_BACKTRACE
+/**
+ * Start the sampling profiler. An optional argument sets the
+ * sampling frequency in Hz, default is 99: an odd rate avoids
+ * lockstep with periodic activity.
+ */
+static int
+lbox_stat_prof_start(struct lua_State *L)
+{
+	int freq_hz = luaL_optint(L, 1, 99);
+	if (sampler_start(freq_hz) != 0)
+		return luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_stat_prof_stop(struct lua_State *L)
+{
+	(void)L;
+	sampler_stop();
+	return 0;
+}
+
+/**
+ * Dump collected samples to a file in the collapsed stack
+ * format. Returns the number of dumped samples.
+ */
+static int
+lbox_stat_prof_dump(struct lua_State *L)
+{
+	const char *path = luaL_checkstring(L, 1);
+	int64_t count = sampler_dump(path);
+	if (count < 0)
+		return luaT_error(L);
+	lua_pushnumber(L, count);
+	return 1;
+}
+#endif /* ENABLE_BACKTRACE */
+
+/**
+ * An alloc_profile_foreach() callback: append one sample as
+ * {size = ..., fiber = ..., stack = {...}} to the array on top
+ * of the Lua stack.
+ */
+static int
+set_alloc_profile_item(size_t size, const char *fiber_name,
+		       void *const *frames, int n_frames, void *cb_ctx)
+{
+	struct lua_State *L = (struct lua_State *) cb_ctx;
+
+	int idx = lua_objlen(L, -1) + 1;
+	lua_newtable(L);
+	lua_pushstring(L, "size");
+	lua_pushnumber(L, size);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "fiber");
+	lua_pushstring(L, fiber_name);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "stack");
+	lua_newtable(L);
+#ifdef ENABLE_BACKTRACE
+	for (int i = 0; i < n_frames; i++) {
+		lua_pushstring(L, backtrace_ip_name(frames[i]));
+		lua_rawseti(L, -2, i + 1);
+	}
+#else
+	(void)frames;
+	(void)n_frames;
+#endif /* ENABLE_BACKTRACE */
+	lua_rawset(L, -3);
+	lua_rawseti(L, -2, idx);
+
+	return 0;
+}
+
+/**
+ * Push a table with the sampled allocation profile: the total
+ * number of samples taken and the retained ones, newest last.
+ */
+static int
+lbox_stat_alloc_profile(struct lua_State *L)
+{
+	lua_newtable(L);
+	lua_pushstring(L, "total");
+	lua_pushnumber(L, alloc_profile_total());
+	lua_rawset(L, -3);
+	lua_pushstring(L, "period");
+	lua_pushnumber(L, alloc_profile_period);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "samples");
+	lua_newtable(L);
+	alloc_profile_foreach(set_alloc_profile_item, L);
+	lua_rawset(L, -3);
+	return 1;
+}
+
+/**
+ * Enable allocation profiling. An optional argument sets the
+ * sampling period, default is every 1024th allocation.
+ */
+static int
+lbox_stat_alloc_profile_start(struct lua_State *L)
+{
+	int period = luaL_optint(L, 1, 1024);
+	if (alloc_profile_start(period) != 0)
+		return luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_stat_alloc_profile_stop(struct lua_State *L)
+{
+	(void)L;
+	alloc_profile_stop();
+	return 0;
+}
+
+/**
+ * Start counting hardware events (cycles, instructions, cache
+ * and branch statistics) for the tx thread.
+ */
+/**
+ * Dump the flight recorder rings of all threads to a file and
+ * push the number of dumped events.
+ */
+static int
+lbox_stat_flightrec_dump(struct lua_State *L)
+{
+	const char *path = luaL_checkstring(L, 1);
+	int64_t count = flightrec_dump(path);
+	if (count < 0)
+		return luaT_error(L);
+	lua_pushnumber(L, count);
+	return 1;
+}
+
+static int
+lbox_stat_cpu_start(struct lua_State *L)
+{
+	if (hw_counters_start() != 0)
+		return luaT_error(L);
+	return 0;
+}
+
+/**
+ * Push a table of hardware counter values accumulated since
+ * box.stat.cpu_start(), plus the derived instructions per cycle.
+ * The counters keep running.
+ */
+static int
+lbox_stat_cpu(struct lua_State *L)
+{
+	struct hw_counters counters;
+	if (hw_counters_read(&counters) != 0)
+		return luaT_error(L);
+	lua_newtable(L);
+	lua_pushstring(L, "cycles");
+	lua_pushnumber(L, counters.cycles);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "instructions");
+	lua_pushnumber(L, counters.instructions);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "ipc");
+	lua_pushnumber(L, counters.cycles != 0 ?
+		       (double)counters.instructions / counters.cycles : 0);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "cache_refs");
+	lua_pushnumber(L, counters.cache_refs);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "cache_misses");
+	lua_pushnumber(L, counters.cache_misses);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "branches");
+	lua_pushnumber(L, counters.branches);
+	lua_rawset(L, -3);
+	lua_pushstring(L, "branch_misses");
+	lua_pushnumber(L, counters.branch_misses);
+	lua_rawset(L, -3);
+	return 1;
+}
+
+static int
+lbox_stat_cpu_stop(struct lua_State *L)
+{
+	(void)L;
+	hw_counters_stop();
+	return 0;
+}
+
 static int
 lbox_stat_sql(struct lua_State *L)
 {
@@ -229,6 +522,20 @@ box_lua_stat_init(struct lua_State *L)
 		{"vinyl", lbox_stat_vinyl},
 		{"reset", lbox_stat_reset},
 		{"sql", lbox_stat_sql},
+		{"latency", lbox_stat_latency},
+		{"io", lbox_stat_io},
+#ifdef ENABLE_BACKTRACE
+		{"prof_start", lbox_stat_prof_start},
+		{"prof_stop", lbox_stat_prof_stop},
+		{"prof_dump", lbox_stat_prof_dump},
+#endif /* ENABLE_BACKTRACE */
+		{"alloc_profile", lbox_stat_alloc_profile},
+		{"alloc_profile_start", lbox_stat_alloc_profile_start},
+		{"alloc_profile_stop", lbox_stat_alloc_profile_stop},
+		{"cpu", lbox_stat_cpu},
+		{"cpu_start", lbox_stat_cpu_start},
+		{"cpu_stop", lbox_stat_cpu_stop},
+		{"flightrec_dump", lbox_stat_flightrec_dump},
 		{NULL, NULL}
 	};
 
@@ -628,6 +628,77 @@ lbox_tuple_transform(struct lua_State *L)
 	return 1;
 }
 
+enum {
+	/** Slot count of the decoded string cache, a power of two. */
+	TUPLE_STRCACHE_SIZE = 256,
+	/**
+	 * Longest cacheable string. Enum-like field values (status
+	 * tags, country codes and so on) are short; capping the
+	 * length keeps high-cardinality payload strings out of the
+	 * cache and bounds the pinned Lua memory.
+	 */
+	TUPLE_STRCACHE_MAX_LEN = 32,
+};
+
+/** One slot of the decoded string cache. */
+struct tuple_strcache_entry {
+	/** Length of the cached string, 0 for an empty slot. */
+	uint32_t len;
+	/** Registry reference keeping the Lua string alive. */
+	int ref;
+	/** The raw string bytes, without the MessagePack header. */
+	char data[TUPLE_STRCACHE_MAX_LEN];
+};
+
+/**
+ * Direct-mapped cache of recently decoded string field values.
+ * Repeatedly decoding the same bytes (a status enum scanned over
+ * millions of tuples) makes LuaJIT hash and intern them anew on
+ * every access. A hit here returns the referenced string object
+ * instead. The cache is keyed on the value bytes, so low
+ * cardinality fields keep their slots hot while unique payloads
+ * simply churn through. Lua runs in the tx thread only, hence no
+ * locking.
+ */
+static struct tuple_strcache_entry tuple_strcache[TUPLE_STRCACHE_SIZE];
+
+/**
+ * Decode one MessagePack field onto the Lua stack, serving short
+ * strings from tuple_strcache. Non-string and long string fields
+ * take the ordinary luamp_decode() path.
+ */
+static void
+luamp_decode_field_cached(struct lua_State *L, const char **field)
+{
+	if (mp_typeof(**field) != MP_STR) {
+		luamp_decode(L, luaL_msgpack_default, field);
+		return;
+	}
+	const char *pos = *field;
+	uint32_t len = mp_decode_strl(&pos);
+	if (len == 0 || len > TUPLE_STRCACHE_MAX_LEN) {
+		luamp_decode(L, luaL_msgpack_default, field);
+		return;
+	}
+	uint32_t h = len;
+	for (uint32_t i = 0; i < len; i++)
+		h = h * 31 + (unsigned char)pos[i];
+	struct tuple_strcache_entry *e =
+		&tuple_strcache[h & (TUPLE_STRCACHE_SIZE - 1)];
+	if (e->len == len && memcmp(e->data, pos, len) == 0) {
+		lua_rawgeti(L, LUA_REGISTRYINDEX, e->ref);
+	} else {
+		lua_pushlstring(L, pos, len);
+		lua_pushvalue(L, -1);
+		if (e->len != 0)
+			luaL_unref(L, LUA_REGISTRYINDEX, e->ref);
+		e->ref = luaL_ref(L, LUA_REGISTRYINDEX);
+		e->len = len;
+		memcpy(e->data, pos, len);
+	}
+	*field = pos + len;
+}
+
 /**
  * Find a tuple field by JSON path. If a field was not found and a
  * path contains JSON syntax errors, then an exception is raised.
@@ -655,10 +726,11 @@ lbox_tuple_field_by_path(struct lua_State *L)
 					     tuple_data(tuple),
 					     tuple_field_map(tuple),
 					     path, (uint32_t)len,
-					     lua_hashstring(L, 2));
+					     lua_hashstring(L, 2),
+					     tuple_is_compact(tuple));
 	if (field == NULL)
 		return 0;
-	luamp_decode(L, luaL_msgpack_default, &field);
+	luamp_decode_field_cached(L, &field);
 	return 1;
 }
 
@@ -275,6 +275,63 @@ local function tuple_field_by_path(tuple, path)
     return internal.tuple.tuple_field_by_path(tuple, path)
 end
 
+local char_ptr_t = ffi.typeof('const char *')
+local const_u8_ptr_t = ffi.typeof('const uint8_t *')
+
+-- Read a string (or binary) field as a view into the tuple data:
+-- returns a const char * cdata and the length, without interning
+-- a Lua string. The pointer stays valid as long as the tuple
+-- object itself is alive - the cdata holds a tuple reference.
+-- Returns nil when there is no such field; raises when the field
+-- is not a string.
+local function tuple_strview(tuple, field_n)
+    tuple_check(tuple, "tuple:strview(field_n)")
+    local field = builtin.box_tuple_field(tuple, field_n - 1)
+    if field == nil then
+        return nil
+    end
+    local p = ffi.cast(const_u8_ptr_t, field)
+    local c = p[0]
+    local len, data
+    if c >= 0xa0 and c <= 0xbf then
+        len = c - 0xa0
+        data = p + 1
+    elseif c == 0xd9 or c == 0xc4 then
+        len = p[1]
+        data = p + 2
+    elseif c == 0xda or c == 0xc5 then
+        len = p[1] * 256 + p[2]
+        data = p + 3
+    elseif c == 0xdb or c == 0xc6 then
+        len = p[1] * 16777216 + p[2] * 65536 + p[3] * 256 + p[4]
+        data = p + 5
+    else
+        error("tuple:strview(): field is not a string")
+    end
+    return ffi.cast(char_ptr_t, data), len
+end
+
+-- Read a numeric field as a plain Lua number instead of a boxed
+-- 64-bit cdata, so hot loops allocate nothing the JIT cannot
+-- sink. Loses precision above 2^53, as any Lua number does.
+-- Returns nil when there is no such field; raises when the field
+-- is not a number.
+local function tuple_numview(tuple, field_n)
+    tuple_check(tuple, "tuple:numview(field_n)")
+    local field = builtin.box_tuple_field(tuple, field_n - 1)
+    if field == nil then
+        return nil
+    end
+    local val = msgpackffi.decode_unchecked(field)
+    if type(val) == 'cdata' then
+        return tonumber(val)
+    end
+    if type(val) ~= 'number' then
+        error("tuple:numview(): field is not a number")
+    end
+    return val
+end
+
 local methods = {
     ["next"]        = tuple_next;
     ["ipairs"]      = tuple_ipairs;
@@ -289,6 +346,8 @@ local methods = {
     ["upsert"]      = tuple_upsert;
     ["bsize"]       = tuple_bsize;
     ["tomap"]       = internal.tuple.tuple_to_map;
+    ["strview"]     = tuple_strview;
+    ["numview"]     = tuple_numview;
 }
 
 -- Aliases for tuple:methods().
@@ -487,8 +487,22 @@ memtx_bitset_index_count(struct index *base, enum iterator_type type,
 				tt_bitset_index_count(&index->index, bit);
 	}
 
-	/* Call generic method */
-	return generic_index_count(base, type, key, part_count);
+	/*
+	 * For a multi-bit key evaluate the expression page by page
+	 * and popcount whole result pages instead of extracting
+	 * every matching position and looking up its tuple, which
+	 * is what the generic implementation would do. Like the
+	 * single-bit shortcuts above, the result does not account
+	 * for tuples invisible to the current transaction.
+	 */
+	struct iterator *it = memtx_bitset_index_create_iterator(base, type,
+								 key, part_count);
+	if (it == NULL)
+		return -1;
+	ssize_t result = tt_bitset_iterator_count(
+		&bitset_index_iterator(it)->bitset_it);
+	iterator_delete(it);
+	return result;
 }
 
 static const struct index_vtab memtx_bitset_index_vtab = {
@@ -31,10 +31,13 @@
 #include "memtx_engine.h"
 #include "memtx_space.h"
 
+#include <fcntl.h>
+
 #include <small/quota.h>
 #include <small/small.h>
 #include <small/mempool.h>
 
+#include "alloc_profile.h"
 #include "fiber.h"
 #include "errinj.h"
 #include "coio_file.h"
@@ -109,16 +112,46 @@ memtx_build_secondary_keys(struct space *space, void *param)
 		struct index *pk = space->index[0];
 		ssize_t n_tuples = index_size(pk);
 		assert(n_tuples >= 0);
+		uint32_t estimated_tuples = n_tuples * 1.2;
 
 		if (n_tuples > 0) {
-			say_info("Building secondary indexes in space '%s'...",
-				 space_name(space));
+			say_info("Building %u secondary indexes in space '%s'...",
+				 space->index_count - 1, space_name(space));
 		}
 
+		/*
+		 * All secondary indexes are built in a single pass
+		 * over the primary key: fetching a tuple once and
+		 * feeding it to every index under construction is
+		 * much cheaper than walking the primary key anew
+		 * for each of them, as index_build() would do.
+		 */
 		for (uint32_t j = 1; j < space->index_count; j++) {
-			if (index_build(space->index[j], pk) < 0)
+			index_begin_build(space->index[j]);
+			if (index_reserve(space->index[j],
+					  estimated_tuples) < 0)
 				return -1;
 		}
+		struct iterator *it = index_create_iterator(pk, ITER_ALL,
+							    NULL, 0);
+		if (it == NULL)
+			return -1;
+		int rc;
+		struct tuple *tuple;
+		while ((rc = iterator_next(it, &tuple)) == 0 && tuple != NULL) {
+			for (uint32_t j = 1; j < space->index_count; j++) {
+				rc = index_build_next(space->index[j], tuple);
+				if (rc != 0)
+					break;
+			}
+			if (rc != 0)
+				break;
+		}
+		iterator_delete(it);
+		if (rc != 0)
+			return -1;
+		for (uint32_t j = 1; j < space->index_count; j++)
+			index_end_build(space->index[j]);
 
 		if (n_tuples > 0) {
 			say_info("Space '%s': done", space_name(space));
@@ -150,7 +183,11 @@ memtx_engine_shutdown(struct engine *engine)
 
 static int
 memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
-				  struct xrow_header *row, int *is_space_system);
+				  struct xrow_header *row, int *is_space_system,
+				  struct txn **batch_txn, int *batch_rows);
+
+static int
+memtx_engine_recover_snapshot_flush(struct txn **batch_txn);
 
 int
 memtx_engine_recover_snapshot(struct memtx_engine *memtx,
@@ -167,18 +204,36 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 	if (xlog_cursor_open(&cursor, filename) < 0)
 		return -1;
 
+#ifdef HAVE_POSIX_FADVISE
+	/*
+	 * The cursor advises POSIX_FADV_SEQUENTIAL on its own, but
+	 * the readahead window it earns that way only grows as the
+	 * reads progress. A snapshot is replayed front to back in
+	 * its entirety, so ask the kernel to start pulling the whole
+	 * file into the page cache right away: on a warm restart the
+	 * data is already resident and this is a no-op, on a cold
+	 * one the disk reads run ahead of row decoding instead of
+	 * stalling it.
+	 */
+	if (posix_fadvise(cursor.fd, 0, 0, POSIX_FADV_WILLNEED) != 0)
+		say_syserror("posix_fadvise, fd=%i", cursor.fd);
+#endif
+
 	int rc;
 	struct xrow_header row;
 	uint64_t row_count = 0;
 	int is_space_system = -1;
 	bool force_recovery = false;
+	struct txn *batch_txn = NULL;
+	int batch_rows = 0;
 	/*
 	 * In case when we read system space, we can't ignore errors.
 	 */
 	while ((rc = xlog_cursor_next(&cursor, &row, force_recovery)) == 0) {
 		row.lsn = signature;
 		rc = memtx_engine_recover_snapshot_row(memtx, &row,
-						       &is_space_system);
+						       &is_space_system,
+						       &batch_txn, &batch_rows);
 		force_recovery = is_space_system == 0 ?
 				 memtx->force_recovery : false;
 		if (rc < 0) {
@@ -191,9 +246,20 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 		if (row_count % 100000 == 0) {
 			say_info("%.1fM rows processed",
 				 row_count / 1000000.);
+			/* Can't hold a transaction over a yield. */
+			if (memtx_engine_recover_snapshot_flush(&batch_txn) != 0) {
+				rc = -1;
+				break;
+			}
 			fiber_yield_timeout(0);
 		}
 	}
+	if (rc >= 0 && memtx_engine_recover_snapshot_flush(&batch_txn) != 0)
+		rc = -1;
+	if (batch_txn != NULL) {
+		txn_rollback(batch_txn);
+		fiber_gc();
+	}
 	xlog_cursor_close(&cursor, false);
 	if (rc < 0 || is_space_system < 0)
 		return -1;
@@ -225,34 +291,83 @@ memtx_engine_recover_raft(const struct xrow_header *row)
 	return 0;
 }
 
+/**
+ * Snapshot rows are plain inserts confirmed by definition, so
+ * there is no need to pay for a separate transaction with its own
+ * commit and region cleanup on every one of them. Group this many
+ * rows into one multi-statement transaction instead.
+ */
+enum { SNAPSHOT_RECOVERY_ROWS_PER_TXN = 64 };
+
+/** Commit an open snapshot row batch transaction, if any. */
+static int
+memtx_engine_recover_snapshot_flush(struct txn **batch_txn)
+{
+	struct txn *txn = *batch_txn;
+	if (txn == NULL)
+		return 0;
+	*batch_txn = NULL;
+	/*
+	 * Snapshot rows are confirmed by definition. They don't need to go to
+	 * the synchronous transactions limbo.
+	 */
+	txn_set_flags(txn, TXN_FORCE_ASYNC);
+	int rc = txn_commit(txn);
+	/*
+	 * Don't let gc pool grow too much. Yet to
+	 * it before reading the next row, to make
+	 * sure it's not freed along here.
+	 */
+	fiber_gc();
+	return rc;
+}
+
 static int
 memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
-				  struct xrow_header *row, int *is_space_system)
+				  struct xrow_header *row, int *is_space_system,
+				  struct txn **batch_txn, int *batch_rows)
 {
 	assert(row->bodycnt == 1); /* always 1 for read */
 	if (row->type != IPROTO_INSERT) {
+		if (memtx_engine_recover_snapshot_flush(batch_txn) != 0)
+			return -1;
 		if (row->type == IPROTO_RAFT)
 			return memtx_engine_recover_raft(row);
 		diag_set(ClientError, ER_UNKNOWN_REQUEST_TYPE,
 			 (uint32_t) row->type);
 		return -1;
 	}
-	int rc;
 	struct request request;
 	if (xrow_decode_dml(row, &request, dml_request_key_map(row->type)) != 0)
-		return -1;
+		goto rollback_batch;
 	*is_space_system = (request.space_id < BOX_SYSTEM_ID_MAX);
+	/*
+	 * System space rows keep running one transaction each: the
+	 * DDL their commit triggers bring in must be visible to the
+	 * rows which follow. force_recovery keeps them solo too, so
+	 * that a skipped bad row doesn't drag its batch mates down.
+	 */
+	bool batch = !*is_space_system && !memtx->force_recovery;
+	if (!batch && memtx_engine_recover_snapshot_flush(batch_txn) != 0)
+		return -1;
 	struct space *space = space_cache_find(request.space_id);
 	if (space == NULL)
-		return -1;
+		goto rollback_batch;
 	/* memtx snapshot must contain only memtx spaces */
 	if (space->engine != (struct engine *)memtx) {
 		diag_set(ClientError, ER_CROSS_ENGINE_TRANSACTION);
-		return -1;
+		goto rollback_batch;
+	}
+	struct txn *txn = *batch_txn;
+	if (txn == NULL) {
+		txn = txn_begin();
+		if (txn == NULL)
+			return -1;
+		if (batch) {
+			*batch_txn = txn;
+			*batch_rows = 0;
+		}
 	}
-	struct txn *txn = txn_begin();
-	if (txn == NULL)
-		return -1;
 	if (txn_begin_stmt(txn, space, request.type) != 0)
 		goto rollback;
 	/* no access checks here - applier always works with admin privs */
@@ -261,25 +376,28 @@ memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 		goto rollback_stmt;
 	if (txn_commit_stmt(txn, &request) != 0)
 		goto rollback;
-	/*
-	 * Snapshot rows are confirmed by definition. They don't need to go to
-	 * the synchronous transactions limbo.
-	 */
-	txn_set_flags(txn, TXN_FORCE_ASYNC);
-	rc = txn_commit(txn);
-	/*
-	 * Don't let gc pool grow too much. Yet to
-	 * it before reading the next row, to make
-	 * sure it's not freed along here.
-	 */
-	fiber_gc();
-	return rc;
+	if (!batch) {
+		assert(*batch_txn == NULL);
+		*batch_txn = txn;
+		return memtx_engine_recover_snapshot_flush(batch_txn);
+	}
+	if (++*batch_rows >= SNAPSHOT_RECOVERY_ROWS_PER_TXN)
+		return memtx_engine_recover_snapshot_flush(batch_txn);
+	return 0;
 rollback_stmt:
 	txn_rollback_stmt(txn);
 rollback:
 	txn_rollback(txn);
+	*batch_txn = NULL;
 	fiber_gc();
 	return -1;
+rollback_batch:
+	if (*batch_txn != NULL) {
+		txn_rollback(*batch_txn);
+		*batch_txn = NULL;
+		fiber_gc();
+	}
+	return -1;
 }
 
 /** Called at start to tell memtx to recover to a given LSN. */
@@ -462,11 +580,21 @@ memtx_engine_bootstrap(struct engine *engine)
 
 	int rc, is_space_system;
 	struct xrow_header row;
+	struct txn *batch_txn = NULL;
+	int batch_rows = 0;
 	while ((rc = xlog_cursor_next(&cursor, &row, true)) == 0) {
-		rc = memtx_engine_recover_snapshot_row(memtx, &row, &is_space_system);
+		rc = memtx_engine_recover_snapshot_row(memtx, &row,
+						       &is_space_system,
+						       &batch_txn, &batch_rows);
 		if (rc < 0)
 			break;
 	}
+	if (rc >= 0)
+		rc = memtx_engine_recover_snapshot_flush(&batch_txn);
+	else if (batch_txn != NULL) {
+		txn_rollback(batch_txn);
+		fiber_gc();
+	}
 	xlog_cursor_close(&cursor, false);
 	return rc < 0 ? -1 : 0;
 }
@@ -571,14 +699,28 @@ checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit)
 	return ckpt;
 }
 
+/**
+ * Release the space read views attached to the checkpoint. Apart
+ * from checkpoint deletion, this is done as soon as it is known
+ * that no rows are going to be written (a touch checkpoint), since
+ * open read views would otherwise pin deleted tuples in memory for
+ * the rest of the checkpoint.
+ */
 static void
-checkpoint_delete(struct checkpoint *ckpt)
+checkpoint_release_entries(struct checkpoint *ckpt)
 {
 	struct checkpoint_entry *entry, *tmp;
 	rlist_foreach_entry_safe(entry, &ckpt->entries, link, tmp) {
 		entry->iterator->free(entry->iterator);
 		free(entry);
 	}
+	rlist_create(&ckpt->entries);
+}
+
+static void
+checkpoint_delete(struct checkpoint *ckpt)
+{
+	checkpoint_release_entries(ckpt);
 	xdir_destroy(&ckpt->dir);
 	free(ckpt);
 }
@@ -664,10 +806,13 @@ checkpoint_f(va_list ap)
 		if (xdir_touch_xlog(&ckpt->dir, &ckpt->vclock) == 0)
 			return 0;
 		/*
-		 * Failed to touch an existing snapshot, create
-		 * a new one.
+		 * Failed to touch the existing snapshot. A full one
+		 * can't be written instead - the read views were
+		 * released when the checkpoint was downgraded to a
+		 * touch - so report the failure and let the next
+		 * scheduled checkpoint write a full snapshot.
 		 */
-		ckpt->touch = false;
+		return -1;
 	}
 
 	struct xlog snap;
@@ -737,6 +882,7 @@ memtx_engine_wait_checkpoint(struct engine *engine,
 	if (xdir_last_vclock(&memtx->snap_dir, &last) >= 0 &&
 	    vclock_compare(&last, vclock) == 0) {
 		memtx->checkpoint->touch = true;
+		checkpoint_release_entries(memtx->checkpoint);
 	}
 	vclock_copy(&memtx->checkpoint->vclock, vclock);
 
@@ -1148,6 +1294,7 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		       MEMTX_ITERATOR_SIZE);
 	memtx->num_reserved_extents = 0;
 	memtx->reserved_extents = NULL;
+	memtx->memory_pressure_level = 0;
 
 	memtx->state = MEMTX_INITIALIZED;
 	memtx->max_tuple_size = MAX_TUPLE_SIZE;
@@ -1214,6 +1361,41 @@ memtx_leave_delayed_free_mode(struct memtx_engine *memtx)
 		small_alloc_setopt(&memtx->alloc, SMALL_DELAYED_FREE_MODE, false);
 }
 
+/**
+ * Quota usage ratios at which the engine reports growing memory
+ * pressure and nudges garbage collection, so that the instance
+ * degrades gradually instead of failing allocations at the quota
+ * cliff.
+ */
+static const double memtx_memory_watermarks[] = {0.8, 0.9, 0.95};
+
+/**
+ * Recompute the quota watermark level and, when a new watermark
+ * has just been crossed, warn the operator and wake up the gc
+ * fiber so that queued garbage is reclaimed before allocations
+ * start hitting the quota.
+ */
+static void
+memtx_engine_check_memory_pressure(struct memtx_engine *memtx)
+{
+	size_t total = quota_total(&memtx->quota);
+	size_t used = quota_used(&memtx->quota);
+	int level = 0;
+	while (level < (int)lengthof(memtx_memory_watermarks) &&
+	       used >= (size_t)(memtx_memory_watermarks[level] * total))
+		level++;
+	if (level <= memtx->memory_pressure_level) {
+		memtx->memory_pressure_level = level;
+		return;
+	}
+	memtx->memory_pressure_level = level;
+	say_warn("memtx quota is over %d%% used (%zu of %zu bytes), "
+		 "consider raising memtx_memory or freeing data",
+		 (int)(memtx_memory_watermarks[level - 1] * 100),
+		 used, total);
+	fiber_wakeup(memtx->gc_fiber);
+}
+
 struct tuple *
 memtx_tuple_new(struct tuple_format *format, const char *data, const char *end)
 {
@@ -1225,21 +1407,29 @@ memtx_tuple_new(struct tuple_format *format, const char *data, const char *end)
 	struct field_map_builder builder;
 	if (tuple_field_map_create(format, data, true, &builder) != 0)
 		goto end;
-	uint32_t field_map_size = field_map_build_size(&builder);
+	size_t tuple_len = end - data;
+	/*
+	 * Small tuples whose field maps have no multikey extents
+	 * are stored with byte-wide offset slots - for spaces with
+	 * several indexes this shrinks the metadata 4 times.
+	 */
+	bool is_compact = field_map_can_be_compact(&builder, tuple_len);
+	uint32_t field_map_size = is_compact ?
+		field_map_build_size_compact(&builder) :
+		field_map_build_size(&builder);
 	/*
 	 * Data offset is calculated from the begin of the struct
 	 * tuple base, not from memtx_tuple, because the struct
 	 * tuple is not the first field of the memtx_tuple.
 	 */
 	uint32_t data_offset = sizeof(struct tuple) + field_map_size;
-	if (data_offset > INT16_MAX) {
-		/** tuple->data_offset is 15 bits */
+	if (data_offset > TUPLE_DATA_OFFSET_MAX) {
+		/** tuple->data_offset is 14 bits */
 		diag_set(ClientError, ER_TUPLE_METADATA_IS_TOO_BIG,
 			 data_offset);
 		goto end;
 	}
 
-	size_t tuple_len = end - data;
 	size_t total = sizeof(struct memtx_tuple) + field_map_size + tuple_len;
 
 	ERROR_INJECT(ERRINJ_TUPLE_ALLOC, {
@@ -1263,6 +1453,8 @@ memtx_tuple_new(struct tuple_format *format, const char *data, const char *end)
 		diag_set(OutOfMemory, total, "slab allocator", "memtx_tuple");
 		goto end;
 	}
+	alloc_profile_sample(total);
+	memtx_engine_check_memory_pressure(memtx);
 	tuple = &memtx_tuple->base;
 	tuple->refs = 0;
 	memtx_tuple->version = memtx->snapshot_version;
@@ -1271,9 +1463,13 @@ memtx_tuple_new(struct tuple_format *format, const char *data, const char *end)
 	tuple->format_id = tuple_format_id(format);
 	tuple_format_ref(format);
 	tuple->data_offset = data_offset;
+	tuple->is_compact = is_compact;
 	tuple->is_dirty = false;
 	char *raw = (char *) tuple + tuple->data_offset;
-	field_map_build(&builder, raw - field_map_size);
+	if (is_compact)
+		field_map_build_compact(&builder, raw - field_map_size);
+	else
+		field_map_build(&builder, raw - field_map_size);
 	memcpy(raw, data, tuple_len);
 	say_debug("%s(%zu) = %p", __func__, tuple_len, memtx_tuple);
 end:
@@ -1322,6 +1518,7 @@ memtx_tuple_chunk_new(struct tuple_format *format, struct tuple *tuple,
 		diag_set(OutOfMemory, sz, "smalloc", "tuple");
 		return NULL;
 	}
+	alloc_profile_sample(sz);
 	tuple_chunk->data_sz = data_sz;
 	memcpy(tuple_chunk->data, data, data_sz);
 	return tuple_chunk->data;
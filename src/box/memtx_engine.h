@@ -178,6 +178,14 @@ struct memtx_engine {
 	 * memtx_gc_task::link.
 	 */
 	struct stailq gc_queue;
+	/**
+	 * The highest quota watermark the engine has crossed so
+	 * far: 0 below the lowest watermark, 1, 2, ... above the
+	 * corresponding entry of the watermark table. Used to
+	 * warn and kick garbage collection once per crossing
+	 * instead of on every allocation.
+	 */
+	int memory_pressure_level;
 };
 
 struct memtx_gc_task;
@@ -319,11 +319,25 @@ memtx_hash_index_get(struct index *base, const char *key,
 	       part_count == base->def->key_def->part_count);
 	(void) part_count;
 
+	*result = NULL;
+	uint32_t h = key_hash(key, base->def->key_def);
+	/*
+	 * Without MVCC a committed tuple never needs
+	 * clarification, so resolve the point lookup straight
+	 * from the hash table and skip the space cache lookup
+	 * and transaction tracking altogether. This is the
+	 * hottest iproto read path.
+	 */
+	if (!memtx_tx_manager_use_mvcc_engine) {
+		uint32_t k = light_index_find_key(&index->hash_table, h, key);
+		if (k != light_index_end)
+			*result = light_index_get(&index->hash_table, k);
+		return 0;
+	}
+
 	struct space *space = space_by_id(base->def->space_id);
 	struct txn *txn = in_txn();
 	uint32_t iid = base->def->iid;
-	*result = NULL;
-	uint32_t h = key_hash(key, base->def->key_def);
 	uint32_t k = light_index_find_key(&index->hash_table, h, key);
 	if (k != light_index_end) {
 		struct tuple *tuple = light_index_get(&index->hash_table, k);
@@ -406,6 +420,32 @@ memtx_hash_index_replace(struct index *base, struct tuple *old_tuple,
 	return 0;
 }
 
+static int
+memtx_hash_index_reserve(struct index *base, uint32_t size_hint)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	struct light_index_core *hash_table = &index->hash_table;
+	if (size_hint > 0) {
+		/*
+		 * An index build knows the final size up front:
+		 * grow the table to it here so the build inserts
+		 * never split chains inline.
+		 */
+		light_index_grow_steps(hash_table, size_hint, UINT32_MAX);
+	} else {
+		/*
+		 * Keep a slack of pre-split slots ahead of the
+		 * record count so a burst of inserts finds empty
+		 * slots ready instead of paying for a chain split
+		 * in the middle of a request. The step bound keeps
+		 * the cost of a single reserve call fixed.
+		 */
+		light_index_grow_steps(hash_table, hash_table->count +
+				       2 * LIGHT_GROW_INCREMENT, 2);
+	}
+	return 0;
+}
+
 static struct iterator *
 memtx_hash_index_create_iterator(struct index *base, enum iterator_type type,
 				 const char *key, uint32_t part_count)
@@ -572,7 +612,7 @@ static const struct index_vtab memtx_hash_index_vtab = {
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
 	/* .begin_build = */ generic_index_begin_build,
-	/* .reserve = */ generic_index_reserve,
+	/* .reserve = */ memtx_hash_index_reserve,
 	/* .build_next = */ generic_index_build_next,
 	/* .end_build = */ generic_index_end_build,
 };
@@ -50,6 +50,12 @@ struct memtx_rtree_index {
 	struct index base;
 	unsigned dimension;
 	struct rtree tree;
+	/* Array of rectangles for bulk-loading on build. */
+	struct rtree_build_elem *build_array;
+	/* Number of elements in build_array. */
+	size_t build_array_size;
+	/* Allocated size of build_array. */
+	size_t build_array_alloc_size;
 };
 
 /* {{{ Utilities. *************************************************/
@@ -174,6 +180,7 @@ memtx_rtree_index_destroy(struct index *base)
 {
 	struct memtx_rtree_index *index = (struct memtx_rtree_index *)base;
 	rtree_destroy(&index->tree);
+	free(index->build_array);
 	free(index);
 }
 
@@ -296,6 +303,80 @@ memtx_rtree_index_reserve(struct index *base, uint32_t size_hint)
 	return memtx_index_extent_reserve(memtx, RESERVE_EXTENTS_BEFORE_REPLACE);
 }
 
+static void
+memtx_rtree_index_begin_build(struct index *base)
+{
+	struct memtx_rtree_index *index = (struct memtx_rtree_index *)base;
+	assert(rtree_number_of_records(&index->tree) == 0);
+	(void)index;
+}
+
+static int
+memtx_rtree_index_build_next(struct index *base, struct tuple *tuple)
+{
+	struct memtx_rtree_index *index = (struct memtx_rtree_index *)base;
+	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
+	struct rtree_rect rect;
+	if (extract_rectangle(&rect, tuple, base->def) != 0)
+		return -1;
+	if (index->build_array == NULL) {
+		index->build_array =
+			(struct rtree_build_elem *)malloc(MEMTX_EXTENT_SIZE);
+		if (index->build_array == NULL) {
+			diag_set(OutOfMemory, MEMTX_EXTENT_SIZE,
+				 "memtx_rtree_index", "build_next");
+			return -1;
+		}
+		index->build_array_alloc_size =
+			MEMTX_EXTENT_SIZE / sizeof(index->build_array[0]);
+	}
+	assert(index->build_array_size <= index->build_array_alloc_size);
+	if (index->build_array_size == index->build_array_alloc_size) {
+		index->build_array_alloc_size = index->build_array_alloc_size +
+				DIV_ROUND_UP(index->build_array_alloc_size, 2);
+		struct rtree_build_elem *tmp = (struct rtree_build_elem *)
+			realloc(index->build_array,
+				index->build_array_alloc_size * sizeof(*tmp));
+		if (tmp == NULL) {
+			diag_set(OutOfMemory, index->build_array_alloc_size *
+				 sizeof(*tmp), "memtx_rtree_index",
+				 "build_next");
+			return -1;
+		}
+		index->build_array = tmp;
+	}
+	struct rtree_build_elem *elem =
+		&index->build_array[index->build_array_size++];
+	elem->rect = rect;
+	elem->record = tuple;
+	/*
+	 * rtree_build() cannot report allocation failure, so keep
+	 * enough extents reserved for the final packed tree while
+	 * the tuples are still being collected: this is the only
+	 * step of the build path that may return an error.
+	 */
+	unsigned n_pages = rtree_build_pages(&index->tree,
+					     index->build_array_size);
+	unsigned pages_per_extent = MEMTX_EXTENT_SIZE / index->tree.page_size;
+	unsigned n_extents = DIV_ROUND_UP(n_pages, pages_per_extent);
+	/* Extents spent by matras on its mapping blocks. */
+	n_extents += n_extents / (MEMTX_EXTENT_SIZE / sizeof(void *)) +
+		     RESERVE_EXTENTS_BEFORE_REPLACE;
+	return memtx_index_extent_reserve(memtx, n_extents);
+}
+
+static void
+memtx_rtree_index_end_build(struct index *base)
+{
+	struct memtx_rtree_index *index = (struct memtx_rtree_index *)base;
+	rtree_build(&index->tree, index->build_array,
+		    index->build_array_size);
+	free(index->build_array);
+	index->build_array = NULL;
+	index->build_array_size = 0;
+	index->build_array_alloc_size = 0;
+}
+
 static struct iterator *
 memtx_rtree_index_create_iterator(struct index *base,  enum iterator_type type,
 				  const char *key, uint32_t part_count)
@@ -393,10 +474,10 @@ static const struct index_vtab memtx_rtree_index_vtab = {
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
-	/* .begin_build = */ generic_index_begin_build,
+	/* .begin_build = */ memtx_rtree_index_begin_build,
 	/* .reserve = */ memtx_rtree_index_reserve,
-	/* .build_next = */ generic_index_build_next,
-	/* .end_build = */ generic_index_end_build,
+	/* .build_next = */ memtx_rtree_index_build_next,
+	/* .end_build = */ memtx_rtree_index_end_build,
 };
 
 struct index *
@@ -199,6 +199,16 @@ struct memtx_tree_index {
 	size_t build_array_size, build_array_alloc_size;
 	struct memtx_gc_task gc_task;
 	memtx_tree_iterator_t<USE_HINT> gc_iterator;
+	/**
+	 * Scan resume cache: tree position of the last element
+	 * returned by a forward iterator. When a paginated
+	 * client restarts the scan with ITER_GT and the full key
+	 * of exactly that element, the new iterator starts right
+	 * behind the cached position instead of descending from
+	 * the root. The position is validated by comparison on
+	 * use, so a stale one only costs the fallback descent.
+	 */
+	memtx_tree_iterator_t<USE_HINT> resume_pos;
 };
 
 /* {{{ Utilities. *************************************************/
@@ -273,6 +283,27 @@ tree_iterator_dummie(struct iterator *iterator, struct tuple **ret)
 	return 0;
 }
 
+/**
+ * Prefetch the tuple the iterator is going to return on the
+ * following step. Tuples live in scattered slab memory, so a
+ * range scan is bound by the pointer chase unless the next
+ * dereference is started while the current tuple is still being
+ * processed. The tree iterator is taken by value: advancing a
+ * copy is a matter of a block id and a position and does not
+ * disturb the caller's position.
+ */
+template <bool USE_HINT>
+static inline void
+tree_iterator_prefetch_successor(memtx_tree_t<USE_HINT> *tree,
+				 memtx_tree_iterator_t<USE_HINT> itr)
+{
+	memtx_tree_iterator_next(tree, &itr);
+	struct memtx_tree_data<USE_HINT> *succ =
+		memtx_tree_iterator_get_elem(tree, &itr);
+	if (succ != NULL)
+		prefetch(succ->tuple, 0);
+}
+
 template <bool USE_HINT>
 static int
 tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
@@ -300,6 +331,9 @@ tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
 		*ret = res->tuple;
 		tuple_ref(*ret);
 		it->current = *res;
+		index->resume_pos = it->tree_iterator;
+		tree_iterator_prefetch_successor(&index->tree,
+						 it->tree_iterator);
 	}
 	uint32_t iid = iterator->index->def->iid;
 	struct space *space = space_by_id(iterator->space_id);
@@ -382,6 +416,9 @@ tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 		*ret = res->tuple;
 		tuple_ref(*ret);
 		it->current = *res;
+		index->resume_pos = it->tree_iterator;
+		tree_iterator_prefetch_successor(&index->tree,
+						 it->tree_iterator);
 	}
 	uint32_t iid = iterator->index->def->iid;
 	struct space *space = space_by_id(iterator->space_id);
@@ -563,15 +600,48 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 		 * efficiently equals to the empty key. */
 		equals = memtx_tree_size(tree) != 0;
 	} else {
-		if (type == ITER_ALL || type == ITER_EQ ||
-		    type == ITER_GE || type == ITER_LT) {
-			it->tree_iterator =
-				memtx_tree_lower_bound(tree, &it->key_data,
-						       &equals);
-		} else { // ITER_GT, ITER_REQ, ITER_LE
-			it->tree_iterator =
-				memtx_tree_upper_bound(tree, &it->key_data,
-						       &equals);
+		bool resumed = false;
+		if (type == ITER_GT && key_is_full) {
+			/*
+			 * Pagination fast path: if the restart
+			 * key is exactly the last element a
+			 * forward iterator returned, step right
+			 * behind the cached position instead of
+			 * descending from the root. A full
+			 * cmp_def key matches at most one
+			 * element, so any cached position whose
+			 * element equals the key is the correct
+			 * upper bound predecessor, no matter how
+			 * stale the cache is.
+			 */
+			struct memtx_tree_data<USE_HINT> *last =
+				memtx_tree_iterator_get_elem(tree,
+							     &index->resume_pos);
+			if (last != NULL &&
+			    tuple_compare_with_key(last->tuple, last->hint,
+						   it->key_data.key,
+						   it->key_data.part_count,
+						   it->key_data.hint,
+						   cmp_def) == 0) {
+				it->tree_iterator = index->resume_pos;
+				memtx_tree_iterator_next(tree,
+							 &it->tree_iterator);
+				resumed = true;
+			}
+		}
+		if (!resumed) {
+			if (type == ITER_ALL || type == ITER_EQ ||
+			    type == ITER_GE || type == ITER_LT) {
+				it->tree_iterator =
+					memtx_tree_lower_bound(tree,
+							       &it->key_data,
+							       &equals);
+			} else { // ITER_GT, ITER_REQ, ITER_LE
+				it->tree_iterator =
+					memtx_tree_upper_bound(tree,
+							       &it->key_data,
+							       &equals);
+			}
 		}
 	}
 	if (!equals && (type == ITER_EQ || type == ITER_REQ)) {
@@ -612,6 +682,7 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 	*ret = res->tuple;
 	tuple_ref(*ret);
 	it->current = *res;
+	index->resume_pos = it->tree_iterator;
 	tree_iterator_set_next_method(it);
 
 	bool is_multikey = iterator->index->def->key_def->is_multikey;
@@ -1408,9 +1479,13 @@ memtx_tree_index_build_next(struct index *base, struct tuple *tuple)
 		return 0;
 	struct memtx_tree_index<USE_HINT> *index =
 		(struct memtx_tree_index<USE_HINT> *)base;
-	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
-	return memtx_tree_index_build_array_append(index, tuple,
-						   tuple_hint(tuple, cmp_def));
+	/*
+	 * The comparison hint is not computed here on purpose:
+	 * hints of all collected tuples are filled in batch by
+	 * memtx_tree_index_build_array_set_hints() right before
+	 * the sort, where the work can be spread across cores.
+	 */
+	return memtx_tree_index_build_array_append(index, tuple, HINT_NONE);
 }
 
 static int
@@ -1462,6 +1537,40 @@ error:
 	return -1;
 }
 
+enum {
+	/**
+	 * Minimal build_array size for which batch hint
+	 * calculation goes multithreaded. Matches the
+	 * threshold qsort_arg() uses for the sort itself.
+	 */
+	BUILD_HINTS_MT_THRESHOLD = 128 * 1024,
+};
+
+/**
+ * Compute comparison hints for all elements of build_array.
+ * Hint calculation is pure per-tuple work, so on OpenMP-enabled
+ * builds it is spread across all cores the same way qsort_arg()
+ * parallelizes the subsequent sort. Doing it here instead of in
+ * build_next() keeps the per-tuple collection path short and
+ * makes a huge ALTER bounded by memory bandwidth rather than by
+ * one core.
+ */
+template <bool USE_HINT>
+static void
+memtx_tree_index_build_array_set_hints(struct memtx_tree_index<USE_HINT> *index,
+				       struct key_def *cmp_def)
+{
+	if (!USE_HINT)
+		return;
+	struct memtx_tree_data<USE_HINT> *arr = index->build_array;
+	ssize_t size = index->build_array_size;
+#ifdef HAVE_OPENMP
+#pragma omp parallel for if (size >= (ssize_t)BUILD_HINTS_MT_THRESHOLD)
+#endif
+	for (ssize_t i = 0; i < size; i++)
+		arr[i].set_hint(tuple_hint(arr[i].tuple, cmp_def));
+}
+
 /**
  * Process build_array of specified index and remove duplicates
  * of equal tuples (in terms of index's cmp_def and have same
@@ -1510,6 +1619,8 @@ memtx_tree_index_end_build(struct index *base)
 	struct memtx_tree_index<USE_HINT> *index =
 		(struct memtx_tree_index<USE_HINT> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	if (!cmp_def->is_multikey && !cmp_def->for_func_index)
+		memtx_tree_index_build_array_set_hints(index, cmp_def);
 	qsort_arg(index->build_array, index->build_array_size,
 		  sizeof(index->build_array[0]),
 		  memtx_tree_qcompare<USE_HINT>, cmp_def);
@@ -1811,6 +1922,8 @@ memtx_tree_index_new_tpl(struct memtx_engine *memtx, struct index_def *def,
 
 	memtx_tree_create(&index->tree, cmp_def, memtx_index_extent_alloc,
 			  memtx_index_extent_free, memtx);
+	/* An all-zero iterator is a valid position, reset explicitly. */
+	invalidate_tree_iterator(&index->resume_pos);
 	return &index->base;
 }
 
@@ -34,6 +34,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "fiber_cond.h"
 #include "txn.h"
 #include "schema_def.h"
 #include "small/mempool.h"
@@ -193,6 +194,12 @@ struct tx_manager
 	struct rlist all_stories;
 	/** Iterator that sequentially traverses all memtx_story objects. */
 	struct rlist *traverse_all_stories;
+	/** Number of story objects currently allocated. */
+	size_t story_count;
+	/** Background fiber that crawls and reclaims unused stories. */
+	struct fiber *gc_fiber;
+	/** Signaled when the story pool goes from empty to non-empty. */
+	struct fiber_cond gc_cond;
 };
 
 enum {
@@ -202,14 +209,30 @@ enum {
 	 * a new story.
 	 */
 		TX_MANAGER_GC_STEPS_SIZE = 2,
+	/**
+	 * Number of crawler steps the background GC fiber makes per
+	 * wakeup. Bounds how long the TX thread is occupied by story
+	 * reclamation in one go.
+	 */
+	TX_MANAGER_GC_BATCH_SIZE = 1024,
 };
 
+/**
+ * Interval between background GC batches while the pool is shallow
+ * or no story could be reclaimed in the last batch.
+ */
+static const double TX_MANAGER_GC_IDLE_INTERVAL = 0.1;
+
 /** That's a definition, see declaration for description. */
 bool memtx_tx_manager_use_mvcc_engine = false;
 
 /** The one and only instance of tx_manager. */
 static struct tx_manager txm;
 
+/** See definition for details */
+static int
+memtx_tx_gc_f(va_list va);
+
 void
 memtx_tx_manager_init()
 {
@@ -233,11 +256,18 @@ memtx_tx_manager_init()
 	txm.point_holes_size = 0;
 	rlist_create(&txm.all_stories);
 	txm.traverse_all_stories = &txm.all_stories;
+	txm.story_count = 0;
+	fiber_cond_create(&txm.gc_cond);
+	txm.gc_fiber = fiber_new("memtx.tx.gc", memtx_tx_gc_f);
+	if (txm.gc_fiber == NULL)
+		panic("failed to create memtx tx gc fiber");
+	fiber_start(txm.gc_fiber);
 }
 
 void
 memtx_tx_manager_free()
 {
+	fiber_cancel(txm.gc_fiber);
 	for (size_t i = 0; i < BOX_INDEX_MAX; i++)
 		mempool_destroy(&txm.memtx_tx_story_pool[i]);
 	mh_history_delete(txm.history);
@@ -317,6 +347,46 @@ memtx_tx_handle_conflict(struct txn *breaker, struct txn *victim)
 static void
 memtx_tx_story_gc_step();
 
+/**
+ * Background fiber that drains the story backlog in bounded batches.
+ * The crawler in memtx_tx_story_new() reclaims at most a couple of
+ * stories per created story, so when a long read view finishes and
+ * releases thousands of them at once the backlog would otherwise
+ * linger until enough new stories are created. This fiber sweeps it
+ * out of band: a batch per wakeup, back to back while it makes
+ * progress on a deep pool, at a relaxed pace otherwise, so no
+ * foreground request ever pays for the bulk reclamation.
+ */
+static int
+memtx_tx_gc_f(va_list va)
+{
+	(void)va;
+	while (!fiber_is_cancelled()) {
+		if (txm.story_count == 0) {
+			fiber_cond_wait(&txm.gc_cond);
+			continue;
+		}
+		size_t batch = txm.story_count < TX_MANAGER_GC_BATCH_SIZE ?
+			       txm.story_count : TX_MANAGER_GC_BATCH_SIZE;
+		size_t old_count = txm.story_count;
+		for (size_t i = 0; i < batch; i++)
+			memtx_tx_story_gc_step();
+		/*
+		 * Come back right away only if there is more to do and
+		 * the last batch actually freed something - remaining
+		 * stories may all be pinned by active transactions or
+		 * read views, and spinning on those would burn CPU for
+		 * nothing.
+		 */
+		if (txm.story_count < old_count &&
+		    txm.story_count >= TX_MANAGER_GC_BATCH_SIZE)
+			fiber_sleep(0);
+		else
+			fiber_sleep(TX_MANAGER_GC_IDLE_INTERVAL);
+	}
+	return 0;
+}
+
 /**
  * Create a new story and link it with the @a tuple.
  * @return story on success, NULL on error (diag is set).
@@ -354,6 +424,8 @@ memtx_tx_story_new(struct space *space, struct tuple *tuple)
 	tuple->is_dirty = true;
 	tuple_ref(tuple);
 
+	if (txm.story_count++ == 0)
+		fiber_cond_signal(&txm.gc_cond);
 	story->space = space;
 	story->index_count = index_count;
 	story->add_stmt = NULL;
@@ -398,6 +470,8 @@ memtx_tx_story_delete(struct memtx_story *story)
 
 	struct mempool *pool = &txm.memtx_tx_story_pool[story->index_count];
 	mempool_free(pool, story);
+	assert(txm.story_count > 0);
+	txm.story_count--;
 }
 
 /**
@@ -1880,7 +1954,7 @@ memtx_tx_track_gap_slow(struct txn *txn, struct space *space, uint32_t index,
  * Clean memtx_tx part of @a txm.
  */
 void
-memtx_tx_clean_txn(struct txn *txn)
+memtx_tx_clean_txn_slow(struct txn *txn)
 {
 	while (!rlist_empty(&txn->point_holes_list)) {
 		struct point_hole_item *object =
@@ -370,11 +370,24 @@ memtx_tx_index_invisible_count(struct txn *txn,
 	return memtx_tx_index_invisible_count_slow(txn, space, index);
 }
 
+/** Helper of memtx_tx_clean_txn. */
+void
+memtx_tx_clean_txn_slow(struct txn *txn);
+
 /**
  * Clean memtx_tx part of @a txm.
+ * Point hole and gap trackers exist only when the mvcc engine is
+ * enabled, so without it there is nothing to collect and the call
+ * is elided - txn_free() is on the critical path of every
+ * transaction and should not pay for unused mvcc bookkeeping.
  */
-void
-memtx_tx_clean_txn(struct txn *txn);
+static inline void
+memtx_tx_clean_txn(struct txn *txn)
+{
+	if (!memtx_tx_manager_use_mvcc_engine)
+		return;
+	memtx_tx_clean_txn_slow(txn);
+}
 
 /**
  * Notify manager tha an index is deleted and free data, save in index.
@@ -16,7 +16,9 @@
 #include "assoc.h"
 #include "diag.h"
 #include "fiber.h"
+#include "latch.h"
 #include "errinj.h"
+#include "coio_task.h"
 #include "module_cache.h"
 
 #include "box/error.h"
@@ -27,6 +29,15 @@
 
 static struct mh_strnptr_t *module_cache = NULL;
 
+/**
+ * Loading a dso involves a file copy and dlopen() which are
+ * offloaded to a worker thread, yielding the caller. The latch
+ * serializes loads so that concurrent requests for the same
+ * package can't both miss the cache and insert twice.
+ */
+static struct latch module_cache_latch =
+	LATCH_INITIALIZER(module_cache_latch);
+
 /**
  * Helpers for cache manipulations.
  */
@@ -278,6 +289,69 @@ module_attr_fill(struct module_attr *attr, struct stat *st)
 #endif
 }
 
+/**
+ * The blocking part of a module load: copy the dso and dlopen()
+ * the copy. Runs on a coio worker thread so that the tx event
+ * loop keeps serving requests while the kernel reads the library
+ * and the dynamic linker resolves its symbols. Note that this
+ * also means library constructors execute on the worker thread;
+ * modules were never allowed to call into box outside of their
+ * exported functions, so this is not a new restriction.
+ */
+static ssize_t
+module_dso_load_f(va_list ap)
+{
+	struct module *m = va_arg(ap, struct module *);
+	const char *source_path = va_arg(ap, const char *);
+	const char *load_name = va_arg(ap, const char *);
+	const char *dir_name = va_arg(ap, const char *);
+
+	struct stat st;
+	if (stat(source_path, &st) < 0) {
+		diag_set(SystemError, "failed to stat() module: %s",
+			 source_path);
+		return -1;
+	}
+	module_attr_fill(&m->attr, &st);
+
+	int source_fd = open(source_path, O_RDONLY);
+	if (source_fd < 0) {
+		diag_set(SystemError, "failed to open module %s "
+			 "file for reading", source_path);
+		return -1;
+	}
+	int dest_fd = open(load_name, O_WRONLY | O_CREAT | O_TRUNC,
+			   st.st_mode & 0777);
+	if (dest_fd < 0) {
+		diag_set(SystemError, "failed to open file %s "
+			 "for writing ", load_name);
+		close(source_fd);
+		return -1;
+	}
+
+	off_t ret = eio_sendfile_sync(dest_fd, source_fd, 0, st.st_size);
+	close(source_fd);
+	close(dest_fd);
+	if (ret != st.st_size) {
+		diag_set(SystemError, "failed to copy dso %s to %s",
+			 source_path, load_name);
+		return -1;
+	}
+
+	m->handle = dlopen(load_name, RTLD_NOW | RTLD_LOCAL);
+	if (unlink(load_name) != 0)
+		say_warn("failed to unlink dso link: %s", load_name);
+	if (rmdir(dir_name) != 0)
+		say_warn("failed to delete temporary dir: %s", dir_name);
+	if (m->handle == NULL) {
+		diag_set(ClientError, ER_LOAD_MODULE, m->package_len,
+			 m->package, dlerror());
+		return -1;
+	}
+
+	return 0;
+}
+
 /**
  * Copy shared library to temp directory and load from there,
  * then remove it from this temp place leaving in memory. This
@@ -332,48 +406,9 @@ module_new(const char *package, size_t package_len,
 		goto error;
 	}
 
-	struct stat st;
-	if (stat(source_path, &st) < 0) {
-		diag_set(SystemError, "failed to stat() module: %s",
-			 source_path);
-		goto error;
-	}
-	module_attr_fill(&m->attr, &st);
-
-	int source_fd = open(source_path, O_RDONLY);
-	if (source_fd < 0) {
-		diag_set(SystemError, "failed to open module %s "
-			 "file for reading", source_path);
-		goto error;
-	}
-	int dest_fd = open(load_name, O_WRONLY | O_CREAT | O_TRUNC,
-			   st.st_mode & 0777);
-	if (dest_fd < 0) {
-		diag_set(SystemError, "failed to open file %s "
-			 "for writing ", load_name);
-		close(source_fd);
-		goto error;
-	}
-
-	off_t ret = eio_sendfile_sync(dest_fd, source_fd, 0, st.st_size);
-	close(source_fd);
-	close(dest_fd);
-	if (ret != st.st_size) {
-		diag_set(SystemError, "failed to copy dso %s to %s",
-			 source_path, load_name);
+	if (coio_call(module_dso_load_f, m, source_path,
+		      load_name, dir_name) != 0)
 		goto error;
-	}
-
-	m->handle = dlopen(load_name, RTLD_NOW | RTLD_LOCAL);
-	if (unlink(load_name) != 0)
-		say_warn("failed to unlink dso link: %s", load_name);
-	if (rmdir(dir_name) != 0)
-		say_warn("failed to delete temporary dir: %s", dir_name);
-	if (m->handle == NULL) {
-		diag_set(ClientError, ER_LOAD_MODULE, package_len,
-			  package, dlerror());
-		goto error;
-	}
 
 	struct errinj *e = errinj(ERRINJ_DYN_MODULE_COUNT, ERRINJ_INT);
 	if (e != NULL)
@@ -396,9 +431,11 @@ module_load_force(const char *package, size_t package_len)
 	if (find_package(package, package_len, path, size) != 0)
 		return NULL;
 
+	latch_lock(&module_cache_latch);
+
 	struct module *m = module_new(package, package_len, path);
 	if (m == NULL)
-		return NULL;
+		goto out;
 
 	struct module *c = cache_find(package, package_len);
 	if (c != NULL) {
@@ -406,10 +443,12 @@ module_load_force(const char *package, size_t package_len)
 	} else {
 		if (cache_put(m) != 0) {
 			module_unload(m);
-			return NULL;
+			m = NULL;
 		}
 	}
 
+out:
+	latch_unlock(&module_cache_latch);
 	return m;
 }
 
@@ -421,13 +460,16 @@ module_load(const char *package, size_t package_len)
 	if (find_package(package, package_len, path, sizeof(path)) != 0)
 		return NULL;
 
+	latch_lock(&module_cache_latch);
+
 	struct module *m = cache_find(package, package_len);
 	if (m != NULL) {
 		struct module_attr attr;
 		struct stat st;
 		if (stat(path, &st) != 0) {
 			diag_set(SystemError, "failed to stat() %s", path);
-			return NULL;
+			m = NULL;
+			goto out;
 		}
 
 		/*
@@ -437,7 +479,7 @@ module_load(const char *package, size_t package_len)
 		module_attr_fill(&attr, &st);
 		if (memcmp(&attr, &m->attr, sizeof(attr)) == 0) {
 			module_ref(m);
-			return m;
+			goto out;
 		}
 
 		/*
@@ -454,10 +496,12 @@ module_load(const char *package, size_t package_len)
 		m = module_new(package, package_len, path);
 		if (m != NULL && cache_put(m) != 0) {
 			module_unload(m);
-			return NULL;
+			m = NULL;
 		}
 	}
 
+out:
+	latch_unlock(&module_cache_latch);
 	return m;
 }
 
@@ -30,7 +30,6 @@
  */
 #include "port.h"
 #include "tuple.h"
-#include "tuple_convert.h"
 #include <small/obuf.h>
 #include <small/slab_cache.h>
 #include <small/mempool.h>
@@ -38,15 +37,37 @@
 #include "errinj.h"
 
 /**
- * The pool is used by port_c to allocate entries and to store
- * result data when it fits into an object from the pool.
+ * The pool is used by port_c to store result data when it fits
+ * into an object from the pool.
  */
 static struct mempool port_entry_pool;
 
 enum {
 	PORT_ENTRY_SIZE = sizeof(struct port_c_entry),
+	/**
+	 * Number of entries carved from one block. Big enough to
+	 * make the per-entry allocation cost negligible for large
+	 * selects, small enough not to waste much memory on ports
+	 * with a couple of entries.
+	 */
+	PORT_ENTRY_BLOCK_COUNT = 16,
 };
 
+/**
+ * A batch of port entries obtained in one allocation. Entries of
+ * one block are handed out left to right, so a dump walks them
+ * sequentially in memory instead of hopping between individually
+ * allocated pool objects.
+ */
+struct port_c_entry_block {
+	/** Previously filled block, for destruction. */
+	struct port_c_entry_block *prev;
+	struct port_c_entry entries[PORT_ENTRY_BLOCK_COUNT];
+};
+
+/** The pool is used by port_c to allocate entry blocks. */
+static struct mempool port_entry_block_pool;
+
 static inline void
 port_c_destroy_entry(struct port_c_entry *pe)
 {
@@ -69,18 +90,18 @@ port_c_destroy(struct port *base)
 	struct port_c_entry *pe = port->first;
 	if (pe == NULL)
 		return;
-	port_c_destroy_entry(pe);
+	for (; pe != NULL; pe = pe->next)
+		port_c_destroy_entry(pe);
 	/*
-	 * Port->first is skipped, it is pointing at
-	 * port_c.first_entry, and is freed together with the
-	 * port.
+	 * The entries are freed block-wise. Port->first is not
+	 * freed at all - it is pointing at port_c.first_entry, and
+	 * goes away together with the port.
 	 */
-	pe = pe->next;
-	while (pe != NULL) {
-		struct port_c_entry *cur = pe;
-		pe = pe->next;
-		port_c_destroy_entry(cur);
-		mempool_free(&port_entry_pool, cur);
+	struct port_c_entry_block *block = port->blocks;
+	while (block != NULL) {
+		struct port_c_entry_block *prev = block->prev;
+		mempool_free(&port_entry_block_pool, block);
+		block = prev;
 	}
 }
 
@@ -93,11 +114,20 @@ port_c_new_entry(struct port_c *port)
 		port->first = e;
 		port->last = e;
 	} else {
-		e = mempool_alloc(&port_entry_pool);
-		if (e == NULL) {
-			diag_set(OutOfMemory, sizeof(*e), "mempool_alloc", "e");
-			return NULL;
+		struct port_c_entry_block *block = port->blocks;
+		if (block == NULL ||
+		    port->block_used == PORT_ENTRY_BLOCK_COUNT) {
+			block = mempool_alloc(&port_entry_block_pool);
+			if (block == NULL) {
+				diag_set(OutOfMemory, sizeof(*block),
+					 "mempool_alloc", "block");
+				return NULL;
+			}
+			block->prev = port->blocks;
+			port->blocks = block;
+			port->block_used = 0;
 		}
+		e = &block->entries[port->block_used++];
 		port->last->next = e;
 		port->last = e;
 	}
@@ -160,27 +190,68 @@ port_c_add_mp(struct port *base, const char *mp, const char *mp_end)
 	return -1;
 }
 
+/**
+ * Total size of the msgpack data stored in the port. Used to
+ * reserve the output space for a dump in one go.
+ */
+static size_t
+port_c_size_msgpack(struct port_c *port)
+{
+	size_t size = 0;
+	struct port_c_entry *pe;
+	for (pe = port->first; pe != NULL; pe = pe->next) {
+		if (pe->mp_size == 0) {
+			uint32_t bsize;
+			tuple_data_range(pe->tuple, &bsize);
+			size += bsize;
+		} else {
+			size += pe->mp_size;
+		}
+	}
+	return size;
+}
+
+size_t
+port_c_msgpack_size(struct port *base)
+{
+	return port_c_size_msgpack((struct port_c *)base);
+}
+
 static int
 port_c_dump_msgpack_16(struct port *base, struct obuf *out)
 {
 	struct port_c *port = (struct port_c *)base;
+	if (port->first == NULL)
+		return port->size;
+	/*
+	 * Reserve the whole response upfront: a large range scan
+	 * dumps thousands of entries, and going through obuf_dup()
+	 * for each of them both spends CPU on capacity checks and
+	 * chops the response into more iovecs than the net thread
+	 * needs to pass to writev().
+	 */
+	size_t total = port_c_size_msgpack(port);
+	char *data = obuf_reserve(out, total);
+	if (data == NULL) {
+		diag_set(OutOfMemory, total, "obuf_reserve", "data");
+		return -1;
+	}
 	struct port_c_entry *pe;
 	for (pe = port->first; pe != NULL; pe = pe->next) {
 		uint32_t size = pe->mp_size;
-		if (size == 0) {
-			if (tuple_to_obuf(pe->tuple, out) != 0)
-				return -1;
-		} else if (obuf_dup(out, pe->mp, size) != size) {
-			diag_set(OutOfMemory, size, "obuf_dup", "data");
-			return -1;
-		}
+		const char *mp;
+		if (size == 0)
+			mp = tuple_data_range(pe->tuple, &size);
+		else
+			mp = pe->mp;
+		memcpy(data, mp, size);
+		data += size;
 		ERROR_INJECT(ERRINJ_PORT_DUMP, {
-			diag_set(OutOfMemory,
-				 size == 0 ? tuple_size(pe->tuple) : size,
-				 "obuf_dup", "data");
+			diag_set(OutOfMemory, size, "obuf_dup", "data");
 			return -1;
 		});
 	}
+	obuf_alloc(out, total);
 	return port->size;
 }
 
@@ -224,16 +295,21 @@ port_c_create(struct port *base)
 	port->first = NULL;
 	port->last = NULL;
 	port->size = 0;
+	port->blocks = NULL;
+	port->block_used = 0;
 }
 
 void
 port_init(void)
 {
 	mempool_create(&port_entry_pool, &cord()->slabc, PORT_ENTRY_SIZE);
+	mempool_create(&port_entry_block_pool, &cord()->slabc,
+		       sizeof(struct port_c_entry_block));
 }
 
 void
 port_free(void)
 {
 	mempool_destroy(&port_entry_pool);
+	mempool_destroy(&port_entry_block_pool);
 }
@@ -41,6 +41,7 @@ extern "C" {
 struct tuple;
 
 extern const struct port_vtab port_c_vtab;
+extern const struct port_vtab port_msgpack_vtab;
 
 /** Port implementation used for storing raw data. */
 struct port_msgpack {
@@ -121,6 +122,8 @@ struct port_c_entry {
 	uint32_t mp_size;
 };
 
+struct port_c_entry_block;
+
 /**
  * C port is used by C functions from the public API. They can
  * return tuples and arbitrary MessagePack.
@@ -131,6 +134,15 @@ struct port_c {
 	struct port_c_entry *last;
 	struct port_c_entry first_entry;
 	int size;
+	/**
+	 * Blocks of batch-allocated entries, newest first. All
+	 * entries except the first one are carved from here, so
+	 * consecutive entries of one block are contiguous in
+	 * memory.
+	 */
+	struct port_c_entry_block *blocks;
+	/** Number of entries used in the newest block. */
+	int block_used;
 };
 
 static_assert(sizeof(struct port_c) <= sizeof(struct port),
@@ -148,6 +160,13 @@ port_c_add_tuple(struct port *port, struct tuple *tuple);
 int
 port_c_add_mp(struct port *port, const char *mp, const char *mp_end);
 
+/**
+ * Total size of the MessagePack stored in the port, i.e. how many
+ * bytes a dump would occupy, without dumping anything.
+ */
+size_t
+port_c_msgpack_size(struct port *port);
+
 void
 port_init(void);
 
@@ -233,6 +233,16 @@ box_raft_update_election_quorum(void)
 	 */
 	int quorum = MIN(replication_synchro_quorum, max);
 	raft_cfg_election_quorum(box_raft(), quorum);
+	box_raft_update_quorum_reachability();
+}
+
+void
+box_raft_update_quorum_reachability(void)
+{
+	/* The instance itself always counts towards the quorum. */
+	int reachable = replicaset.applier.connected + 1;
+	raft_cfg_is_quorum_reachable(box_raft(),
+				     reachable >= box_raft()->election_quorum);
 }
 
 void
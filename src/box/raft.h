@@ -75,6 +75,14 @@ box_raft(void)
 void
 box_raft_update_election_quorum(void);
 
+/**
+ * Let the global raft know whether enough peers are connected to gather an
+ * election quorum. Called on every applier connect and disconnect, so that an
+ * isolated node does not inflate the term with elections it can't win.
+ */
+void
+box_raft_update_quorum_reachability(void);
+
 /**
  * Recover a single Raft request. Raft state machine is not turned on yet, this
  * works only during instance recovery from the journal.
@@ -386,6 +386,15 @@ public:
 	unsigned events;
 	struct ev_stat dir_stat;
 	struct ev_stat file_stat;
+	/*
+	 * Polling interval of the stat watchers. Only matters on
+	 * filesystems without inotify support (e.g. shared network
+	 * storage, which is the typical hot standby setup): there
+	 * libev falls back to periodic stat() and would otherwise
+	 * use its own 5 second default instead of the configured
+	 * wal_dir_rescan_delay.
+	 */
+	ev_tstamp stat_interval;
 	char dir_path[PATH_MAX];
 	char file_path[PATH_MAX];
 
@@ -406,7 +415,8 @@ public:
 			fiber_wakeup(f);
 	}
 
-	WalSubscription(const char *wal_dir)
+	WalSubscription(const char *wal_dir, ev_tstamp stat_interval)
+		:stat_interval(stat_interval)
 	{
 		f = fiber();
 		events = 0;
@@ -416,12 +426,12 @@ public:
 			panic("path too long: %s", wal_dir);
 		}
 
-		ev_stat_init(&dir_stat, dir_stat_cb, "", 0.0);
-		ev_stat_init(&file_stat, file_stat_cb, "", 0.0);
+		ev_stat_init(&dir_stat, dir_stat_cb, "", stat_interval);
+		ev_stat_init(&file_stat, file_stat_cb, "", stat_interval);
 		dir_stat.data = this;
 		file_stat.data = this;
 
-		ev_stat_set(&dir_stat, dir_path, 0.0);
+		ev_stat_set(&dir_stat, dir_path, stat_interval);
 		ev_stat_start(loop(), &dir_stat);
 	}
 
@@ -453,7 +463,7 @@ public:
 
 			panic("path too long: %s", path);
 		}
-		ev_stat_set(&file_stat, file_path, 0.0);
+		ev_stat_set(&file_stat, file_path, stat_interval);
 		ev_stat_start(loop(), &file_stat);
 	}
 };
@@ -468,7 +478,7 @@ hot_standby_f(va_list ap)
 	ev_tstamp wal_dir_rescan_delay = va_arg(ap, ev_tstamp);
 	fiber_set_user(fiber(), &admin_credentials);
 
-	WalSubscription subscription(r->wal_dir.dirname);
+	WalSubscription subscription(r->wal_dir.dirname, wal_dir_rescan_delay);
 
 	while (! fiber_is_cancelled()) {
 
@@ -46,6 +46,7 @@
 #include "iproto_constants.h"
 #include "recovery.h"
 #include "replication.h"
+#include "schema_def.h"
 #include "trigger.h"
 #include "vclock/vclock.h"
 #include "version.h"
@@ -58,6 +59,14 @@
 
 #include <stdlib.h>
 
+enum {
+	/**
+	 * Max number of iovecs accumulated in relay->obuf before
+	 * a flush is forced regardless of transaction boundaries.
+	 */
+	RELAY_FLUSH_IOVMAX = 128,
+};
+
 /**
  * Cbus message to send status updates from relay to tx thread.
  */
@@ -132,6 +141,15 @@ struct relay {
 	 * is passed by the replica on subscribe.
 	 */
 	uint32_t id_filter;
+	/**
+	 * An array of space ids the replica subscribed to, or NULL
+	 * if the replica wants everything. Rows of other non-system
+	 * spaces are relayed as NOPs to keep the replica vclock
+	 * promoted. Passed by the replica on subscribe.
+	 */
+	uint32_t *space_filter;
+	/** Length of space_filter. */
+	uint32_t space_filter_count;
 	/**
 	 * How many rows has this relay sent to the replica. Used to yield once
 	 * in a while when reading a WAL to unblock the event loop.
@@ -158,6 +176,17 @@ struct relay {
 	struct stailq pending_gc;
 	/** Time when last row was sent to peer. */
 	double last_row_time;
+	/**
+	 * Rows encoded but not yet written to the socket. Rows of
+	 * a single WAL transaction are collected here and shipped
+	 * with one writev() on the commit row, see relay_push()
+	 * and relay_flush().
+	 */
+	struct iovec obuf[RELAY_FLUSH_IOVMAX];
+	/** Number of iovecs used in obuf. */
+	int obuf_iovcnt;
+	/** Total size of the buffered output, bytes. */
+	size_t obuf_size;
 	/** Relay sync state. */
 	enum relay_state state;
 
@@ -220,6 +249,8 @@ relay_last_row_time(const struct relay *relay)
 static void
 relay_send(struct relay *relay, struct xrow_header *packet);
 static void
+relay_flush(struct relay *relay);
+static void
 relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row);
 static void
 relay_send_row(struct xstream *stream, struct xrow_header *row);
@@ -283,6 +314,8 @@ relay_start(struct relay *relay, int fd, uint64_t sync,
 	relay->sync = sync;
 	relay->state = RELAY_FOLLOW;
 	relay->row_count = 0;
+	relay->obuf_iovcnt = 0;
+	relay->obuf_size = 0;
 	relay->last_row_time = ev_monotonic_now(loop());
 }
 
@@ -329,6 +362,9 @@ relay_stop(struct relay *relay)
 	if (relay->r != NULL)
 		recovery_delete(relay->r);
 	relay->r = NULL;
+	free(relay->space_filter);
+	relay->space_filter = NULL;
+	relay->space_filter_count = 0;
 	relay->state = RELAY_STOPPED;
 	/*
 	 * Needed to track whether relay thread is running or not
@@ -422,6 +458,7 @@ relay_final_join_f(va_list ap)
 	assert(relay->stream.write != NULL);
 	recover_remaining_wals(relay->r, &relay->stream,
 			       &relay->stop_vclock, true);
+	relay_flush(relay);
 	assert(vclock_compare(&relay->r->vclock, &relay->stop_vclock) == 0);
 	return 0;
 }
@@ -582,6 +619,50 @@ relay_set_error(struct relay *relay, struct error *e)
 		diag_set_error(&relay->diag, e);
 }
 
+/**
+ * Try to send the rows delivered with the WAL notification
+ * straight from memory, see wal_watcher_msg::buf. Returns true
+ * if the rows were served from the buffer and no disk read is
+ * needed, false if the caller has to fall back to scanning the
+ * WAL files: either no rows were buffered, or some were dropped
+ * on overflow, or the replica lags behind the buffer.
+ */
+static bool
+relay_process_mem_rows(struct relay *relay)
+{
+	const struct wal_watcher_buf *buf = relay->wal_watcher.msg.buf;
+	if (buf == NULL || buf->is_invalid)
+		return false;
+	struct recovery *r = relay->r;
+	/*
+	 * The buffer continues the WAL from its start vclock. If
+	 * the relay hasn't sent everything up to this point yet,
+	 * it must keep reading the older rows from the files.
+	 */
+	int cmp = vclock_compare(&buf->start_vclock, &r->vclock);
+	if (cmp != 0 && cmp != -1)
+		return false;
+	const char *pos = buf->data.rpos;
+	const char *end = buf->data.wpos;
+	while (pos < end) {
+		/* Rows are length-prefixed as on the wire. */
+		uint64_t len = mp_decode_uint(&pos);
+		const char *next = pos + len;
+		struct xrow_header row;
+		xrow_header_decode_xc(&row, &pos, next, true);
+		pos = next;
+		/*
+		 * The row may have been sent from disk already,
+		 * same check as in recover_xlog().
+		 */
+		if (row.lsn <= vclock_get(&r->vclock, row.replica_id))
+			continue;
+		vclock_follow_xrow(&r->vclock, &row);
+		xstream_write_xc(&relay->stream, &row);
+	}
+	return true;
+}
+
 static void
 relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 {
@@ -599,8 +680,16 @@ relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 		return;
 	}
 	try {
-		recover_remaining_wals(relay->r, &relay->stream, NULL,
-				       (events & WAL_EVENT_ROTATE) != 0);
+		/*
+		 * Serving from memory advances relay->r->vclock, so
+		 * even when a WAL scan is still needed - e.g. on
+		 * rotation - it skips the rows sent here.
+		 */
+		bool is_fed = relay_process_mem_rows(relay);
+		if (!is_fed || (events & WAL_EVENT_ROTATE) != 0)
+			recover_remaining_wals(relay->r, &relay->stream, NULL,
+					       (events & WAL_EVENT_ROTATE) != 0);
+		relay_flush(relay);
 	} catch (Exception *e) {
 		relay_set_error(relay, e);
 		fiber_cancel(fiber());
@@ -775,7 +864,7 @@ relay_subscribe_f(va_list ap)
 
 	/* Setup WAL watcher for sending new rows to the replica. */
 	wal_set_watcher(&relay->wal_watcher, relay->endpoint.name,
-			relay_process_wal_event, cbus_process);
+			relay_process_wal_event, cbus_process, true);
 
 	/* Start fiber for receiving replica acks. */
 	char name[FIBER_NAME_MAX];
@@ -880,7 +969,9 @@ relay_subscribe_f(va_list ap)
 void
 relay_subscribe(struct replica *replica, int fd, uint64_t sync,
 		struct vclock *replica_clock, uint32_t replica_version_id,
-		uint32_t replica_id_filter)
+		uint32_t replica_id_filter,
+		const uint32_t *replica_space_filter,
+		uint32_t replica_space_filter_count)
 {
 	assert(replica->anon || replica->id != REPLICA_ID_NIL);
 	struct relay *relay = replica->relay;
@@ -916,6 +1007,16 @@ relay_subscribe(struct replica *replica, int fd, uint64_t sync,
 	relay->version_id = replica_version_id;
 
 	relay->id_filter = replica_id_filter;
+	assert(relay->space_filter == NULL);
+	if (replica_space_filter_count != 0) {
+		size_t size = replica_space_filter_count *
+			      sizeof(*relay->space_filter);
+		relay->space_filter = (uint32_t *) malloc(size);
+		if (relay->space_filter == NULL)
+			tnt_raise(OutOfMemory, size, "malloc", "space_filter");
+		memcpy(relay->space_filter, replica_space_filter, size);
+		relay->space_filter_count = replica_space_filter_count;
+	}
 
 	int rc = cord_costart(&relay->cord, "subscribe",
 			      relay_subscribe_f, relay);
@@ -925,14 +1026,19 @@ relay_subscribe(struct replica *replica, int fd, uint64_t sync,
 		diag_raise();
 }
 
+/** Write out the rows accumulated by relay_push(), if any. */
 static void
-relay_send(struct relay *relay, struct xrow_header *packet)
+relay_flush(struct relay *relay)
 {
+	if (relay->obuf_iovcnt == 0)
+		return;
 	ERROR_INJECT_YIELD(ERRINJ_RELAY_SEND_DELAY);
 
-	packet->sync = relay->sync;
 	relay->last_row_time = ev_monotonic_now(loop());
-	coio_write_xrow(&relay->io, packet);
+	coio_writev(&relay->io, relay->obuf, relay->obuf_iovcnt,
+		    relay->obuf_size);
+	relay->obuf_iovcnt = 0;
+	relay->obuf_size = 0;
 	fiber_gc();
 
 	struct errinj *inj = errinj(ERRINJ_RELAY_TIMEOUT, ERRINJ_DOUBLE);
@@ -940,6 +1046,50 @@ relay_send(struct relay *relay, struct xrow_header *packet)
 		fiber_sleep(inj->dparam);
 }
 
+/**
+ * Encode a row and append it to the output buffer without
+ * writing it to the socket yet. Sending a multi-row transaction
+ * row by row pays a syscall per row; batching up to the commit
+ * row cuts that to one writev() per transaction.
+ */
+static void
+relay_push(struct relay *relay, struct xrow_header *packet)
+{
+	if (relay->obuf_iovcnt + XROW_IOVMAX > RELAY_FLUSH_IOVMAX)
+		relay_flush(relay);
+
+	packet->sync = relay->sync;
+	struct iovec iov[XROW_IOVMAX];
+	int iovcnt = xrow_to_iovec_xc(packet, iov);
+	/*
+	 * The row body points into the xlog cursor buffer, which
+	 * may be reused before the batch is flushed. The header is
+	 * already encoded on the fiber region, which lives until
+	 * the fiber_gc() in relay_flush(), so copy the body there
+	 * as well.
+	 */
+	for (int i = 1; i < iovcnt; i++) {
+		void *copy = region_alloc(&fiber()->gc, iov[i].iov_len);
+		if (copy == NULL) {
+			tnt_raise(OutOfMemory, iov[i].iov_len, "region_alloc",
+				  "row body");
+		}
+		memcpy(copy, iov[i].iov_base, iov[i].iov_len);
+		iov[i].iov_base = copy;
+	}
+	for (int i = 0; i < iovcnt; i++) {
+		relay->obuf[relay->obuf_iovcnt++] = iov[i];
+		relay->obuf_size += iov[i].iov_len;
+	}
+}
+
+static void
+relay_send(struct relay *relay, struct xrow_header *packet)
+{
+	relay_push(relay, packet);
+	relay_flush(relay);
+}
+
 static void
 relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row)
 {
@@ -1047,6 +1197,48 @@ relay_push_raft(struct relay *relay, const struct raft_request *req)
 	relay_push_raft_msg(relay);
 }
 
+/**
+ * Extract the space id from a DML row body without decoding the
+ * whole request. The body comes from the local WAL, so it is
+ * valid MessagePack.
+ * @retval 0 Success, @a space_id is set.
+ * @retval -1 The body carries no space id.
+ */
+static int
+relay_row_space_id(const struct xrow_header *row, uint32_t *space_id)
+{
+	assert(row->bodycnt == 1);
+	const char *d = (const char *) row->body[0].iov_base;
+	if (mp_typeof(*d) != MP_MAP)
+		return -1;
+	uint32_t map_size = mp_decode_map(&d);
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(*d) != MP_UINT) {
+			mp_next(&d); /* key */
+			mp_next(&d); /* value */
+			continue;
+		}
+		uint64_t key = mp_decode_uint(&d);
+		if (key == IPROTO_SPACE_ID) {
+			*space_id = mp_decode_uint(&d);
+			return 0;
+		}
+		mp_next(&d); /* value */
+	}
+	return -1;
+}
+
+/** True if the replica subscribed to rows of the given space. */
+static bool
+relay_space_filter_match(const struct relay *relay, uint32_t space_id)
+{
+	for (uint32_t i = 0; i < relay->space_filter_count; i++) {
+		if (relay->space_filter[i] == space_id)
+			return true;
+	}
+	return false;
+}
+
 /** Send a single row to the client. */
 static void
 relay_send_row(struct xstream *stream, struct xrow_header *packet)
@@ -1068,6 +1260,24 @@ relay_send_row(struct xstream *stream, struct xrow_header *packet)
 		packet->group_id = GROUP_DEFAULT;
 		packet->bodycnt = 0;
 	}
+	/*
+	 * Turn rows of spaces the replica did not subscribe to
+	 * into NOPs. The rows can't be dropped altogether: the
+	 * replica still needs them to promote its vclock, or it
+	 * would re-request the skipped range on every resubscribe.
+	 * System spaces are always relayed, since the replica
+	 * can't keep its schema in sync without them.
+	 */
+	if (relay->space_filter_count != 0 &&
+	    iproto_type_is_dml(packet->type) && packet->bodycnt == 1) {
+		uint32_t space_id;
+		if (relay_row_space_id(packet, &space_id) == 0 &&
+		    space_id > BOX_SYSTEM_ID_MAX &&
+		    !relay_space_filter_match(relay, space_id)) {
+			packet->type = IPROTO_NOP;
+			packet->bodycnt = 0;
+		}
+	}
 	assert(iproto_type_is_dml(packet->type) ||
 	       iproto_type_is_synchro_request(packet->type));
 	/* Check if the rows from the instance are filtered. */
@@ -1097,6 +1307,15 @@ relay_send_row(struct xstream *stream, struct xrow_header *packet)
 			say_warn("injected broken lsn: %lld",
 				 (long long) packet->lsn);
 		}
-		relay_send(relay, packet);
+		/*
+		 * Accumulate rows of a multi-statement transaction
+		 * and write them out with a single writev() on the
+		 * commit row. The flush in relay_process_wal_event()
+		 * picks up whatever is left when a commit row gets
+		 * filtered out above.
+		 */
+		relay_push(relay, packet);
+		if (packet->is_commit)
+			relay_flush(relay);
 	}
 }
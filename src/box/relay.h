@@ -132,6 +132,8 @@ relay_final_join(int fd, uint64_t sync, struct vclock *start_vclock,
 void
 relay_subscribe(struct replica *replica, int fd, uint64_t sync,
 		struct vclock *replica_vclock, uint32_t replica_version_id,
-		uint32_t replica_id_filter);
+		uint32_t replica_id_filter,
+		const uint32_t *replica_space_filter,
+		uint32_t replica_space_filter_count);
 
 #endif /* TARANTOOL_REPLICATION_RELAY_H_INCLUDED */
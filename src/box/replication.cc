@@ -56,6 +56,8 @@ double replication_synchro_timeout = 5.0; /* seconds */
 double replication_sync_timeout = 300.0; /* seconds */
 bool replication_skip_conflict = false;
 bool replication_anon = false;
+uint32_t *replication_space_filter = NULL;
+uint32_t replication_space_filter_count = 0;
 
 struct replicaset replicaset;
 
@@ -349,6 +351,7 @@ replica_on_applier_connect(struct replica *replica)
 	replica->anon = applier->ballot.is_anon;
 	replica->applier_sync_state = APPLIER_CONNECTED;
 	replicaset.applier.connected++;
+	box_raft_update_quorum_reachability();
 
 	struct replica *orig = replica_hash_search(&replicaset.hash, replica);
 	if (orig != NULL && orig->applier != NULL) {
@@ -424,6 +427,7 @@ replica_on_applier_reconnect(struct replica *replica)
 
 	replica->applier_sync_state = APPLIER_CONNECTED;
 	replicaset.applier.connected++;
+	box_raft_update_quorum_reachability();
 }
 
 static void
@@ -450,6 +454,7 @@ replica_on_applier_disconnect(struct replica *replica)
 	replica->applier_sync_state = replica->applier->state;
 	if (replica->applier_sync_state == APPLIER_LOADING)
 		replicaset.applier.loading++;
+	box_raft_update_quorum_reachability();
 }
 
 static int
@@ -608,6 +613,7 @@ replicaset_update(struct applier **appliers, int count)
 		replicaset.applier.connected++;
 	}
 	rlist_swap(&replicaset.anon, &anon_replicas);
+	box_raft_update_quorum_reachability();
 
 	assert(replica_hash_first(&uniq) == NULL);
 	replica_hash_foreach_safe(&replicaset.hash, replica, next) {
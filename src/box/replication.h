@@ -155,6 +155,17 @@ extern bool replication_skip_conflict;
  */
 extern bool replication_anon;
 
+/**
+ * An array of space ids this replica subscribes to, sent to the
+ * master in SUBSCRIBE. The master relays rows of all other
+ * non-system spaces as NOPs. NULL means no filtering: relay
+ * everything.
+ */
+extern uint32_t *replication_space_filter;
+
+/** Length of replication_space_filter. */
+extern uint32_t replication_space_filter_count;
+
 /**
  * Wait for the given period of time before trying to reconnect
  * to a master.
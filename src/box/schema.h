@@ -33,6 +33,7 @@
 
 #include <stdint.h>
 #include <stdio.h> /* snprintf */
+#include <string.h> /* memset */
 #include "error.h"
 #include "space.h"
 
@@ -71,14 +72,28 @@ box_schema_version(void);
 static inline struct space *
 space_cache_find(uint32_t id)
 {
+	/*
+	 * A tiny direct-mapped cache in front of the spaces hash.
+	 * A request touches few distinct spaces, but they often
+	 * alternate (space plus its sequence, several spaces in a
+	 * transaction), which a single memoized pointer misses
+	 * while the hash lookup costs several dependent loads.
+	 * The cache is flushed wholesale on any schema change,
+	 * like the old one-element memoization was.
+	 */
+	enum { SPACE_CACHE_SIZE = 16 };
 	static uint32_t prev_space_cache_version = 0;
-	static struct space *space = NULL;
-	if (prev_space_cache_version != space_cache_version)
-		space = NULL;
-	if (space && space->def->id == id)
+	static struct space *entries[SPACE_CACHE_SIZE];
+	if (prev_space_cache_version != space_cache_version) {
+		memset(entries, 0, sizeof(entries));
+		prev_space_cache_version = space_cache_version;
+	}
+	struct space **entry = &entries[id % SPACE_CACHE_SIZE];
+	struct space *space = *entry;
+	if (space != NULL && space->def->id == id)
 		return space;
 	if ((space = space_by_id(id))) {
-		prev_space_cache_version = space_cache_version;
+		*entry = space;
 		return space;
 	}
 	diag_set(ClientError, ER_NO_SUCH_SPACE, int2str(id));
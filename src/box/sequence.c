@@ -151,6 +151,7 @@ sequence_delete(struct sequence *seq)
 void
 sequence_reset(struct sequence *seq)
 {
+	seq->cache_remaining = 0;
 	uint32_t key = seq->def->id;
 	uint32_t hash = sequence_hash(key);
 	uint32_t pos = light_sequence_find_key(&sequence_data_index, hash, key);
@@ -161,6 +162,14 @@ sequence_reset(struct sequence *seq)
 int
 sequence_set(struct sequence *seq, int64_t value)
 {
+	/*
+	 * Keep the cached block if the assignment merely mirrors
+	 * its leased end - that is the _sequence_data row written
+	 * by box_sequence_next() when the block was taken out. Any
+	 * other value makes the cached tail stale.
+	 */
+	if (seq->cache_remaining > 0 && value != sequence_leased_end(seq))
+		seq->cache_remaining = 0;
 	uint32_t key = seq->def->id;
 	uint32_t hash = sequence_hash(key);
 	struct sequence_data new_data, old_data;
@@ -178,6 +187,13 @@ sequence_set(struct sequence *seq, int64_t value)
 int
 sequence_update(struct sequence *seq, int64_t value)
 {
+	/*
+	 * An explicitly supplied value may land inside the leased
+	 * block. Discard the rest of the block so that no cached
+	 * value below it is ever served - the skipped values are
+	 * just one more gap a cached sequence is allowed to leave.
+	 */
+	seq->cache_remaining = 0;
 	uint32_t key = seq->def->id;
 	uint32_t hash = sequence_hash(key);
 	uint32_t pos = light_sequence_find_key(&sequence_data_index, hash, key);
@@ -200,23 +216,58 @@ sequence_update(struct sequence *seq, int64_t value)
 	return 0;
 }
 
+/**
+ * Number of values after @a value that can be leased to the cache
+ * of a sequence: limited by the configured cache size and by how
+ * many steps fit before the sequence boundary. The arithmetic is
+ * done in unsigned to be immune to int64 overflow on extreme
+ * min/max settings.
+ */
+static int64_t
+sequence_cache_lease(struct sequence_def *def, int64_t value)
+{
+	if (def->cache <= 1)
+		return 0;
+	uint64_t room, ustep;
+	if (def->step > 0) {
+		room = (uint64_t)def->max - (uint64_t)value;
+		ustep = (uint64_t)def->step;
+	} else {
+		room = (uint64_t)value - (uint64_t)def->min;
+		ustep = -(uint64_t)def->step;
+	}
+	uint64_t extra = room / ustep;
+	if (extra > (uint64_t)(def->cache - 1))
+		extra = (uint64_t)(def->cache - 1);
+	return (int64_t)extra;
+}
+
 int
 sequence_next(struct sequence *seq, int64_t *result)
 {
 	int64_t value;
+	int64_t extra;
 	struct sequence_def *def = seq->def;
 	struct sequence_data new_data, old_data;
+	if (seq->cache_remaining > 0) {
+		/* Serve from the block leased in advance. */
+		*result = seq->cached_next;
+		seq->cached_next += def->step;
+		seq->cache_remaining--;
+		return 0;
+	}
 	uint32_t key = seq->def->id;
 	uint32_t hash = sequence_hash(key);
 	uint32_t pos = light_sequence_find_key(&sequence_data_index, hash, key);
 	if (pos == light_sequence_end) {
+		value = def->start;
+		extra = sequence_cache_lease(def, value);
 		new_data.id = key;
-		new_data.value = def->start;
+		new_data.value = value + def->step * extra;
 		if (light_sequence_insert(&sequence_data_index, hash,
 					  new_data) == light_sequence_end)
 			return -1;
-		*result = def->start;
-		return 0;
+		goto cache;
 	}
 	old_data = light_sequence_get(&sequence_data_index, pos);
 	value = old_data.value;
@@ -244,11 +295,23 @@ sequence_next(struct sequence *seq, int64_t *result)
 	}
 done:
 	assert(value >= def->min && value <= def->max);
+	/*
+	 * Persist the end of the leased block instead of the value
+	 * being served, so the following def->cache - 1 calls need
+	 * no hash access at all. A snapshot taken meanwhile records
+	 * the block end, hence the gap a restart may leave.
+	 */
+	extra = sequence_cache_lease(def, value);
 	new_data.id = key;
-	new_data.value = value;
+	new_data.value = value + def->step * extra;
 	if (light_sequence_replace(&sequence_data_index, hash,
 				   new_data, &old_data) == light_sequence_end)
 		unreachable();
+cache:
+	if (extra > 0) {
+		seq->cached_next = value + def->step;
+		seq->cache_remaining = extra;
+	}
 	*result = value;
 	return 0;
 overflow:
@@ -370,6 +433,15 @@ sequence_data_iterator_create(void)
 int
 sequence_get_value(struct sequence *seq, int64_t *result)
 {
+	if (seq->cache_remaining > 0) {
+		/*
+		 * The hash stores the end of the leased block, not
+		 * the last value actually served - report the
+		 * latter.
+		 */
+		*result = seq->cached_next - seq->def->step;
+		return 0;
+	}
 	uint32_t key = seq->def->id;
 	uint32_t hash = sequence_hash(key);
 	uint32_t pos = light_sequence_find_key(&sequence_data_index, hash, key);
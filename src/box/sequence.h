@@ -64,7 +64,12 @@ struct sequence_def {
 	int64_t max;
 	/** Initial sequence value. */
 	int64_t start;
-	/** Number of values to preallocate. Not implemented yet. */
+	/**
+	 * Number of values to lease per update of the persistent
+	 * sequence state. Values <= 1 disable caching. Cached
+	 * values not consumed before a restart are lost, i.e. a
+	 * cached sequence may leave gaps.
+	 */
 	int64_t cache;
 	/**
 	 * If this flag is set, the sequence will wrap
@@ -80,6 +85,13 @@ struct sequence_def {
 struct sequence {
 	/** Sequence definition. */
 	struct sequence_def *def;
+	/**
+	 * Next value to serve from the block leased in advance
+	 * when def->cache > 1. Valid iff cache_remaining > 0.
+	 */
+	int64_t cached_next;
+	/** Number of values left in the leased block. */
+	int64_t cache_remaining;
 	/** Set if the sequence is automatically generated. */
 	bool is_generated;
 	/** Cached runtime access information. */
@@ -92,6 +104,18 @@ sequence_def_sizeof(uint32_t name_len)
 	return sizeof(struct sequence_def) + name_len + 1;
 }
 
+/**
+ * End of the currently leased cache block, i.e. the value up to
+ * which the sequence state is persisted. May be called only when
+ * a block is active.
+ */
+static inline int64_t
+sequence_leased_end(struct sequence *seq)
+{
+	assert(seq->cache_remaining > 0);
+	return seq->cached_next + (seq->cache_remaining - 1) * seq->def->step;
+}
+
 /** Init sequence subsystem. */
 void
 sequence_init(void);
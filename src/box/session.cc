@@ -142,6 +142,7 @@ session_create(enum session_type type)
 	session->sql_flags = default_flags;
 	session->sql_default_engine = SQL_STORAGE_ENGINE_MEMTX;
 	session->sql_stmts = NULL;
+	memset(session->func_cache, 0, sizeof(session->func_cache));
 
 	/* For on_connect triggers. */
 	credentials_create(&session->credentials, guest_user);
@@ -44,6 +44,7 @@ extern "C" {
 
 struct port;
 struct session_vtab;
+struct func;
 
 void
 session_init(void);
@@ -93,6 +94,33 @@ struct session_meta {
 	struct serializer_opts serializer_opts;
 };
 
+enum {
+	/** Number of slots in the session CALL target cache. */
+	SESSION_FUNC_CACHE_SIZE = 8,
+	/**
+	 * The longest function name the cache can hold. Longer
+	 * names go through the schema hash on every call.
+	 */
+	SESSION_FUNC_CACHE_NAME_MAX = 63,
+};
+
+/**
+ * A slot of the per-session cache of resolved CALL targets. A
+ * slot is trusted only while its schema version matches the
+ * global one: any DDL bumps the version and thereby invalidates
+ * the whole cache, including slots whose function was dropped.
+ */
+struct session_func_cache_entry {
+	/** Schema version the function was resolved under. */
+	uint32_t schema_version;
+	/** Length of name. 0 means the slot is empty. */
+	uint32_t name_len;
+	/** The resolved function. */
+	struct func *func;
+	/** The function name, not zero-terminated. */
+	char name[SESSION_FUNC_CACHE_NAME_MAX];
+};
+
 /**
  * Abstraction of a single user session:
  * for now, only provides accounting of established
@@ -119,6 +147,11 @@ struct session {
 	 * This map is allocated on demand.
 	 */
 	struct mh_i32ptr_t *sql_stmts;
+	/**
+	 * Cache of CALL targets resolved in this session, see
+	 * box_process_call().
+	 */
+	struct session_func_cache_entry func_cache[SESSION_FUNC_CACHE_SIZE];
 	/** Session user id and global grants */
 	struct credentials credentials;
 	/** Trigger for fiber on_stop to cleanup created on-demand session */
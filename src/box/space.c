@@ -49,6 +49,37 @@
 #include "assoc.h"
 #include "constraint_id.h"
 
+/**
+ * Report a space access violation. Kept out of line so that the
+ * hot body of access_check_space() stays a handful of mask reads.
+ */
+static NOINLINE int
+access_check_space_denied(struct space *space, user_access_t access,
+			  struct credentials *cr)
+{
+	/*
+	 * Report access violation. Throw "no such user"
+	 * error if there is no user with this id.
+	 * It is possible that the user was dropped
+	 * from a different connection.
+	 */
+	struct user *user = user_find(cr->uid);
+	if (user != NULL) {
+		if (!(cr->universal_access & PRIV_U)) {
+			diag_set(AccessDeniedError,
+				 priv_name(PRIV_U),
+				 schema_object_name(SC_UNIVERSE), "",
+				 user->def->name);
+		} else {
+			diag_set(AccessDeniedError,
+				 priv_name(access),
+				 schema_object_name(SC_SPACE),
+				 space->def->name, user->def->name);
+		}
+	}
+	return -1;
+}
+
 int
 access_check_space(struct space *space, user_access_t access)
 {
@@ -69,34 +100,13 @@ access_check_space(struct space *space, user_access_t access)
 	 */
 	space_access &= ~entity_access_get(SC_SPACE)[cr->auth_token].effective;
 
-	if (space_access &&
+	if (unlikely(space_access &&
 	    /* Check for missing USAGE access, ignore owner rights. */
 	    (space_access & PRIV_U ||
 	     /* Check for missing specific access, respect owner rights. */
 	    (space->def->uid != cr->uid &&
-	     space_access & ~space->access[cr->auth_token].effective))) {
-		/*
-		 * Report access violation. Throw "no such user"
-		 * error if there is no user with this id.
-		 * It is possible that the user was dropped
-		 * from a different connection.
-		 */
-		struct user *user = user_find(cr->uid);
-		if (user != NULL) {
-			if (!(cr->universal_access & PRIV_U)) {
-				diag_set(AccessDeniedError,
-					 priv_name(PRIV_U),
-					 schema_object_name(SC_UNIVERSE), "",
-					 user->def->name);
-			} else {
-				diag_set(AccessDeniedError,
-					 priv_name(access),
-					 schema_object_name(SC_SPACE),
-					 space->def->name, user->def->name);
-			}
-		}
-		return -1;
-	}
+	     space_access & ~space->access[cr->auth_token].effective))))
+		return access_check_space_denied(space, access, cr);
 	return 0;
 }
 
@@ -269,6 +269,13 @@ space_is_temporary(struct space *space)
 	return space->def->opts.is_temporary;
 }
 
+/** Return true if space changes are not written to the WAL. */
+static inline bool
+space_is_nolog(struct space *space)
+{
+	return space->def->opts.is_nolog;
+}
+
 /** Return replication group id of a space. */
 static inline uint32_t
 space_group_id(struct space *space)
@@ -36,12 +36,17 @@
 #include "msgpuck.h"
 #include "tt_static.h"
 
+const char *conflict_resolution_strs[] = {"none", "lww", "max", "min"};
+
 const struct space_opts space_opts_default = {
 	/* .group_id = */ 0,
 	/* .is_temporary = */ false,
 	/* .is_ephemeral = */ false,
 	/* .view = */ false,
 	/* .is_sync = */ false,
+	/* .is_nolog = */ false,
+	/* .conflict_resolution = */ CONFLICT_RESOLUTION_NONE,
+	/* .conflict_field = */ 0,
 	/* .sql        = */ NULL,
 };
 
@@ -50,6 +55,11 @@ const struct opt_def space_opts_reg[] = {
 	OPT_DEF("temporary", OPT_BOOL, struct space_opts, is_temporary),
 	OPT_DEF("view", OPT_BOOL, struct space_opts, is_view),
 	OPT_DEF("is_sync", OPT_BOOL, struct space_opts, is_sync),
+	OPT_DEF("nolog", OPT_BOOL, struct space_opts, is_nolog),
+	OPT_DEF_ENUM("conflict_resolution", conflict_resolution,
+		     struct space_opts, conflict_resolution, NULL),
+	OPT_DEF("conflict_field", OPT_UINT32, struct space_opts,
+		conflict_field),
 	OPT_DEF("sql", OPT_STRPTR, struct space_opts, sql),
 	OPT_DEF_LEGACY("checks"),
 	OPT_END,
@@ -41,6 +41,32 @@ extern "C" {
 #endif /* defined(__cplusplus) */
 
 /** Space options */
+/**
+ * Policies for resolving replication conflicts on a space
+ * natively in the applier. Used in master-master setups, where
+ * a replicated INSERT may find the key already occupied by a
+ * different tuple.
+ */
+enum conflict_resolution {
+	/**
+	 * No native policy: a conflict is an error, unless
+	 * handled by user triggers or replication_skip_conflict.
+	 */
+	CONFLICT_RESOLUTION_NONE = 0,
+	/**
+	 * Last write wins: the tuple with the greater value in
+	 * the resolution field (a timestamp) is kept.
+	 */
+	CONFLICT_RESOLUTION_LWW,
+	/** The tuple with the greater resolution field is kept. */
+	CONFLICT_RESOLUTION_MAX,
+	/** The tuple with the smaller resolution field is kept. */
+	CONFLICT_RESOLUTION_MIN,
+	conflict_resolution_MAX,
+};
+
+extern const char *conflict_resolution_strs[];
+
 struct space_opts {
 	/**
 	 * Replication group identifier. Defines how changes
@@ -73,6 +99,25 @@ struct space_opts {
 	 * until replicated to a quorum of replicas.
 	 */
 	bool is_sync;
+	/**
+	 * A nolog space has relaxed durability: its changes are
+	 * applied to memory but never written to the WAL, so they
+	 * don't survive a restart beyond the last checkpoint and
+	 * are not replicated. Unlike a temporary space, its
+	 * contents are a part of a snapshot. Suitable for caches.
+	 */
+	bool is_nolog;
+	/**
+	 * How the applier resolves replication conflicts on this
+	 * space, see enum conflict_resolution.
+	 */
+	enum conflict_resolution conflict_resolution;
+	/**
+	 * 0-based number of the field the resolution policy
+	 * compares: a timestamp for "lww", a counter for
+	 * "max"/"min".
+	 */
+	uint32_t conflict_field;
 	/** SQL statement that produced this space. */
 	char *sql;
 };
@@ -337,13 +337,27 @@ sql_ephemeral_space_create(uint32_t field_count, struct sql_key_info *key_info)
 		      "alignment");
 	char *names = (char *)ephemer_key_parts +
 		       part_count * sizeof(struct key_part_def);
+	bool is_pk_rowid = key_info != NULL && key_info->is_pk_rowid;
 	for (uint32_t i = 0; i < field_count; ++i) {
 		struct field_def *field = &fields[i];
 		field->name = names;
 		names += name_len;
 		sprintf(field->name, "_COLUMN_%d", i);
-		field->is_nullable = true;
-		field->nullable_action = ON_CONFLICT_ACTION_NONE;
+		/*
+		 * The rowid column is generated by
+		 * OP_NextIdEphemeral and can never be NULL.
+		 * Keeping it non-nullable lets key_def_new()
+		 * choose the non-nullable comparators for the
+		 * rowid-keyed ephemeral spaces instead of the
+		 * generic NULL-aware ones.
+		 */
+		if (is_pk_rowid && i == field_count - 1) {
+			field->is_nullable = false;
+			field->nullable_action = ON_CONFLICT_ACTION_ABORT;
+		} else {
+			field->is_nullable = true;
+			field->nullable_action = ON_CONFLICT_ACTION_NONE;
+		}
 		field->default_value = NULL;
 		field->default_value_expr = NULL;
 		if (def != NULL && i < def->part_count) {
@@ -365,11 +379,12 @@ sql_ephemeral_space_create(uint32_t field_count, struct sql_key_info *key_info)
 		 * a rowid, it is always the last column.
 		 */
 		uint32_t j = i;
-		if (key_info != NULL && key_info->is_pk_rowid)
+		if (is_pk_rowid)
 			j = field_count - 1;
 		part->fieldno = j;
-		part->nullable_action = ON_CONFLICT_ACTION_NONE;
-		part->is_nullable = true;
+		part->nullable_action = is_pk_rowid ?
+			ON_CONFLICT_ACTION_ABORT : ON_CONFLICT_ACTION_NONE;
+		part->is_nullable = !is_pk_rowid;
 		part->exclude_null = false;
 		part->sort_order = SORT_ORDER_ASC;
 		part->path = NULL;
@@ -760,7 +775,8 @@ tarantoolsqlIdxKeyCompare(struct BtCursor *cursor,
 				uint32_t field_offset =
 					field_map_get_offset(field_map,
 							     field->offset_slot,
-							     MULTIKEY_NONE);
+							     MULTIKEY_NONE,
+							     tuple_is_compact(tuple));
 				p = base + field_offset;
 			}
 		}
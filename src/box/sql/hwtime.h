@@ -38,11 +38,13 @@
 #define SQL_HWTIME_H
 
 /*
- * The following routine only works on pentium-class (or newer) processors.
- * It uses the RDTSC opcode to read the cycle count value out of the
- * processor and returns that value.  This can be used for high-res
- * profiling.
+ * The following routines only work on pentium-class (or newer)
+ * processors.  They use the RDTSC opcode to read the cycle count
+ * value out of the processor and return that value.  This can be
+ * used for high-res profiling.
  */
+#if defined(__i386__)
+
 __inline__ sql_uint64
 sqlHwtime(void)
 {
@@ -51,4 +53,38 @@ sqlHwtime(void)
 	return val;
 }
 
+#elif defined(__x86_64__)
+
+__inline__ sql_uint64
+sqlHwtime(void)
+{
+	unsigned int lo, hi;
+	__asm__ __volatile__("rdtsc":"=a"(lo), "=d"(hi));
+	return ((sql_uint64) hi << 32) | lo;
+}
+
+#elif defined(__aarch64__)
+
+__inline__ sql_uint64
+sqlHwtime(void)
+{
+	sql_uint64 val;
+	__asm__ __volatile__("mrs %0, cntvct_el0":"=r"(val));
+	return val;
+}
+
+#else
+
+/*
+ * There is no known way to read a cycle counter on this
+ * architecture, so just say the counter is always zero.
+ */
+__inline__ sql_uint64
+sqlHwtime(void)
+{
+	return (sql_uint64) 0;
+}
+
+#endif
+
 #endif				/* !defined(SQL_HWTIME_H) */
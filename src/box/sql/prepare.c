@@ -117,23 +117,27 @@ sql_stmt_compile(const char *zSql, int nBytes, struct Vdbe *pReprepare,
 			/* 13 */ "text",
 			/* 14 */ "comment",
 			/* 15 */ "text",
-			/* 16 */ "selectid",
+			/* 16 */ "cnt",
 			/* 17 */ "integer",
-			/* 18 */ "order",
+			/* 18 */ "cycles",
 			/* 19 */ "integer",
-			/* 20 */ "from",
+			/* 20 */ "selectid",
 			/* 21 */ "integer",
-			/* 22 */ "detail",
-			/* 23 */ "text",
+			/* 22 */ "order",
+			/* 23 */ "integer",
+			/* 24 */ "from",
+			/* 25 */ "integer",
+			/* 26 */ "detail",
+			/* 27 */ "text",
 		};
 
 		int name_first, name_count;
 		if (sParse.explain == 2) {
-			name_first = 16;
+			name_first = 20;
 			name_count = 4;
 		} else {
 			name_first = 0;
-			name_count = 8;
+			name_count = sParse.explain == 3 ? 10 : 8;
 		}
 		sqlVdbeSetNumCols(sParse.pVdbe, name_count);
 		for (int i = 0; i < name_count; i++) {
@@ -259,16 +259,13 @@ allocateCursor(
 #endif
 
 
-#ifdef VDBE_PROFILE
-
 /*
  * hwtime.h contains inline assembler code for implementing
- * high-performance timing routines.
+ * high-performance timing routines.  Besides the VDBE_PROFILE
+ * debug build it is used at runtime by EXPLAIN ANALYZE.
  */
 #include "hwtime.h"
 
-#endif
-
 static struct Mem *
 vdbe_prepare_null_out(struct Vdbe *v, int n)
 {
@@ -419,9 +416,7 @@ int sqlVdbeExec(Vdbe *p)
 {
 	Op *aOp = p->aOp;          /* Copy of p->aOp */
 	Op *pOp = aOp;             /* Current operation */
-#if defined(SQL_DEBUG) || defined(VDBE_PROFILE)
 	Op *pOrigOp;               /* Value of pOp at the top of the loop */
-#endif
 	int rc = 0;        /* Value to return */
 	sql *db = p->db;       /* The database */
 	int iCompare = 0;          /* Result of last comparison */
@@ -432,15 +427,14 @@ int sqlVdbeExec(Vdbe *p)
 	Mem *pIn3 = 0;             /* 3rd input operand */
 	Mem *pOut = 0;             /* Output operand */
 	int *aPermute = 0;         /* Permutation of columns for OP_Compare */
-#ifdef VDBE_PROFILE
-	u64 start;                 /* CPU clock count at start of opcode */
-#endif
+	u64 start = 0;             /* CPU clock count at start of opcode */
 	/*** INSERT STACK UNION HERE ***/
 
 	assert(p->magic==VDBE_MAGIC_RUN);  /* sql_step() verifies this */
 	assert(!p->is_aborted);
 	p->iCurrentTime = 0;
-	assert(p->explain==0);
+	/* EXPLAIN ANALYZE runs the program before listing it. */
+	assert(p->explain==0 || p->explain==3);
 	p->pResultSet = 0;
 #ifdef SQL_DEBUG
 	if (p->pc == 0 &&
@@ -476,6 +470,9 @@ int sqlVdbeExec(Vdbe *p)
 		assert(pOp>=aOp && pOp<&aOp[p->nOp]);
 #ifdef VDBE_PROFILE
 		start = sqlHwtime();
+#else
+		if (p->explain == 3)
+			start = sqlHwtime();
 #endif
 		nVmStep++;
 
@@ -524,9 +521,7 @@ int sqlVdbeExec(Vdbe *p)
 			}
 		}
 #endif
-#if defined(SQL_DEBUG) || defined(VDBE_PROFILE)
 		pOrigOp = pOp;
-#endif
 
 		switch( pOp->opcode) {
 
@@ -1022,7 +1017,12 @@ case OP_SCopy: {            /* out2 */
  * the result row.
  */
 case OP_ResultRow: {
-	assert(p->nResColumn==pOp->p2);
+	/*
+	 * Under EXPLAIN ANALYZE the result columns describe the
+	 * opcode listing, not the statement's own result rows,
+	 * which are executed and discarded.
+	 */
+	assert(p->nResColumn==pOp->p2 || p->explain==3);
 	assert(pOp->p1>0);
 	assert(pOp->p1+pOp->p2<=(p->nMem+1 - p->nCursor)+1);
 	assert(p->iStatement == 0 && p->anonymous_savepoint == NULL);
@@ -4699,13 +4699,14 @@ default: {          /* This is really OP_Noop and OP_Explain */
  ****************************************************************************/
 		}
 
-#ifdef VDBE_PROFILE
+#ifndef VDBE_PROFILE
+		if (p->explain == 3)
+#endif
 		{
 			u64 endTime = sqlHwtime();
 			if (endTime>start) pOrigOp->cycles += endTime - start;
 			pOrigOp->cnt++;
 		}
-#endif
 
 		/* The following code adds nothing to the actual functionality
 		 * of the program.  It is only here for testing and debugging.
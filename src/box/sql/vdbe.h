@@ -97,10 +97,8 @@ struct VdbeOp {
 #ifdef SQL_ENABLE_EXPLAIN_COMMENTS
 	char *zComment;		/* Comment to improve readability */
 #endif
-#ifdef VDBE_PROFILE
 	u32 cnt;		/* Number of times this instruction was executed */
 	u64 cycles;		/* Total time spent executing this instruction */
-#endif
 #ifdef SQL_VDBE_COVERAGE
 	int iSrcLine;		/* Source-code line that generated this opcode */
 #endif
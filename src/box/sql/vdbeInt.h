@@ -294,6 +294,7 @@ struct Vdbe {
 	bft expired:1;		/* True if the VM needs to be recompiled */
 	bft doingRerun:1;	/* True if rerunning after an auto-reprepare */
 	bft explain:2;		/* True if EXPLAIN present on SQL command */
+	bft analyzed:1;		/* EXPLAIN ANALYZE: execution phase is done */
 	bft changeCntOn:1;	/* True to update the change-counter */
 	bft runOnlyOnce:1;	/* Automatically expire on reset */
 	u32 aCounter[5];	/* Counters used by sql_stmt_status() */
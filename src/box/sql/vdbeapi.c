@@ -296,9 +296,28 @@ sqlStep(Vdbe * p)
 		db->nVdbeActive++;
 		p->pc = 0;
 	}
-	if (p->explain) {
+	if (p->explain == 3 && !p->analyzed) {
+		/*
+		 * EXPLAIN ANALYZE: run the statement to completion
+		 * first, discarding its result rows, so that the
+		 * per-opcode counters get filled in.  Then rewind
+		 * just enough to list the program below.
+		 */
+		db->nVdbeExec++;
+		do {
+			rc = sqlVdbeExec(p);
+		} while (rc == SQL_ROW);
+		db->nVdbeExec--;
+		if (rc == SQL_DONE) {
+			p->analyzed = 1;
+			p->magic = VDBE_MAGIC_RUN;
+			p->pc = 0;
+			db->nVdbeActive++;
+		}
+	}
+	if (p->explain && (p->explain != 3 || p->analyzed)) {
 		rc = sqlVdbeList(p);
-	} else {
+	} else if (p->explain == 0) {
 		db->nVdbeExec++;
 		rc = sqlVdbeExec(p);
 		db->nVdbeExec--;
@@ -233,10 +233,8 @@ sqlVdbeAddOp3(Vdbe * p, int op, int p1, int p2, int p3)
 #ifdef SQL_DEBUG
 	test_addop_breakpoint();
 #endif
-#ifdef VDBE_PROFILE
 	pOp->cycles = 0;
 	pOp->cnt = 0;
-#endif
 #ifdef SQL_VDBE_COVERAGE
 	pOp->iSrcLine = 0;
 #endif
@@ -1211,6 +1209,11 @@ sqlVdbeFrameDelete(VdbeFrame * p)
  * are shown in a different format.  p->explain==2 is used to implement
  * EXPLAIN QUERY PLAN.
  *
+ * When p->explain==3 ("EXPLAIN ANALYZE") the program has already been
+ * executed by sqlStep() and each instruction is listed together with
+ * its execution count and the cycles spent in it.  Trigger
+ * subprograms are not traversed in this mode.
+ *
  * When p->explain==1, first the main program is listed, then each of
  * the trigger subprograms are listed one by one.
  */
@@ -1232,7 +1235,7 @@ sqlVdbeList(Vdbe * p)
 	 * the result, result columns may become dynamic if the user calls
 	 * sql_column_text16(), causing a translation to UTF-16 encoding.
 	 */
-	releaseMemArray(pMem, 8);
+	releaseMemArray(pMem, p->explain == 3 ? 10 : 8);
 	p->pResultSet = 0;
 
 	/* When the number of output rows reaches nRow, that means the
@@ -1287,7 +1290,7 @@ sqlVdbeList(Vdbe * p)
 			}
 			pOp = &apSub[j]->aOp[i];
 		}
-		if (p->explain == 1) {
+		if (p->explain != 2) {
 			assert(i >= 0);
 			mem_set_uint(pMem, i);
 
@@ -1302,7 +1305,7 @@ sqlVdbeList(Vdbe * p)
 			 * kept in p->aMem[9].z to hold the new program - assuming this subprogram
 			 * has not already been seen.
 			 */
-			if (pOp->p4type == P4_SUBPROGRAM) {
+			if (pOp->p4type == P4_SUBPROGRAM && p->explain == 1) {
 				int j;
 				for (j = 0; j < nSub; j++) {
 					if (apSub[j] == pOp->p4.pProgram)
@@ -1348,7 +1351,7 @@ sqlVdbeList(Vdbe * p)
 		}
 		pMem++;
 
-		if (p->explain == 1) {
+		if (p->explain != 2) {
 			buf = sqlDbMallocRaw(sql_get(), 4);
 			if (buf == NULL)
 				return -1;
@@ -1365,9 +1368,23 @@ sqlVdbeList(Vdbe * p)
 #else
 			mem_set_null(pMem);
 #endif
+			pMem++;
+		}
+
+		if (p->explain == 3) {
+			mem_set_uint(pMem, pOp->cnt);
+			pMem++;
+
+			mem_set_uint(pMem, pOp->cycles);
+			pMem++;
 		}
 
-		p->nResColumn = 8 - 4 * (p->explain - 1);
+		if (p->explain == 1)
+			p->nResColumn = 8;
+		else if (p->explain == 2)
+			p->nResColumn = 4;
+		else
+			p->nResColumn = 10;
 		p->pResultSet = &p->aMem[1];
 		rc = SQL_ROW;
 	}
@@ -1449,7 +1466,7 @@ allocSpace(struct ReusableSpace *p,	/* Bulk memory available for allocation */
 void
 sqlVdbeRewind(Vdbe * p)
 {
-#if defined(SQL_DEBUG) || defined(VDBE_PROFILE)
+#if defined(SQL_DEBUG)
 	int i;
 #endif
 	assert(p != 0);
@@ -1470,17 +1487,21 @@ sqlVdbeRewind(Vdbe * p)
 	p->pc = -1;
 	p->is_aborted = false;
 	p->ignoreRaised = 0;
+	p->analyzed = 0;
 	p->errorAction = ON_CONFLICT_ACTION_ABORT;
 	p->nChange = 0;
 	p->cacheCtr = 1;
 	p->iStatement = 0;
 	p->nFkConstraint = 0;
-#ifdef VDBE_PROFILE
-	for (i = 0; i < p->nOp; i++) {
-		p->aOp[i].cnt = 0;
-		p->aOp[i].cycles = 0;
-	}
+#ifndef VDBE_PROFILE
+	if (p->explain == 3)
 #endif
+	{
+		for (int j = 0; j < p->nOp; j++) {
+			p->aOp[j].cnt = 0;
+			p->aOp[j].cycles = 0;
+		}
+	}
 }
 
 /*
@@ -1550,6 +1571,10 @@ sqlVdbeMakeReady(Vdbe * p,	/* The VDBE */
 	if (pParse->explain && nMem < 10) {
 		nMem = 10;
 	}
+	/* EXPLAIN ANALYZE lists two more columns: cnt and cycles. */
+	if (pParse->explain == 3 && nMem < 12) {
+		nMem = 12;
+	}
 	p->expired = 0;
 
 	/* Memory for registers, parameters, cursor, etc, is allocated in one or two
@@ -47,6 +47,8 @@ sql_stmt_cache_init(void)
 	sql_stmt_cache.mem_quota = 0;
 	sql_stmt_cache.mem_used = 0;
 	rlist_create(&sql_stmt_cache.gc_queue);
+	sql_stmt_cache.hits = 0;
+	sql_stmt_cache.misses = 0;
 }
 
 void
@@ -55,11 +57,9 @@ sql_stmt_cache_stat(struct info_handler *h)
 	info_begin(h);
 	info_table_begin(h, "cache");
 	info_append_int(h, "size", sql_stmt_cache.mem_used);
-	uint32_t entry_count = 0;
-	mh_int_t i;
-	mh_foreach(sql_stmt_cache.hash, i)
-		entry_count++;
-	info_append_int(h, "stmt_count", entry_count);
+	info_append_int(h, "stmt_count", mh_size(sql_stmt_cache.hash));
+	info_append_int(h, "hits", sql_stmt_cache.hits);
+	info_append_int(h, "misses", sql_stmt_cache.misses);
 	info_table_end(h);
 	info_end(h);
 }
@@ -81,16 +81,22 @@ sql_cache_entry_delete(struct stmt_cache_entry *entry)
 }
 
 /**
- * Remove statement entry from cache: remove from LRU list and
- * account cache size changes, then release occupied memory.
- * At the moment of calling this function, entry is already
- * removed from hash.
+ * Remove statement entry from cache: remove from hash and from
+ * the eviction queue, account cache size changes, then release
+ * occupied memory.
  */
 static void
 sql_stmt_cache_delete(struct stmt_cache_entry *entry)
 {
-	if (sql_stmt_cache.last_found == entry)
-		sql_stmt_cache.last_found = NULL;
+	struct sql_stmt_cache *cache = &sql_stmt_cache;
+	const char *sql_str = sql_stmt_query_str(entry->stmt);
+	uint32_t stmt_id = sql_stmt_calculate_id(sql_str, strlen(sql_str));
+	mh_int_t i = mh_i32ptr_find(cache->hash, stmt_id, NULL);
+	assert(i != mh_end(cache->hash));
+	mh_i32ptr_del(cache->hash, i, NULL);
+	cache->mem_used -= sql_cache_entry_sizeof(entry->stmt);
+	if (cache->last_found == entry)
+		cache->last_found = NULL;
 	rlist_del(&entry->link);
 	sql_cache_entry_delete(entry);
 }
@@ -118,13 +124,22 @@ stmt_cache_find_entry(uint32_t stmt_id)
 	return entry;
 }
 
+/**
+ * Evict statements that are not used by any session, the least
+ * recently released first, until the cache occupies at most
+ * @a limit bytes. May stop earlier if every remaining statement
+ * is still referenced.
+ */
 static void
-sql_stmt_cache_gc(void)
+sql_stmt_cache_gc(size_t limit)
 {
-	struct stmt_cache_entry *entry, *next;
-	rlist_foreach_entry_safe(entry, &sql_stmt_cache.gc_queue, link, next)
+	while (sql_stmt_cache.mem_used > limit &&
+	       !rlist_empty(&sql_stmt_cache.gc_queue)) {
+		struct stmt_cache_entry *entry =
+			rlist_last_entry(&sql_stmt_cache.gc_queue,
+					 struct stmt_cache_entry, link);
 		sql_stmt_cache_delete(entry);
-	assert(rlist_empty(&sql_stmt_cache.gc_queue));
+	}
 }
 
 /**
@@ -141,7 +156,7 @@ sql_cache_entry_new(struct sql_stmt *stmt)
 		return NULL;
 	}
 	entry->stmt = stmt;
-	entry->link = (struct rlist) { NULL, NULL };
+	rlist_create(&entry->link);
 	entry->refs = 0;
 	return entry;
 }
@@ -162,21 +177,14 @@ sql_stmt_cache_entry_unref(struct stmt_cache_entry *entry)
 	assert((int64_t)entry->refs - 1 >= 0);
 	if (--entry->refs == 0) {
 		/*
-		 * Remove entry from hash and add it to gc queue.
-		 * Resources are to be released in the nearest
-		 * GC cycle (see sql_stmt_cache_insert()).
+		 * Keep the entry in the hash and its size in
+		 * mem_used, but put it at the head of the
+		 * eviction queue. It is released only when the
+		 * memory quota demands it (see
+		 * sql_stmt_cache_gc()), so a re-prepare of a
+		 * recently released query hits the cache.
 		 */
-		struct sql_stmt_cache *cache = &sql_stmt_cache;
-		const char *sql_str = sql_stmt_query_str(entry->stmt);
-		uint32_t stmt_id = sql_stmt_calculate_id(sql_str,
-							 strlen(sql_str));
-		mh_int_t i = mh_i32ptr_find(cache->hash, stmt_id, NULL);
-		assert(i != mh_end(cache->hash));
-		mh_i32ptr_del(cache->hash, i, NULL);
 		rlist_add(&sql_stmt_cache.gc_queue, &entry->link);
-		sql_stmt_cache.mem_used -= sql_cache_entry_sizeof(entry->stmt);
-		if (sql_stmt_cache.last_found == entry)
-			sql_stmt_cache.last_found = NULL;
 	}
 }
 
@@ -207,7 +215,15 @@ sql_session_stmt_hash_add_id(struct mh_i32ptr_t *hash, uint32_t stmt_id)
 		return -1;
 	}
 	assert(old_node == NULL);
-	entry->refs++;
+	if (entry->refs++ == 0) {
+		/*
+		 * The statement was sitting in the eviction
+		 * queue - pull it back. For a freshly inserted
+		 * entry the link points to itself and the
+		 * operation is a no-op.
+		 */
+		rlist_del(&entry->link);
+	}
 	return 0;
 }
 
@@ -243,8 +259,9 @@ sql_stmt_cache_insert(struct sql_stmt *stmt)
 	struct sql_stmt_cache *cache = &sql_stmt_cache;
 	size_t new_entry_size = sql_cache_entry_sizeof(stmt);
 
-	if (! sql_cache_check_new_entry_size(new_entry_size))
-		sql_stmt_cache_gc();
+	if (! sql_cache_check_new_entry_size(new_entry_size) &&
+	    new_entry_size <= cache->mem_quota)
+		sql_stmt_cache_gc(cache->mem_quota - new_entry_size);
 	/*
 	 * Test memory limit again. Raise an error if it is
 	 * still overcrowded.
@@ -279,8 +296,11 @@ struct sql_stmt *
 sql_stmt_cache_find(uint32_t stmt_id)
 {
 	struct stmt_cache_entry *entry = stmt_cache_find_entry(stmt_id);
-	if (entry == NULL)
+	if (entry == NULL) {
+		sql_stmt_cache.misses++;
 		return NULL;
+	}
+	sql_stmt_cache.hits++;
 	return entry->stmt;
 }
 
@@ -288,7 +308,7 @@ int
 sql_stmt_cache_set_size(size_t size)
 {
 	if (sql_stmt_cache.mem_used > size)
-		sql_stmt_cache_gc();
+		sql_stmt_cache_gc(size);
 	if (sql_stmt_cache.mem_used > size) {
 		diag_set(ClientError, ER_SQL_PREPARE, "Can't reduce memory "\
 			 "limit for SQL prepared statements: please, deallocate "\
@@ -47,13 +47,14 @@ struct stmt_cache_entry {
 	/** Prepared statement itself. */
 	struct sql_stmt *stmt;
 	/**
-	 * Link to the next entry. All statements are to be
-	 * evicted on the next gc cycle.
+	 * Link in the eviction queue. An entry is enqueued
+	 * while its reference counter is zero and is removed
+	 * from the queue as soon as it is referenced again.
 	 */
 	struct rlist link;
 	/**
 	 * Reference counter. If it is == 0, entry gets
-	 * into GC queue.
+	 * into the eviction queue.
 	 */
 	uint32_t refs;
 };
@@ -70,9 +71,12 @@ struct sql_stmt_cache {
 	struct mh_i32ptr_t *hash;
 	/**
 	 * After deallocation statements are not deleted, but
-	 * moved to this list. GC process is triggered only
-	 * when memory limit has reached. It allows to reduce
-	 * workload on session's disconnect.
+	 * moved to this list in LRU order (most recently
+	 * released first) while still remaining in the hash.
+	 * They are evicted from the tail of the list only when
+	 * the memory limit demands it, so a re-prepare of a
+	 * recently released statement is a cache hit. It also
+	 * allows to reduce workload on session's disconnect.
 	 */
 	struct rlist gc_queue;
 	/**
@@ -82,6 +86,10 @@ struct sql_stmt_cache {
 	 * times.
 	 */
 	struct stmt_cache_entry *last_found;
+	/** Number of successful lookups, for statistics. */
+	size_t hits;
+	/** Number of failed lookups, for statistics. */
+	size_t misses;
 };
 
 /**
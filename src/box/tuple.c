@@ -30,7 +30,10 @@
  */
 #include "tuple.h"
 
+#include <sys/mman.h>
+
 #include "trivia/util.h"
+#include "alloc_profile.h"
 #include "memory.h"
 #include "fiber.h"
 #include "small/quota.h"
@@ -84,8 +87,8 @@ runtime_tuple_new(struct tuple_format *format, const char *data, const char *end
 		goto end;
 	uint32_t field_map_size = field_map_build_size(&builder);
 	uint32_t data_offset = sizeof(struct tuple) + field_map_size;
-	if (data_offset > INT16_MAX) {
-		/** tuple->data_offset is 15 bits */
+	if (data_offset > TUPLE_DATA_OFFSET_MAX) {
+		/** tuple->data_offset is 14 bits */
 		diag_set(ClientError, ER_TUPLE_METADATA_IS_TOO_BIG,
 			 data_offset);
 		goto end;
@@ -99,12 +102,14 @@ runtime_tuple_new(struct tuple_format *format, const char *data, const char *end
 			 "malloc", "tuple");
 		goto end;
 	}
+	alloc_profile_sample(total);
 
 	tuple->refs = 0;
 	tuple->bsize = data_len;
 	tuple->format_id = tuple_format_id(format);
 	tuple_format_ref(format);
 	tuple->data_offset = data_offset;
+	tuple->is_compact = false;
 	tuple->is_dirty = false;
 	char *raw = (char *) tuple + data_offset;
 	field_map_build(&builder, raw - field_map_size);
@@ -365,6 +370,21 @@ tuple_arena_create(struct slab_arena *arena, struct quota *quota,
 
 	say_debug("tuple arena %s: addr %p size %zu flags %#x dontdump %d",
 		  arena_name, arena->arena, prealloc, flags, dontdump);
+#ifdef HAVE_MADV_HUGEPAGE
+	/*
+	 * Ask the kernel to back the arena with huge pages. The
+	 * arena lives for the whole instance lifetime and is
+	 * scanned tuple by tuple, so fewer DTLB entries per GB of
+	 * data directly translate into scan throughput. This is a
+	 * hint: if THP is disabled the call is a no-op, and a
+	 * failure is not worth even a warning. Node locality of
+	 * the pages is already taken care of by the kernel's
+	 * first-touch policy - slabs are faulted in by the single
+	 * tx thread that also reads them back.
+	 */
+	if (arena->arena != NULL && prealloc > 0)
+		(void)madvise(arena->arena, prealloc, MADV_HUGEPAGE);
+#endif
 }
 
 void
@@ -402,8 +422,7 @@ tuple_field_go_to_index(const char **field, uint64_t index)
 		uint32_t count = mp_decode_array(field);
 		if (index >= count)
 			return -1;
-		for (; index > 0; --index)
-			mp_next(field);
+		mp_next_multi(field, index);
 		return 0;
 	} else if (type == MP_MAP) {
 		index += TUPLE_INDEX_BASE;
@@ -487,13 +506,126 @@ tuple_go_to_path(const char **data, const char *path, uint32_t path_len,
 	return rc != 0 ? -1 : 0;
 }
 
+enum {
+	/** Number of slots in the per-thread parsed path cache. */
+	TUPLE_PATH_CACHE_SIZE = 128,
+	/** Longest path string the cache stores. */
+	TUPLE_PATH_CACHE_MAX_LEN = 96,
+};
+
+/**
+ * A resolved runtime path query: the result of lexing a JSON path
+ * and resolving its first component against a format dictionary,
+ * kept so that repeated tuple:get('<path>') calls skip both the
+ * lexer and the name lookup. When the resolved field has an offset
+ * slot in the format, the slot is kept too and a repeated query
+ * becomes a single field map load, skipping the token tree descent
+ * as well. An entry is bound to one format via the format epoch,
+ * which is unique per format, so a freed format's address being
+ * recycled can not revive a stale entry.
+ */
+struct tuple_path_cache_entry {
+	/** Path string this entry describes. */
+	char path[TUPLE_PATH_CACHE_MAX_LEN];
+	/** Length of the path string. */
+	uint32_t path_len;
+	/** Hash of the path, as passed by the caller. */
+	uint32_t path_hash;
+	/** Epoch of the format the entry was resolved against. */
+	uint64_t format_epoch;
+	/** Resolved top-level field index. */
+	uint32_t fieldno;
+	/** Offset of the path remainder after the first component. */
+	uint32_t rest_offset;
+	/**
+	 * Offset slot of the fully resolved field, or
+	 * TUPLE_OFFSET_SLOT_NIL when the field has no slot or is a
+	 * multikey part and the slot can not be used without a
+	 * concrete multikey index.
+	 */
+	int32_t offset_slot;
+	/** True when the whole path matched a field name. */
+	bool is_name;
+};
+
+/**
+ * The cache is direct-mapped by the path hash: a slot holds its
+ * most recent query, which bounds both the memory and the work to
+ * evict - the degenerate but sufficient form of an LRU for point
+ * lookups.
+ */
+static __thread struct tuple_path_cache_entry
+tuple_path_cache[TUPLE_PATH_CACHE_SIZE];
+
+/**
+ * Store a resolved path query in the cache entry, looking up the
+ * offset slot of the target field when it has one.
+ */
+static void
+tuple_path_cache_entry_fill(struct tuple_path_cache_entry *e,
+			    struct tuple_format *format, const char *path,
+			    uint32_t path_len, uint32_t path_hash,
+			    uint32_t fieldno, uint32_t rest_offset,
+			    bool is_name)
+{
+	memcpy(e->path, path, path_len);
+	e->path_len = path_len;
+	e->path_hash = path_hash;
+	e->format_epoch = format->epoch;
+	e->fieldno = fieldno;
+	e->rest_offset = rest_offset;
+	e->is_name = is_name;
+	e->offset_slot = TUPLE_OFFSET_SLOT_NIL;
+	if (fieldno < format->index_field_count) {
+		const char *rest = rest_offset < path_len ?
+				   path + rest_offset : NULL;
+		struct tuple_field *field =
+			tuple_format_field_by_path(format, fieldno, rest,
+						   path_len - rest_offset);
+		if (field != NULL && !field->is_multikey_part)
+			e->offset_slot = field->offset_slot;
+	}
+}
+
 const char *
 tuple_field_raw_by_full_path(struct tuple_format *format, const char *tuple,
 			     const uint32_t *field_map, const char *path,
-			     uint32_t path_len, uint32_t path_hash)
+			     uint32_t path_len, uint32_t path_hash,
+			     bool is_compact)
 {
 	assert(path_len > 0);
 	uint32_t fieldno;
+	struct tuple_path_cache_entry *e = NULL;
+	if (path_len <= TUPLE_PATH_CACHE_MAX_LEN && format->epoch != 0) {
+		e = &tuple_path_cache[path_hash &
+				      (TUPLE_PATH_CACHE_SIZE - 1)];
+		if (e->format_epoch == format->epoch &&
+		    e->path_len == path_len && e->path_hash == path_hash &&
+		    memcmp(e->path, path, path_len) == 0) {
+			if (e->offset_slot != TUPLE_OFFSET_SLOT_NIL) {
+				uint32_t offset =
+					field_map_get_offset(field_map,
+							     e->offset_slot,
+							     MULTIKEY_NONE,
+							     is_compact);
+				if (offset == 0)
+					return NULL;
+				return tuple + offset;
+			}
+			if (e->is_name)
+				return tuple_field_raw(format, tuple,
+						       field_map, e->fieldno,
+						       is_compact);
+			return tuple_field_raw_by_path(format, tuple,
+						       field_map, e->fieldno,
+						       path + e->rest_offset,
+						       path_len -
+						       e->rest_offset,
+						       NULL, MULTIKEY_NONE,
+						       is_compact);
+		}
+		/* The slot is refilled below on successful resolve. */
+	}
 	/*
 	 * It is possible, that a field has a name as
 	 * well-formatted JSON. For example 'a.b.c.d' or '[1]' can
@@ -501,8 +633,14 @@ tuple_field_raw_by_full_path(struct tuple_format *format, const char *tuple,
 	 * use the path as a field name.
 	 */
 	if (tuple_fieldno_by_name(format->dict, path, path_len, path_hash,
-				  &fieldno) == 0)
-		return tuple_field_raw(format, tuple, field_map, fieldno);
+				  &fieldno) == 0) {
+		if (e != NULL)
+			tuple_path_cache_entry_fill(e, format, path, path_len,
+						    path_hash, fieldno,
+						    path_len, true);
+		return tuple_field_raw(format, tuple, field_map, fieldno,
+				       is_compact);
+	}
 	struct json_lexer lexer;
 	struct json_token token;
 	json_lexer_create(&lexer, path, path_len, TUPLE_INDEX_BASE);
@@ -537,24 +675,38 @@ tuple_field_raw_by_full_path(struct tuple_format *format, const char *tuple,
 		       token.type == JSON_TOKEN_ANY);
 		return NULL;
 	}
+	if (e != NULL)
+		tuple_path_cache_entry_fill(e, format, path, path_len,
+					    path_hash, fieldno, lexer.offset,
+					    false);
 	return tuple_field_raw_by_path(format, tuple, field_map, fieldno,
 				       path + lexer.offset,
 				       path_len - lexer.offset,
-				       NULL, MULTIKEY_NONE);
+				       NULL, MULTIKEY_NONE, is_compact);
 }
 
 uint32_t
 tuple_raw_multikey_count(struct tuple_format *format, const char *data,
 			       const uint32_t *field_map,
-			       struct key_def *key_def)
+			       struct key_def *key_def, bool is_compact)
 {
 	assert(key_def->is_multikey);
+	if (unlikely(key_def->multikey_format_epoch != format->epoch)) {
+		assert(format->epoch != 0);
+		key_def->multikey_format_epoch = format->epoch;
+		/*
+		 * Clear the stale offset slot cache. It is reset by
+		 * the lookup, @sa tuple_field_raw_by_part().
+		 */
+		key_def->multikey_offset_slot_cache = TUPLE_OFFSET_SLOT_NIL;
+	}
 	const char *array_raw =
 		tuple_field_raw_by_path(format, data, field_map,
 					key_def->multikey_fieldno,
 					key_def->multikey_path,
 					key_def->multikey_path_len,
-					NULL, MULTIKEY_NONE);
+					&key_def->multikey_offset_slot_cache,
+					MULTIKEY_NONE, is_compact);
 	if (array_raw == NULL)
 		return 0;
 	enum mp_type type = mp_typeof(*array_raw);
@@ -330,7 +330,14 @@ struct PACKED tuple
 	/**
 	 * Offset to the MessagePack from the begin of the tuple.
 	 */
-	uint16_t data_offset : 15;
+	uint16_t data_offset : 14;
+	/**
+	 * The field map of the tuple is stored in the compact
+	 * layout - a sequence of 8-bit offsets instead of 32-bit
+	 * ones, see field_map_get_offset(). Only set for small
+	 * tuples of formats without multikey indexes.
+	 */
+	bool is_compact : 1;
 	/**
 	 * The tuple (if it's found in index for example) could be invisible
 	 * for current transactions. The flag means that the tuple must
@@ -344,6 +351,21 @@ struct PACKED tuple
 	 */
 };
 
+enum {
+	/** Maximal value of tuple::data_offset. */
+	TUPLE_DATA_OFFSET_MAX = (1 << 14) - 1,
+};
+
+/**
+ * True if the tuple's field map is stored in the compact
+ * layout, @sa field_map_get_offset().
+ */
+static inline bool
+tuple_is_compact(struct tuple *tuple)
+{
+	return tuple->is_compact;
+}
+
 /** Size of the tuple including size of struct tuple. */
 static inline size_t
 tuple_size(struct tuple *tuple)
@@ -591,6 +613,46 @@ tuple_field_go_to_index(const char **field, uint64_t index);
 int
 tuple_field_go_to_key(const char **field, const char *key, int len);
 
+/**
+ * Skip @a count MessagePack values starting from @a data.
+ * Equivalent to calling mp_next() in a loop, but skips runs of
+ * positive fixints - the common case for enum-like and counter
+ * fields - eight bytes per load instead of one value per call.
+ *
+ * The buffer must contain at least @a count well-formed values.
+ * Since a MessagePack value is never shorter than one byte, while
+ * at least 8 values remain at least 8 bytes remain too, so the
+ * wide loads can not run past the buffer.
+ */
+static inline void
+mp_next_multi(const char **data, uint32_t count)
+{
+	const char *pos = *data;
+	while (count >= 8) {
+		uint64_t window = load_u64(pos);
+		/* A zero high bit is a positive fixint. */
+		if ((window & 0x8080808080808080ULL) == 0) {
+			pos += 8;
+			count -= 8;
+			continue;
+		}
+		/*
+		 * Skip the fixint prefix of the window byte by byte
+		 * (endianness-agnostic), then one arbitrary value,
+		 * and retry the wide loop.
+		 */
+		while ((*(const uint8_t *)pos & 0x80) == 0) {
+			pos++;
+			count--;
+		}
+		mp_next(&pos);
+		count--;
+	}
+	while (count-- > 0)
+		mp_next(&pos);
+	*data = pos;
+}
+
 /**
  * Get tuple field by field index, relative JSON path and
  * multikey_idx.
@@ -609,12 +671,15 @@ tuple_field_go_to_key(const char **field, const char *key, int len);
  * @param multikey_idx The multikey index hint - index of
  *                     multikey item item to retrieve when array
  *                     index placeholder "[*]" is met.
+ * @param is_compact True if the field map has the compact layout,
+ *                   @sa field_map_get_offset().
  */
 static inline const char *
 tuple_field_raw_by_path(struct tuple_format *format, const char *tuple,
 			const uint32_t *field_map, uint32_t fieldno,
 			const char *path, uint32_t path_len,
-			int32_t *offset_slot_hint, int multikey_idx)
+			int32_t *offset_slot_hint, int multikey_idx,
+			bool is_compact)
 {
 	int32_t offset_slot;
 	if (offset_slot_hint != NULL &&
@@ -661,7 +726,7 @@ tuple_field_raw_by_path(struct tuple_format *format, const char *tuple,
 offset_slot_access:
 		/* Indexed field */
 		offset = field_map_get_offset(field_map, offset_slot,
-					      multikey_idx);
+					      multikey_idx, is_compact);
 		if (offset == 0)
 			return NULL;
 		tuple += offset;
@@ -672,8 +737,7 @@ parse:
 		field_count = mp_decode_array(&tuple);
 		if (unlikely(fieldno >= field_count))
 			return NULL;
-		for (uint32_t k = 0; k < fieldno; k++)
-			mp_next(&tuple);
+		mp_next_multi(&tuple, fieldno);
 		if (path != NULL &&
 		    unlikely(tuple_go_to_path(&tuple, path, path_len,
 					      multikey_idx) != 0))
@@ -689,13 +753,15 @@ parse:
  * @param tuple a pointer to MessagePack array
  * @param field_map a pointer to the LAST element of field map
  * @param field_no the index of field to return
+ * @param is_compact true if the field map has the compact layout
  *
  * @returns field data if field exists or NULL
  * @sa tuple_field_map_create()
  */
 static inline const char *
 tuple_field_raw(struct tuple_format *format, const char *tuple,
-		const uint32_t *field_map, uint32_t field_no)
+		const uint32_t *field_map, uint32_t field_no,
+		bool is_compact)
 {
 	if (likely(field_no < format->index_field_count)) {
 		int32_t offset_slot;
@@ -711,7 +777,7 @@ tuple_field_raw(struct tuple_format *format, const char *tuple,
 		if (offset_slot == TUPLE_OFFSET_SLOT_NIL)
 			goto parse;
 		offset = field_map_get_offset(field_map, offset_slot,
-					      MULTIKEY_NONE);
+					      MULTIKEY_NONE, is_compact);
 		if (offset == 0)
 			return NULL;
 		tuple += offset;
@@ -721,8 +787,7 @@ parse:
 		uint32_t field_count = mp_decode_array(&tuple);
 		if (unlikely(field_no >= field_count))
 			return NULL;
-		for ( ; field_no > 0; field_no--)
-			mp_next(&tuple);
+		mp_next_multi(&tuple, field_no);
 	}
 	return tuple;
 }
@@ -739,7 +804,8 @@ static inline const char *
 tuple_field(struct tuple *tuple, uint32_t fieldno)
 {
 	return tuple_field_raw(tuple_format(tuple), tuple_data(tuple),
-			       tuple_field_map(tuple), fieldno);
+			       tuple_field_map(tuple), fieldno,
+			       tuple_is_compact(tuple));
 }
 
 /**
@@ -760,7 +826,8 @@ tuple_field(struct tuple *tuple, uint32_t fieldno)
 const char *
 tuple_field_raw_by_full_path(struct tuple_format *format, const char *tuple,
 			     const uint32_t *field_map, const char *path,
-			     uint32_t path_len, uint32_t path_hash);
+			     uint32_t path_len, uint32_t path_hash,
+			     bool is_compact);
 
 /**
  * Get a tuple field pointed to by an index part and multikey
@@ -770,12 +837,14 @@ tuple_field_raw_by_full_path(struct tuple_format *format, const char *tuple,
  * @param field_map A pointer to the LAST element of field map.
  * @param part Index part to use.
  * @param multikey_idx A multikey index hint.
+ * @param is_compact True if the field map has the compact layout.
  * @retval Field data if the field exists or NULL.
  */
 static inline const char *
 tuple_field_raw_by_part(struct tuple_format *format, const char *data,
 			const uint32_t *field_map,
-			struct key_part *part, int multikey_idx)
+			struct key_part *part, int multikey_idx,
+			bool is_compact)
 {
 	if (unlikely(part->format_epoch != format->epoch)) {
 		assert(format->epoch != 0);
@@ -788,7 +857,8 @@ tuple_field_raw_by_part(struct tuple_format *format, const char *data,
 	}
 	return tuple_field_raw_by_path(format, data, field_map, part->fieldno,
 				       part->path, part->path_len,
-				       &part->offset_slot_cache, multikey_idx);
+				       &part->offset_slot_cache, multikey_idx,
+				       is_compact);
 }
 
 /**
@@ -804,7 +874,7 @@ tuple_field_by_part(struct tuple *tuple, struct key_part *part,
 {
 	return tuple_field_raw_by_part(tuple_format(tuple), tuple_data(tuple),
 				       tuple_field_map(tuple), part,
-				       multikey_idx);
+				       multikey_idx, tuple_is_compact(tuple));
 }
 
 /**
@@ -818,7 +888,8 @@ tuple_field_by_part(struct tuple *tuple, struct key_part *part,
  */
 uint32_t
 tuple_raw_multikey_count(struct tuple_format *format, const char *data,
-			 const uint32_t *field_map, struct key_def *key_def);
+			 const uint32_t *field_map, struct key_def *key_def,
+			 bool is_compact);
 
 /**
  * Get count of multikey index keys in tuple by given multikey
@@ -831,7 +902,8 @@ static inline uint32_t
 tuple_multikey_count(struct tuple *tuple, struct key_def *key_def)
 {
 	return tuple_raw_multikey_count(tuple_format(tuple), tuple_data(tuple),
-					tuple_field_map(tuple), key_def);
+					tuple_field_map(tuple), key_def,
+					tuple_is_compact(tuple));
 }
 
 /**
@@ -40,6 +40,7 @@
 #include "diag.h"
 #include "errcode.h"
 #include "key_def.h"
+#include "schema_def.h"
 #include "tuple.h"
 #include "salad/bloom.h"
 #include "trivia/util.h"
@@ -216,13 +217,23 @@ tuple_bloom_maybe_has(const struct tuple_bloom *bloom, struct tuple *tuple,
 	uint32_t h = HASH_SEED;
 	uint32_t carry = 0;
 	uint32_t total_size = 0;
-
+	uint32_t hashes[BOX_INDEX_PART_MAX];
+
+	/*
+	 * Compute all part hashes and prefetch the corresponding
+	 * filter blocks first: by the time the probe loop reads a
+	 * block, its cache miss has been overlapped with hashing
+	 * the remaining parts instead of being paid serially.
+	 */
 	for (uint32_t i = 0; i < key_def->part_count; i++) {
 		total_size += tuple_hash_key_part(&h, &carry, tuple,
 						  &key_def->parts[i],
 						  multikey_idx);
-		uint32_t hash = PMurHash32_Result(h, carry, total_size);
-		if (!bloom_maybe_has(&bloom->parts[i], hash))
+		hashes[i] = PMurHash32_Result(h, carry, total_size);
+		bloom_prefetch(&bloom->parts[i], hashes[i]);
+	}
+	for (uint32_t i = 0; i < key_def->part_count; i++) {
+		if (!bloom_maybe_has(&bloom->parts[i], hashes[i]))
 			return false;
 	}
 	return true;
@@ -246,12 +257,17 @@ tuple_bloom_maybe_has_key(const struct tuple_bloom *bloom,
 	uint32_t h = HASH_SEED;
 	uint32_t carry = 0;
 	uint32_t total_size = 0;
+	uint32_t hashes[BOX_INDEX_PART_MAX];
 
+	/* See the comment in tuple_bloom_maybe_has(). */
 	for (uint32_t i = 0; i < part_count; i++) {
 		total_size += tuple_hash_field(&h, &carry, &key,
 					       key_def->parts[i].coll);
-		uint32_t hash = PMurHash32_Result(h, carry, total_size);
-		if (!bloom_maybe_has(&bloom->parts[i], hash))
+		hashes[i] = PMurHash32_Result(h, carry, total_size);
+		bloom_prefetch(&bloom->parts[i], hashes[i]);
+	}
+	for (uint32_t i = 0; i < part_count; i++) {
+		if (!bloom_maybe_has(&bloom->parts[i], hashes[i]))
 			return false;
 	}
 	return true;
@@ -33,6 +33,9 @@
 #include "coll/coll.h"
 #include "trivia/util.h" /* NOINLINE */
 #include <math.h>
+#if defined(__SSE2__) || defined(ENABLE_SSE2)
+#include <emmintrin.h>
+#endif
 #include "lib/core/decimal.h"
 #include "lib/core/mp_decimal.h"
 #include "uuid/mp_uuid.h"
@@ -347,15 +350,54 @@ mp_compare_number(const char *lhs, const char *rhs)
 					   rhs, mp_typeof(*rhs));
 }
 
+/**
+ * Compare two binary blobs the way memcmp() + size comparison
+ * does, but check the common prefix in 16-byte SSE2 blocks.
+ * Comparison is the hottest path of a range scan and for
+ * multi-part string keys most of the time is spent exactly here,
+ * so the vectorized prefix check pays off on any key longer
+ * than one block. Falls back to plain memcmp() for the tail and
+ * on builds without SSE2.
+ */
+static inline int
+mp_compare_data(const char *a, uint32_t size_a,
+		const char *b, uint32_t size_b)
+{
+	uint32_t size = MIN(size_a, size_b);
+#if defined(__SSE2__) || defined(ENABLE_SSE2)
+	while (size >= 16) {
+		__m128i va = _mm_loadu_si128((const __m128i *)a);
+		__m128i vb = _mm_loadu_si128((const __m128i *)b);
+		uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb));
+		if (mask != 0xffff) {
+			uint32_t i = __builtin_ctz(~mask);
+			return (unsigned char)a[i] < (unsigned char)b[i] ?
+			       -1 : 1;
+		}
+		a += 16;
+		b += 16;
+		size -= 16;
+	}
+#endif
+	int r = memcmp(a, b, size);
+	if (r != 0)
+		return r;
+	return COMPARE_RESULT(size_a, size_b);
+}
+
+/**
+ * Compare two string fields whose comparison hints are equal.
+ * Defined in the tuple_hint section, see the comment there.
+ */
+static inline int
+mp_compare_str_hinted(const char *field_a, const char *field_b);
+
 static inline int
 mp_compare_str(const char *field_a, const char *field_b)
 {
 	uint32_t size_a = mp_decode_strl(&field_a);
 	uint32_t size_b = mp_decode_strl(&field_b);
-	int r = memcmp(field_a, field_b, MIN(size_a, size_b));
-	if (r != 0)
-		return r;
-	return COMPARE_RESULT(size_a, size_b);
+	return mp_compare_data(field_a, size_a, field_b, size_b);
 }
 
 static inline int
@@ -371,10 +413,7 @@ mp_compare_bin(const char *field_a, const char *field_b)
 {
 	uint32_t size_a = mp_decode_binl(&field_a);
 	uint32_t size_b = mp_decode_binl(&field_b);
-	int r = memcmp(field_a, field_b, MIN(size_a, size_b));
-	if (r != 0)
-		return r;
-	return COMPARE_RESULT(size_a, size_b);
+	return mp_compare_data(field_a, size_a, field_b, size_b);
 }
 
 static inline int
@@ -554,6 +593,17 @@ tuple_compare_slowpath(struct tuple *tuple_a, hint_t tuple_a_hint,
 		mp_decode_array(&tuple_a_raw);
 		mp_decode_array(&tuple_b_raw);
 		if (! is_nullable) {
+			/*
+			 * Equal string hints of a non-collated
+			 * index imply an equal key prefix, so
+			 * the comparison may skip it.
+			 */
+			if (part->type == FIELD_TYPE_STRING &&
+			    part->coll == NULL &&
+			    tuple_a_hint != HINT_NONE &&
+			    tuple_a_hint == tuple_b_hint)
+				return mp_compare_str_hinted(tuple_a_raw,
+							     tuple_b_raw);
 			return tuple_compare_field(tuple_a_raw, tuple_b_raw,
 						   part->type, part->coll);
 		}
@@ -573,6 +623,8 @@ tuple_compare_slowpath(struct tuple *tuple_a, hint_t tuple_a_hint,
 	struct tuple_format *format_b = tuple_format(tuple_b);
 	const uint32_t *field_map_a = tuple_field_map(tuple_a);
 	const uint32_t *field_map_b = tuple_field_map(tuple_b);
+	bool is_compact_a = tuple_is_compact(tuple_a);
+	bool is_compact_b = tuple_is_compact(tuple_b);
 	struct key_part *end;
 	const char *field_a, *field_b;
 	enum mp_type a_type, b_type;
@@ -585,22 +637,28 @@ tuple_compare_slowpath(struct tuple *tuple_a, hint_t tuple_a_hint,
 		if (is_multikey) {
 			field_a = tuple_field_raw_by_part(format_a, tuple_a_raw,
 							  field_map_a, part,
-							  (int)tuple_a_hint);
+							  (int)tuple_a_hint,
+							  is_compact_a);
 			field_b = tuple_field_raw_by_part(format_b, tuple_b_raw,
 							  field_map_b, part,
-							  (int)tuple_b_hint);
+							  (int)tuple_b_hint,
+							  is_compact_b);
 		} else if (has_json_paths) {
 			field_a = tuple_field_raw_by_part(format_a, tuple_a_raw,
 							  field_map_a, part,
-							  MULTIKEY_NONE);
+							  MULTIKEY_NONE,
+							  is_compact_a);
 			field_b = tuple_field_raw_by_part(format_b, tuple_b_raw,
 							  field_map_b, part,
-							  MULTIKEY_NONE);
+							  MULTIKEY_NONE,
+							  is_compact_b);
 		} else {
 			field_a = tuple_field_raw(format_a, tuple_a_raw,
-						  field_map_a, part->fieldno);
+						  field_map_a, part->fieldno,
+						  is_compact_a);
 			field_b = tuple_field_raw(format_b, tuple_b_raw,
-						  field_map_b, part->fieldno);
+						  field_map_b, part->fieldno,
+						  is_compact_b);
 		}
 		assert(has_optional_parts ||
 		       (field_a != NULL && field_b != NULL));
@@ -651,22 +709,28 @@ tuple_compare_slowpath(struct tuple *tuple_a, hint_t tuple_a_hint,
 		if (is_multikey) {
 			field_a = tuple_field_raw_by_part(format_a, tuple_a_raw,
 							  field_map_a, part,
-							  (int)tuple_a_hint);
+							  (int)tuple_a_hint,
+							  is_compact_a);
 			field_b = tuple_field_raw_by_part(format_b, tuple_b_raw,
 							  field_map_b, part,
-							  (int)tuple_b_hint);
+							  (int)tuple_b_hint,
+							  is_compact_b);
 		} else if (has_json_paths) {
 			field_a = tuple_field_raw_by_part(format_a, tuple_a_raw,
 							  field_map_a, part,
-							  MULTIKEY_NONE);
+							  MULTIKEY_NONE,
+							  is_compact_a);
 			field_b = tuple_field_raw_by_part(format_b, tuple_b_raw,
 							  field_map_b, part,
-							  MULTIKEY_NONE);
+							  MULTIKEY_NONE,
+							  is_compact_b);
 		} else {
 			field_a = tuple_field_raw(format_a, tuple_a_raw,
-						  field_map_a, part->fieldno);
+						  field_map_a, part->fieldno,
+						  is_compact_a);
 			field_b = tuple_field_raw(format_b, tuple_b_raw,
-						  field_map_b, part->fieldno);
+						  field_map_b, part->fieldno,
+						  is_compact_b);
 		}
 		/*
 		 * Extended parts are primary, and they can not
@@ -704,20 +768,23 @@ tuple_compare_with_key_slowpath(struct tuple *tuple, hint_t tuple_hint,
 	struct tuple_format *format = tuple_format(tuple);
 	const char *tuple_raw = tuple_data(tuple);
 	const uint32_t *field_map = tuple_field_map(tuple);
+	bool is_compact = tuple_is_compact(tuple);
 	enum mp_type a_type, b_type;
 	if (likely(part_count == 1)) {
 		const char *field;
 		if (is_multikey) {
 			field = tuple_field_raw_by_part(format, tuple_raw,
 							field_map, part,
-							(int)tuple_hint);
+							(int)tuple_hint,
+							is_compact);
 		} else if (has_json_paths) {
 			field = tuple_field_raw_by_part(format, tuple_raw,
 							field_map, part,
-							MULTIKEY_NONE);
+							MULTIKEY_NONE,
+							is_compact);
 		} else {
 			field = tuple_field_raw(format, tuple_raw, field_map,
-						part->fieldno);
+						part->fieldno, is_compact);
 		}
 		if (! is_nullable) {
 			return tuple_compare_field(field, key, part->type,
@@ -745,14 +812,16 @@ tuple_compare_with_key_slowpath(struct tuple *tuple, hint_t tuple_hint,
 		if (is_multikey) {
 			field = tuple_field_raw_by_part(format, tuple_raw,
 							field_map, part,
-							(int)tuple_hint);
+							(int)tuple_hint,
+							is_compact);
 		} else if (has_json_paths) {
 			field = tuple_field_raw_by_part(format, tuple_raw,
 							field_map, part,
-							MULTIKEY_NONE);
+							MULTIKEY_NONE,
+							is_compact);
 		} else {
 			field = tuple_field_raw(format, tuple_raw, field_map,
-						part->fieldno);
+						part->fieldno, is_compact);
 		}
 		if (! is_nullable) {
 			rc = tuple_compare_field(field, key, part->type,
@@ -1061,11 +1130,11 @@ struct FieldCompare<IDX, TYPE, IDX2, TYPE2, MORE_TYPES...>
 			if ((r = field_compare<TYPE>(&field_a, &field_b)) != 0)
 				return r;
 			field_a = tuple_field_raw(format_a, tuple_data(tuple_a),
-						  tuple_field_map(tuple_a),
-						  IDX2);
+						  tuple_field_map(tuple_a), IDX2,
+						  tuple_is_compact(tuple_a));
 			field_b = tuple_field_raw(format_b, tuple_data(tuple_b),
-						  tuple_field_map(tuple_b),
-						  IDX2);
+						  tuple_field_map(tuple_b), IDX2,
+						  tuple_is_compact(tuple_b));
 		}
 		return FieldCompare<IDX2, TYPE2, MORE_TYPES...>::
 			compare(tuple_a, tuple_b, format_a,
@@ -1104,9 +1173,11 @@ struct TupleCompare
 		struct tuple_format *format_b = tuple_format(tuple_b);
 		const char *field_a, *field_b;
 		field_a = tuple_field_raw(format_a, tuple_data(tuple_a),
-					  tuple_field_map(tuple_a), IDX);
+					  tuple_field_map(tuple_a), IDX,
+					  tuple_is_compact(tuple_a));
 		field_b = tuple_field_raw(format_b, tuple_data(tuple_b),
-					  tuple_field_map(tuple_b), IDX);
+					  tuple_field_map(tuple_b), IDX,
+					  tuple_is_compact(tuple_b));
 		return FieldCompare<IDX, TYPE, MORE_TYPES...>::
 			compare(tuple_a, tuple_b, format_a,
 				format_b, field_a, field_b);
@@ -1248,7 +1319,8 @@ struct FieldCompareWithKey<FLD_ID, IDX, TYPE, IDX2, TYPE2, MORE_TYPES...>
 			if (r || part_count == FLD_ID + 1)
 				return r;
 			field = tuple_field_raw(format, tuple_data(tuple),
-						tuple_field_map(tuple), IDX2);
+						tuple_field_map(tuple), IDX2,
+						tuple_is_compact(tuple));
 			mp_next(&key);
 		}
 		return FieldCompareWithKey<FLD_ID + 1, IDX2, TYPE2, MORE_TYPES...>::
@@ -1289,8 +1361,8 @@ struct TupleCompareWithKey
 			return rc;
 		struct tuple_format *format = tuple_format(tuple);
 		const char *field = tuple_field_raw(format, tuple_data(tuple),
-						    tuple_field_map(tuple),
-						    IDX);
+						    tuple_field_map(tuple), IDX,
+						    tuple_is_compact(tuple));
 		return FieldCompareWithKey<FLD_ID, IDX, TYPE, MORE_TYPES...>::
 				compare(tuple, key, part_count,
 					key_def, format, field);
@@ -1393,10 +1465,12 @@ func_index_compare(struct tuple *tuple_a, hint_t tuple_a_hint,
 		struct key_part *part = &cmp_def->parts[i];
 		field_a = tuple_field_raw_by_part(format_a, tuple_a_raw,
 						  field_map_a, part,
-						  MULTIKEY_NONE);
+						  MULTIKEY_NONE,
+						  tuple_is_compact(tuple_a));
 		field_b = tuple_field_raw_by_part(format_b, tuple_b_raw,
 						  field_map_b, part,
-						  MULTIKEY_NONE);
+						  MULTIKEY_NONE,
+						  tuple_is_compact(tuple_b));
 		assert(field_a != NULL && field_b != NULL);
 		rc = tuple_compare_field(field_a, field_b, part->type,
 					 part->coll);
@@ -1525,6 +1599,28 @@ func_index_compare_with_key(struct tuple *tuple, hint_t tuple_hint,
 static_assert(mp_class_max < (1 << HINT_CLASS_BITS) - 1,
 	      "mp_class must fit in tuple hint");
 
+/**
+ * Compare two string fields whose comparison hints are equal.
+ * Equal hints of two long enough strings guarantee that their
+ * first HINT_VALUE_BYTES bytes match (see hint_str()), so the
+ * comparison resumes past the shared prefix instead of reading
+ * it again. Tree scans over keys with a long common prefix hit
+ * this path on nearly every comparison.
+ */
+static inline int
+mp_compare_str_hinted(const char *field_a, const char *field_b)
+{
+	uint32_t size_a = mp_decode_strl(&field_a);
+	uint32_t size_b = mp_decode_strl(&field_b);
+	if (size_a >= HINT_VALUE_BYTES && size_b >= HINT_VALUE_BYTES) {
+		return mp_compare_data(field_a + HINT_VALUE_BYTES,
+				       size_a - HINT_VALUE_BYTES,
+				       field_b + HINT_VALUE_BYTES,
+				       size_b - HINT_VALUE_BYTES);
+	}
+	return mp_compare_data(field_a, size_a, field_b, size_b);
+}
+
 static inline hint_t
 hint_create(enum mp_class c, uint64_t val)
 {
@@ -31,6 +31,7 @@
 #include "bit/bit.h"
 #include "fiber.h"
 #include "json/json.h"
+#include "tuple.h"
 #include "tuple_format.h"
 #include "coll_id_cache.h"
 #include "tt_static.h"
@@ -441,6 +442,7 @@ tuple_format_create(struct tuple_format *format, struct key_def * const *keys,
 					     field_count);
 	if (tuple_format_field_count(format) == 0) {
 		format->field_map_size = 0;
+		format->is_trivial = format->exact_field_count == 0;
 		return 0;
 	}
 	/* Initialize defined fields */
@@ -491,8 +493,8 @@ tuple_format_create(struct tuple_format *format, struct key_def * const *keys,
 	assert(tuple_format_field(format, 0)->offset_slot == TUPLE_OFFSET_SLOT_NIL
 	       || json_token_is_multikey(&tuple_format_field(format, 0)->token));
 	size_t field_map_size = -current_slot * sizeof(uint32_t);
-	if (field_map_size > INT16_MAX) {
-		/** tuple->data_offset is 15 bits */
+	if (field_map_size > TUPLE_DATA_OFFSET_MAX) {
+		/** tuple->data_offset is 14 bits */
 		diag_set(ClientError, ER_INDEX_FIELD_COUNT_LIMIT,
 			 -current_slot);
 		return -1;
@@ -547,6 +549,19 @@ tuple_format_create(struct tuple_format *format, struct key_def * const *keys,
 		    !tuple_field_is_nullable(field))
 			bit_set(required_fields, field->id);
 	}
+	/*
+	 * Find out whether the data walk on field map creation may
+	 * be skipped for this format, see the is_trivial member
+	 * description.
+	 */
+	format->is_trivial = format->field_map_size == 0 &&
+			     format->exact_field_count == 0;
+	json_tree_foreach_entry_preorder(field, &format->fields.root,
+					 struct tuple_field, token) {
+		if (field->type != FIELD_TYPE_ANY ||
+		    !tuple_field_is_nullable(field))
+			format->is_trivial = false;
+	}
 	format->hash = tuple_format_hash(format);
 	return 0;
 }
@@ -822,7 +837,14 @@ bool
 tuple_format1_can_store_format2_tuples(struct tuple_format *format1,
 				       struct tuple_format *format2)
 {
-	if (format1->exact_field_count != format2->exact_field_count)
+	/*
+	 * No exact field count in format1 is no constraint at all,
+	 * whatever format2 demanded. A non-zero one must match
+	 * format2 exactly: old tuples all have format2's count if
+	 * it is set and an arbitrary count otherwise.
+	 */
+	if (format1->exact_field_count != 0 &&
+	    format1->exact_field_count != format2->exact_field_count)
 		return false;
 	struct tuple_field *field1;
 	json_tree_foreach_entry_preorder(field1, &format1->fields.root,
@@ -942,6 +964,15 @@ tuple_field_map_create(struct tuple_format *format, const char *tuple,
 	if (tuple_format_field_count(format) == 0)
 		return 0; /* Nothing to initialize */
 
+	/*
+	 * A trivial format accepts any tuple and stores no offsets,
+	 * so there is nothing to walk the data for. The same holds
+	 * for a slotless format when validation is not requested.
+	 */
+	if (format->is_trivial ||
+	    (!validate && format->field_map_size == 0))
+		return 0;
+
 	/*
 	 * In case tuple format doesn't contain fields accessed by JSON paths,
 	 * tuple field traversal may be simplified.
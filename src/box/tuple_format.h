@@ -193,6 +193,16 @@ struct tuple_format {
 	 * be shared with other ephemeral spaces.
 	 */
 	bool is_ephemeral;
+	/**
+	 * True, if the format has no offset slots to fill, no
+	 * required fields and no field type restrictions, so it
+	 * cannot reject or annotate any tuple. Field map creation
+	 * may skip the MessagePack walk for such a format entirely,
+	 * which matters on bulk load. A typical case is a space
+	 * with a primary key over the first tuple fields and no
+	 * declared field types.
+	 */
+	bool is_trivial;
 	/**
 	 * Size of minimal field map of tuple where each indexed
 	 * field has own offset slot (in bytes). The real tuple
@@ -38,6 +38,7 @@
 #include "xrow.h"
 #include "errinj.h"
 #include "iproto_constants.h"
+#include "assoc.h"
 
 double too_long_threshold;
 
@@ -243,6 +244,11 @@ txn_free(struct txn *txn)
 	stailq_foreach_entry(stmt, &txn->stmts, next)
 		txn_stmt_destroy(stmt);
 
+	if (txn->savepoint_map != NULL) {
+		mh_strnptr_delete(txn->savepoint_map);
+		txn->savepoint_map = NULL;
+	}
+
 	/* Truncate region up to struct txn size. */
 	region_truncate(&txn->region, sizeof(struct txn));
 	stailq_add(&txn_cache, &txn->in_txn_cache);
@@ -275,6 +281,7 @@ txn_begin(void)
 	txn->engine_tx = NULL;
 	txn->fk_deferred_count = 0;
 	rlist_create(&txn->savepoints);
+	txn->savepoint_map = NULL;
 	txn->fiber = NULL;
 	fiber_set_txn(fiber(), txn);
 	/* fiber_on_yield is initialized by engine on demand */
@@ -381,10 +388,11 @@ txn_commit_stmt(struct txn *txn, struct request *request)
 
 	/*
 	 * Create WAL record for the write requests in
-	 * non-temporary spaces. stmt->space can be NULL for
-	 * IRPOTO_NOP or IPROTO_CONFIRM.
+	 * non-temporary, journalled spaces. stmt->space can be
+	 * NULL for IRPOTO_NOP or IPROTO_CONFIRM.
 	 */
-	if (stmt->space == NULL || !space_is_temporary(stmt->space)) {
+	if (stmt->space == NULL || (!space_is_temporary(stmt->space) &&
+				    !space_is_nolog(stmt->space))) {
 		if (txn_add_redo(txn, stmt, request) != 0)
 			goto fail;
 		assert(stmt->row != NULL);
@@ -1071,6 +1079,56 @@ box_txn_alloc(size_t size)
 	                            alignof(union natural_align));
 }
 
+/**
+ * Insert a named savepoint into the name hash, creating the hash
+ * on first use so that transactions without named savepoints do
+ * not allocate it.
+ */
+static int
+txn_savepoint_map_put(struct txn *txn, struct txn_savepoint *svp)
+{
+	if (txn->savepoint_map == NULL) {
+		txn->savepoint_map = mh_strnptr_new();
+		if (txn->savepoint_map == NULL) {
+			diag_set(OutOfMemory, sizeof(*txn->savepoint_map),
+				 "malloc", "savepoint_map");
+			return -1;
+		}
+	}
+	size_t name_len = strlen(svp->name);
+	struct mh_strnptr_node_t node = {
+		.str	= svp->name,
+		.len	= name_len,
+		.hash	= mh_strn_hash(svp->name, name_len),
+		.val	= svp,
+	};
+	if (mh_strnptr_put(txn->savepoint_map, &node, NULL,
+			   NULL) == mh_end(txn->savepoint_map)) {
+		diag_set(OutOfMemory, sizeof(node), "malloc", "savepoint_map");
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Remove a discarded savepoint from the name hash. A later
+ * savepoint with the same name replaces the hash entry of the one
+ * it shadows, so only delete the entry if it still points at @a
+ * svp.
+ */
+static void
+txn_savepoint_map_del(struct txn *txn, struct txn_savepoint *svp)
+{
+	if (svp->name[0] == 0)
+		return;
+	assert(txn->savepoint_map != NULL);
+	mh_int_t pos = mh_strnptr_find_inp(txn->savepoint_map, svp->name,
+					   strlen(svp->name));
+	if (pos != mh_end(txn->savepoint_map) &&
+	    mh_strnptr_node(txn->savepoint_map, pos)->val == svp)
+		mh_strnptr_del(txn->savepoint_map, pos, NULL);
+}
+
 struct txn_savepoint *
 txn_savepoint_new(struct txn *txn, const char *name)
 {
@@ -1090,16 +1148,25 @@ txn_savepoint_new(struct txn *txn, const char *name)
 	svp->in_sub_stmt = txn->in_sub_stmt;
 	svp->fk_deferred_count = txn->fk_deferred_count;
 	if (name != NULL) {
+		struct txn_savepoint *old_svp =
+			txn_savepoint_by_name(txn, name);
+		memcpy(svp->name, name, name_len + 1);
+		/*
+		 * Insert into the hash before delisting the
+		 * shadowed savepoint: if the insertion fails, the
+		 * old one must stay reachable both by name and in
+		 * the list, or a later rollback to it would step
+		 * on a delisted node.
+		 */
+		if (txn_savepoint_map_put(txn, svp) != 0)
+			return NULL;
 		/*
 		 * If savepoint with given name already exists,
 		 * erase it from the list. This has to be done
 		 * in accordance with ANSI SQL compliance.
 		 */
-		struct txn_savepoint *old_svp =
-			txn_savepoint_by_name(txn, name);
 		if (old_svp != NULL)
 			rlist_del(&old_svp->link);
-		memcpy(svp->name, name, name_len + 1);
 	} else {
 		svp->name[0] = 0;
 	}
@@ -1111,12 +1178,13 @@ struct txn_savepoint *
 txn_savepoint_by_name(struct txn *txn, const char *name)
 {
 	assert(txn == in_txn());
-	struct txn_savepoint *sv;
-	rlist_foreach_entry(sv, &txn->savepoints, link) {
-		if (strcmp(sv->name, name) == 0)
-			return sv;
-	}
-	return NULL;
+	if (txn->savepoint_map == NULL)
+		return NULL;
+	mh_int_t pos = mh_strnptr_find_inp(txn->savepoint_map, name,
+					   strlen(name));
+	if (pos == mh_end(txn->savepoint_map))
+		return NULL;
+	return mh_strnptr_node(txn->savepoint_map, pos)->val;
 }
 
 box_txn_savepoint_t *
@@ -1156,6 +1224,9 @@ box_txn_rollback_to_savepoint(box_txn_savepoint_t *svp)
 	/* Discard from list all newer savepoints. */
 	RLIST_HEAD(discard);
 	rlist_cut_before(&discard, &txn->savepoints, &svp->link);
+	struct txn_savepoint *discarded;
+	rlist_foreach_entry(discarded, &discard, link)
+		txn_savepoint_map_del(txn, discarded);
 	txn->fk_deferred_count = svp->fk_deferred_count;
 	return 0;
 }
@@ -1176,6 +1247,9 @@ txn_savepoint_release(struct txn_savepoint *svp)
 	 */
 	RLIST_HEAD(discard);
 	rlist_cut_before(&discard, &txn->savepoints, rlist_next(&svp->link));
+	struct txn_savepoint *discarded;
+	rlist_foreach_entry(discarded, &discard, link)
+		txn_savepoint_map_del(txn, discarded);
 }
 
 static int
@@ -53,6 +53,7 @@ struct space;
 struct tuple;
 struct xrow_header;
 struct Vdbe;
+struct mh_strnptr_t;
 
 enum txn_flag {
 	/** Transaction has been processed. */
@@ -377,6 +378,15 @@ struct txn {
 	uint32_t fk_deferred_count;
 	/** List of savepoints to find savepoint by name. */
 	struct rlist savepoints;
+	/**
+	 * Hash of named savepoints (name -> txn_savepoint), kept in
+	 * sync with the savepoints list. NULL until the first named
+	 * savepoint is created, so transactions that never use them
+	 * pay nothing. SQL migration scripts may create thousands of
+	 * named savepoints in one transaction, and a list scan per
+	 * lookup made that quadratic.
+	 */
+	struct mh_strnptr_t *savepoint_map;
 	/**
 	 * List of tx_conflict_tracker records where .breaker is the current
 	 * transaction and .victim is the transactions that must be aborted
@@ -28,6 +28,7 @@
  * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
  * SUCH DAMAGE.
  */
+#include "flightrec.h"
 #include "txn.h"
 #include "txn_limbo.h"
 #include "replication.h"
@@ -99,6 +100,8 @@ txn_limbo_append(struct txn_limbo *limbo, uint32_t id, struct txn *txn)
 		if (rlist_empty(&limbo->queue)) {
 			limbo->owner_id = id;
 			limbo->confirmed_lsn = 0;
+			flightrec_record(FLIGHTREC_STATE,
+					 FLIGHTREC_SUBSYS_LIMBO, id, 0);
 			if (id != instance_id)
 				make_ro = true;
 		} else {
@@ -359,7 +362,13 @@ txn_limbo_write_synchro(struct txn_limbo *limbo, uint16_t type, int64_t lsn,
 static void
 txn_limbo_write_confirm(struct txn_limbo *limbo, int64_t lsn)
 {
-	assert(lsn > limbo->confirmed_lsn);
+	/*
+	 * The LSN may be equal to confirmed_lsn when the batching
+	 * loop in txn_limbo_confirm_batch() writes a follow-up
+	 * request for LSNs folded into confirmed_lsn during the
+	 * previous WAL write.
+	 */
+	assert(lsn >= limbo->confirmed_lsn);
 	assert(!limbo->is_in_rollback);
 	limbo->confirmed_lsn = lsn;
 	txn_limbo_write_synchro(limbo, IPROTO_CONFIRM, lsn, 0);
@@ -405,6 +414,40 @@ txn_limbo_read_confirm(struct txn_limbo *limbo, int64_t lsn)
 		box_update_ro_summary();
 }
 
+/**
+ * Write a CONFIRM covering @a confirm_lsn and complete the covered
+ * transactions. The CONFIRM WAL write yields, and while it is in
+ * progress more transactions may gather a quorum. They fold into
+ * confirmed_lsn instead of queueing a WAL write each, and the loop
+ * here covers them all with a single follow-up request. This way a
+ * burst of quorums costs a couple of CONFIRM writes instead of one
+ * per transaction.
+ */
+static void
+txn_limbo_confirm_batch(struct txn_limbo *limbo, int64_t confirm_lsn)
+{
+	assert(confirm_lsn > limbo->confirmed_lsn);
+	if (limbo->is_writing_confirm) {
+		/*
+		 * Bumping confirmed_lsn right away also keeps timed
+		 * out waiters of the folded transactions waiting
+		 * instead of writing a conflicting ROLLBACK - the
+		 * LSN counts as "confirmation in progress".
+		 */
+		limbo->confirmed_lsn = confirm_lsn;
+		return;
+	}
+	limbo->is_writing_confirm = true;
+	int64_t written_lsn;
+	do {
+		written_lsn = confirm_lsn;
+		txn_limbo_write_confirm(limbo, confirm_lsn);
+		txn_limbo_read_confirm(limbo, confirm_lsn);
+		confirm_lsn = limbo->confirmed_lsn;
+	} while (confirm_lsn > written_lsn);
+	limbo->is_writing_confirm = false;
+}
+
 /**
  * Write a rollback message to WAL. After it's written all the
  * transactions following the current one and waiting for
@@ -484,6 +527,8 @@ txn_limbo_read_promote(struct txn_limbo *limbo, uint32_t replica_id,
 	assert(txn_limbo_is_empty(&txn_limbo));
 	limbo->owner_id = replica_id;
 	limbo->confirmed_lsn = 0;
+	flightrec_record(FLIGHTREC_STATE, FLIGHTREC_SUBSYS_LIMBO,
+			 replica_id, lsn);
 }
 
 void
@@ -539,8 +584,7 @@ txn_limbo_ack(struct txn_limbo *limbo, uint32_t replica_id, int64_t lsn)
 	}
 	if (confirm_lsn == -1 || confirm_lsn <= limbo->confirmed_lsn)
 		return;
-	txn_limbo_write_confirm(limbo, confirm_lsn);
-	txn_limbo_read_confirm(limbo, confirm_lsn);
+	txn_limbo_confirm_batch(limbo, confirm_lsn);
 }
 
 /**
@@ -703,10 +747,8 @@ txn_limbo_on_parameters_change(struct txn_limbo *limbo)
 			assert(confirm_lsn > 0);
 		}
 	}
-	if (confirm_lsn > limbo->confirmed_lsn && !limbo->is_in_rollback) {
-		txn_limbo_write_confirm(limbo, confirm_lsn);
-		txn_limbo_read_confirm(limbo, confirm_lsn);
-	}
+	if (confirm_lsn > limbo->confirmed_lsn && !limbo->is_in_rollback)
+		txn_limbo_confirm_batch(limbo, confirm_lsn);
 	/*
 	 * Wakeup all the others - timed out will rollback. Also
 	 * there can be non-transactional waiters, such as CONFIRM
@@ -179,6 +179,15 @@ struct txn_limbo {
 	 * by the 'reversed rollback order' rule - contradiction.
 	 */
 	bool is_in_rollback;
+	/**
+	 * Whether a fiber is writing a CONFIRM request to WAL right
+	 * now. While the write is in progress more transactions may
+	 * gather a quorum; instead of queueing one CONFIRM WAL write
+	 * each they bump confirmed_lsn, and the active writer covers
+	 * them all with a follow-up request, see
+	 * txn_limbo_confirm_batch().
+	 */
+	bool is_writing_confirm;
 };
 
 /**
@@ -295,6 +295,7 @@ vy_info_append_memory(struct vy_env *env, struct info_handler *h)
 	info_append_int(h, "tx", vy_tx_manager_mem_used(env->xm));
 	info_append_int(h, "level0", lsregion_used(&env->mem_env.allocator));
 	info_append_int(h, "tuple_cache", env->cache_env.mem_used);
+	info_append_int(h, "stmt_buf_cache", env->stmt_env.buf_cache_size);
 	info_append_int(h, "page_index", env->lsm_env.page_index_size);
 	info_append_int(h, "bloom_filter", env->lsm_env.bloom_size);
 	info_table_end(h); /* memory */
@@ -2620,6 +2621,12 @@ vy_env_new(const char *path, size_t memory,
 	               sizeof(struct vinyl_iterator));
 	vy_cache_env_create(&e->cache_env, slab_cache);
 	vy_run_env_create(&e->run_env, read_threads);
+	/*
+	 * Prewarm at most as much run data as vinyl may keep in
+	 * memory anyway - advising more would just make the kernel
+	 * evict one part of the database to fault in another.
+	 */
+	e->run_env.prewarm_quota = memory;
 	vy_log_init(e->path);
 	return e;
 
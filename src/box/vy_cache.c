@@ -47,6 +47,12 @@ enum {
 	/* Flag in cache node that means that there are no values in DB
 	 * that greater than the current and less than the previous */
 	VY_CACHE_RIGHT_LINKED = 2,
+	/* Flag in cache node that is set when the node is returned by
+	 * a cache iterator and cleared by the garbage collector. A node
+	 * carrying this flag gets a second chance on eviction so that
+	 * a one-shot scan can't flush frequently read entries out of
+	 * the cache. */
+	VY_CACHE_REFERENCED = 4,
 	/* Max number of deletes that are made by cleanup action per one
 	 * cache operation */
 	VY_CACHE_CLEANUP_MAX_STEPS = 10,
@@ -169,6 +175,18 @@ vy_cache_gc_step(struct vy_cache_env *env)
 	struct rlist *lru = &env->cache_lru;
 	struct vy_cache_node *node =
 		rlist_last_entry(lru, struct vy_cache_node, in_lru);
+	if (node->flags & VY_CACHE_REFERENCED) {
+		/*
+		 * The node was read since it was added or last
+		 * considered for eviction. Give it a second chance:
+		 * move it back to the head of the LRU list so that
+		 * entries inserted by a one-shot scan are evicted
+		 * before it.
+		 */
+		node->flags &= ~VY_CACHE_REFERENCED;
+		rlist_move(lru, &node->in_lru);
+		return;
+	}
 	struct vy_cache *cache = node->cache;
 	struct vy_cache_tree *tree = &cache->cache_tree;
 	if (node->flags & (VY_CACHE_LEFT_LINKED | VY_CACHE_RIGHT_LINKED)) {
@@ -610,6 +628,7 @@ vy_cache_iterator_step(struct vy_cache_iterator *itr)
 	    vy_entry_compare(itr->key, node->entry, itr->cache->cmp_def)) {
 		return vy_cache_iterator_is_end_stop(itr, prev_node);
 	}
+	node->flags |= VY_CACHE_REFERENCED;
 	itr->curr = node->entry;
 	tuple_ref(itr->curr.stmt);
 	return vy_cache_iterator_is_stop(itr, node);
@@ -689,6 +708,7 @@ vy_cache_iterator_seek(struct vy_cache_iterator *itr, struct vy_entry last)
 						    itr->cache->cmp_def) != 0)))
 		return false;
 
+	node->flags |= VY_CACHE_REFERENCED;
 	itr->curr = node->entry;
 	tuple_ref(itr->curr.stmt);
 	return vy_cache_iterator_is_stop(itr, node);
@@ -139,6 +139,11 @@ struct vy_log_tx {
 	struct region region;
 	/** List of records, linked by vy_log_record::in_tx. */
 	struct stailq records;
+	/**
+	 * Number of records in the list. Saves the flusher a walk
+	 * over the list just to size the journal entry.
+	 */
+	int n_records;
 };
 
 /** Metadata log object. */
@@ -784,6 +789,7 @@ vy_log_tx_new(void)
 	}
 	region_create(&tx->region, cord_slab_cache());
 	stailq_create(&tx->records);
+	tx->n_records = 0;
 	tx->in_pending.next = NULL;
 	return tx;
 }
@@ -810,10 +816,8 @@ vy_log_tx_flush(struct vy_log_tx *tx)
 	});
 	ERROR_INJECT_YIELD(ERRINJ_VY_LOG_FLUSH_DELAY);
 
-	int tx_size = 0;
+	int tx_size = tx->n_records;
 	struct vy_log_record *record;
-	stailq_foreach_entry(record, &tx->records, in_tx)
-		tx_size++;
 
 	size_t used = region_used(&fiber()->gc);
 
@@ -886,8 +890,7 @@ vy_log_flush(void)
 		stailq_shift(&pending);
 		vy_log_tx_delete(tx);
 	}
-	stailq_concat(&pending, &vy_log.pending_tx);
-	stailq_concat(&vy_log.pending_tx, &pending);
+	stailq_concat_head(&vy_log.pending_tx, &pending);
 	return rc;
 }
 
@@ -1402,6 +1405,7 @@ vy_log_write(const struct vy_log_record *record)
 		return;
 	}
 	stailq_add_tail_entry(&vy_log.tx->records, tx_record, in_tx);
+	vy_log.tx->n_records++;
 }
 
 /**
@@ -684,6 +684,19 @@ vy_lsm_recover(struct vy_lsm *lsm, struct vy_recovery *recovery,
 				    (long long)prev->id));
 		return -1;
 	}
+	/*
+	 * Start pulling run data back into the page cache while
+	 * recovery is still replaying the WAL. With no persisted
+	 * access statistics, recency is the best hotness predictor
+	 * an LSM tree offers: walk each range's slices from the
+	 * newest down so the budget is spent on the freshest runs.
+	 */
+	for (range = vy_range_tree_first(&lsm->range_tree); range != NULL;
+	     range = vy_range_tree_next(&lsm->range_tree, range)) {
+		struct vy_slice *slice;
+		rlist_foreach_entry(slice, &range->slices, in_range)
+			vy_run_prewarm(run_env, slice->run);
+	}
 	return 0;
 }
 
@@ -119,6 +119,16 @@ vy_mem_new(struct vy_mem_env *env, struct key_def *cmp_def,
 			   vy_mem_tree_extent_free, index);
 	rlist_create(&index->in_sealed);
 	fiber_cond_create(&index->pin_cond);
+	/*
+	 * Make sure the allocator has a slab ready for the first
+	 * tree extent. A new in-memory level is typically installed
+	 * when the active one is sealed for dump, and reserving the
+	 * slab here keeps the first writer of the new generation
+	 * from paying for arena mapping. This is best effort - if
+	 * the reservation fails, the first insertion will allocate
+	 * the extent and report the error as usual.
+	 */
+	lsregion_reserve(&env->allocator, VY_MEM_TREE_EXTENT_SIZE);
 	return index;
 }
 
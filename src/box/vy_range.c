@@ -415,10 +415,15 @@ vy_range_update_compaction_priority(struct vy_range *range,
 		}
 	}
 
-	if (level_run_count > 1) {
+	if (level_run_count > 1 &&
+	    opts->compaction_policy != VY_COMPACTION_TIERED) {
 		/*
 		 * Do not store more than one run at the last level
-		 * to keep space amplification low.
+		 * to keep space amplification low. The tiered
+		 * policy deliberately skips this rule: the oldest
+		 * run is rewritten only when the run count at its
+		 * level demands it, trading space amplification
+		 * for much lower write amplification.
 		 */
 		range->compaction_priority = total_run_count;
 		range->compaction_queue = total_stmt_count;
@@ -577,6 +577,22 @@ vy_read_iterator_add_disk(struct vy_read_iterator *itr)
 	 * format in vy_mem.
 	 */
 	rlist_foreach_entry(slice, &itr->curr_range->slices, in_range) {
+		/*
+		 * Check the bloom filter before opening a source.
+		 * Covers not only plain EQ, but also REQ, which
+		 * source iterators see as LE and hence could
+		 * never prune themselves: the run bloom keeps a
+		 * filter per key prefix length, so a partial-key
+		 * reverse lookup is pruned here as well.
+		 */
+		if ((itr->iterator_type == ITER_EQ ||
+		     itr->iterator_type == ITER_REQ) &&
+		    slice->run->info.bloom != NULL &&
+		    !vy_bloom_maybe_has(slice->run->info.bloom, itr->key,
+					lsm->key_def)) {
+			lsm->stat.disk.iterator.bloom_hit++;
+			continue;
+		}
 		struct vy_read_src *sub_src = vy_read_iterator_add_src(itr);
 		vy_run_iterator_open(&sub_src->run_iterator,
 				     &lsm->stat.disk.iterator, slice,
@@ -30,6 +30,7 @@
  */
 #include "vy_run.h"
 
+#include <fcntl.h>
 #include <zstd.h>
 
 #include "fiber.h"
@@ -955,6 +956,26 @@ error:
 	return -1;
 }
 
+/**
+ * Hint the kernel to prefetch a run page so that its data is
+ * likely to be in the page cache by the time it is actually read
+ * and decompressed. Errors are not critical and only logged.
+ */
+static void
+vy_run_advise_page(struct vy_run *run, uint32_t page_no)
+{
+	if (page_no >= run->info.page_count)
+		return;
+#ifdef HAVE_POSIX_FADVISE
+	struct vy_page_info *page_info = vy_run_page_info(run, page_no);
+	if (posix_fadvise(run->fd, page_info->offset, page_info->size,
+			  POSIX_FADV_WILLNEED) != 0)
+		say_syserror("posix_fadvise, fd=%i", run->fd);
+#else
+	(void)run;
+#endif
+}
+
 /**
  * Get thread local zstd decompression context
  */
@@ -1078,6 +1099,17 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 	itr->stat->read.bytes_compressed += page_info->size;
 	itr->stat->read.pages++;
 
+	/*
+	 * Ask the kernel to prefetch the next page in the scan
+	 * direction so that a range scan overlaps disk reads with
+	 * searching the current page. Point lookups touching a
+	 * single page only waste one readahead request.
+	 */
+	if (iterator_direction(itr->iterator_type) > 0)
+		vy_run_advise_page(slice->run, page_no + 1);
+	else if (page_no > 0)
+		vy_run_advise_page(slice->run, page_no - 1);
+
 	*result = page;
 	return 0;
 }
@@ -1109,6 +1141,34 @@ vy_run_iterator_read(struct vy_run_iterator *itr,
 	return 0;
 }
 
+/**
+ * Read only the LSN of a statement by a given wide position.
+ * Unlike vy_run_iterator_read(), this function doesn't decode
+ * the statement body and hence doesn't allocate a tuple - the
+ * LSN is taken right from the row header.
+ *
+ * @retval 0 success
+ * @retval -1 read error or out of memory.
+ */
+static NODISCARD int
+vy_run_iterator_read_lsn(struct vy_run_iterator *itr,
+			 struct vy_run_iterator_pos pos, int64_t *lsn)
+{
+	struct vy_page *page;
+	bool equal_found;
+	uint32_t pos_in_page;
+	int rc = vy_run_iterator_load_page(itr, pos.page_no, vy_entry_none(),
+					   ITER_GE, &page, &pos_in_page,
+					   &equal_found);
+	if (rc != 0)
+		return rc;
+	struct xrow_header xrow;
+	if (vy_page_xrow(page, pos.pos_in_page, &xrow) != 0)
+		return -1;
+	*lsn = xrow.lsn;
+	return 0;
+}
+
 /**
  * Binary search in a run for the given key.
  * In terms of STL, makes lower_bound for EQ,GE,LT and upper_bound for GT,LE
@@ -1212,15 +1272,35 @@ vy_run_iterator_find_lsn(struct vy_run_iterator *itr, struct vy_entry *ret)
 	assert(itr->curr.stmt != NULL);
 	assert(itr->curr_pos.page_no < slice->run->info.page_count);
 
-	while (vy_stmt_lsn(itr->curr.stmt) > (**itr->read_view).vlsn ||
-	       vy_stmt_flags(itr->curr.stmt) & VY_STMT_SKIP_READ) {
+	for (;;) {
+		if (itr->curr.stmt != NULL &&
+		    vy_stmt_lsn(itr->curr.stmt) <= (**itr->read_view).vlsn &&
+		    (vy_stmt_flags(itr->curr.stmt) & VY_STMT_SKIP_READ) == 0)
+			break;
 		if (vy_run_iterator_next_pos(itr, itr->iterator_type,
 					     &itr->curr_pos) != 0) {
 			vy_run_iterator_stop(itr);
 			return 0;
 		}
-		tuple_unref(itr->curr.stmt);
-		itr->curr = vy_entry_none();
+		if (itr->curr.stmt != NULL) {
+			tuple_unref(itr->curr.stmt);
+			itr->curr = vy_entry_none();
+		}
+		/*
+		 * Skip statement versions invisible in the read view
+		 * by peeking at the row header so that no tuple is
+		 * materialized for them. An EQ search has to decode
+		 * every row anyway to detect the end of the series
+		 * of statements matching the search key.
+		 */
+		if (itr->iterator_type != ITER_EQ) {
+			int64_t lsn;
+			if (vy_run_iterator_read_lsn(itr, itr->curr_pos,
+						     &lsn) != 0)
+				return -1;
+			if (lsn > (**itr->read_view).vlsn)
+				continue;
+		}
 		if (vy_run_iterator_read(itr, itr->curr_pos, &itr->curr) != 0)
 			return -1;
 		if (itr->iterator_type == ITER_EQ &&
@@ -1779,6 +1859,25 @@ fail:
 	return -1;
 }
 
+void
+vy_run_prewarm(struct vy_run_env *env, struct vy_run *run)
+{
+	if (run->prewarmed || env->prewarm_quota <= 0 || run->fd < 0)
+		return;
+	run->prewarmed = true;
+	/*
+	 * Charge the whole run before checking the budget again:
+	 * overshooting by one run is harmless, while splitting a
+	 * run into an advised and a cold half would only tear the
+	 * kernel's readahead apart.
+	 */
+	env->prewarm_quota -= run->count.bytes_compressed;
+#ifdef HAVE_POSIX_FADVISE
+	if (posix_fadvise(run->fd, 0, 0, POSIX_FADV_WILLNEED) != 0)
+		say_syserror("posix_fadvise, fd=%i", run->fd);
+#endif
+}
+
 /* dump statement to the run page buffers (stmt header and data) */
 static int
 vy_run_dump_stmt(struct vy_entry entry, struct xlog *data_xlog,
@@ -2586,6 +2685,14 @@ vy_slice_stream_read_page(struct vy_slice_stream *stream)
 	if (stream->page == NULL)
 		return -1;
 
+	/*
+	 * A slice stream reads pages strictly in order, so ask
+	 * the kernel to fetch the next page while the current
+	 * one is being decompressed and processed. This keeps
+	 * dump and compaction readers from stalling on every
+	 * page boundary.
+	 */
+	vy_run_advise_page(run, stream->page_no + 1);
 	if (vy_page_read(stream->page, page_info, run, zdctx) != 0) {
 		vy_page_delete(stream->page);
 		stream->page = NULL;
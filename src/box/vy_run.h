@@ -69,6 +69,12 @@ struct vy_run_env {
 	 * processing the next read request.
 	 */
 	int next_reader;
+	/**
+	 * Number of bytes of run data which may still be prewarmed
+	 * into the page cache on recovery, see vy_run_prewarm().
+	 * Non-positive means the prewarm budget is exhausted.
+	 */
+	int64_t prewarm_quota;
 };
 
 /**
@@ -125,6 +131,8 @@ struct vy_run {
 	int fd;
 	/** Unique ID of this run. */
 	int64_t id;
+	/** Set once the run was prewarmed, see vy_run_prewarm(). */
+	bool prewarmed;
 	/** Number of statements in this run. */
 	struct vy_disk_stmt_counter count;
 	/** Size of memory used for storing page index. */
@@ -383,6 +391,15 @@ int
 vy_run_recover(struct vy_run *run, const char *dir,
 	       uint32_t space_id, uint32_t iid, struct key_def *cmp_def);
 
+/**
+ * Ask the kernel to pull the data file of a recovered run back
+ * into the page cache, charging its compressed size to the
+ * environment-wide prewarm quota. Once the quota is spent the
+ * call becomes a no-op, as does a repeated call for the same run.
+ */
+void
+vy_run_prewarm(struct vy_run_env *env, struct vy_run *run);
+
 /**
  * Rebuild run index
  * @param run - run to rebuild index for
@@ -1061,6 +1061,8 @@ vy_task_write_run(struct vy_task *task, bool no_compression)
 		     {diag_set(ClientError, ER_INJECTION,
 			       "vinyl dump"); return -1;});
 	ERROR_INJECT_SLEEP(ERRINJ_VY_RUN_WRITE_DELAY);
+	/* Chaos testing: simulate slow run writes, see errinj.h. */
+	DELAY_INJECT_BLOCKING(ERRINJ_DELAY_VY_RUN_WRITE);
 
 	struct vy_run_writer writer;
 	if (vy_run_writer_create(&writer, task->new_run, lsm->env->path,
@@ -1899,6 +1901,17 @@ retry:
 		goto no_task; /* nothing to do */
 	if (worker == NULL) {
 		worker = vy_worker_pool_get(&scheduler->compaction_pool);
+		if (worker == NULL && scheduler->dump_task_count == 0) {
+			/*
+			 * No dump is running: let compaction
+			 * borrow idle dump workers instead of
+			 * leaving them parked. A worker returns
+			 * to its own pool when put back, so the
+			 * next dump waits for the borrowed
+			 * worker's current task at worst.
+			 */
+			worker = vy_worker_pool_get(&scheduler->dump_pool);
+		}
 		if (worker == NULL)
 			return 0; /* all workers are busy */
 	}
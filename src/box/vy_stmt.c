@@ -95,11 +95,63 @@ vy_tuple_new(struct tuple_format *format, const char *data, const char *end)
 	return tuple;
 }
 
+/**
+ * Try to take a buffer of at least @size bytes from the statement
+ * buffer cache. To keep internal fragmentation in check a cached
+ * buffer is only reused if no more than half of it would be wasted.
+ *
+ * @retval not NULL Buffer taken from the cache.
+ * @retval     NULL The cache has no suitable buffer.
+ */
+static void *
+vy_stmt_buf_cache_get(struct vy_stmt_env *env, uint32_t size)
+{
+	if (!cord_is_main())
+		return NULL;
+	for (int i = 0; i < VY_STMT_BUF_CACHE_SLOTS; i++) {
+		struct vy_stmt_buf_cache_slot *slot = &env->buf_cache[i];
+		if (slot->size >= size && slot->size <= 2 * size) {
+			void *buf = slot->buf;
+			env->buf_cache_size -= slot->size;
+			slot->buf = NULL;
+			slot->size = 0;
+			return buf;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Offer a freed statement buffer of @size bytes to the statement
+ * buffer cache. If the cache is full or the buffer is too big to
+ * cache, the buffer is freed.
+ */
+static void
+vy_stmt_buf_cache_put(struct vy_stmt_env *env, void *buf, uint32_t size)
+{
+	if (!cord_is_main() || size > VY_STMT_BUF_CACHE_MAX_SIZE) {
+		free(buf);
+		return;
+	}
+	for (int i = 0; i < VY_STMT_BUF_CACHE_SLOTS; i++) {
+		struct vy_stmt_buf_cache_slot *slot = &env->buf_cache[i];
+		if (slot->size == 0) {
+			slot->buf = buf;
+			slot->size = size;
+			env->buf_cache_size += size;
+			return;
+		}
+	}
+	free(buf);
+}
+
 static void
 vy_tuple_delete(struct tuple_format *format, struct tuple *tuple)
 {
 	say_debug("%s(%p)", __func__, tuple);
 	assert(tuple->refs == 0);
+	struct vy_stmt_env *env = format->engine;
+	uint32_t size = tuple_size(tuple);
 	/*
 	 * Turn off formats referencing in worker threads to avoid
 	 * multithread unsafe modifications of a reference
@@ -110,7 +162,7 @@ vy_tuple_delete(struct tuple_format *format, struct tuple *tuple)
 #ifndef NDEBUG
 	memset(tuple, '#', tuple_size(tuple)); /* fail early */
 #endif
-	free(tuple);
+	vy_stmt_buf_cache_put(env, tuple, size);
 }
 
 void
@@ -121,6 +173,8 @@ vy_stmt_env_create(struct vy_stmt_env *env)
 	env->tuple_format_vtab.tuple_chunk_new = NULL;
 	env->tuple_format_vtab.tuple_chunk_delete = NULL;
 	env->max_tuple_size = 1024 * 1024;
+	memset(env->buf_cache, 0, sizeof(env->buf_cache));
+	env->buf_cache_size = 0;
 	env->key_format = vy_stmt_format_new(env, NULL, 0, NULL, 0, 0, NULL);
 	if (env->key_format == NULL)
 		panic("failed to create vinyl key format");
@@ -130,6 +184,10 @@ vy_stmt_env_create(struct vy_stmt_env *env)
 void
 vy_stmt_env_destroy(struct vy_stmt_env *env)
 {
+	for (int i = 0; i < VY_STMT_BUF_CACHE_SLOTS; i++) {
+		if (env->buf_cache[i].size > 0)
+			free(env->buf_cache[i].buf);
+	}
 	tuple_format_unref(env->key_format);
 }
 
@@ -160,8 +218,8 @@ vy_stmt_alloc(struct tuple_format *format, uint32_t data_offset, uint32_t bsize)
 {
 	assert(data_offset >= sizeof(struct vy_stmt) + format->field_map_size);
 
-	if (data_offset > INT16_MAX) {
-		/** tuple->data_offset is 15 bits */
+	if (data_offset > TUPLE_DATA_OFFSET_MAX) {
+		/** tuple->data_offset is 14 bits */
 		diag_set(ClientError, ER_TUPLE_METADATA_IS_TOO_BIG,
 			 data_offset);
 		return NULL;
@@ -185,7 +243,9 @@ vy_stmt_alloc(struct tuple_format *format, uint32_t data_offset, uint32_t bsize)
 		}
 	}
 #endif
-	struct tuple *tuple = malloc(total_size);
+	struct tuple *tuple = vy_stmt_buf_cache_get(env, total_size);
+	if (tuple == NULL)
+		tuple = malloc(total_size);
 	if (unlikely(tuple == NULL)) {
 		diag_set(OutOfMemory, total_size, "malloc", "struct vy_stmt");
 		return NULL;
@@ -198,6 +258,8 @@ vy_stmt_alloc(struct tuple_format *format, uint32_t data_offset, uint32_t bsize)
 		tuple_format_ref(format);
 	tuple->bsize = bsize;
 	tuple->data_offset = data_offset;
+	/* Vinyl statements never use the compact field map layout. */
+	tuple->is_compact = false;
 	tuple->is_dirty = false;
 	vy_stmt_set_lsn(tuple, 0);
 	vy_stmt_set_type(tuple, 0);
@@ -65,6 +65,27 @@ static_assert(VY_UPSERT_THRESHOLD <= UINT8_MAX, "n_upserts max value");
 static_assert(VY_UPSERT_INF == VY_UPSERT_THRESHOLD + 1,
 	      "inf must be threshold + 1");
 
+enum {
+	/** Max number of statement buffers cached for reuse. */
+	VY_STMT_BUF_CACHE_SLOTS = 8,
+	/**
+	 * Max size of a statement buffer eligible for caching.
+	 * Bounds the memory held by the cache to
+	 * VY_STMT_BUF_CACHE_SLOTS * VY_STMT_BUF_CACHE_MAX_SIZE.
+	 */
+	VY_STMT_BUF_CACHE_MAX_SIZE = 16 * 1024,
+};
+
+/**
+ * A cached statement buffer, see vy_stmt_env::buf_cache.
+ */
+struct vy_stmt_buf_cache_slot {
+	/** Buffer freed by the last statement that used it. */
+	void *buf;
+	/** Allocation size of the buffer, 0 if the slot is empty. */
+	uint32_t size;
+};
+
 /** Vinyl statement environment. */
 struct vy_stmt_env {
 	/** Vinyl statement vtable. */
@@ -84,6 +105,16 @@ struct vy_stmt_env {
 	 * vy_stmt_is_key() is built upon that assumption.
 	 */
 	struct tuple_format *key_format;
+	/**
+	 * Cache of statement buffers recycled between allocations
+	 * to take pressure off malloc on statement-heavy loads.
+	 * Only used in the tx thread - worker threads keep going
+	 * straight to malloc/free, similar to how format
+	 * referencing is handled in vy_stmt_alloc().
+	 */
+	struct vy_stmt_buf_cache_slot buf_cache[VY_STMT_BUF_CACHE_SLOTS];
+	/** Number of bytes held by the statement buffer cache. */
+	size_t buf_cache_size;
 };
 
 /** Initialize a vinyl statement environment. */
@@ -558,7 +558,11 @@ vy_tx_handle_deferred_delete(struct vy_tx *tx, struct txv *v)
 	assert(pk->index_id == 0);
 	assert(flags & VY_STMT_DEFERRED_DELETE);
 
-	struct space *space = space_cache_find(pk->space_id);
+	/*
+	 * Use space_by_id() instead of space_cache_find() as a missing
+	 * space is not an error here and must not set the diagnostics.
+	 */
+	struct space *space = space_by_id(pk->space_id);
 	if (space == NULL) {
 		/*
 		 * Space was dropped while transaction was
@@ -30,9 +30,13 @@
  */
 #include "wal.h"
 
+#include "clock.h"
 #include "fiber.h"
 #include "fio.h"
 #include "errinj.h"
+#include "flightrec.h"
+#include "histogram.h"
+#include "latency.h"
 #include "error.h"
 #include "exception.h"
 
@@ -53,6 +57,15 @@ enum {
 	 * latency. 1 MB seems to be a well balanced choice.
 	 */
 	WAL_FALLOCATE_LEN = 1024 * 1024,
+	/**
+	 * How many bytes may be written to a WAL file before its
+	 * writeback is kicked off with sync_file_range(). Without
+	 * a bound the kernel accumulates the dirty pages until its
+	 * own thresholds fire and then flushes them in one burst,
+	 * stealing disk bandwidth from whatever else is writing to
+	 * the device - e.g. a vinyl dump - at the worst moment.
+	 */
+	WAL_SYNC_INTERVAL = 1 << 24,
 };
 
 const char *wal_mode_STRS[WAL_MODE_MAX] = {
@@ -141,6 +154,12 @@ struct wal_writer
 	struct vclock checkpoint_vclock;
 	/** Total size of WAL files written since the last checkpoint. */
 	int64_t checkpoint_wal_size;
+	/**
+	 * Signature of the newest WAL file that has been compacted,
+	 * see wal_compact_garbage(). Used to avoid rescanning files
+	 * that have already been rewritten.
+	 */
+	int64_t compacted_signature;
 	/**
 	 * Checkpoint threshold: when the total size of WAL files
 	 * written since the last checkpoint exceeds the value of
@@ -170,6 +189,20 @@ struct wal_writer
 	 * Used for replication relays.
 	 */
 	struct rlist watchers;
+	/**
+	 * I/O statistics, written by the wal thread only. The tx
+	 * thread reads them without any locking when serving
+	 * box.stat.io(), with the same tolerance to slightly
+	 * stale values as the iproto request statistics.
+	 */
+	/** Write + sync latency of each flushed batch. */
+	struct latency flush_latency;
+	/** Distribution of bytes written per flushed batch. */
+	struct histogram *batch_size_hist;
+	/** Total number of batches flushed to disk. */
+	int64_t flushed_batches;
+	/** Total number of bytes flushed to disk. */
+	int64_t flushed_bytes;
 };
 
 struct wal_msg {
@@ -204,6 +237,29 @@ wal_mode(void)
 	return wal_writer_singleton.wal_mode;
 }
 
+void
+wal_io_stat_get(struct wal_io_stat *stat)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	memset(stat, 0, sizeof(*stat));
+	stat->queue_len = journal_queue.len;
+	stat->queue_size = journal_queue.size;
+	/* The WAL writer is not created until box is configured. */
+	if (writer->batch_size_hist == NULL)
+		return;
+	stat->batches = writer->flushed_batches;
+	stat->bytes = writer->flushed_bytes;
+	stat->flush_p50 = latency_get(&writer->flush_latency, 50);
+	stat->flush_p90 = latency_get(&writer->flush_latency, 90);
+	stat->flush_p99 = latency_get(&writer->flush_latency, 99);
+	stat->batch_size_p50 = histogram_percentile(writer->batch_size_hist,
+						    50);
+	stat->batch_size_p90 = histogram_percentile(writer->batch_size_hist,
+						    90);
+	stat->batch_size_p99 = histogram_percentile(writer->batch_size_hist,
+						    99);
+}
+
 const char *
 wal_dir(void)
 {
@@ -429,6 +485,12 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 
 	struct xlog_opts opts = xlog_opts_default;
 	opts.sync_is_async = true;
+	/*
+	 * With O_SYNC every write is flushed right away, so the
+	 * interval only matters for the buffered modes.
+	 */
+	if (wal_mode != WAL_FSYNC)
+		opts.sync_interval = WAL_SYNC_INTERVAL;
 	xdir_create(&writer->wal_dir, wal_dirname, XLOG, instance_uuid, &opts);
 	xlog_clear(&writer->current_wal);
 	if (wal_mode == WAL_FSYNC)
@@ -440,6 +502,7 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	writer->checkpoint_wal_size = 0;
 	writer->checkpoint_threshold = INT64_MAX;
 	writer->checkpoint_triggered = false;
+	writer->compacted_signature = 0;
 
 	vclock_create(&writer->vclock);
 	vclock_create(&writer->checkpoint_vclock);
@@ -448,6 +511,23 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	writer->on_garbage_collection = on_garbage_collection;
 	writer->on_checkpoint_threshold = on_checkpoint_threshold;
 
+	/*
+	 * Bytes per batch range from a single tiny row to
+	 * many megabytes under group commit, so use
+	 * power-of-two buckets.
+	 */
+	static int64_t batch_size_buckets[] = {
+		256, 1024, 4096, 16384, 65536, 262144, 1048576,
+		4194304, 16777216, 67108864,
+	};
+	writer->batch_size_hist = histogram_new(batch_size_buckets,
+						lengthof(batch_size_buckets));
+	if (writer->batch_size_hist == NULL ||
+	    latency_create(&writer->flush_latency) != 0)
+		panic("failed to allocate WAL I/O statistics");
+	writer->flushed_batches = 0;
+	writer->flushed_bytes = 0;
+
 	mempool_create(&writer->msg_pool, &cord()->slabc,
 		       sizeof(struct wal_msg));
 }
@@ -456,6 +536,8 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 static void
 wal_writer_destroy(struct wal_writer *writer)
 {
+	latency_destroy(&writer->flush_latency);
+	histogram_delete(writer->batch_size_hist);
 	xdir_destroy(&writer->wal_dir);
 }
 
@@ -825,9 +907,294 @@ wal_collect_garbage(const struct vclock *vclock)
 	fiber_set_cancellable(cancellable);
 }
 
+/**
+ * Rewrite a sealed WAL file dropping transactions all of whose
+ * rows are replica-local. Consumers never need such rows: the
+ * relay doesn't send them and the garbage collector doesn't
+ * account for them (see the vclock_min_ignore0() usage in
+ * gc_run_cleanup()). Files retained only for the sake of lagging
+ * consumers may thus shrink considerably if the instance writes
+ * a lot of local data, e.g. vinyl deferred DELETEs.
+ *
+ * The replacement is prepared under a temporary name and renamed
+ * over the original only after it has been synced, so readers
+ * see either the old file or the complete new one.
+ *
+ * This is the blocking part of the job and it runs on a coio
+ * thread: the WAL thread must not spend seconds rereading and
+ * rewriting files while commits wait in its queue. Only constant
+ * xdir configuration is accessed here; the rename itself is done
+ * by the WAL thread, see wal_compact_commit_f().
+ */
+static ssize_t
+wal_compact_xlog_f(va_list ap)
+{
+	struct xdir *dir = va_arg(ap, struct xdir *);
+	int64_t signature = va_arg(ap, int64_t);
+	bool *has_replacement = va_arg(ap, bool *);
+
+	struct xlog_cursor cursor;
+	if (xdir_open_cursor(dir, signature, &cursor) != 0)
+		return -1;
+
+	char dst_path[PATH_MAX];
+	char tmp_path[PATH_MAX];
+	char inprogress_path[PATH_MAX];
+	snprintf(dst_path, sizeof(dst_path), "%s",
+		 xdir_format_filename(dir, signature, NONE));
+	snprintf(tmp_path, sizeof(tmp_path), "%s.compact", dst_path);
+	snprintf(inprogress_path, sizeof(inprogress_path), "%s.inprogress",
+		 tmp_path);
+	/* Remove a leftover of an interrupted attempt, if any. */
+	unlink(inprogress_path);
+
+	struct xlog out;
+	if (xlog_create(&out, tmp_path, dir->open_wflags,
+			&cursor.meta, &dir->opts) != 0) {
+		xlog_cursor_close(&cursor, false);
+		return -1;
+	}
+
+	struct xrow_header *tx_rows = NULL;
+	int tx_size = 0;
+	int tx_capacity = 0;
+	bool tx_has_global = false;
+	int64_t dropped = 0;
+	struct xrow_header row;
+	int rc;
+	while ((rc = xlog_cursor_next(&cursor, &row,
+				      dir->force_recovery)) == 0) {
+		if (tx_size == tx_capacity) {
+			tx_capacity = tx_capacity == 0 ? 16 : tx_capacity * 2;
+			struct xrow_header *p =
+				realloc(tx_rows, tx_capacity * sizeof(*p));
+			if (p == NULL) {
+				diag_set(OutOfMemory,
+					 tx_capacity * sizeof(*p),
+					 "realloc", "tx_rows");
+				goto error;
+			}
+			tx_rows = p;
+		}
+		/*
+		 * Row bodies point into the cursor read buffer.
+		 * A transaction never spans xlog tx boundaries
+		 * (see xlog_write_entry()), so they stay valid
+		 * until the last row of the transaction is
+		 * fetched and the buffered rows are written out.
+		 */
+		tx_rows[tx_size++] = row;
+		if (row.group_id != GROUP_LOCAL)
+			tx_has_global = true;
+		if (!row.is_commit)
+			continue;
+		if (!tx_has_global) {
+			dropped += tx_size;
+			tx_size = 0;
+			continue;
+		}
+		xlog_tx_begin(&out);
+		for (int i = 0; i < tx_size; i++) {
+			if (xlog_write_row(&out, &tx_rows[i]) < 0) {
+				xlog_tx_rollback(&out);
+				goto error;
+			}
+		}
+		if (xlog_tx_commit(&out) < 0)
+			goto error;
+		tx_size = 0;
+		tx_has_global = false;
+	}
+	if (rc < 0)
+		goto error;
+	/*
+	 * A transaction torn at the end of the file - keep it
+	 * as is, recovery knows how to deal with it.
+	 */
+	for (int i = 0; i < tx_size; i++) {
+		if (xlog_write_row(&out, &tx_rows[i]) < 0)
+			goto error;
+	}
+	if (dropped == 0) {
+		/* Nothing to gain, keep the original file. */
+		xlog_close(&out, false);
+		unlink(inprogress_path);
+		xlog_cursor_close(&cursor, false);
+		free(tx_rows);
+		return 0;
+	}
+	if (xlog_flush(&out) < 0)
+		goto error;
+	/* Writes the EOF marker and syncs the file. */
+	if (xlog_close(&out, false) < 0) {
+		unlink(inprogress_path);
+		xlog_cursor_close(&cursor, false);
+		free(tx_rows);
+		return -1;
+	}
+	say_info("compacted %s: dropped %lld replica-local rows",
+		 dst_path, (long long)dropped);
+	*has_replacement = true;
+	xlog_cursor_close(&cursor, false);
+	free(tx_rows);
+	return 0;
+error:
+	xlog_close(&out, false);
+	unlink(inprogress_path);
+	xlog_cursor_close(&cursor, false);
+	free(tx_rows);
+	return -1;
+}
+
+struct wal_compact_msg
+{
+	struct cbus_call_msg base;
+	/** Compaction upper bound: the checkpoint signature. */
+	int64_t checkpoint_signature;
+	/**
+	 * Signature of the file being processed: an output of
+	 * wal_compact_pick_f (-1 when there are no candidates
+	 * left), an input of wal_compact_commit_f.
+	 */
+	int64_t signature;
+	/**
+	 * Set by the rewrite when a replacement file has been
+	 * prepared; clear when the original had nothing to drop.
+	 */
+	bool has_replacement;
+};
+
+/**
+ * Pick the next WAL file to compact. Runs on the WAL thread
+ * since it owns the directory index, but does no I/O at all.
+ */
+static int
+wal_compact_pick_f(struct cbus_call_msg *data)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_compact_msg *msg = (struct wal_compact_msg *)data;
+
+	msg->signature = -1;
+	struct vclock *first = vclockset_first(&writer->wal_dir.index);
+	while (first != NULL) {
+		struct vclock *next = vclockset_next(&writer->wal_dir.index,
+						     first);
+		/*
+		 * A file may be rewritten only if it is sealed and
+		 * all its rows are covered by the checkpoint: the
+		 * range of a file ends where the next one begins.
+		 */
+		if (next == NULL ||
+		    vclock_sum(next) > msg->checkpoint_signature)
+			break;
+		if (vclock_sum(first) > writer->compacted_signature) {
+			msg->signature = vclock_sum(first);
+			break;
+		}
+		first = next;
+	}
+	return 0;
+}
+
+/**
+ * Install the replacement file prepared by wal_compact_xlog_f()
+ * and advance the compaction watermark. Runs on the WAL thread:
+ * WAL file deletions are issued from here too, so the existence
+ * check and the rename can't race with one. The only I/O is a
+ * single rename (or unlink) of an already synced file.
+ */
+static int
+wal_compact_commit_f(struct cbus_call_msg *data)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_compact_msg *msg = (struct wal_compact_msg *)data;
+	struct xdir *dir = &writer->wal_dir;
+
+	char dst_path[PATH_MAX];
+	char inprogress_path[PATH_MAX];
+	snprintf(dst_path, sizeof(dst_path), "%s",
+		 xdir_format_filename(dir, msg->signature, NONE));
+	snprintf(inprogress_path, sizeof(inprogress_path),
+		 "%s.compact.inprogress", dst_path);
+
+	/*
+	 * The original might have been deleted by the garbage
+	 * collector while the replacement was being written. Its
+	 * rows are not needed by anyone then, so simply drop the
+	 * replacement instead of resurrecting the file.
+	 */
+	struct vclock *v = vclockset_first(&dir->index);
+	while (v != NULL && vclock_sum(v) != msg->signature)
+		v = vclockset_next(&dir->index, v);
+	if (v == NULL) {
+		if (msg->has_replacement)
+			unlink(inprogress_path);
+	} else if (msg->has_replacement &&
+		   rename(inprogress_path, dst_path) != 0) {
+		diag_set(SystemError, "failed to rename '%s' file",
+			 inprogress_path);
+		unlink(inprogress_path);
+		return -1;
+	}
+	if (writer->compacted_signature < msg->signature)
+		writer->compacted_signature = msg->signature;
+	return 0;
+}
+
+void
+wal_compact_garbage(const struct vclock *vclock)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	if (writer->wal_mode == WAL_NONE)
+		return;
+	/*
+	 * One pass at a time is enough: a concurrent checkpoint
+	 * only raises the upper bound of the next pass.
+	 */
+	static bool in_progress;
+	if (in_progress)
+		return;
+	in_progress = true;
+
+	struct wal_compact_msg msg;
+	msg.checkpoint_signature = vclock_sum(vclock);
+	while (true) {
+		bool cancellable = fiber_set_cancellable(false);
+		int rc = cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe,
+				   &msg.base, wal_compact_pick_f, NULL,
+				   TIMEOUT_INFINITY);
+		fiber_set_cancellable(cancellable);
+		if (rc != 0 || msg.signature < 0)
+			break;
+		msg.has_replacement = false;
+		if (coio_call(wal_compact_xlog_f, &writer->wal_dir,
+			      msg.signature, &msg.has_replacement) != 0) {
+			diag_log();
+			break;
+		}
+		cancellable = fiber_set_cancellable(false);
+		rc = cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe,
+			       &msg.base, wal_compact_commit_f, NULL,
+			       TIMEOUT_INFINITY);
+		fiber_set_cancellable(cancellable);
+		if (rc != 0) {
+			diag_log();
+			break;
+		}
+	}
+	in_progress = false;
+}
+
 static void
 wal_notify_watchers(struct wal_writer *writer, unsigned events);
 
+static bool
+wal_watchers_want_rows(struct wal_writer *writer);
+
+static void
+wal_collect_watcher_rows(struct wal_writer *writer, struct wal_msg *wal_msg,
+			 const struct vclock *start_vclock);
+
 /**
  * If there is no current WAL, try to open it, and close the
  * previous WAL. We close the previous WAL only after opening
@@ -1049,6 +1416,8 @@ wal_write_to_disk(struct cmsg *msg)
 	vclock_create(&vclock_diff);
 
 	ERROR_INJECT_SLEEP(ERRINJ_WAL_DELAY);
+	/* Chaos testing: simulate a slow disk, see errinj.h. */
+	DELAY_INJECT_BLOCKING(ERRINJ_DELAY_WAL_WRITE);
 
 	ERROR_INJECT_COUNTDOWN(ERRINJ_WAL_DELAY_COUNTDOWN, {
 		struct errinj *e = errinj(ERRINJ_WAL_DELAY, ERRINJ_BOOL);
@@ -1100,9 +1469,21 @@ wal_write_to_disk(struct cmsg *msg)
 
 	struct xlog *l = &writer->current_wal;
 
+	/*
+	 * Remember the vclock as of before this batch: it tells
+	 * a watcher where the rows buffered for in-memory
+	 * delivery begin.
+	 */
+	bool collect_rows = wal_watchers_want_rows(writer);
+	struct vclock batch_vclock;
+	if (collect_rows)
+		vclock_copy(&batch_vclock, &writer->vclock);
+
 	/*
 	 * Iterate over requests (transactions)
 	 */
+	double write_start = clock_monotonic();
+	int64_t batch_bytes = 0;
 	int rc;
 	struct journal_entry *entry;
 	struct stailq_entry *last_committed = NULL;
@@ -1115,6 +1496,7 @@ wal_write_to_disk(struct cmsg *msg)
 			goto done;
 		if (rc > 0) {
 			writer->checkpoint_wal_size += rc;
+			batch_bytes += rc;
 			last_committed = &entry->fifo;
 			vclock_merge(&writer->vclock, &vclock_diff);
 		}
@@ -1125,9 +1507,18 @@ wal_write_to_disk(struct cmsg *msg)
 		goto done;
 
 	writer->checkpoint_wal_size += rc;
+	batch_bytes += rc;
 	last_committed = stailq_last(&wal_msg->commit);
 	vclock_merge(&writer->vclock, &vclock_diff);
 
+	double flush_time = clock_monotonic() - write_start;
+	latency_collect(&writer->flush_latency, flush_time);
+	flightrec_record(FLIGHTREC_WAL, batch_bytes, flush_time * 1e6,
+			 vclock_sum(&writer->vclock));
+	histogram_collect(writer->batch_size_hist, batch_bytes);
+	writer->flushed_batches++;
+	writer->flushed_bytes += batch_bytes;
+
 	/*
 	 * Notify TX if the checkpoint threshold has been exceeded.
 	 * Use malloc() for allocating the notification message and
@@ -1181,11 +1572,57 @@ done:
 		stailq_concat(&wal_msg->rollback, &rollback);
 		wal_begin_rollback();
 	}
+	if (collect_rows)
+		wal_collect_watcher_rows(writer, wal_msg, &batch_vclock);
 	fiber_gc();
 	wal_notify_watchers(writer, WAL_EVENT_WRITE);
 	ERROR_INJECT_SLEEP(ERRINJ_RELAY_FASTER_THAN_TX);
 }
 
+/**
+ * WAL thread analogue of cbus_process(): deliver all pending
+ * messages, but first merge adjacent write batches so that all
+ * journal entries delivered by one endpoint wakeup are written
+ * and synced with a single xlog_flush() instead of one per batch.
+ * This is what makes group commit work: under moderate load every
+ * tx loop iteration produces a small wal_msg, and without merging
+ * each of them would pay a separate sync.
+ *
+ * Only runs of consecutive write batches are merged - an alien
+ * message (e.g. a checkpoint request) between two batches acts
+ * as a barrier to keep the processing order intact.
+ */
+static void
+wal_writer_process(struct cbus_endpoint *endpoint)
+{
+	struct stailq output;
+	stailq_create(&output);
+	cbus_endpoint_fetch(endpoint, &output);
+	struct cmsg *msg, *msg_next;
+	struct wal_msg *batch = NULL;
+	stailq_foreach_entry(msg, &output, fifo) {
+		struct wal_msg *write_msg = wal_msg(msg);
+		if (write_msg == NULL) {
+			batch = NULL;
+			continue;
+		}
+		if (batch == NULL) {
+			batch = write_msg;
+			continue;
+		}
+		/*
+		 * Move the entries to the head batch. The emptied
+		 * message is still delivered to report the results
+		 * to tx in the original order.
+		 */
+		stailq_concat(&batch->commit, &write_msg->commit);
+		batch->approx_len += write_msg->approx_len;
+		write_msg->approx_len = 0;
+	}
+	stailq_foreach_entry_safe(msg, msg_next, &output, fifo)
+		cmsg_deliver(msg);
+}
+
 /** WAL writer main loop.  */
 static int
 wal_writer_f(va_list ap)
@@ -1205,7 +1642,12 @@ wal_writer_f(va_list ap)
 	 */
 	cpipe_create(&writer->tx_prio_pipe, "tx_prio");
 
-	cbus_loop(&endpoint);
+	while (true) {
+		wal_writer_process(&endpoint);
+		if (fiber_is_cancelled())
+			break;
+		fiber_yield();
+	}
 
 	/*
 	 * Create a new empty WAL on shutdown so that we don't
@@ -1407,6 +1849,90 @@ wal_rotate_vy_log(void)
 	fiber_set_cancellable(cancellable);
 }
 
+/** Return true if any watcher is subscribed to row delivery. */
+static bool
+wal_watchers_want_rows(struct wal_writer *writer)
+{
+	struct wal_watcher *watcher;
+	rlist_foreach_entry(watcher, &writer->watchers, next) {
+		if (watcher->do_deliver_rows)
+			return true;
+	}
+	return false;
+}
+
+/** Drop the buffered rows and remember that some were lost. */
+static void
+wal_watcher_buf_invalidate(struct wal_watcher_buf *buf)
+{
+	ibuf_reset(&buf->data);
+	buf->is_invalid = true;
+}
+
+/**
+ * Append the rows committed by @a wal_msg to the buffers of the
+ * watchers subscribed to row delivery. Each row is encoded once
+ * and copied to every buffer in the wire format, so that a relay
+ * serving an up-to-date replica can forward it to the socket
+ * without re-reading the xlog file that has just been written.
+ * On any failure the affected buffers are invalidated and the
+ * watchers fall back to reading the rows from disk.
+ */
+static void
+wal_collect_watcher_rows(struct wal_writer *writer, struct wal_msg *wal_msg,
+			 const struct vclock *start_vclock)
+{
+	struct wal_watcher *watcher;
+	struct journal_entry *entry;
+	stailq_foreach_entry(entry, &wal_msg->commit, fifo) {
+		for (int i = 0; i < entry->n_rows; i++) {
+			struct iovec iov[XROW_IOVMAX];
+			int iovcnt = xrow_to_iovec(entry->rows[i], iov);
+			if (iovcnt < 0) {
+				diag_clear(diag_get());
+				rlist_foreach_entry(watcher, &writer->watchers,
+						    next) {
+					if (!watcher->do_deliver_rows)
+						continue;
+					wal_watcher_buf_invalidate(
+						&watcher->bufs[
+							watcher->buf_fill_idx]);
+				}
+				return;
+			}
+			size_t len = 0;
+			for (int j = 0; j < iovcnt; j++)
+				len += iov[j].iov_len;
+			rlist_foreach_entry(watcher, &writer->watchers, next) {
+				if (!watcher->do_deliver_rows)
+					continue;
+				struct wal_watcher_buf *buf =
+					&watcher->bufs[watcher->buf_fill_idx];
+				if (buf->is_invalid)
+					continue;
+				if (ibuf_used(&buf->data) == 0)
+					vclock_copy(&buf->start_vclock,
+						    start_vclock);
+				if (ibuf_used(&buf->data) + len >
+				    WAL_WATCHER_BUF_SIZE_MAX) {
+					wal_watcher_buf_invalidate(buf);
+					continue;
+				}
+				char *p = ibuf_alloc(&buf->data, len);
+				if (p == NULL) {
+					wal_watcher_buf_invalidate(buf);
+					continue;
+				}
+				for (int j = 0; j < iovcnt; j++) {
+					memcpy(p, iov[j].iov_base,
+					       iov[j].iov_len);
+					p += iov[j].iov_len;
+				}
+			}
+		}
+	}
+}
+
 static void
 wal_watcher_notify(struct wal_watcher *watcher, unsigned events)
 {
@@ -1424,6 +1950,21 @@ wal_watcher_notify(struct wal_watcher *watcher, unsigned events)
 	}
 
 	msg->events = events;
+	msg->buf = NULL;
+	if (watcher->do_deliver_rows) {
+		struct wal_watcher_buf *buf =
+			&watcher->bufs[watcher->buf_fill_idx];
+		if (ibuf_used(&buf->data) != 0 || buf->is_invalid) {
+			/*
+			 * Hand the filled buffer over to the watcher
+			 * and switch to filling the other one. The
+			 * other buffer was reset when its message
+			 * returned, see wal_watcher_notify_complete().
+			 */
+			msg->buf = buf;
+			watcher->buf_fill_idx ^= 1;
+		}
+	}
 	cmsg_init(&msg->cmsg, watcher->route);
 	cpipe_push(&watcher->watcher_pipe, &msg->cmsg);
 	ERROR_INJECT(ERRINJ_RELAY_FASTER_THAN_TX,
@@ -1448,6 +1989,16 @@ wal_watcher_notify_complete(struct cmsg *cmsg)
 
 	cmsg->route = NULL;
 
+	if (msg->buf != NULL) {
+		/*
+		 * The watcher is done with the buffer - make it
+		 * ready for refilling.
+		 */
+		ibuf_reset(&msg->buf->data);
+		msg->buf->is_invalid = false;
+		msg->buf = NULL;
+	}
+
 	if (rlist_empty(&watcher->next)) {
 		/* The watcher is about to be destroyed. */
 		return;
@@ -1472,6 +2023,15 @@ wal_watcher_attach(void *arg)
 	assert(rlist_empty(&watcher->next));
 	rlist_add_tail_entry(&writer->watchers, watcher, next);
 
+	if (watcher->do_deliver_rows) {
+		for (int i = 0; i < 2; i++) {
+			struct wal_watcher_buf *buf = &watcher->bufs[i];
+			vclock_create(&buf->start_vclock);
+			ibuf_create(&buf->data, &cord()->slabc, 16384);
+			buf->is_invalid = false;
+		}
+	}
+
 	/*
 	 * Notify the watcher right after registering it
 	 * so that it can process existing WALs.
@@ -1486,12 +2046,23 @@ wal_watcher_detach(void *arg)
 
 	assert(!rlist_empty(&watcher->next));
 	rlist_del_entry(watcher, next);
+
+	/*
+	 * By the time the watcher is detached cbus_unpair() has
+	 * drained the pipes, so no message is in flight and the
+	 * buffers can be safely destroyed.
+	 */
+	if (watcher->do_deliver_rows) {
+		for (int i = 0; i < 2; i++)
+			ibuf_destroy(&watcher->bufs[i].data);
+	}
 }
 
 void
 wal_set_watcher(struct wal_watcher *watcher, const char *name,
 		void (*watcher_cb)(struct wal_watcher *, unsigned events),
-		void (*process_cb)(struct cbus_endpoint *))
+		void (*process_cb)(struct cbus_endpoint *),
+		bool deliver_rows)
 {
 	assert(journal_is_initialized(&wal_writer_singleton.base));
 
@@ -1500,7 +2071,10 @@ wal_set_watcher(struct wal_watcher *watcher, const char *name,
 	watcher->msg.watcher = watcher;
 	watcher->msg.events = 0;
 	watcher->msg.cmsg.route = NULL;
+	watcher->msg.buf = NULL;
 	watcher->pending_events = 0;
+	watcher->buf_fill_idx = 0;
+	watcher->do_deliver_rows = deliver_rows;
 
 	assert(lengthof(watcher->route) == 2);
 	watcher->route[0] = (struct cmsg_hop)
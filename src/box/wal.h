@@ -32,6 +32,7 @@
  */
 #include <stdint.h>
 #include <sys/types.h>
+#include "small/ibuf.h"
 #include "small/rlist.h"
 #include "cbus.h"
 #include "journal.h"
@@ -124,10 +125,50 @@ wal_free(void);
 const char *
 wal_dir(void);
 
+enum {
+	/**
+	 * Max size of encoded rows buffered for a single watcher
+	 * between notifications. On overflow the rows are dropped
+	 * and the watcher has to read them from the WAL files.
+	 */
+	WAL_WATCHER_BUF_SIZE_MAX = 1 << 20,
+};
+
+/**
+ * Rows committed to WAL since the previous notification of a
+ * watcher, buffered in memory in the wire format. A relay whose
+ * replica is up to date can feed them to the socket directly
+ * instead of re-reading the just-written xlog file from disk.
+ */
+struct wal_watcher_buf {
+	/**
+	 * WAL vclock right before the first buffered row. The
+	 * consumer may use the buffer only if it has processed
+	 * everything up to this point, otherwise it must fall
+	 * back to reading the WAL files.
+	 */
+	struct vclock start_vclock;
+	/** Encoded rows, each prefixed with its packet length. */
+	struct ibuf data;
+	/**
+	 * Set if the buffer overflowed or a row could not be
+	 * encoded. The rows are only available on disk then.
+	 */
+	bool is_invalid;
+};
+
 struct wal_watcher_msg {
 	struct cmsg cmsg;
 	struct wal_watcher *watcher;
 	unsigned events;
+	/**
+	 * Rows written since the previous notification or NULL
+	 * if the watcher is not subscribed to row delivery or
+	 * no rows were buffered. Valid until the message returns
+	 * to the WAL thread, i.e. until the watcher callback
+	 * completes.
+	 */
+	struct wal_watcher_buf *buf;
 };
 
 enum wal_event {
@@ -157,6 +198,16 @@ struct wal_watcher {
 	 * right upon returning to WAL.
 	 */
 	unsigned pending_events;
+	/**
+	 * Two row buffers, see wal_watcher_buf. While one is en
+	 * route with the notification message, the WAL thread
+	 * keeps filling the other one.
+	 */
+	struct wal_watcher_buf bufs[2];
+	/** Index of the buffer the WAL thread currently fills. */
+	int buf_fill_idx;
+	/** Whether written rows should be buffered and delivered. */
+	bool do_deliver_rows;
 };
 
 /**
@@ -181,11 +232,15 @@ struct wal_watcher {
  * @param process_cb  Function called to process cbus messages
  *                    while the watcher is being attached or NULL
  *                    if the cbus loop is running elsewhere.
+ * @param deliver_rows  If set, rows committed to WAL are also
+ *                    buffered in memory and delivered with the
+ *                    notification, see wal_watcher_msg::buf.
  */
 void
 wal_set_watcher(struct wal_watcher *watcher, const char *name,
 		void (*watcher_cb)(struct wal_watcher *, unsigned events),
-		void (*process_cb)(struct cbus_endpoint *));
+		void (*process_cb)(struct cbus_endpoint *),
+		bool deliver_rows);
 
 /**
  * Unsubscribe from WAL events.
@@ -205,6 +260,38 @@ wal_atfork(void);
 enum wal_mode
 wal_mode(void);
 
+/**
+ * WAL I/O statistics, as served by box.stat.io(). Queue figures
+ * are exact tx thread counters; the flush and batch numbers are
+ * collected in the wal thread and read without locking, so they
+ * may lag by the batch currently in flight.
+ */
+struct wal_io_stat {
+	/** Journal entries submitted and not yet completed. */
+	int64_t queue_len;
+	/** Approximate bytes submitted and not yet completed. */
+	int64_t queue_size;
+	/** Batches flushed to disk since start. */
+	int64_t batches;
+	/** Bytes flushed to disk since start. */
+	int64_t bytes;
+	/** Percentiles of batch write + sync latency, seconds. */
+	double flush_p50;
+	double flush_p90;
+	double flush_p99;
+	/** Percentiles of bytes written per batch. */
+	int64_t batch_size_p50;
+	int64_t batch_size_p90;
+	int64_t batch_size_p99;
+};
+
+/**
+ * Fill @a stat with current WAL I/O statistics. Called from the
+ * tx thread.
+ */
+void
+wal_io_stat_get(struct wal_io_stat *stat);
+
 /**
  * Wait until all submitted writes are successfully flushed
  * to disk. Returns 0 on success, -1 if write failed.
@@ -270,6 +357,15 @@ wal_set_queue_max_size(int64_t size);
 void
 wal_collect_garbage(const struct vclock *vclock);
 
+/**
+ * Rewrite sealed WAL files fully covered by the checkpoint with
+ * the given @vclock, dropping replica-local transactions. Such
+ * files are retained only for lagging consumers, which never
+ * need local rows.
+ */
+void
+wal_compact_garbage(const struct vclock *vclock);
+
 void
 wal_init_vy_log(void);
 
@@ -60,15 +60,17 @@ static inline char *
 mp_encode_vclock_ignore0(char *data, const struct vclock *vclock)
 {
 	data = mp_encode_map(data, vclock_size_ignore0(vclock));
-	struct vclock_iterator it;
-	vclock_iterator_init(&it, vclock);
-	struct vclock_c replica;
-	replica = vclock_iterator_next(&it);
-	if (replica.id == 0)
-		replica = vclock_iterator_next(&it);
-	for ( ; replica.id < VCLOCK_MAX; replica = vclock_iterator_next(&it)) {
-		data = mp_encode_uint(data, replica.id);
-		data = mp_encode_uint(data, replica.lsn);
+	/*
+	 * Walk the set bits of the map directly - cheaper than the
+	 * generic vclock iterator when status rows carry a wide
+	 * cluster's vclock on every heartbeat.
+	 */
+	vclock_map_t map = vclock->map & ~1;
+	while (map != 0) {
+		uint32_t replica_id = bit_ctz_u32(map);
+		map &= map - 1;
+		data = mp_encode_uint(data, replica_id);
+		data = mp_encode_uint(data, vclock->lsn[replica_id]);
 	}
 	return data;
 }
@@ -204,7 +206,18 @@ error:
 	/* Nop requests aren't supposed to have a body. */
 	if (*pos < end && header->type != IPROTO_NOP) {
 		const char *body = *pos;
-		if (mp_check(pos, end)) {
+		if (end_is_exact) {
+			/*
+			 * The end of the body is known from the
+			 * framing, so don't waste cycles walking
+			 * its msgpack here: this runs in the net
+			 * thread for every request, while each
+			 * request decoder fully validates the body
+			 * before use anyway, and xlog rows are
+			 * additionally protected by a checksum.
+			 */
+			*pos = end;
+		} else if (mp_check(pos, end)) {
 			xrow_on_decode_err(start, end, ER_INVALID_MSGPACK, "packet body");
 			return -1;
 		}
@@ -234,20 +247,10 @@ xrow_decode_uuid(const char **pos, struct tt_uuid *out)
 	return 0;
 }
 
-int
-xrow_header_encode(const struct xrow_header *header, uint64_t sync,
-		   struct iovec *out, size_t fixheader_len)
+char *
+xrow_header_encode_raw(const struct xrow_header *header, uint64_t sync,
+		       char *data)
 {
-	/* allocate memory for sign + header */
-	out->iov_base = region_alloc(&fiber()->gc, XROW_HEADER_LEN_MAX +
-				     fixheader_len);
-	if (out->iov_base == NULL) {
-		diag_set(OutOfMemory, XROW_HEADER_LEN_MAX + fixheader_len,
-			 "gc arena", "xrow header encode");
-		return -1;
-	}
-	char *data = (char *) out->iov_base + fixheader_len;
-
 	/* Header */
 	char *d = data + 1; /* Skip 1 byte for MP_MAP */
 	int map_size = 0;
@@ -325,6 +328,23 @@ xrow_header_encode(const struct xrow_header *header, uint64_t sync,
 	}
 	assert(d <= data + XROW_HEADER_LEN_MAX);
 	mp_encode_map(data, map_size);
+	return d;
+}
+
+int
+xrow_header_encode(const struct xrow_header *header, uint64_t sync,
+		   struct iovec *out, size_t fixheader_len)
+{
+	/* allocate memory for sign + header */
+	out->iov_base = region_alloc(&fiber()->gc, XROW_HEADER_LEN_MAX +
+				     fixheader_len);
+	if (out->iov_base == NULL) {
+		diag_set(OutOfMemory, XROW_HEADER_LEN_MAX + fixheader_len,
+			 "gc arena", "xrow header encode");
+		return -1;
+	}
+	char *data = (char *) out->iov_base + fixheader_len;
+	char *d = xrow_header_encode_raw(header, sync, data);
 	out->iov_len = d - (char *) out->iov_base;
 	out++;
 
@@ -1469,11 +1489,18 @@ xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
 		      const struct vclock *vclock, bool anon,
-		      uint32_t id_filter)
+		      uint32_t id_filter, const uint32_t *space_filter,
+		      uint32_t space_filter_count)
 {
 	memset(row, 0, sizeof(*row));
 	size_t size = XROW_BODY_LEN_MAX +
 		      mp_sizeof_vclock_ignore0(vclock);
+	if (space_filter_count != 0) {
+		size += mp_sizeof_uint(IPROTO_SPACE_FILTER) +
+			mp_sizeof_array(space_filter_count);
+		for (uint32_t i = 0; i < space_filter_count; i++)
+			size += mp_sizeof_uint(space_filter[i]);
+	}
 	char *buf = (char *) region_alloc(&fiber()->gc, size);
 	if (buf == NULL) {
 		diag_set(OutOfMemory, size, "region_alloc", "buf");
@@ -1481,7 +1508,12 @@ xrow_encode_subscribe(struct xrow_header *row,
 	}
 	char *data = buf;
 	int filter_size = bit_count_u32(id_filter);
-	data = mp_encode_map(data, filter_size != 0 ? 6 : 5);
+	uint32_t map_size = 5;
+	if (filter_size != 0)
+		map_size++;
+	if (space_filter_count != 0)
+		map_size++;
+	data = mp_encode_map(data, map_size);
 	data = mp_encode_uint(data, IPROTO_CLUSTER_UUID);
 	data = xrow_encode_uuid(data, replicaset_uuid);
 	data = mp_encode_uint(data, IPROTO_INSTANCE_UUID);
@@ -1503,6 +1535,12 @@ xrow_encode_subscribe(struct xrow_header *row,
 			data = mp_encode_uint(data, id);
 		}
 	}
+	if (space_filter_count != 0) {
+		data = mp_encode_uint(data, IPROTO_SPACE_FILTER);
+		data = mp_encode_array(data, space_filter_count);
+		for (uint32_t i = 0; i < space_filter_count; i++)
+			data = mp_encode_uint(data, space_filter[i]);
+	}
 	assert(data <= buf + size);
 	row->body[0].iov_base = buf;
 	row->body[0].iov_len = (data - buf);
@@ -1515,7 +1553,8 @@ int
 xrow_decode_subscribe(struct xrow_header *row, struct tt_uuid *replicaset_uuid,
 		      struct tt_uuid *instance_uuid, struct vclock *vclock,
 		      uint32_t *version_id, bool *anon,
-		      uint32_t *id_filter)
+		      uint32_t *id_filter, uint32_t **space_filter,
+		      uint32_t *space_filter_count)
 {
 	if (row->bodycnt == 0) {
 		diag_set(ClientError, ER_INVALID_MSGPACK, "request body");
@@ -1535,6 +1574,10 @@ xrow_decode_subscribe(struct xrow_header *row, struct tt_uuid *replicaset_uuid,
 		*anon = false;
 	if (id_filter)
 		*id_filter = 0;
+	if (space_filter) {
+		*space_filter = NULL;
+		*space_filter_count = 0;
+	}
 	d = data;
 	uint32_t map_size = mp_decode_map(&d);
 	for (uint32_t i = 0; i < map_size; i++) {
@@ -1610,6 +1653,37 @@ id_filter_decode_err:		xrow_on_decode_err(data, end, ER_INVALID_MSGPACK,
 				*id_filter |= 1 << val;
 			}
 			break;
+		case IPROTO_SPACE_FILTER:
+			if (space_filter == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_ARRAY) {
+space_filter_decode_err:	xrow_on_decode_err(data, end, ER_INVALID_MSGPACK,
+						   "invalid SPACE_FILTER");
+				return -1;
+			}
+			uint32_t count = mp_decode_array(&d);
+			uint32_t *ids = NULL;
+			if (count != 0) {
+				size_t size = count * sizeof(*ids);
+				ids = (uint32_t *) region_alloc(&fiber()->gc,
+								size);
+				if (ids == NULL) {
+					diag_set(OutOfMemory, size,
+						 "region_alloc", "ids");
+					return -1;
+				}
+			}
+			for (uint32_t i = 0; i < count; ++i) {
+				if (mp_typeof(*d) != MP_UINT)
+					goto space_filter_decode_err;
+				uint64_t val = mp_decode_uint(&d);
+				if (val > UINT32_MAX)
+					goto space_filter_decode_err;
+				ids[i] = val;
+			}
+			*space_filter = ids;
+			*space_filter_count = count;
+			break;
 		default: skip:
 			mp_next(&d); /* value */
 		}
@@ -1618,21 +1692,30 @@ id_filter_decode_err:		xrow_on_decode_err(data, end, ER_INVALID_MSGPACK,
 }
 
 int
-xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid)
+xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid,
+		 const struct vclock *vclock)
 {
 	memset(row, 0, sizeof(*row));
 
+	bool has_vclock = vclock != NULL && vclock_sum(vclock) > 0;
 	size_t size = 64;
+	if (has_vclock)
+		size += mp_sizeof_vclock_ignore0(vclock);
 	char *buf = (char *) region_alloc(&fiber()->gc, size);
 	if (buf == NULL) {
 		diag_set(OutOfMemory, size, "region_alloc", "buf");
 		return -1;
 	}
 	char *data = buf;
-	data = mp_encode_map(data, 1);
+	data = mp_encode_map(data, has_vclock ? 2 : 1);
 	data = mp_encode_uint(data, IPROTO_INSTANCE_UUID);
 	/* Greet the remote replica with our replica UUID */
 	data = xrow_encode_uuid(data, instance_uuid);
+	if (has_vclock) {
+		/* Advertise the data we already have, see decode. */
+		data = mp_encode_uint(data, IPROTO_VCLOCK);
+		data = mp_encode_vclock_ignore0(data, vclock);
+	}
 	assert(data <= buf + size);
 
 	row->body[0].iov_base = buf;
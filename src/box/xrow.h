@@ -139,6 +139,22 @@ int
 xrow_header_encode(const struct xrow_header *header, uint64_t sync,
 		   struct iovec *out, size_t fixheader_len);
 
+/**
+ * Encode an xrow header into a caller-provided buffer of at
+ * least XROW_HEADER_LEN_MAX bytes. Unlike xrow_header_encode(),
+ * doesn't allocate anything and doesn't describe the row body -
+ * appending body iovecs is up to the caller.
+ *
+ * @param header xrow
+ * @param sync sync or 0 to omit it
+ * @param data output buffer
+ *
+ * @retval the end of the encoded header
+ */
+char *
+xrow_header_encode_raw(const struct xrow_header *header, uint64_t sync,
+		       char *data);
+
 /**
  * Decode xrow from a binary packet
  *
@@ -422,6 +438,10 @@ xrow_encode_register(struct xrow_header *row,
  * @param anon Whether it is an anonymous subscribe request or not.
  * @param id_filter A List of replica ids to skip rows from
  *		    when feeding a replica.
+ * @param space_filter An array of space ids to relay to the
+ *		       replica. Rows of other non-system spaces
+ *		       are sent as NOPs. NULL means no filtering.
+ * @param space_filter_count Length of @a space_filter.
  *
  * @retval  0 Success.
  * @retval -1 Memory error.
@@ -431,7 +451,8 @@ xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
 		      const struct vclock *vclock, bool anon,
-		      uint32_t id_filter);
+		      uint32_t id_filter, const uint32_t *space_filter,
+		      uint32_t space_filter_count);
 
 /**
  * Decode SUBSCRIBE command.
@@ -443,6 +464,10 @@ xrow_encode_subscribe(struct xrow_header *row,
  * @param[out] anon Whether it is an anonymous subscribe.
  * @param[out] id_filter A list of ids to skip rows from when
  *			 feeding a replica.
+ * @param[out] space_filter An array of space ids to relay,
+ *			    allocated on the fiber region. NULL
+ *			    if the request carries no filter.
+ * @param[out] space_filter_count Length of @a space_filter.
  *
  * @retval  0 Success.
  * @retval -1 Memory or format error.
@@ -451,32 +476,40 @@ int
 xrow_decode_subscribe(struct xrow_header *row, struct tt_uuid *replicaset_uuid,
 		      struct tt_uuid *instance_uuid, struct vclock *vclock,
 		      uint32_t *version_id, bool *anon,
-		      uint32_t *id_filter);
+		      uint32_t *id_filter, uint32_t **space_filter,
+		      uint32_t *space_filter_count);
 
 /**
  * Encode JOIN command.
  * @param[out] row Row to encode into.
  * @param instance_uuid.
+ * @param vclock Replica vclock, or NULL. A non-empty vclock
+ *        advertises that the replica already has data up to it
+ *        and lets the master rejoin it incrementally from the
+ *        WAL files instead of sending a full snapshot.
  *
  * @retval  0 Success.
  * @retval -1 Memory error.
  */
 int
-xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid);
+xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid,
+		 const struct vclock *vclock);
 
 /**
  * Decode JOIN command.
  * @param row Row to decode.
  * @param[out] instance_uuid.
+ * @param[out] vclock Advertised replica vclock, if any.
  *
  * @retval  0 Success.
  * @retval -1 Memory or format error.
  */
 static inline int
-xrow_decode_join(struct xrow_header *row, struct tt_uuid *instance_uuid)
+xrow_decode_join(struct xrow_header *row, struct tt_uuid *instance_uuid,
+		 struct vclock *vclock)
 {
-	return xrow_decode_subscribe(row, NULL, instance_uuid, NULL, NULL, NULL,
-				     NULL);
+	return xrow_decode_subscribe(row, NULL, instance_uuid, vclock, NULL,
+				     NULL, NULL, NULL, NULL);
 }
 
 /**
@@ -492,7 +525,7 @@ xrow_decode_register(struct xrow_header *row, struct tt_uuid *instance_uuid,
 		     struct vclock *vclock)
 {
 	return xrow_decode_subscribe(row, NULL, instance_uuid, vclock, NULL,
-				     NULL, NULL);
+				     NULL, NULL, NULL, NULL);
 }
 
 /**
@@ -517,7 +550,8 @@ xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock);
 static inline int
 xrow_decode_vclock(struct xrow_header *row, struct vclock *vclock)
 {
-	return xrow_decode_subscribe(row, NULL, NULL, vclock, NULL, NULL, NULL);
+	return xrow_decode_subscribe(row, NULL, NULL, vclock, NULL, NULL, NULL,
+				     NULL, NULL);
 }
 
 /**
@@ -549,7 +583,7 @@ xrow_decode_subscribe_response(struct xrow_header *row,
 			       struct vclock *vclock)
 {
 	return xrow_decode_subscribe(row, replicaset_uuid, NULL, vclock, NULL,
-				     NULL, NULL);
+				     NULL, NULL, NULL, NULL);
 }
 
 /**
@@ -925,10 +959,12 @@ xrow_encode_subscribe_xc(struct xrow_header *row,
 			 const struct tt_uuid *replicaset_uuid,
 			 const struct tt_uuid *instance_uuid,
 			 const struct vclock *vclock, bool anon,
-			 uint32_t id_filter)
+			 uint32_t id_filter, const uint32_t *space_filter,
+			 uint32_t space_filter_count)
 {
 	if (xrow_encode_subscribe(row, replicaset_uuid, instance_uuid,
-				  vclock, anon, id_filter) != 0)
+				  vclock, anon, id_filter, space_filter,
+				  space_filter_count) != 0)
 		diag_raise();
 }
 
@@ -938,28 +974,32 @@ xrow_decode_subscribe_xc(struct xrow_header *row,
 			 struct tt_uuid *replicaset_uuid,
 			 struct tt_uuid *instance_uuid, struct vclock *vclock,
 			 uint32_t *replica_version_id, bool *anon,
-			 uint32_t *id_filter)
+			 uint32_t *id_filter, uint32_t **space_filter,
+			 uint32_t *space_filter_count)
 {
 	if (xrow_decode_subscribe(row, replicaset_uuid, instance_uuid,
 				  vclock, replica_version_id, anon,
-				  id_filter) != 0)
+				  id_filter, space_filter,
+				  space_filter_count) != 0)
 		diag_raise();
 }
 
 /** @copydoc xrow_encode_join. */
 static inline void
 xrow_encode_join_xc(struct xrow_header *row,
-		    const struct tt_uuid *instance_uuid)
+		    const struct tt_uuid *instance_uuid,
+		    const struct vclock *vclock)
 {
-	if (xrow_encode_join(row, instance_uuid) != 0)
+	if (xrow_encode_join(row, instance_uuid, vclock) != 0)
 		diag_raise();
 }
 
 /** @copydoc xrow_decode_join. */
 static inline void
-xrow_decode_join_xc(struct xrow_header *row, struct tt_uuid *instance_uuid)
+xrow_decode_join_xc(struct xrow_header *row, struct tt_uuid *instance_uuid,
+		    struct vclock *vclock)
 {
-	if (xrow_decode_join(row, instance_uuid) != 0)
+	if (xrow_decode_join(row, instance_uuid, vclock) != 0)
 		diag_raise();
 }
 
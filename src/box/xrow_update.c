@@ -279,6 +279,92 @@ xrow_update_read_ops(struct xrow_update *update, const char *expr,
 	return 0;
 }
 
+/**
+ * Try to apply a single-operation arithmetic update ('+' or '-'
+ * on a top-level field) by patching the old tuple data instead of
+ * building the update tree. Counter bumps are the most frequent
+ * update shape, and when the result encodes into the same number
+ * of bytes as the old value - which for a counter is almost
+ * always - the new tuple is the old one with a few bytes swapped,
+ * produced in a single pass.
+ *
+ * @param update Update meta with exactly one decoded operation.
+ * @param header Tuple MessagePack, including the array header.
+ * @param old_data Tuple fields, right after the array header.
+ * @param old_data_end End of the @old_data.
+ * @param field_count Field count in the @old_data.
+ * @param format Tuple format of the updated space.
+ * @param[out] p_new_data The patched tuple on success.
+ * @param[out] p_tuple_len Length of @a p_new_data.
+ *
+ * @retval  0 Success, the result is written.
+ * @retval  1 The fast path is not applicable, the operation is
+ *            intact - fall back to the generic machinery.
+ * @retval -1 Client or memory error.
+ */
+static int
+xrow_update_try_arith_fastpath(struct xrow_update *update, const char *header,
+			       const char *old_data, const char *old_data_end,
+			       uint32_t field_count,
+			       struct tuple_format *format,
+			       const char **p_new_data, uint32_t *p_tuple_len)
+{
+	assert(update->op_count == 1);
+	struct xrow_update_op *op = &update->ops[0];
+	if ((op->opcode != '+' && op->opcode != '-') ||
+	    !xrow_update_op_is_term(op) || op->token_type != JSON_TOKEN_NUM)
+		return 1;
+	int32_t field_no = op->field_no;
+	if (field_no < 0)
+		field_no += field_count;
+	if (field_no < 0 || field_no >= (int32_t)field_count)
+		return 1;
+	const char *old_field = old_data;
+	for (int32_t i = 0; i < field_no; i++)
+		mp_next(&old_field);
+	const char *old_field_end = old_field;
+	mp_next(&old_field_end);
+	uint32_t old_field_len = old_field_end - old_field;
+	/*
+	 * The operation argument is consumed by the arithmetics
+	 * below - keep a copy so that falling back to the generic
+	 * path replays the operation on the original argument.
+	 */
+	union xrow_update_arg saved_arg = op->arg;
+	if (xrow_update_op_do_arith(op, old_field) != 0)
+		return -1;
+	/*
+	 * Only integers store exactly new_field_len bytes: a float
+	 * result may be widened to double by the space format on
+	 * store, see xrow_update_op_store_arith().
+	 */
+	if (op->arg.arith.type != XUPDATE_TYPE_INT ||
+	    op->new_field_len != old_field_len) {
+		op->arg = saved_arg;
+		return 1;
+	}
+	uint32_t tuple_len = old_data_end - header;
+	char *buffer = (char *)region_alloc(&fiber()->gc, tuple_len);
+	if (buffer == NULL) {
+		diag_set(OutOfMemory, tuple_len, "region_alloc", "buffer");
+		return -1;
+	}
+	struct json_token *this_node = NULL;
+	if ((uint32_t)field_no < tuple_format_field_count(format))
+		this_node = &tuple_format_field(format, field_no)->token;
+	char *out = buffer;
+	memcpy(out, header, old_field - header);
+	out += old_field - header;
+	out += xrow_update_op_store_arith(op, &format->fields, this_node,
+					  old_field, out);
+	memcpy(out, old_field_end, old_data_end - old_field_end);
+	out += old_data_end - old_field_end;
+	assert(out == buffer + tuple_len);
+	*p_new_data = buffer;
+	*p_tuple_len = tuple_len;
+	return 0;
+}
+
 /**
  * Apply update operations to the concrete tuple.
  *
@@ -384,6 +470,20 @@ xrow_update_execute(const char *expr,const char *expr_end,
 	if (xrow_update_read_ops(&update, expr, expr_end, format->dict,
 				 field_count) != 0)
 		return NULL;
+	if (update.op_count == 1) {
+		const char *new_data;
+		int rc = xrow_update_try_arith_fastpath(&update, header,
+							old_data, old_data_end,
+							field_count, format,
+							&new_data, p_tuple_len);
+		if (rc < 0)
+			return NULL;
+		if (rc == 0) {
+			if (column_mask)
+				*column_mask = update.column_mask;
+			return new_data;
+		}
+	}
 	if (xrow_update_do_ops(&update, header, old_data, old_data_end,
 			       field_count) != 0)
 		return NULL;
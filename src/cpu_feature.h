@@ -42,6 +42,13 @@
  */
 bool sse42_enabled_cpu();
 
+/* Check whether CPU supports the PCLMULQDQ carry-less multiply
+ * instruction (needed to fold interleaved CRC32 streams).
+ *
+ * @return	true if available, false if unavailable.
+ */
+bool pclmul_enabled_cpu();
+
 #if defined (__x86_64__) || defined (__i386__)
 /* Hardware-calculate CRC32 for the given data buffer.
  *
@@ -55,5 +62,21 @@ bool sse42_enabled_cpu();
 uint32_t crc32c_hw(uint32_t crc, const char *buf, unsigned int len);
 #endif
 
+#if defined (__x86_64__)
+/* Hardware-calculate CRC32 over three interleaved streams, folding
+ * the partial results together with carry-less multiplication.
+ * Identical output to crc32c_hw(), roughly 3x the throughput on
+ * buffers big enough to split.
+ *
+ * @param	crc 		initial CRC
+ * @param	buf			data buffer
+ * @param	len			buffer length
+ *
+ * @pre 	true == sse42_enabled_cpu() && pclmul_enabled_cpu()
+ * @return	CRC32 value
+ */
+uint32_t crc32c_hw_3way(uint32_t crc, const char *buf, unsigned int len);
+#endif
+
 #endif /* TARANTOOL_CPU_FEATURES_H */
 
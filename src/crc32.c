@@ -42,7 +42,14 @@ crc32_func crc32_calc = NULL;
 void
 crc32_init(void)
 {
-#if defined(HAVE_CPUID) && (defined (__x86_64__) || defined (__i386__))
+#if defined(HAVE_CPUID) && defined (__x86_64__)
+	if (sse42_enabled_cpu()) {
+		crc32_calc = pclmul_enabled_cpu() ? &crc32c_hw_3way :
+						    &crc32c_hw;
+	} else {
+		crc32_calc = &crc32c;
+	}
+#elif defined(HAVE_CPUID) && defined (__i386__)
 	crc32_calc = sse42_enabled_cpu() ? &crc32c_hw : &crc32c;
 #else
 	crc32_calc = &crc32c;
@@ -37,11 +37,57 @@
 #include "fiber.h"
 #include "errinj.h"
 
+/**
+ * Collect transfers finished by the events fed to libcurl so far
+ * and signal the fibers waiting on them.
+ */
+static void
+curl_env_complete(struct curl_env *env)
+{
+	CURLMsg *msg;
+	int msgs_left;
+	while ((msg = curl_multi_info_read(env->multi, &msgs_left))) {
+		if (msg->msg != CURLMSG_DONE)
+			continue;
+
+		CURL *easy = msg->easy_handle;
+		CURLcode code = msg->data.result;
+		struct curl_request *request = NULL;
+		curl_easy_getinfo(easy, CURLINFO_PRIVATE, (void *) &request);
+		request->code = (int) code;
+		request->in_progress = false;
+#ifndef NDEBUG
+		struct errinj *errinj = errinj(ERRINJ_HTTP_RESPONSE_ADD_WAIT,
+					       ERRINJ_BOOL);
+		if (errinj != NULL)
+			errinj->bparam = false;
+#endif
+		fiber_cond_signal(&request->cond);
+	}
+}
+
+/**
+ * ev_prepare callback scheduled by curl_multi_process(). It runs
+ * at the end of the loop iteration, after every socket and timer
+ * event of the burst has been handed to libcurl, so a burst of
+ * events drains curl_multi_info_read() once instead of once per
+ * ready descriptor.
+ */
+static void
+curl_complete_cb(struct ev_loop *loop, struct ev_prepare *watcher, int revents)
+{
+	(void) revents;
+	struct curl_env *env = (struct curl_env *) watcher->data;
+
+	ev_prepare_stop(loop, watcher);
+	curl_env_complete(env);
+}
+
 /**
  * Process events
  */
 static void
-curl_multi_process(CURLM *multi, curl_socket_t sockfd, int events)
+curl_multi_process(struct curl_env *env, curl_socket_t sockfd, int events)
 {
 	/*
 	 * Notify curl about events
@@ -59,7 +105,7 @@ curl_multi_process(CURLM *multi, curl_socket_t sockfd, int events)
 	 * more data to send off before it is "satisfied".
 	 */
 	do {
-		code = curl_multi_socket_action(multi, sockfd, events,
+		code = curl_multi_socket_action(env->multi, sockfd, events,
 						&still_running);
 	} while (code == CURLM_CALL_MULTI_PERFORM);
 	if (code != CURLM_OK) {
@@ -69,29 +115,10 @@ curl_multi_process(CURLM *multi, curl_socket_t sockfd, int events)
 	}
 
 	/*
-	 * Check for resuls
+	 * Check for results once per burst, see curl_complete_cb().
 	 */
-
-	CURLMsg *msg;
-	int msgs_left;
-	while ((msg = curl_multi_info_read(multi, &msgs_left))) {
-		if (msg->msg != CURLMSG_DONE)
-			continue;
-
-		CURL *easy = msg->easy_handle;
-		CURLcode code = msg->data.result;
-		struct curl_request *request = NULL;
-		curl_easy_getinfo(easy, CURLINFO_PRIVATE, (void *) &request);
-		request->code = (int) code;
-		request->in_progress = false;
-#ifndef NDEBUG
-		struct errinj *errinj = errinj(ERRINJ_HTTP_RESPONSE_ADD_WAIT,
-					       ERRINJ_BOOL);
-		if (errinj != NULL)
-			errinj->bparam = false;
-#endif
-		fiber_cond_signal(&request->cond);
-	}
+	if (!ev_is_active(&env->complete_event))
+		ev_prepare_start(loop(), &env->complete_event);
 }
 
 /**
@@ -106,7 +133,7 @@ curl_timer_cb(struct ev_loop *loop, struct ev_timer *watcher, int revents)
 	struct curl_env *env = (struct curl_env *) watcher->data;
 
 	say_debug("curl %p: event timer", env);
-	curl_multi_process(env->multi, CURL_SOCKET_TIMEOUT, 0);
+	curl_multi_process(env, CURL_SOCKET_TIMEOUT, 0);
 }
 
 /**
@@ -163,7 +190,7 @@ curl_sock_cb(struct ev_loop *loop, struct ev_io *watcher, int revents)
 	say_debug("curl %p: event fd=%d %s", env, fd, evstr[revents]);
 	const int action = ((revents & EV_READ  ? CURL_POLL_IN  : 0) |
 			    (revents & EV_WRITE ? CURL_POLL_OUT : 0));
-	curl_multi_process(env->multi, fd, action);
+	curl_multi_process(env, fd, action);
 }
 
 /**
@@ -234,6 +261,8 @@ curl_env_create(struct curl_env *env, long max_conns, long max_total_conns)
 
 	ev_init(&env->timer_event, curl_timer_cb);
 	env->timer_event.data = (void *) env;
+	ev_prepare_init(&env->complete_event, curl_complete_cb);
+	env->complete_event.data = (void *) env;
 	curl_multi_setopt(env->multi, CURLMOPT_TIMERFUNCTION,
 			  curl_multi_timer_cb);
 	curl_multi_setopt(env->multi, CURLMOPT_TIMERDATA, (void *) env);
@@ -248,6 +277,14 @@ curl_env_create(struct curl_env *env, long max_conns, long max_total_conns)
 #else
 	(void) max_total_conns;
 #endif
+#if LIBCURL_VERSION_NUM >= 0x072b00
+	/*
+	 * Let concurrent transfers to the same host share one
+	 * HTTP/2 connection when the server negotiates it.
+	 */
+	curl_multi_setopt(env->multi, CURLMOPT_PIPELINING,
+			  CURLPIPE_MULTIPLEX);
+#endif
 
 	return 0;
 
@@ -260,6 +297,9 @@ void
 curl_env_destroy(struct curl_env *env)
 {
 	assert(env);
+	ev_prepare_stop(loop(), &env->complete_event);
+	for (int i = 0; i < env->easy_cache_size; i++)
+		curl_easy_cleanup(env->easy_cache[i]);
 	if (env->multi != NULL)
 		curl_multi_cleanup(env->multi);
 
@@ -267,12 +307,21 @@ curl_env_destroy(struct curl_env *env)
 }
 
 int
-curl_request_create(struct curl_request *curl_request)
+curl_request_create(struct curl_request *curl_request, struct curl_env *env)
 {
-	curl_request->easy = curl_easy_init();
-	if (curl_request->easy == NULL) {
-		diag_set(OutOfMemory, 0, "curl", "easy");
-		return -1;
+	if (env->easy_cache_size > 0) {
+		/*
+		 * The connection cache lives in the multi handle,
+		 * so any cached easy handle can serve any host;
+		 * reuse also keeps the handle's DNS cache warm.
+		 */
+		curl_request->easy = env->easy_cache[--env->easy_cache_size];
+	} else {
+		curl_request->easy = curl_easy_init();
+		if (curl_request->easy == NULL) {
+			diag_set(OutOfMemory, 0, "curl", "easy");
+			return -1;
+		}
 	}
 	curl_request->in_progress = false;
 	curl_request->code = CURLE_OK;
@@ -281,10 +330,17 @@ curl_request_create(struct curl_request *curl_request)
 }
 
 void
-curl_request_destroy(struct curl_request *curl_request)
+curl_request_destroy(struct curl_request *curl_request, struct curl_env *env)
 {
-	if (curl_request->easy != NULL)
-		curl_easy_cleanup(curl_request->easy);
+	if (curl_request->easy != NULL) {
+		if (env->easy_cache_size < CURL_EASY_CACHE_SIZE) {
+			curl_easy_reset(curl_request->easy);
+			env->easy_cache[env->easy_cache_size++] =
+				curl_request->easy;
+		} else {
+			curl_easy_cleanup(curl_request->easy);
+		}
+	}
 	fiber_cond_destroy(&curl_request->cond);
 }
 
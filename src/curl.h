@@ -48,6 +48,15 @@ struct curl_stat {
 	uint64_t active_requests;
 };
 
+enum {
+	/**
+	 * How many finished easy handles to keep around for reuse
+	 * by later requests instead of destroying them. A reused
+	 * handle skips curl_easy_init() and keeps its DNS cache.
+	 */
+	CURL_EASY_CACHE_SIZE = 32,
+};
+
 /**
  * CURL Environment
  */
@@ -58,6 +67,16 @@ struct curl_env {
 	struct mempool sock_pool;
 	/** libev timer watcher. */
 	struct ev_timer timer_event;
+	/**
+	 * Fires once at the end of an event-loop iteration when
+	 * socket or timer events were fed to libcurl, to collect
+	 * all transfers completed by the burst in one pass.
+	 */
+	struct ev_prepare complete_event;
+	/** Cache of reset easy handles ready for reuse. */
+	CURL *easy_cache[CURL_EASY_CACHE_SIZE];
+	/** Number of handles in easy_cache. */
+	int easy_cache_size;
 	/** Statistics. */
 	struct curl_stat stat;
 };
@@ -99,18 +118,20 @@ curl_env_destroy(struct curl_env *env);
 /**
  * Initialize a new CURL request
  * @param curl_request request
+ * @param env environment whose easy handle cache to draw from
  * @retval  0 success
  * @retval -1 error, check diag
  */
 int
-curl_request_create(struct curl_request *curl_request);
+curl_request_create(struct curl_request *curl_request, struct curl_env *env);
 
 /**
  * Cleanup CURL request
  * @param curl_request request
+ * @param env environment the request was created with
  */
 void
-curl_request_destroy(struct curl_request *curl_request);
+curl_request_destroy(struct curl_request *curl_request, struct curl_env *env);
 
 /**
  * Execute CURL request
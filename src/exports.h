@@ -28,7 +28,11 @@ EXPORT(box_index_iterator)
 EXPORT(box_index_len)
 EXPORT(box_index_max)
 EXPORT(box_index_min)
+EXPORT(box_index_multi_get)
 EXPORT(box_index_random)
+EXPORT(box_index_read_view_create)
+EXPORT(box_index_read_view_free)
+EXPORT(box_index_read_view_next)
 EXPORT(box_insert)
 EXPORT(box_iterator_free)
 EXPORT(box_iterator_next)
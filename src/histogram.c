@@ -131,6 +131,19 @@ histogram_discard(struct histogram *hist, int64_t val)
 	hist->total--;
 }
 
+void
+histogram_merge(struct histogram *dest, const struct histogram *src)
+{
+	assert(dest->n_buckets == src->n_buckets);
+	for (size_t i = 0; i < dest->n_buckets; i++) {
+		assert(dest->buckets[i].max == src->buckets[i].max);
+		dest->buckets[i].count += src->buckets[i].count;
+	}
+	if (dest->max < src->max)
+		dest->max = src->max;
+	dest->total += src->total;
+}
+
 int64_t
 histogram_percentile(struct histogram *hist, int pct)
 {
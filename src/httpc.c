@@ -121,7 +121,7 @@ httpc_request_new(struct httpc_env *env, const char *method,
 	region_create(&req->resp_headers, &cord()->slabc);
 	region_create(&req->resp_body, &cord()->slabc);
 
-	if (curl_request_create(&req->curl_request) != 0)
+	if (curl_request_create(&req->curl_request, &env->curl_env) != 0)
 		return NULL;
 
 	if (strcmp(method, "GET") == 0) {
@@ -155,8 +155,19 @@ httpc_request_new(struct httpc_env *env, const char *method,
 	curl_easy_setopt(req->curl_request.easy, CURLOPT_HEADERFUNCTION,
 			 curl_easy_header_cb);
 	curl_easy_setopt(req->curl_request.easy, CURLOPT_NOPROGRESS, 1L);
+#if LIBCURL_VERSION_NUM >= 0x072f00
+	/*
+	 * HTTP/2 over TLS when the server offers it via ALPN, so
+	 * concurrent requests multiplex over one connection (see
+	 * CURLMOPT_PIPELINING in curl_env_create()); plain HTTP
+	 * and older servers keep getting 1.1.
+	 */
+	curl_easy_setopt(req->curl_request.easy, CURLOPT_HTTP_VERSION,
+			 CURL_HTTP_VERSION_2TLS);
+#else
 	curl_easy_setopt(req->curl_request.easy, CURLOPT_HTTP_VERSION,
 			 CURL_HTTP_VERSION_1_1);
+#endif
 
 	ibuf_create(&req->body, &cord()->slabc, 1);
 
@@ -169,7 +180,7 @@ httpc_request_delete(struct httpc_request *req)
 	if (req->headers != NULL)
 		curl_slist_free_all(req->headers);
 
-	curl_request_destroy(&req->curl_request);
+	curl_request_destroy(&req->curl_request, &req->env->curl_env);
 
 	ibuf_destroy(&req->body);
 	region_destroy(&req->resp_headers);
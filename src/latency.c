@@ -89,6 +89,12 @@ latency_collect(struct latency *latency, double value)
 	histogram_collect(latency->histogram, value_usec);
 }
 
+void
+latency_merge(struct latency *dest, const struct latency *src)
+{
+	histogram_merge(dest->histogram, src->histogram);
+}
+
 double
 latency_get(struct latency *latency, int pct)
 {
@@ -70,6 +70,13 @@ latency_reset(struct latency *latency);
 void
 latency_collect(struct latency *latency, double value);
 
+/**
+ * Add all observations of @src to @dest. Both counters must
+ * have been initialized with latency_create().
+ */
+void
+latency_merge(struct latency *dest, const struct latency *src);
+
 /**
  * Get accumulated latency value, in seconds.
  * Returns @pct-th percentile of all observations.
@@ -432,3 +432,16 @@ tt_bitset_iterator_next(struct tt_bitset_iterator *it)
 		tt_bitset_iterator_next_page(it);
 	}
 }
+
+size_t
+tt_bitset_iterator_count(struct tt_bitset_iterator *it)
+{
+	assert(it != NULL);
+
+	size_t result = 0;
+	while (it->page->first_pos != SIZE_MAX) {
+		result += tt_bitset_page_popcount(it->page);
+		tt_bitset_iterator_next_page(it);
+	}
+	return result;
+}
@@ -136,6 +136,20 @@ tt_bitset_iterator_rewind(struct tt_bitset_iterator *it);
 size_t
 tt_bitset_iterator_next(struct tt_bitset_iterator *it);
 
+/**
+ * @brief Count the positions left in the result set of \a it.
+ * Evaluates the expression page by page and popcounts whole
+ * result pages, which is much cheaper than extracting every
+ * position one by one with @link tt_bitset_iterator_next @endlink.
+ * The iterator is consumed: a subsequent next() returns SIZE_MAX.
+ * Rewind the iterator to reuse it.
+ * @param it bitset iterator
+ * @return number of offsets where the expression evaluates to true
+ * @see @link bitset_iterator_init @endlink
+ */
+size_t
+tt_bitset_iterator_count(struct tt_bitset_iterator *it);
+
 #if defined(__cplusplus)
 }
 #endif /* defined(__cplusplus) */
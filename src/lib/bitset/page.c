@@ -62,6 +62,9 @@ tt_bitset_page_nand(struct tt_bitset_page *dst, struct tt_bitset_page *src);
 extern inline void
 tt_bitset_page_or(struct tt_bitset_page *dst, struct tt_bitset_page *src);
 
+extern inline size_t
+tt_bitset_page_popcount(struct tt_bitset_page *page);
+
 #if defined(DEBUG)
 void
 tt_bitset_page_dump(struct tt_bitset_page *page, FILE *stream)
@@ -187,6 +187,20 @@ tt_bitset_page_or(struct tt_bitset_page *dst, struct tt_bitset_page *src)
 	}
 }
 
+inline size_t
+tt_bitset_page_popcount(struct tt_bitset_page *page)
+{
+	uint64_t *d = (uint64_t *) tt_bitset_page_data(page);
+
+	assert(BITSET_PAGE_DATA_SIZE % sizeof(uint64_t) == 0);
+	int cnt = BITSET_PAGE_DATA_SIZE / sizeof(uint64_t);
+	size_t result = 0;
+	for (int i = 0; i < cnt; i++) {
+		result += bit_count_u64(d[i]);
+	}
+	return result;
+}
+
 #if defined(DEBUG)
 void
 tt_bitset_page_dump(struct tt_bitset_page *page, FILE *stream);
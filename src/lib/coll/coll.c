@@ -36,6 +36,7 @@
 #include <unicode/ucol.h>
 #include <unicode/ucnv.h>
 #include <unicode/ucasemap.h>
+#include <pmatomic.h>
 #include "tt_static.h"
 
 struct UCaseMap *icu_ucase_default_map = NULL;
@@ -74,6 +75,86 @@ static struct mh_coll_t *coll_cache = NULL;
 static_assert(COLL_LOCALE_LEN_MAX <= TT_STATIC_BUF_LEN,
 	      "static buf is used to 0-terminate locale name");
 
+enum {
+	/** Slots in the per-thread sort key cache, a power of two. */
+	COLL_SORTKEY_CACHE_SIZE = 256,
+	/** Longest source string whose sort key is cached. */
+	COLL_SORTKEY_SRC_MAX = 64,
+	/** Room for the materialized sort key of one string. */
+	COLL_SORTKEY_KEY_MAX = 192,
+};
+
+/** Cached ICU sort key of one string under one collation. */
+struct coll_sortkey_entry {
+	/** Collation the key was built with. */
+	const struct coll *coll;
+	/** Value of coll_sortkey_gen when the key was built. */
+	uint64_t gen;
+	/** Source string length, 0 for an empty slot. */
+	uint32_t src_len;
+	/** Materialized sort key length. */
+	uint32_t key_len;
+	/** The source string. */
+	char src[COLL_SORTKEY_SRC_MAX];
+	/** The sort key, ordered by plain memcmp(). */
+	uint8_t key[COLL_SORTKEY_KEY_MAX];
+};
+
+/**
+ * Direct-mapped cache of materialized sort keys. A BPS tree
+ * descent calls the comparator O(log n) times with the same
+ * probe key, and hot tree elements repeat across descents, so
+ * each string's key is built once and subsequent comparisons
+ * collapse to memcmp(). Comparators also run in vinyl worker
+ * threads, hence the cache is per thread and needs no locking.
+ */
+static __thread struct coll_sortkey_entry
+	coll_sortkey_cache[COLL_SORTKEY_CACHE_SIZE];
+
+/**
+ * Bumped whenever an ICU collator is destroyed so that entries
+ * built with a recycled collator address cannot produce stale
+ * hits in any thread.
+ */
+static uint64_t coll_sortkey_gen;
+
+/**
+ * Find or build the cached sort key of @a s under @a coll.
+ * Returns NULL when the string or its key does not fit, in which
+ * case the caller must fall back to a direct ICU comparison.
+ */
+static struct coll_sortkey_entry *
+coll_sortkey_get(const struct coll *coll, const char *s, size_t slen,
+		 uint64_t gen)
+{
+	if (slen == 0 || slen > COLL_SORTKEY_SRC_MAX)
+		return NULL;
+	uint32_t h = PMurHash32((uint32_t)(uintptr_t)coll, s, slen);
+	struct coll_sortkey_entry *e =
+		&coll_sortkey_cache[h & (COLL_SORTKEY_CACHE_SIZE - 1)];
+	if (e->coll == coll && e->gen == gen && e->src_len == slen &&
+	    memcmp(e->src, s, slen) == 0)
+		return e;
+	UCharIterator itr;
+	uiter_setUTF8(&itr, s, slen);
+	uint32_t state[2] = {0, 0};
+	UErrorCode status = U_ZERO_ERROR;
+	int32_t got = ucol_nextSortKeyPart(coll->collator, &itr, state,
+					   e->key, COLL_SORTKEY_KEY_MAX,
+					   &status);
+	if (U_FAILURE(status) || got == COLL_SORTKEY_KEY_MAX) {
+		/* The slot content is clobbered - empty it. */
+		e->src_len = 0;
+		return NULL;
+	}
+	e->coll = coll;
+	e->gen = gen;
+	e->src_len = slen;
+	e->key_len = got;
+	memcpy(e->src, s, slen);
+	return e;
+}
+
 /** Compare two string using ICU collation. */
 static int
 coll_icu_cmp(const char *s, size_t slen, const char *t, size_t tlen,
@@ -81,6 +162,30 @@ coll_icu_cmp(const char *s, size_t slen, const char *t, size_t tlen,
 {
 	assert(coll->collator != NULL);
 
+	/* Identical bytes collate equal under any strength. */
+	if (slen == tlen && memcmp(s, t, slen) == 0)
+		return 0;
+
+	uint64_t gen = pm_atomic_load(&coll_sortkey_gen);
+	struct coll_sortkey_entry *se = coll_sortkey_get(coll, s, slen, gen);
+	if (se != NULL) {
+		struct coll_sortkey_entry *te =
+			coll_sortkey_get(coll, t, tlen, gen);
+		/*
+		 * Distinct strings hashed into one slot would have
+		 * the second lookup evict the first key, so only
+		 * trust distinct entries.
+		 */
+		if (te != NULL && te != se) {
+			uint32_t len = MIN(se->key_len, te->key_len);
+			int res = memcmp(se->key, te->key, len);
+			if (res != 0)
+				return res < 0 ? -1 : 1;
+			return se->key_len < te->key_len ? -1 :
+			       se->key_len > te->key_len ? 1 : 0;
+		}
+	}
+
 	UErrorCode status = U_ZERO_ERROR;
 
 #ifdef HAVE_ICU_STRCOLLUTF8
@@ -411,6 +516,11 @@ coll_unref(struct coll *coll)
 			len, mh_strn_hash(coll->fingerprint, len), coll
 		};
 		mh_coll_remove(coll_cache, &node, NULL);
+		/*
+		 * A later collator may reuse this address; retire
+		 * sort keys built with this one in every thread.
+		 */
+		pm_atomic_fetch_add(&coll_sortkey_gen, 1);
 		ucol_close(coll->collator);
 		free(coll);
 	}
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "alloc_profile.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <pmatomic.h>
+
+#ifdef ENABLE_BACKTRACE
+#ifdef TARGET_OS_DARWIN
+#include <execinfo.h>
+#else
+#include <libunwind.h>
+#endif
+#endif /* ENABLE_BACKTRACE */
+
+#include "diag.h"
+#include "fiber.h"
+
+enum {
+	/**
+	 * Retained samples. Allocation profiles are read while
+	 * the workload is live, so only the recent window
+	 * matters and the ring may wrap.
+	 */
+	ALLOC_PROFILE_RING_SIZE = 256,
+};
+
+struct alloc_profile_entry {
+	/** Requested allocation size, in bytes. */
+	size_t size;
+	/** Raw frame addresses of the allocating call, leaf first. */
+	void *frames[ALLOC_PROFILE_FRAMES_MAX];
+	/** Number of valid entries in @a frames. */
+	int n_frames;
+	/** Name of the allocating fiber, truncated. */
+	char fiber_name[FIBER_NAME_INLINE];
+};
+
+int alloc_profile_period;
+
+static struct {
+	/** Total samples taken, also the ring write position. */
+	uint64_t n_samples;
+	/** Preallocated sample ring, NULL until first start. */
+	struct alloc_profile_entry *ring;
+} alloc_profile;
+
+/** Allocations left until the next sample on this thread. */
+static __thread int alloc_profile_countdown;
+
+void
+alloc_profile_record(size_t size)
+{
+	if (--alloc_profile_countdown > 0)
+		return;
+	alloc_profile_countdown = alloc_profile_period;
+	uint64_t n = pm_atomic_fetch_add(&alloc_profile.n_samples, 1);
+	struct alloc_profile_entry *e =
+		&alloc_profile.ring[n % ALLOC_PROFILE_RING_SIZE];
+	e->size = size;
+#ifdef ENABLE_BACKTRACE
+#ifdef TARGET_OS_DARWIN
+	e->n_frames = backtrace(e->frames, ALLOC_PROFILE_FRAMES_MAX);
+#else
+	e->n_frames = unw_backtrace(e->frames, ALLOC_PROFILE_FRAMES_MAX);
+#endif
+#else
+	e->n_frames = 0;
+#endif /* ENABLE_BACKTRACE */
+	const char *name = "<thread>";
+	if (cord() != NULL && fiber() != NULL)
+		name = fiber()->name;
+	strlcpy(e->fiber_name, name, sizeof(e->fiber_name));
+}
+
+int
+alloc_profile_start(int period)
+{
+	if (period < 1) {
+		diag_set(IllegalParams, "allocation profile period must be "
+			 "a positive number");
+		return -1;
+	}
+	if (alloc_profile.ring == NULL) {
+		alloc_profile.ring = calloc(ALLOC_PROFILE_RING_SIZE,
+					    sizeof(*alloc_profile.ring));
+		if (alloc_profile.ring == NULL) {
+			diag_set(OutOfMemory, ALLOC_PROFILE_RING_SIZE *
+				 sizeof(*alloc_profile.ring), "calloc",
+				 "allocation profile ring");
+			return -1;
+		}
+	}
+	alloc_profile.n_samples = 0;
+	alloc_profile_period = period;
+	return 0;
+}
+
+void
+alloc_profile_stop(void)
+{
+	alloc_profile_period = 0;
+}
+
+uint64_t
+alloc_profile_total(void)
+{
+	return alloc_profile.n_samples;
+}
+
+int
+alloc_profile_foreach(alloc_profile_cb cb, void *cb_ctx)
+{
+	if (alloc_profile.ring == NULL)
+		return 0;
+	uint64_t total = alloc_profile.n_samples;
+	uint64_t count = total;
+	if (count > ALLOC_PROFILE_RING_SIZE)
+		count = ALLOC_PROFILE_RING_SIZE;
+	for (uint64_t i = total - count; i < total; i++) {
+		struct alloc_profile_entry *e =
+			&alloc_profile.ring[i % ALLOC_PROFILE_RING_SIZE];
+		int rc = cb(e->size, e->fiber_name, e->frames, e->n_frames,
+			    cb_ctx);
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
+}
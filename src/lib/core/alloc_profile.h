@@ -0,0 +1,112 @@
+#ifndef TARANTOOL_LIB_CORE_ALLOC_PROFILE_H_INCLUDED
+#define TARANTOOL_LIB_CORE_ALLOC_PROFILE_H_INCLUDED
+/*
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "trivia/util.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Sampled allocation profiler. Hot allocation paths call
+ * alloc_profile_sample(), which is a single comparison against a
+ * global period while profiling is off. When on, every period-th
+ * call per thread records the requested size, the current fiber
+ * name and a shallow raw backtrace into a fixed ring, cheap
+ * enough to leave enabled while hunting an allocation hog.
+ * Frames are resolved to names only when the ring is read.
+ */
+
+enum {
+	/** Frames kept per sample - the immediate call chain. */
+	ALLOC_PROFILE_FRAMES_MAX = 8,
+};
+
+/** Sampling period, 0 while profiling is off. */
+extern int alloc_profile_period;
+
+/** Slow path of alloc_profile_sample(), do not call directly. */
+void
+alloc_profile_record(size_t size);
+
+/**
+ * Account one allocation of @a size bytes. To be called from
+ * allocation wrappers; costs one predictable branch when
+ * profiling is off.
+ */
+static inline void
+alloc_profile_sample(size_t size)
+{
+	if (likely(alloc_profile_period == 0))
+		return;
+	alloc_profile_record(size);
+}
+
+/**
+ * Enable profiling, recording every @a period-th allocation.
+ * Previously collected samples are discarded. Returns 0 on
+ * success, -1 on error (diag is set).
+ */
+int
+alloc_profile_start(int period);
+
+/** Disable profiling, retaining the collected samples. */
+void
+alloc_profile_stop(void);
+
+/** Number of samples recorded since the last start. */
+uint64_t
+alloc_profile_total(void);
+
+/**
+ * Callback for alloc_profile_foreach(): allocation size, name of
+ * the allocating fiber and its raw frame addresses, leaf first.
+ */
+typedef int (*alloc_profile_cb)(size_t size, const char *fiber_name,
+				void *const *frames, int n_frames,
+				void *cb_ctx);
+
+/**
+ * Invoke @a cb for every retained sample, newest last. Stops and
+ * returns the callback result as soon as it is not 0.
+ */
+int
+alloc_profile_foreach(alloc_profile_cb cb, void *cb_ctx);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* TARANTOOL_LIB_CORE_ALLOC_PROFILE_H_INCLUDED */
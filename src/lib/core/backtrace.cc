@@ -46,6 +46,10 @@
 #ifdef ENABLE_BACKTRACE
 #include <libunwind.h>
 
+#ifdef TARGET_OS_DARWIN
+#include <dlfcn.h>
+#endif
+
 #include "small/region.h"
 #include "small/static.h"
 /*
@@ -130,6 +134,27 @@ error:
 	return proc_name;
 }
 
+const char *
+backtrace_ip_name(void *ip)
+{
+	static __thread char ip_name[BACKTRACE_NAME_MAX];
+#ifdef TARGET_OS_DARWIN
+	/* The Darwin unwinder cannot look a name up by address. */
+	Dl_info dli;
+	if (dladdr(ip, &dli) == 0 || dli.dli_sname == NULL)
+		snprintf(ip_name, sizeof(ip_name), "%p", ip);
+	else
+		snprintf(ip_name, sizeof(ip_name), "%s", dli.dli_sname);
+#else
+	unw_word_t offset;
+	if (unw_get_proc_name_by_ip(unw_local_addr_space, (unw_word_t)ip,
+				    ip_name, sizeof(ip_name), &offset,
+				    NULL) < 0)
+		snprintf(ip_name, sizeof(ip_name), "%p", ip);
+#endif
+	return ip_name;
+}
+
 char *
 backtrace(char *start, size_t size)
 {
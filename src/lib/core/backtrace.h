@@ -55,6 +55,15 @@ backtrace_foreach(backtrace_cb cb, coro_context *coro_ctx, void *cb_ctx);
 void
 backtrace_proc_cache_clear(void);
 
+/**
+ * Resolve a raw instruction address to a function name. Returns
+ * a pointer to a thread-local buffer, or the address printed in
+ * hex if the symbol is unknown. For symbolizing frames captured
+ * outside of an unwind, where no cursor is available.
+ */
+const char *
+backtrace_ip_name(void *ip);
+
 #endif /* ENABLE_BACKTRACE */
 
 #if defined(__cplusplus)
@@ -94,6 +94,9 @@ cpipe_create(struct cpipe *pipe, const char *consumer)
 
 	pipe->n_input = 0;
 	pipe->max_input = INT_MAX;
+	pipe->max_input_limit = INT_MAX;
+	pipe->flush_count = 0;
+	pipe->tune_time = 0;
 	pipe->producer = cord()->loop;
 
 	ev_async_init(&pipe->flush_input, cpipe_flush_cb);
@@ -279,15 +282,56 @@ cbus_endpoint_destroy(struct cbus_endpoint *endpoint,
 	return 0;
 }
 
+enum {
+	/**
+	 * Flushes per second above which a pipe is considered to
+	 * keep the endpoint mutex hot, so the staging cap may grow
+	 * back to its ceiling to merge more messages into one lock
+	 * acquisition. Well below the target the cap decays
+	 * instead, trading a few extra locks for lower staging
+	 * latency.
+	 */
+	CPIPE_FLUSH_RATE_TARGET = 1024,
+	/** The lowest value auto-tuning can shrink max_input to. */
+	CPIPE_MIN_INPUT = 64,
+};
+
+/**
+ * Adjust the staging cap of the pipe to the observed flush rate,
+ * at most once a second (@sa cpipe_set_max_input()).
+ */
+static void
+cpipe_tune_max_input(struct cpipe *pipe, ev_tstamp now)
+{
+	if (pipe->max_input_limit == INT_MAX)
+		return;
+	pipe->flush_count++;
+	if (now - pipe->tune_time < 1.0)
+		return;
+	if (pipe->tune_time != 0) {
+		if (pipe->flush_count > CPIPE_FLUSH_RATE_TARGET) {
+			if (pipe->max_input <= pipe->max_input_limit / 2)
+				pipe->max_input *= 2;
+			else
+				pipe->max_input = pipe->max_input_limit;
+		} else if (pipe->flush_count < CPIPE_FLUSH_RATE_TARGET / 4 &&
+			   pipe->max_input / 2 >= CPIPE_MIN_INPUT) {
+			pipe->max_input /= 2;
+		}
+	}
+	pipe->flush_count = 0;
+	pipe->tune_time = now;
+}
+
 static void
 cpipe_flush_cb(ev_loop *loop, struct ev_async *watcher, int events)
 {
-	(void) loop;
 	(void) events;
 	struct cpipe *pipe = (struct cpipe *) watcher->data;
 	struct cbus_endpoint *endpoint = pipe->endpoint;
 	if (pipe->n_input == 0)
 		return;
+	cpipe_tune_max_input(pipe, ev_monotonic_now(loop));
 
 	trigger_run(&pipe->on_flush, pipe);
 	/* Trigger task processing when the queue becomes non-empty. */
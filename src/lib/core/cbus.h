@@ -140,6 +140,15 @@ struct cpipe {
 	 * is not empty.
 	 */
 	struct rlist on_flush;
+	/**
+	 * Ceiling for the auto-tuned max_input, as given to
+	 * cpipe_set_max_input(). INT_MAX disables the tuning.
+	 */
+	int max_input_limit;
+	/** Number of flushes since the last auto-tune. */
+	int flush_count;
+	/** Time of the last auto-tune, producer loop clock. */
+	ev_tstamp tune_time;
 };
 
 /**
@@ -165,15 +174,18 @@ cpipe_destroy(struct cpipe *pipe);
  * per event loop.
  * Otherwise, the messages flushed once per event loop iteration.
  *
- * @todo: collect bus stats per second and adjust max_input once
- * a second to keep the mutex cold regardless of the message load,
- * while still keeping the latency low if there are few
- * long-to-process messages.
+ * The given value also becomes the ceiling for auto-tuning: the
+ * effective cap is adjusted once a second from the observed flush
+ * rate, shrinking when the pipe is quiet - so a message staged
+ * early in a long event loop iteration is not held up behind a
+ * huge batch - and growing back to the ceiling under load to keep
+ * the endpoint mutex cold.
  */
 static inline void
 cpipe_set_max_input(struct cpipe *pipe, int max_input)
 {
 	pipe->max_input = max_input;
+	pipe->max_input_limit = max_input;
 }
 
 static inline void
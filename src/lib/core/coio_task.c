@@ -66,6 +66,18 @@
  * http://pod.tst.eu/http://cvs.schmorp.de/libeio/eio.pod
 */
 
+enum {
+	/**
+	 * Cap on the number of eio worker threads. eio starts a
+	 * thread only when a submitted task would otherwise wait
+	 * in the queue, and workers idling beyond eio's idle
+	 * timeout exit, so the cap is reached only under sustained
+	 * blocking-I/O load. The stock limit of 4 threads made
+	 * task bursts queue up behind whatever was posted first.
+	 */
+	COIO_MAX_THREADS = 64,
+};
+
 struct coio_manager {
 	ev_loop *loop;
 	ev_idle coio_idle;
@@ -143,6 +155,12 @@ void
 coio_enable(void)
 {
 	eio_init(&coio_manager, coio_want_poll_cb, coio_done_poll_cb);
+	/*
+	 * Despite the name, this raises the ceiling the pool may
+	 * grow to on demand; eio_set_max_parallel() can only lower
+	 * it.
+	 */
+	eio_set_min_parallel(COIO_MAX_THREADS);
 	coio_manager.loop = loop();
 
 	ev_idle_init(&coio_manager.coio_idle, coio_idle_cb);
@@ -372,6 +390,11 @@ coio_getaddrinfo(const char *host, const char *port,
 	}
 
 	coio_task_create(&task->base, getaddrinfo_cb, getaddrinfo_free_cb);
+	/*
+	 * A DNS lookup is short and latency-sensitive: let it jump
+	 * the eio queue ahead of bulk file I/O posted before it.
+	 */
+	task->base.base.pri = EIO_PRI_MAX;
 
 	/*
 	 * getaddrinfo() on osx upto osx 10.8 crashes when AI_NUMERICSERV is
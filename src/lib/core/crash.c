@@ -19,6 +19,7 @@
 #include "box/replication.h"
 #include "backtrace.h"
 #include "crash.h"
+#include "flightrec.h"
 #include "say.h"
 
 #define pr_fmt(fmt)		"crash: " fmt
@@ -527,6 +528,13 @@ crash_signal_cb(int signo, siginfo_t *siginfo, void *context)
 		in_cb = 1;
 		cinfo = crash_collect(signo, siginfo, context);
 		crash_report_stderr(cinfo);
+		/*
+		 * Preserve the last recorded events for post-mortem
+		 * analysis; the file lands in the working directory
+		 * next to the snaps.
+		 */
+		if (flightrec_dump("flightrec.crash.log") < 0)
+			pr_crit("unable to dump the flight recorder");
 		if (send_crashinfo &&
 		    crash_report_feedback_daemon(cinfo) != 0) {
 			pr_crit("unable to send a crash report");
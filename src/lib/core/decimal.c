@@ -312,9 +312,79 @@ decimal_minus(decimal_t *res, const decimal_t *dec)
 	return res;
 }
 
+enum {
+	/** Largest scale served by the fixed-point fast path. */
+	DECIMAL_FAST_SCALE_MAX = 4,
+	/**
+	 * Operand coefficient digit cap. With at most 4 digits of
+	 * exponent alignment both scaled coefficients stay below
+	 * 10^18 and their sum below 2 * 10^18, well within int64.
+	 */
+	DECIMAL_FAST_DIGITS = 14,
+};
+
+#if DECDPUN == 3
+
+/** Read a fast-path operand coefficient as a signed integer. */
+static inline int64_t
+decimal_fast_coeff(const decimal_t *d)
+{
+	int nunits = (d->digits + DECDPUN - 1) / DECDPUN;
+	int64_t v = 0;
+	for (int i = nunits - 1; i >= 0; i--)
+		v = v * 1000 + d->lsu[i];
+	return (d->bits & DECNEG) != 0 ? -v : v;
+}
+
+/**
+ * Add or subtract two decimals as scaled int64 integers when both
+ * have a small scale and coefficient - the common case of money
+ * arithmetic, where the general decNumber machinery is overkill.
+ * The result is bit-identical to decNumberAdd(): the exponent is
+ * the smaller operand exponent, trailing zeros are kept, no
+ * rounding can occur at these sizes.
+ * @retval true Result written to @a res.
+ * @retval false Operands out of range, take the decNumber path.
+ */
+static bool
+decimal_fast_add(decimal_t *res, const decimal_t *lhs, const decimal_t *rhs,
+		 bool negate_rhs)
+{
+	if (lhs->exponent > 0 || lhs->exponent < -DECIMAL_FAST_SCALE_MAX ||
+	    rhs->exponent > 0 || rhs->exponent < -DECIMAL_FAST_SCALE_MAX ||
+	    lhs->digits > DECIMAL_FAST_DIGITS ||
+	    rhs->digits > DECIMAL_FAST_DIGITS ||
+	    ((lhs->bits | rhs->bits) & DECSPECIAL) != 0)
+		return false;
+	static const int64_t pow10[] = {1, 10, 100, 1000, 10000};
+	int32_t e = MIN(lhs->exponent, rhs->exponent);
+	int64_t a = decimal_fast_coeff(lhs) * pow10[lhs->exponent - e];
+	int64_t b = decimal_fast_coeff(rhs) * pow10[rhs->exponent - e];
+	int64_t r = negate_rhs ? a - b : a + b;
+	uint64_t coeff = r < 0 ? (uint64_t)-r : (uint64_t)r;
+	int i = 0;
+	do {
+		res->lsu[i++] = coeff % 1000;
+		coeff /= 1000;
+	} while (coeff != 0);
+	decNumberUnit top = res->lsu[i - 1];
+	res->digits = (i - 1) * DECDPUN + (top >= 100 ? 3 :
+					   top >= 10 ? 2 : 1);
+	res->exponent = e;
+	/* A zero sum is +0 under the default rounding mode. */
+	res->bits = r < 0 ? DECNEG : 0;
+	return true;
+}
+
+#endif /* DECDPUN == 3 */
+
 decimal_t *
 decimal_add(decimal_t *res, const decimal_t *lhs, const decimal_t *rhs)
 {
+#if DECDPUN == 3
+	if (decimal_fast_add(res, lhs, rhs, false))
+		return res;
+#endif
 	decNumberAdd(res, lhs, rhs, &decimal_context);
 	return decimal_check_status(res, &decimal_context);
 }
@@ -322,6 +392,10 @@ decimal_add(decimal_t *res, const decimal_t *lhs, const decimal_t *rhs)
 decimal_t *
 decimal_sub(decimal_t *res, const decimal_t *lhs, const decimal_t *rhs)
 {
+#if DECDPUN == 3
+	if (decimal_fast_add(res, lhs, rhs, true))
+		return res;
+#endif
 	decNumberSubtract(res, lhs, rhs, &decimal_context);
 
 	return decimal_check_status(res, &decimal_context);
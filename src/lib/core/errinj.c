@@ -37,6 +37,7 @@
 
 #include "trivia/config.h"
 #include "trivia/util.h"
+#include "random.h"
 #include "say.h"
 #include "errinj.h"
 
@@ -46,6 +47,28 @@ struct errinj errinjs[errinj_id_MAX] = {
 	ERRINJ_LIST(ERRINJ_MEMBER)
 };
 
+bool errinj_delay_enabled;
+
+double
+errinj_delay_value(int id)
+{
+	assert(id >= 0 && id < errinj_id_MAX);
+	struct errinj *inj = &errinjs[id];
+	assert(inj->type == ERRINJ_DOUBLE);
+	double delay = inj->dparam;
+	if (delay <= 0)
+		return 0;
+	double jitter = errinjs[ERRINJ_DELAY_JITTER].dparam;
+	if (jitter > 0) {
+		if (jitter > 1)
+			jitter = 1;
+		/* Scale the delay by a factor in [1 - j, 1 + j]. */
+		double r = pseudo_random_in_range(0, 1000000) * 1e-6;
+		delay *= 1 - jitter + 2 * jitter * r;
+	}
+	return delay;
+}
+
 struct errinj *
 errinj_by_name(char *name)
 {
@@ -70,6 +93,14 @@ int errinj_foreach(errinj_cb cb, void *cb_ctx) {
 }
 
 void errinj_set_with_environment_vars(void) {
+	const char *delay_env = getenv("ERRINJ_DELAY_ENABLE");
+	if (delay_env != NULL && *delay_env != '\0') {
+		if (strcasecmp(delay_env, "true") == 0)
+			errinj_delay_enabled = true;
+		else if (strcasecmp(delay_env, "false") != 0)
+			panic("Incorrect value for boolean "
+			      "ERRINJ_DELAY_ENABLE: %s", delay_env);
+	}
 	for (enum errinj_id i = 0; i < errinj_id_MAX; i++) {
 		struct errinj *inj = &errinjs[i];
 		const char *env_value = getenv(inj->name);
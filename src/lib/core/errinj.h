@@ -152,6 +152,10 @@ struct errinj {
 	_(ERRINJ_STDIN_ISATTY, ERRINJ_INT, {.iparam = -1}) \
 	_(ERRINJ_SNAP_COMMIT_FAIL, ERRINJ_BOOL, {.bparam = false}) \
 	_(ERRINJ_IPROTO_SINGLE_THREAD_STAT, ERRINJ_INT, {.iparam = -1}) \
+	_(ERRINJ_DELAY_WAL_WRITE, ERRINJ_DOUBLE, {.dparam = 0}) \
+	_(ERRINJ_DELAY_IPROTO_TX, ERRINJ_DOUBLE, {.dparam = 0}) \
+	_(ERRINJ_DELAY_VY_RUN_WRITE, ERRINJ_DOUBLE, {.dparam = 0}) \
+	_(ERRINJ_DELAY_JITTER, ERRINJ_DOUBLE, {.dparam = 0}) \
 
 ENUM0(errinj_id, ERRINJ_LIST);
 extern struct errinj errinjs[];
@@ -215,6 +219,47 @@ void errinj_set_with_environment_vars(void);
 	} while (0)
 #endif
 
+/**
+ * Latency injection, for chaos testing of timeouts, queueing and
+ * replication lag. Unlike ERROR_INJECT, the DELAY_INJECT sites
+ * are compiled into release builds too: the ERRINJ_DELAY_*
+ * values above are settable at runtime via box.error.injection,
+ * but all the sites stay dormant - a single flag test - unless
+ * the instance was deliberately started with
+ * ERRINJ_DELAY_ENABLE=true in the environment.
+ *
+ * The injected delay is the ERRINJ_DELAY_* value in seconds,
+ * randomized by up to +/- ERRINJ_DELAY_JITTER fraction of it.
+ * DELAY_INJECT sleeps the fiber, DELAY_INJECT_BLOCKING stalls
+ * the whole thread the way a slow disk would.
+ */
+extern bool errinj_delay_enabled;
+
+/**
+ * Compute the delay for injection @a id: its double parameter
+ * with jitter applied, in seconds. 0 if the point is not set.
+ */
+double
+errinj_delay_value(int id);
+
+#define DELAY_INJECT(ID) \
+	do { \
+		if (unlikely(errinj_delay_enabled)) { \
+			double inj_delay = errinj_delay_value(ID); \
+			if (inj_delay > 0) \
+				fiber_sleep(inj_delay); \
+		} \
+	} while (0)
+
+#define DELAY_INJECT_BLOCKING(ID) \
+	do { \
+		if (unlikely(errinj_delay_enabled)) { \
+			double inj_delay = errinj_delay_value(ID); \
+			if (inj_delay > 0) \
+				usleep(inj_delay * 1000000); \
+		} \
+	} while (0)
+
 #define ERROR_INJECT_RETURN(ID) ERROR_INJECT(ID, return -1)
 #define ERROR_INJECT_SLEEP(ID) ERROR_INJECT_WHILE(ID, usleep(1000))
 #define ERROR_INJECT_YIELD(ID) ERROR_INJECT_WHILE(ID, fiber_sleep(0.001))
@@ -257,6 +257,19 @@ evio_service_bind_addr(struct evio_service *service)
 				   SOCK_STREAM) != 0)
 		goto error;
 
+	if (service->reuseport && service->addr.sa_family != AF_UNIX) {
+#ifdef SO_REUSEPORT
+		int on = 1;
+		if (sio_setsockopt(fd, SOL_SOCKET, SO_REUSEPORT,
+				   &on, sizeof(on)))
+			goto error;
+#else
+		diag_set(SocketError, sio_socketname(fd),
+			 "SO_REUSEPORT is not supported");
+		goto error;
+#endif
+	}
+
 	if (sio_bind(fd, &service->addr, service->addr_len)) {
 		if (errno != EADDRINUSE)
 			goto error;
@@ -401,6 +414,25 @@ evio_service_bind(struct evio_service *service, const char *uri)
 	return -1;
 }
 
+int
+evio_service_bind_dup(struct evio_service *service,
+		      const struct evio_service *master)
+{
+	assert(! ev_is_active(&service->ev));
+
+	snprintf(service->host, sizeof(service->host), "%s", master->host);
+	snprintf(service->serv, sizeof(service->serv), "%s", master->serv);
+	/*
+	 * Copy the resolved address rather than re-parsing the
+	 * uri: if the configured port was 0, the master service
+	 * holds the port actually assigned by the kernel.
+	 */
+	service->addrstorage = master->addrstorage;
+	service->addr_len = master->addr_len;
+	service->reuseport = master->reuseport;
+	return evio_service_bind_addr(service);
+}
+
 /** It's safe to stop a service which is not started yet. */
 void
 evio_service_stop(struct evio_service *service)
@@ -87,6 +87,15 @@ struct evio_service
 	};
 	socklen_t addr_len;
 
+	/**
+	 * If set before binding, create the acceptor socket with
+	 * SO_REUSEPORT, so that several services may be bound to
+	 * the same TCP address and the kernel load-balances
+	 * incoming connections between them. Has no effect on
+	 * unix sockets.
+	 */
+	bool reuseport;
+
 	/**
 	 * A callback invoked on every accepted client socket.
 	 * If a callback returned != 0, the accepted socket is
@@ -109,6 +118,15 @@ evio_service_init(ev_loop *loop, struct evio_service *service, const char *name,
 int
 evio_service_bind(struct evio_service *service, const char *uri);
 
+/**
+ * Bind a service to the address another service is already
+ * bound to. Only makes sense with SO_REUSEPORT, to create
+ * several acceptor sockets for one address.
+ */
+int
+evio_service_bind_dup(struct evio_service *service,
+		      const struct evio_service *master);
+
 /**
  * Listen on bounded socket
  *
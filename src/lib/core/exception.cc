@@ -33,6 +33,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <pmatomic.h>
 
 #include "fiber.h"
 #include "reflection.h"
@@ -93,10 +94,77 @@ static const struct method_info exception_methods[] = {
 const struct type_info type_Exception = make_type("Exception", NULL,
 	exception_methods);
 
+enum {
+	/**
+	 * Size of one preallocated error slot. Covers every
+	 * frequently raised error type; an error object which
+	 * does not fit falls back to malloc().
+	 */
+	EXCEPTION_SLOT_SIZE = 1024,
+	/**
+	 * Slots preallocated for the whole process, one bit of
+	 * the busy mask each. Several errors can be alive at a
+	 * time: a cause list, a pending diag in every thread,
+	 * an exception in flight.
+	 */
+	EXCEPTION_SLOT_COUNT = 32,
+};
+
+/**
+ * Preallocated storage for error objects. Raising an error is
+ * often a hot path - think of a buggy client flooding duplicate
+ * key errors - and a malloc() per raise adds allocator contention
+ * on top of the storm. The slots make the common raise/free cycle
+ * allocation-free; the message is formatted by vsnprintf() into
+ * the fixed buffer embedded in struct error as before, so nothing
+ * else on the path allocates. The storage is global rather than
+ * per-thread because errors travel between cords (WAL, relay,
+ * iproto) and may well be destroyed by a thread other than the
+ * one which raised them, possibly after the raising thread has
+ * exited.
+ */
+static char exception_slots[EXCEPTION_SLOT_COUNT][EXCEPTION_SLOT_SIZE]
+	__attribute__((aligned(16)));
+/** Busy mask of exception_slots, accessed atomically. */
+static uint32_t exception_slot_busy;
+
+static void *
+exception_slot_alloc(size_t size)
+{
+	if (size > EXCEPTION_SLOT_SIZE)
+		return NULL;
+	uint32_t busy = pm_atomic_load(&exception_slot_busy);
+	while (busy != UINT32_MAX) {
+		uint32_t i = __builtin_ffs(~busy) - 1;
+		if (pm_atomic_compare_exchange_weak(&exception_slot_busy,
+						    &busy, busy | (1U << i)))
+			return exception_slots[i];
+	}
+	return NULL;
+}
+
+/** Return true if @a ptr was a slot and has been released. */
+static bool
+exception_slot_release(void *ptr)
+{
+	char *p = (char *)ptr;
+	if (p < exception_slots[0] ||
+	    p >= exception_slots[EXCEPTION_SLOT_COUNT - 1] +
+	    EXCEPTION_SLOT_SIZE)
+		return false;
+	uint32_t i = (p - exception_slots[0]) / EXCEPTION_SLOT_SIZE;
+	assert(p == exception_slots[i]);
+	assert((pm_atomic_load(&exception_slot_busy) & (1U << i)) != 0);
+	pm_atomic_fetch_and(&exception_slot_busy, ~(1U << i));
+	return true;
+}
+
 void *
 Exception::operator new(size_t size)
 {
-	void *buf = malloc(size);
+	void *buf = exception_slot_alloc(size);
+	if (buf == NULL)
+		buf = malloc(size);
 	if (buf != NULL)
 		return buf;
 	diag_set_error(diag_get(), &out_of_memory);
@@ -106,6 +174,8 @@ Exception::operator new(size_t size)
 void
 Exception::operator delete(void *ptr)
 {
+	if (ptr == NULL || exception_slot_release(ptr))
+		return;
 	free(ptr);
 }
 
@@ -301,7 +371,9 @@ RaftError::RaftError(const char *file, unsigned line, const char *format, ...)
 }
 
 #define BuildAlloc(type)				\
-	void *p = malloc(sizeof(type));			\
+	void *p = exception_slot_alloc(sizeof(type));	\
+	if (p == NULL)					\
+		p = malloc(sizeof(type));		\
 	if (p == NULL)					\
 		return &out_of_memory;
 
@@ -39,6 +39,7 @@
 #include <pmatomic.h>
 
 #include "assoc.h"
+#include "clock.h"
 #include "memory.h"
 #include "trigger.h"
 #include "errinj.h"
@@ -215,6 +216,16 @@ fiber_mprotect(void *addr, size_t len, int prot)
 static __thread bool fiber_top_enabled = false;
 #endif /* ENABLE_FIBER_TOP */
 
+/**
+ * A fiber that keeps the cord for longer than this many seconds
+ * between two context switches is reported to the log. Nothing in
+ * the cord can preempt it - timers, network events and the other
+ * fibers all wait - and forcing a yield from outside would break
+ * transaction atomicity, so the most the core can do is name the
+ * offender; the fix is a voluntary yield inside the hot loop.
+ */
+static const double FIBER_LONG_SLICE = 1.0;
+
 /**
  * An action performed each time a context switch happens.
  * Used to count each fiber's processing time.
@@ -224,6 +235,17 @@ clock_set_on_csw(struct fiber *caller)
 {
 	caller->csw++;
 
+	struct cord *cord = cord();
+	double now = clock_monotonic();
+	if (caller != &cord->sched &&
+	    unlikely(now - cord->csw_time > FIBER_LONG_SLICE)) {
+		say_warn_ratelimited("fiber '%s' blocked cord '%s' for "
+				     "%.1f sec without yielding",
+				     fiber_name(caller), cord->name,
+				     now - cord->csw_time);
+	}
+	cord->csw_time = now;
+
 #if ENABLE_FIBER_TOP
 	if (!fiber_top_enabled)
 		return;
@@ -372,6 +394,9 @@ fiber_recycle(struct fiber *fiber);
 static void
 fiber_stack_recycle(struct fiber *fiber);
 
+static inline void
+stack_check_canary(struct fiber *fiber);
+
 static void
 fiber_destroy(struct cord *cord, struct fiber *f);
 
@@ -680,6 +705,12 @@ fiber_yield(void)
 	struct fiber *callee = caller->caller;
 	caller->caller = &cord->sched;
 
+	/*
+	 * A couple of loads and compares per yield buy overflow
+	 * detection on the stacks which have no mprotect() guard.
+	 */
+	stack_check_canary(caller);
+
 	/** By convention, these triggers must not throw. */
 	if (! rlist_empty(&caller->on_yield))
 		trigger_run(&caller->on_yield, NULL);
@@ -853,15 +884,44 @@ fiber_self(void)
 	return fiber();
 }
 
+enum {
+	/** Cached region memory is always kept up to this much. */
+	FIBER_GC_RETAIN_MIN = 128 * 1024,
+	/**
+	 * Cap on how much cached region memory a single fiber may
+	 * retain between requests, whatever its history.
+	 */
+	FIBER_GC_RETAIN_MAX = 512 * 1024,
+};
+
 void
 fiber_gc(void)
 {
-	if (region_used(&fiber()->gc) < 128 * 1024) {
-		region_reset(&fiber()->gc);
+	struct fiber *f = fiber();
+	size_t used = region_used(&f->gc);
+	/*
+	 * Track the per-request footprint with fast rise and slow
+	 * decay, and retain the region slabs a typical request of
+	 * this fiber is going to ask for again right away. A fixed
+	 * cliff made every fiber serving larger-than-threshold
+	 * requests give its slabs back only to re-request them on
+	 * the next message.
+	 */
+	if (used > f->gc_high_water)
+		f->gc_high_water = used;
+	else
+		f->gc_high_water -= f->gc_high_water / 16;
+	size_t retain = f->gc_high_water;
+	if (retain < FIBER_GC_RETAIN_MIN)
+		retain = FIBER_GC_RETAIN_MIN;
+	else if (retain > FIBER_GC_RETAIN_MAX)
+		retain = FIBER_GC_RETAIN_MAX;
+	if (used < retain) {
+		region_reset(&f->gc);
 		return;
 	}
 
-	region_free(&fiber()->gc);
+	region_free(&f->gc);
 }
 
 /** Common part of fiber_new() and fiber_recycle(). */
@@ -898,6 +958,7 @@ fiber_recycle(struct fiber *fiber)
 	unregister_fid(fiber);
 	fiber->fid = 0;
 	region_free(&fiber->gc);
+	fiber->gc_high_water = 0;
 	if (!has_custom_stack) {
 		rlist_move_entry(&cord()->dead, fiber, link);
 	} else {
@@ -994,7 +1055,76 @@ page_align_up(void *ptr)
 	return page_align_down(ptr + page_size - 1);
 }
 
+enum {
+	/**
+	 * One out of this many coro stacks gets a real PROT_NONE
+	 * guard page. The syscall per stack creation is too
+	 * expensive to pay for all of them under heavy fiber
+	 * churn, while a random sample keeps statistical coverage
+	 * of hard overflow detection across the fiber population.
+	 */
+	FIBER_STACK_GUARD_SAMPLE = 100,
+};
+
+/*
+ * Random values generated with uuid. Written to the overflow end
+ * of every coro stack, right next to the reserved guard page, and
+ * verified on every yield. They catch an overflow that stepped
+ * over the boundary even on the stacks which were not picked for
+ * an mprotect() guard.
+ */
+static const uint64_t stack_canary[] = {
+	0x2c0950a318d3a1d7, 0xe67660cfc38a3d9b,
+};
+
+/** Address of the canary words on a fiber stack. */
+static inline uint64_t *
+stack_canary_addr(struct fiber *fiber)
+{
+	if (stack_direction < 0)
+		return (uint64_t *)fiber->stack;
+	return (uint64_t *)(fiber->stack + fiber->stack_size) -
+	       lengthof(stack_canary);
+}
+
+/**
+ * Write the canary words to the overflow end of the stack. The
+ * sched fiber runs on the thread stack and has no slab, custom
+ * stacks are not tracked for simplicity - same as the watermark.
+ */
+static void
+stack_put_canary(struct fiber *fiber)
+{
+	if (fiber->stack_slab == NULL || (fiber->flags & FIBER_CUSTOM_STACK))
+		return;
+	memcpy(stack_canary_addr(fiber), stack_canary, sizeof(stack_canary));
+}
+
+/** Panic if the canary words have been overwritten. */
+static inline void
+stack_check_canary(struct fiber *fiber)
+{
+	if (fiber->stack_slab == NULL || (fiber->flags & FIBER_CUSTOM_STACK))
+		return;
+	if (memcmp(stack_canary_addr(fiber), stack_canary,
+		   sizeof(stack_canary)) != 0)
+		panic("fiber `%s' has overflowed its stack", fiber->name);
+}
+
 #ifdef HAVE_MADV_DONTNEED
+/*
+ * Prefer MADV_FREE for releasing stack pages where available:
+ * reclamation is deferred until the kernel actually needs the
+ * memory, so a warm stack picked up from the recycle list shortly
+ * afterwards does not page-fault its pages back in. MADV_DONTNEED
+ * drops them immediately.
+ */
+#ifdef HAVE_MADV_FREE
+#define FIBER_STACK_RECLAIM_ADVICE MADV_FREE
+#else
+#define FIBER_STACK_RECLAIM_ADVICE MADV_DONTNEED
+#endif
+
 /**
  * Check if stack poison values are present starting from
  * the address provided.
@@ -1057,12 +1187,17 @@ fiber_stack_recycle(struct fiber *fiber)
 	}
 
 	/*
-	 * Ignore errors on MADV_DONTNEED because this is
-	 * just a hint for OS and not critical for
-	 * functionality.
+	 * Ignore errors on madvise() because this is just a
+	 * hint for OS and not critical for functionality.
 	 */
-	fiber_madvise(start, end - start, MADV_DONTNEED);
+	fiber_madvise(start, end - start, FIBER_STACK_RECLAIM_ADVICE);
 	stack_put_watermark(fiber->stack_watermark);
+	/*
+	 * The dropped range covers the overflow end of the stack,
+	 * so the canary words read back as zeros now - rewrite
+	 * them.
+	 */
+	stack_put_canary(fiber);
 }
 
 /**
@@ -1132,7 +1267,11 @@ fiber_stack_destroy(struct fiber *fiber, struct slab_cache *slabc)
 		else
 			guard = page_align_up(fiber->stack + fiber->stack_size);
 
-		if (fiber_mprotect(guard, page_size, mprotect_flags) != 0) {
+		if (!fiber->stack_has_guard) {
+			/* No PROT_NONE page, nothing to undo. */
+			slab_put(slabc, fiber->stack_slab);
+		} else if (fiber_mprotect(guard, page_size,
+					  mprotect_flags) != 0) {
 			/*
 			 * FIXME: We need some intelligent handling:
 			 * say put this slab into a queue and retry
@@ -1153,6 +1292,7 @@ fiber_stack_destroy(struct fiber *fiber, struct slab_cache *slabc)
 			say_syserror("fiber: Can't put guard page to slab. "
 				     "Leak %zu bytes", (size_t)fiber->stack_size);
 		} else {
+			fiber->stack_has_guard = false;
 			slab_put(slabc, fiber->stack_slab);
 		}
 	}
@@ -1199,17 +1339,28 @@ fiber_stack_create(struct fiber *fiber, struct slab_cache *slabc,
 						  (char *)fiber->stack +
 						  fiber->stack_size);
 
-	if (fiber_mprotect(guard, page_size, PROT_NONE)) {
-		/*
-		 * Write an error into the log since a guard
-		 * page is critical for functionality.
-		 */
-		diag_log();
-		fiber_stack_destroy(fiber, slabc);
-		return -1;
+	/*
+	 * The guard page is reserved in the layout of every stack,
+	 * but only a random sample of stacks pays the mprotect()
+	 * syscall for it. The rest rely on the canary words checked
+	 * on every yield, which keeps fiber creation cheap under
+	 * heavy churn.
+	 */
+	if (rand() % FIBER_STACK_GUARD_SAMPLE == 0) {
+		if (fiber_mprotect(guard, page_size, PROT_NONE)) {
+			/*
+			 * Write an error into the log since a guard
+			 * page is critical for functionality.
+			 */
+			diag_log();
+			fiber_stack_destroy(fiber, slabc);
+			return -1;
+		}
+		fiber->stack_has_guard = true;
 	}
 
 	fiber_stack_watermark_create(fiber);
+	stack_put_canary(fiber);
 	return 0;
 }
 
@@ -1435,6 +1586,31 @@ box_region_truncate(size_t size)
 	return region_truncate(&fiber()->gc, size);
 }
 
+/**
+ * Threshold for reporting a long event loop iteration, seconds.
+ * Watcher callbacks and all dispatched fibers run within one
+ * iteration; past this budget the loop cannot service timers or
+ * sockets, so the stall deserves a log line even when no single
+ * fiber tripped the per-fiber slice warning.
+ */
+static const double FIBER_LOOP_STALL_THRESHOLD = 0.1;
+
+/**
+ * A wrapper around the invocation of pending watchers: times the
+ * processing phase of every loop iteration to report stalls.
+ */
+static void
+fiber_invoke_pending_cb(ev_loop *loop)
+{
+	double start = clock_monotonic();
+	ev_invoke_pending(loop);
+	double elapsed = clock_monotonic() - start;
+	if (unlikely(elapsed > FIBER_LOOP_STALL_THRESHOLD)) {
+		say_warn_ratelimited("event loop iteration on cord '%s' "
+				     "took %.3f sec", cord()->name, elapsed);
+	}
+}
+
 void
 cord_create(struct cord *cord, const char *name)
 {
@@ -1443,6 +1619,7 @@ cord_create(struct cord *cord, const char *name)
 
 	cord->id = pthread_self();
 	cord->on_exit = NULL;
+	cord->csw_time = clock_monotonic();
 	slab_cache_create(&cord->slabc, &runtime);
 	mempool_create(&cord->fiber_mempool, &cord->slabc,
 		       sizeof(struct fiber));
@@ -1471,6 +1648,10 @@ cord_create(struct cord *cord, const char *name)
 
 	ev_idle_init(&cord->idle_event, fiber_schedule_idle);
 
+	/* Cords of the eio thread pool never run an event loop. */
+	if (cord->loop != NULL)
+		ev_set_invoke_pending_cb(cord->loop, fiber_invoke_pending_cb);
+
 #if ENABLE_FIBER_TOP
 	/* fiber.top() currently works only for the main thread. */
 	if (cord_is_main()) {
@@ -540,8 +540,21 @@ struct fiber {
 	size_t stack_size;
 	/** Valgrind stack id. */
 	unsigned int stack_id;
+	/**
+	 * True if the stack has a real PROT_NONE guard page.
+	 * Only a random sample of stacks gets one, see
+	 * fiber_stack_create(); the rest are covered by canary
+	 * words checked on every yield.
+	 */
+	bool stack_has_guard;
 	/* A garbage-collected memory pool. */
 	struct region gc;
+	/**
+	 * Decaying high-water mark of gc region usage between
+	 * fiber_gc() calls; decides how much cached region memory
+	 * is worth keeping for the next request.
+	 */
+	size_t gc_high_water;
 	/**
 	 * The fiber which should be scheduled when
 	 * this fiber yields.
@@ -701,6 +714,11 @@ struct cord {
 	 */
 	ev_prepare prepare_event;
 #endif /* ENABLE_FIBER_TOP */
+	/**
+	 * Monotonic time of the last context switch, used to spot
+	 * fibers monopolizing the cord.
+	 */
+	double csw_time;
 	/** A memory cache for (struct fiber) */
 	struct mempool fiber_mempool;
 	/** A runtime slab cache for general use in this cord. */
@@ -152,6 +152,25 @@ fiber_pool_set_max_size(struct fiber_pool *pool, int new_max_size)
 	pool->max_size = new_max_size;
 }
 
+void
+fiber_pool_prime(struct fiber_pool *pool, int size)
+{
+	if (size > pool->max_size)
+		size = pool->max_size;
+	while (pool->size < size) {
+		struct fiber *f = fiber_new(cord_name(cord()), fiber_pool_f);
+		if (f == NULL) {
+			diag_log();
+			break;
+		}
+		/*
+		 * With no outstanding messages the worker parks
+		 * itself on the idle list right away.
+		 */
+		fiber_start(f, pool);
+	}
+}
+
 void
 fiber_pool_create(struct fiber_pool *pool, const char *name, int max_pool_size,
 		  float idle_timeout)
@@ -92,6 +92,18 @@ fiber_pool_create(struct fiber_pool *pool, const char *name, int max_pool_size,
 void
 fiber_pool_set_max_size(struct fiber_pool *pool, int new_max_size);
 
+/**
+ * Pre-create up to @a size idle worker fibers, so that the first
+ * tasks after start do not pay for fiber and stack allocation.
+ * Workers which stay unused decay through the ordinary idle
+ * timeout. Priming is best effort: a fiber creation failure is
+ * logged and the pool is left with the workers made so far.
+ * @param pool Fiber pool to prime.
+ * @param size Target number of idle workers, capped by max size.
+ */
+void
+fiber_pool_prime(struct fiber_pool *pool, int size);
+
 /**
  * Destroy a fiber pool
  */
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "flightrec.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <pmatomic.h>
+
+#include "clock.h"
+#include "diag.h"
+#include "fiber.h"
+
+enum {
+	/** Events kept per thread, must be a power of two. */
+	FLIGHTREC_RING_SIZE = 1024,
+	/** Threads the recorder can serve over process lifetime. */
+	FLIGHTREC_RINGS_MAX = 64,
+	/** Thread name bytes kept in a ring header. */
+	FLIGHTREC_NAME_MAX = 32,
+};
+
+/** Printable tags matching enum flightrec_type. */
+static const char *flightrec_type_strs[flightrec_type_MAX] = {
+	"REQUEST",
+	"WAL",
+	"STATE",
+};
+
+/** One recorded event. */
+struct flightrec_event {
+	/** Monotonic time the event was recorded at. */
+	double time;
+	/** Event type, enum flightrec_type. */
+	int32_t type;
+	/** Type-specific values, see enum flightrec_type. */
+	int64_t args[3];
+};
+
+/** Ring of the most recent events of one thread. */
+struct flightrec_ring {
+	/** Name of the owning thread, for the dump. */
+	char name[FLIGHTREC_NAME_MAX];
+	/** Events recorded over the thread lifetime. */
+	uint64_t count;
+	/** The events, slot = sequence % FLIGHTREC_RING_SIZE. */
+	struct flightrec_event events[FLIGHTREC_RING_SIZE];
+};
+
+/** Rings of all threads which recorded anything so far. */
+static struct flightrec_ring *flightrec_rings[FLIGHTREC_RINGS_MAX];
+/** Count of registered rings, also the next free slot. */
+static int flightrec_n_rings;
+/** Ring of the calling thread, NULL before the first event. */
+static __thread struct flightrec_ring *flightrec_ring;
+/** Set when ring creation failed, to not retry on every event. */
+static __thread bool flightrec_is_broken;
+
+/**
+ * Create and register the calling thread's ring. Returns NULL
+ * when out of memory or out of ring slots; the thread is then
+ * marked broken and its events are dropped.
+ */
+static struct flightrec_ring *
+flightrec_ring_new(void)
+{
+	int slot = pm_atomic_fetch_add(&flightrec_n_rings, 1);
+	if (slot >= FLIGHTREC_RINGS_MAX) {
+		flightrec_is_broken = true;
+		return NULL;
+	}
+	struct flightrec_ring *ring = calloc(1, sizeof(*ring));
+	if (ring == NULL) {
+		flightrec_is_broken = true;
+		return NULL;
+	}
+	const char *name = cord() != NULL ? cord()->name : "<thread>";
+	strlcpy(ring->name, name, sizeof(ring->name));
+	flightrec_ring = ring;
+	/*
+	 * Publish the ring last so that a concurrent dump never
+	 * sees an uninitialized pointer in a claimed slot.
+	 */
+	flightrec_rings[slot] = ring;
+	return ring;
+}
+
+void
+flightrec_record(enum flightrec_type type, int64_t a0, int64_t a1, int64_t a2)
+{
+	struct flightrec_ring *ring = flightrec_ring;
+	if (ring == NULL) {
+		if (flightrec_is_broken)
+			return;
+		ring = flightrec_ring_new();
+		if (ring == NULL)
+			return;
+	}
+	struct flightrec_event *event =
+		&ring->events[ring->count++ % FLIGHTREC_RING_SIZE];
+	event->time = clock_monotonic();
+	event->type = type;
+	event->args[0] = a0;
+	event->args[1] = a1;
+	event->args[2] = a2;
+}
+
+int64_t
+flightrec_dump(const char *path)
+{
+	FILE *f = fopen(path, "w");
+	if (f == NULL) {
+		diag_set(SystemError, "failed to open '%s'", path);
+		return -1;
+	}
+	int64_t total = 0;
+	fprintf(f, "# flight recorder dump, monotonic now %.6f\n",
+		clock_monotonic());
+	int n_rings = flightrec_n_rings;
+	if (n_rings > FLIGHTREC_RINGS_MAX)
+		n_rings = FLIGHTREC_RINGS_MAX;
+	for (int i = 0; i < n_rings; i++) {
+		struct flightrec_ring *ring = flightrec_rings[i];
+		if (ring == NULL)
+			continue;
+		uint64_t count = ring->count;
+		uint64_t seq = count > FLIGHTREC_RING_SIZE ?
+			       count - FLIGHTREC_RING_SIZE : 0;
+		for (; seq < count; seq++) {
+			struct flightrec_event *event =
+				&ring->events[seq % FLIGHTREC_RING_SIZE];
+			int32_t type = event->type;
+			const char *type_str =
+				type >= 0 && type < flightrec_type_MAX ?
+				flightrec_type_strs[type] : "?";
+			fprintf(f, "%s %llu %.6f %s %lld %lld %lld\n",
+				ring->name, (unsigned long long)seq,
+				event->time, type_str,
+				(long long)event->args[0],
+				(long long)event->args[1],
+				(long long)event->args[2]);
+			total++;
+		}
+	}
+	if (fclose(f) != 0) {
+		diag_set(SystemError, "failed to write '%s'", path);
+		return -1;
+	}
+	return total;
+}
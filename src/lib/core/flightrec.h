@@ -0,0 +1,90 @@
+#ifndef TARANTOOL_LIB_CORE_FLIGHTREC_H_INCLUDED
+#define TARANTOOL_LIB_CORE_FLIGHTREC_H_INCLUDED
+/*
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Flight recorder: always-on fixed-size per-thread rings of
+ * recent noteworthy events - request summaries, WAL flushes,
+ * replication state transitions. A write is a timestamp, a type
+ * tag and three integers appended to the calling thread's own
+ * ring, so the hot path needs no locks and no atomics. The rings
+ * are dumped to a file either on demand or from the fatal signal
+ * handler, giving the last seconds of server activity when the
+ * logs have nothing to say.
+ */
+
+enum flightrec_type {
+	/** Client request: request type, space id (DML), usec. */
+	FLIGHTREC_REQUEST = 0,
+	/** WAL flush: bytes, duration in usec, vclock signature. */
+	FLIGHTREC_WAL = 1,
+	/** State change: subsystem and two subsystem values. */
+	FLIGHTREC_STATE = 2,
+	flightrec_type_MAX,
+};
+
+/** Subsystem tags for FLIGHTREC_STATE events. */
+enum flightrec_subsystem {
+	FLIGHTREC_SUBSYS_RAFT = 0,
+	FLIGHTREC_SUBSYS_LIMBO = 1,
+};
+
+/**
+ * Append an event to the calling thread's ring. The ring is
+ * created on first use; if that fails, events of this thread are
+ * silently dropped - the recorder must never disturb the work it
+ * observes.
+ */
+void
+flightrec_record(enum flightrec_type type, int64_t a0, int64_t a1, int64_t a2);
+
+/**
+ * Dump the rings of all threads to @a path, oldest event of each
+ * ring first. Rings of other threads are read without
+ * synchronization, so an event being written at this very moment
+ * may come out torn - a fair price for lock-free writes.
+ * Returns the number of dumped events or -1 on error (diag is
+ * set).
+ */
+int64_t
+flightrec_dump(const char *path);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* TARANTOOL_LIB_CORE_FLIGHTREC_H_INCLUDED */
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "hw_counters.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "diag.h"
+
+#ifdef TARGET_OS_LINUX
+
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <linux/perf_event.h>
+
+enum { HW_COUNTERS_N = 6 };
+
+/** Events, in struct hw_counters field order. */
+static const uint64_t hw_counters_events[HW_COUNTERS_N] = {
+	PERF_COUNT_HW_CPU_CYCLES,
+	PERF_COUNT_HW_INSTRUCTIONS,
+	PERF_COUNT_HW_CACHE_REFERENCES,
+	PERF_COUNT_HW_CACHE_MISSES,
+	PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+	PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+/**
+ * Counter descriptors of this thread, the first one leads the
+ * group. Per-thread so that each cord may measure its own work.
+ */
+static __thread int hw_counters_fds[HW_COUNTERS_N] = {
+	-1, -1, -1, -1, -1, -1,
+};
+
+int
+hw_counters_start(void)
+{
+	if (hw_counters_fds[0] >= 0) {
+		diag_set(IllegalParams, "hardware counters are "
+			 "already running");
+		return -1;
+	}
+	for (int i = 0; i < HW_COUNTERS_N; i++) {
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = hw_counters_events[i];
+		/*
+		 * Usable with the default perf_event_paranoid
+		 * setting, at the cost of not counting kernel
+		 * time spent in syscalls.
+		 */
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.disabled = i == 0;
+		int group = i == 0 ? -1 : hw_counters_fds[0];
+		int fd = syscall(SYS_perf_event_open, &attr, 0, -1,
+				 group, 0);
+		if (fd < 0) {
+			diag_set(SystemError, "perf_event_open() failed");
+			hw_counters_stop();
+			return -1;
+		}
+		hw_counters_fds[i] = fd;
+	}
+	ioctl(hw_counters_fds[0], PERF_EVENT_IOC_RESET,
+	      PERF_IOC_FLAG_GROUP);
+	ioctl(hw_counters_fds[0], PERF_EVENT_IOC_ENABLE,
+	      PERF_IOC_FLAG_GROUP);
+	return 0;
+}
+
+int
+hw_counters_read(struct hw_counters *counters)
+{
+	if (hw_counters_fds[0] < 0) {
+		diag_set(IllegalParams, "hardware counters are "
+			 "not running");
+		return -1;
+	}
+	uint64_t *values = (uint64_t *)counters;
+	for (int i = 0; i < HW_COUNTERS_N; i++) {
+		if (read(hw_counters_fds[i], &values[i],
+			 sizeof(values[i])) != sizeof(values[i])) {
+			diag_set(SystemError, "failed to read a "
+				 "hardware counter");
+			return -1;
+		}
+	}
+	return 0;
+}
+
+void
+hw_counters_stop(void)
+{
+	if (hw_counters_fds[0] >= 0)
+		ioctl(hw_counters_fds[0], PERF_EVENT_IOC_DISABLE,
+		      PERF_IOC_FLAG_GROUP);
+	for (int i = 0; i < HW_COUNTERS_N; i++) {
+		if (hw_counters_fds[i] >= 0) {
+			close(hw_counters_fds[i]);
+			hw_counters_fds[i] = -1;
+		}
+	}
+}
+
+#else /* !TARGET_OS_LINUX */
+
+int
+hw_counters_start(void)
+{
+	errno = ENOSYS;
+	diag_set(SystemError, "hardware counters require "
+		 "perf_event_open()");
+	return -1;
+}
+
+int
+hw_counters_read(struct hw_counters *counters)
+{
+	(void)counters;
+	errno = ENOSYS;
+	diag_set(SystemError, "hardware counters require "
+		 "perf_event_open()");
+	return -1;
+}
+
+void
+hw_counters_stop(void)
+{
+}
+
+#endif /* TARGET_OS_LINUX */
@@ -0,0 +1,94 @@
+#ifndef TARANTOOL_LIB_CORE_HW_COUNTERS_H_INCLUDED
+#define TARANTOOL_LIB_CORE_HW_COUNTERS_H_INCLUDED
+/*
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "trivia/config.h"
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Hardware performance counters for the calling thread, a thin
+ * wrapper around perf_event_open(2). Counting events costs
+ * nothing between the start and read calls - the PMU counts in
+ * hardware - so a scope may span an arbitrary stretch of work.
+ * On platforms without perf_event_open, or when the kernel
+ * forbids it (perf_event_paranoid), starting fails with a
+ * regular diag error.
+ */
+
+/** Counter values accumulated since hw_counters_start(). */
+struct hw_counters {
+	/** CPU cycles. */
+	uint64_t cycles;
+	/** Retired instructions. */
+	uint64_t instructions;
+	/** Cache references. */
+	uint64_t cache_refs;
+	/** Cache misses. */
+	uint64_t cache_misses;
+	/** Retired branch instructions. */
+	uint64_t branches;
+	/** Mispredicted branches. */
+	uint64_t branch_misses;
+};
+
+/**
+ * Open and start the counter group on the calling thread.
+ * Returns 0 on success, -1 on error (diag is set). Starting an
+ * already started group is an error.
+ */
+int
+hw_counters_start(void);
+
+/**
+ * Read the values accumulated since hw_counters_start() into
+ * @a counters. The counters keep running. Returns 0 on success,
+ * -1 on error (diag is set).
+ */
+int
+hw_counters_read(struct hw_counters *counters);
+
+/**
+ * Stop the counters and release the descriptors. Safe to call
+ * when the counters are not running.
+ */
+void
+hw_counters_stop(void);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* TARANTOOL_LIB_CORE_HW_COUNTERS_H_INCLUDED */
@@ -35,6 +35,10 @@
 #include <sys/time.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <string.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
 #include "bit/bit.h"
 #include "say.h"
 #include "tt_static.h"
@@ -112,6 +116,53 @@ real_random(void)
 	return result;
 }
 
+enum {
+	/** Size of the per-thread entropy buffer. */
+	RANDOM_BUF_SIZE = 4096,
+};
+
+static __thread char random_buf[RANDOM_BUF_SIZE];
+/** Offset of the first still unconsumed byte in random_buf. */
+static __thread size_t random_buf_pos = RANDOM_BUF_SIZE;
+
+/** Refill the whole per-thread entropy buffer in bulk. */
+static void
+random_buf_refill(void)
+{
+	size_t generated = 0;
+#if defined(__linux__) && defined(SYS_getrandom)
+	/*
+	 * Call getrandom(2) directly so as not to depend on the
+	 * glibc wrapper, which appeared much later than the
+	 * system call itself.
+	 */
+	while (generated < RANDOM_BUF_SIZE) {
+		ssize_t n = syscall(SYS_getrandom, random_buf + generated,
+				    RANDOM_BUF_SIZE - generated, 0);
+		if (n <= 0)
+			break;
+		generated += n;
+	}
+#endif
+	if (generated < RANDOM_BUF_SIZE)
+		random_bytes(random_buf + generated,
+			     RANDOM_BUF_SIZE - generated);
+	random_buf_pos = 0;
+}
+
+void
+random_bytes_buffered(char *buf, size_t size)
+{
+	if (size > RANDOM_BUF_SIZE) {
+		random_bytes(buf, size);
+		return;
+	}
+	if (RANDOM_BUF_SIZE - random_buf_pos < size)
+		random_buf_refill();
+	memcpy(buf, random_buf + random_buf_pos, size);
+	random_buf_pos += size;
+}
+
 /**
  * Helper function for the xoshiro256++ pseudo random generator:
  * rotate left.
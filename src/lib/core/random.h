@@ -46,6 +46,16 @@ random_free(void);
 void
 random_bytes(char *buf, size_t size);
 
+/**
+ * Same entropy quality as random_bytes(), but served from a
+ * per-thread buffer refilled in bulk - getrandom(2) where the
+ * system call exists, the random_bytes() source otherwise. Meant
+ * for hot paths drawing many small amounts, e.g. UUID generation;
+ * sizes above the buffer capacity fall through to random_bytes().
+ */
+void
+random_bytes_buffered(char *buf, size_t size);
+
 /**
  * Just 8 random_bytes().
  */
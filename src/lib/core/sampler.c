@@ -0,0 +1,289 @@
+/*
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "sampler.h"
+
+#ifdef ENABLE_BACKTRACE
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <pmatomic.h>
+
+#ifdef TARGET_OS_DARWIN
+#include <dlfcn.h>
+#include <execinfo.h>
+#else
+#include <libunwind.h>
+#endif
+
+#include "assoc.h"
+#include "diag.h"
+#include "fiber.h"
+#include "trivia/util.h"
+
+enum {
+	/**
+	 * Frames captured per sample. Deep Lua/SQL call chains get
+	 * truncated at the leaf end, which is fine for a profile.
+	 */
+	SAMPLER_FRAMES_MAX = 32,
+	/**
+	 * The sample ring wraps, so at 99 Hz it holds more than a
+	 * minute of the most recent profile, ~3 MB worth of slots.
+	 */
+	SAMPLER_RING_SIZE = 8192,
+	/** Maximal resolved procedure name length. */
+	SAMPLER_NAME_MAX = 200,
+};
+
+struct sampler_sample {
+	/** Raw frame addresses, leaf first. */
+	void *frames[SAMPLER_FRAMES_MAX];
+	/** Number of valid entries in @a frames. */
+	int n_frames;
+	/** Name of the fiber that owned the CPU, truncated. */
+	char fiber_name[FIBER_NAME_INLINE];
+};
+
+static struct {
+	/**
+	 * Checked by the signal handler: a disarmed timer may
+	 * still have one signal in flight.
+	 */
+	volatile sig_atomic_t is_enabled;
+	/**
+	 * Total samples taken. Incremented atomically, because
+	 * SIGPROF is delivered to whatever thread is running.
+	 * Also serves as the ring write position.
+	 */
+	uint64_t n_samples;
+	/** Preallocated sample ring, NULL until first start. */
+	struct sampler_sample *ring;
+} sampler;
+
+/**
+ * SIGPROF handler. Everything here must be async-signal-safe:
+ * the stack walk is done by libunwind over the current context,
+ * the slot index is claimed with an atomic increment, and the
+ * fiber name is a plain memory copy. Two threads may claim the
+ * same slot only after the counter wraps around the ring, in
+ * which case one torn sample is an acceptable loss.
+ */
+static void
+sampler_signal_cb(int signo)
+{
+	(void)signo;
+	if (!sampler.is_enabled)
+		return;
+	uint64_t n = pm_atomic_fetch_add(&sampler.n_samples, 1);
+	struct sampler_sample *s = &sampler.ring[n % SAMPLER_RING_SIZE];
+#ifdef TARGET_OS_DARWIN
+	s->n_frames = backtrace(s->frames, SAMPLER_FRAMES_MAX);
+#else
+	s->n_frames = unw_backtrace(s->frames, SAMPLER_FRAMES_MAX);
+#endif
+	const char *name = "<thread>";
+	if (cord() != NULL && fiber() != NULL)
+		name = fiber()->name;
+	strlcpy(s->fiber_name, name, sizeof(s->fiber_name));
+}
+
+int
+sampler_start(int freq_hz)
+{
+	if (freq_hz < 1 || freq_hz > 1000) {
+		diag_set(IllegalParams, "sampler frequency must be "
+			 "in range [1, 1000] Hz");
+		return -1;
+	}
+	if (sampler.is_enabled) {
+		diag_set(IllegalParams, "sampler is already running");
+		return -1;
+	}
+	if (sampler.ring == NULL) {
+		sampler.ring = calloc(SAMPLER_RING_SIZE,
+				      sizeof(*sampler.ring));
+		if (sampler.ring == NULL) {
+			diag_set(OutOfMemory, SAMPLER_RING_SIZE *
+				 sizeof(*sampler.ring), "calloc",
+				 "sampler ring");
+			return -1;
+		}
+	}
+	sampler.n_samples = 0;
+	/*
+	 * The first stack walk initializes libunwind caches and
+	 * may allocate, which is not allowed in a signal handler,
+	 * so take one warm-up walk before arming the timer.
+	 */
+	void *warmup[SAMPLER_FRAMES_MAX];
+#ifdef TARGET_OS_DARWIN
+	backtrace(warmup, SAMPLER_FRAMES_MAX);
+#else
+	unw_backtrace(warmup, SAMPLER_FRAMES_MAX);
+#endif
+	struct sigaction sa;
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = sampler_signal_cb;
+	sa.sa_flags = SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+	if (sigaction(SIGPROF, &sa, NULL) != 0) {
+		diag_set(SystemError, "sigaction(SIGPROF) failed");
+		return -1;
+	}
+	sampler.is_enabled = 1;
+	struct itimerval timer;
+	int interval_usec = 1000000 / freq_hz;
+	timer.it_interval.tv_sec = interval_usec / 1000000;
+	timer.it_interval.tv_usec = interval_usec % 1000000;
+	timer.it_value = timer.it_interval;
+	if (setitimer(ITIMER_PROF, &timer, NULL) != 0) {
+		sampler.is_enabled = 0;
+		signal(SIGPROF, SIG_IGN);
+		diag_set(SystemError, "setitimer(ITIMER_PROF) failed");
+		return -1;
+	}
+	return 0;
+}
+
+void
+sampler_stop(void)
+{
+	if (!sampler.is_enabled)
+		return;
+	struct itimerval timer;
+	memset(&timer, 0, sizeof(timer));
+	setitimer(ITIMER_PROF, &timer, NULL);
+	sampler.is_enabled = 0;
+	/* Swallow a signal that may be already queued. */
+	signal(SIGPROF, SIG_IGN);
+}
+
+uint64_t
+sampler_total(void)
+{
+	return sampler.n_samples;
+}
+
+/**
+ * Resolve a frame address to a function name, consulting a
+ * per-dump cache: a typical profile has thousands of samples but
+ * only dozens of distinct frames, and symbol table lookups are
+ * the expensive part of the dump.
+ */
+static const char *
+sampler_proc_name(struct mh_i64ptr_t *cache, void *ip)
+{
+	mh_int_t k;
+	if (cache != NULL) {
+		k = mh_i64ptr_find(cache, (int64_t)(intptr_t)ip, NULL);
+		if (k != mh_end(cache))
+			return mh_i64ptr_node(cache, k)->val;
+	}
+	static char name[SAMPLER_NAME_MAX];
+#ifdef TARGET_OS_DARWIN
+	Dl_info dli;
+	if (dladdr(ip, &dli) == 0 || dli.dli_sname == NULL)
+		snprintf(name, sizeof(name), "%p", ip);
+	else
+		snprintf(name, sizeof(name), "%s", dli.dli_sname);
+#else
+	unw_word_t offset;
+	if (unw_get_proc_name_by_ip(unw_local_addr_space, (unw_word_t)ip,
+				    name, sizeof(name), &offset, NULL) < 0)
+		snprintf(name, sizeof(name), "%p", ip);
+#endif
+	if (cache == NULL)
+		return name;
+	char *copy = strdup(name);
+	if (copy == NULL)
+		return name;
+	struct mh_i64ptr_node_t node;
+	node.key = (int64_t)(intptr_t)ip;
+	node.val = copy;
+	k = mh_i64ptr_put(cache, &node, NULL, NULL);
+	if (k == mh_end(cache)) {
+		free(copy);
+		return name;
+	}
+	return copy;
+}
+
+int64_t
+sampler_dump(const char *path)
+{
+	if (sampler.ring == NULL || sampler.n_samples == 0) {
+		diag_set(IllegalParams, "sampler has no samples to dump");
+		return -1;
+	}
+	FILE *f = fopen(path, "w");
+	if (f == NULL) {
+		diag_set(SystemError, "failed to open '%s'", path);
+		return -1;
+	}
+	struct mh_i64ptr_t *cache = mh_i64ptr_new();
+	uint64_t count = sampler.n_samples;
+	if (count > SAMPLER_RING_SIZE)
+		count = SAMPLER_RING_SIZE;
+	for (uint64_t i = 0; i < count; i++) {
+		struct sampler_sample *s = &sampler.ring[i];
+		fputs(s->fiber_name, f);
+		/*
+		 * Frames 0 and 1 are the signal handler itself
+		 * and the kernel signal trampoline - skip them.
+		 * Emit root-first, as flamegraph tools expect,
+		 * one line per sample; the tools aggregate
+		 * identical lines themselves.
+		 */
+		for (int frame = s->n_frames - 1; frame >= 2; frame--) {
+			fputc(';', f);
+			fputs(sampler_proc_name(cache, s->frames[frame]), f);
+		}
+		fputs(" 1\n", f);
+	}
+	if (cache != NULL) {
+		mh_int_t k;
+		mh_foreach(cache, k)
+			free(mh_i64ptr_node(cache, k)->val);
+		mh_i64ptr_delete(cache);
+	}
+	if (fclose(f) != 0) {
+		diag_set(SystemError, "failed to write '%s'", path);
+		return -1;
+	}
+	return count;
+}
+
+#endif /* ENABLE_BACKTRACE */
@@ -0,0 +1,96 @@
+#ifndef TARANTOOL_LIB_CORE_SAMPLER_H_INCLUDED
+#define TARANTOOL_LIB_CORE_SAMPLER_H_INCLUDED
+/*
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "trivia/config.h"
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+#ifdef ENABLE_BACKTRACE
+
+/**
+ * Statistical CPU profiler. A SIGPROF timer periodically
+ * interrupts whatever thread is currently consuming CPU and the
+ * signal handler stores the raw stack frame addresses of the
+ * interrupted fiber into a preallocated ring along with the fiber
+ * name. No symbol lookup, allocation or locking happens in the
+ * handler, so the per-sample cost is a stack walk plus a memcpy
+ * and the profiler is safe to keep enabled on a loaded instance.
+ * Frames are resolved to function names only when a dump is
+ * requested.
+ */
+
+/**
+ * Start sampling at the given frequency, in Hz, in range
+ * [1, 1000]. Samples collected by a previous run are discarded.
+ * Returns 0 on success, -1 on error (diag is set). Restarting an
+ * already started sampler is an error.
+ */
+int
+sampler_start(int freq_hz);
+
+/**
+ * Stop sampling. Collected samples are retained until the next
+ * sampler_start() call so that they can still be dumped.
+ * Safe to call when the sampler is not running.
+ */
+void
+sampler_stop(void);
+
+/**
+ * Write collected samples to @a path in the collapsed stack
+ * format consumed by flamegraph tooling: one line per sample,
+ * semicolon-separated frames prefixed with the fiber name,
+ * followed by a space and a count. Returns the number of dumped
+ * samples on success, -1 on error (diag is set).
+ */
+int64_t
+sampler_dump(const char *path);
+
+/**
+ * Return the number of samples taken since the last
+ * sampler_start(). Only the most recent ones are retained if the
+ * sample ring has wrapped.
+ */
+uint64_t
+sampler_total(void);
+
+#endif /* ENABLE_BACKTRACE */
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* TARANTOOL_LIB_CORE_SAMPLER_H_INCLUDED */
@@ -55,7 +55,7 @@ trigger_fiber_f(va_list ap)
 }
 
 int
-trigger_run(struct rlist *list, void *event)
+trigger_run_slow(struct rlist *list, void *event)
 {
 	struct trigger *trigger, *tmp;
 	rlist_foreach_entry_safe(trigger, list, link, tmp)
@@ -65,7 +65,7 @@ trigger_run(struct rlist *list, void *event)
 }
 
 int
-trigger_run_reverse(struct rlist *list, void *event)
+trigger_run_reverse_slow(struct rlist *list, void *event)
 {
 	struct trigger *trigger, *tmp;
 	rlist_foreach_entry_safe_reverse(trigger, list, link, tmp)
@@ -127,10 +127,19 @@ trigger_fiber_run(struct rlist *list, void *event, double timeout)
 	}
 
 	/*
-	 * Waiting for all triggers completion.
+	 * Waiting for all triggers completion. The timeout is a
+	 * budget for the whole run, not for each trigger: the
+	 * fibers execute concurrently, so give every join only
+	 * what is left of the shared deadline. Otherwise a handful
+	 * of slow triggers joined one by one could stretch the wait
+	 * to the timeout times their number.
 	 */
+	ev_tstamp deadline = ev_monotonic_now(loop()) + timeout;
 	for (unsigned int i = 0; i < current_fiber && ! expired; i++) {
-		if (fiber_join_timeout(fibers[i], timeout) != 0) {
+		ev_tstamp time_left = deadline - ev_monotonic_now(loop());
+		if (time_left < 0)
+			time_left = 0;
+		if (fiber_join_timeout(fibers[i], time_left) != 0) {
 			assert(! diag_is_empty(diag_get()));
 			diag_log();
 			diag_clear(diag_get());
@@ -113,23 +113,45 @@ trigger_destroy(struct rlist *list)
 	}
 }
 
+/** Helper of trigger_run(). */
+int
+trigger_run_slow(struct rlist *list, void *event);
+
 /**
  * Run registered triggers. Stop and return an error if
  * a trigger fails.
  *
  * Note, since triggers are added to the list head, this
- * function first runs triggers that were added last
+ * function first runs triggers that were added last.
+ *
+ * An empty list costs a single branch: trigger lists are
+ * consulted on per-statement paths and most of them are empty
+ * most of the time.
  */
+static inline int
+trigger_run(struct rlist *list, void *event)
+{
+	if (rlist_empty(list))
+		return 0;
+	return trigger_run_slow(list, event);
+}
+
+/** Helper of trigger_run_reverse(). */
 int
-trigger_run(struct rlist *list, void *event);
+trigger_run_reverse_slow(struct rlist *list, void *event);
 
 /**
  * Same as trigger_run(), but runs triggers in the reverse
  * order, i.e. it runs triggers in the same order they were
  * added.
  */
-int
-trigger_run_reverse(struct rlist *list, void *event);
+static inline int
+trigger_run_reverse(struct rlist *list, void *event)
+{
+	if (rlist_empty(list))
+		return 0;
+	return trigger_run_reverse_slow(list, event);
+}
 
 /**
  * Runs registered triggers in fibers.
@@ -38,6 +38,9 @@
 #include <assert.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 static void
 csv_emit_row_empty(void *ctx)
@@ -111,12 +114,73 @@ csv_setopt(struct csv *csv, int opt, ...)
 	case CSV_OPT_EMIT_CTX:
 		csv->emit_ctx = va_arg(args, void*);
 		break;
+	case CSV_OPT_ZERO_COPY:
+		csv->zero_copy = va_arg(args, int);
+		break;
 	default:
 		unreachable();
 	}
 	va_end(args);
 }
 
+/**
+ * Return a pointer to the first byte in [p, end) equal to one of
+ * the four given bytes, or end if there is none. The stop bytes
+ * may repeat, which lets a caller scan for fewer than four.
+ */
+static inline const char *
+csv_scan_special(const char *p, const char *end, char c0, char c1,
+		 char c2, char c3)
+{
+#if defined(__SSE2__)
+	const __m128i v0 = _mm_set1_epi8(c0);
+	const __m128i v1 = _mm_set1_epi8(c1);
+	const __m128i v2 = _mm_set1_epi8(c2);
+	const __m128i v3 = _mm_set1_epi8(c3);
+	while (end - p >= 16) {
+		__m128i x = _mm_loadu_si128((const __m128i *)p);
+		__m128i m = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(x, v0),
+				     _mm_cmpeq_epi8(x, v1)),
+			_mm_or_si128(_mm_cmpeq_epi8(x, v2),
+				     _mm_cmpeq_epi8(x, v3)));
+		int mask = _mm_movemask_epi8(m);
+		if (mask != 0)
+			return p + __builtin_ctz(mask);
+		p += 16;
+	}
+#endif
+	while (p != end && *p != c0 && *p != c1 && *p != c2 && *p != c3)
+		p++;
+	return p;
+}
+
+/**
+ * Make sure the internal buffer can take extra more bytes,
+ * growing it with the same doubling policy the per-character
+ * path uses.
+ * @retval 0 Success.
+ * @retval -1 Allocation failure.
+ */
+static int
+csv_buf_reserve(struct csv *csv, size_t extra)
+{
+	size_t used = csv->bufp != NULL ? (size_t)(csv->bufp - csv->buf) : 0;
+	if (csv->buf != NULL && csv->buf_len >= used + extra)
+		return 0;
+	size_t new_size = csv->buf_len == 0 ? 256 : csv->buf_len;
+	while (new_size < used + extra)
+		new_size *= 2;
+	char *new_buf = (char *)csv->realloc(csv->buf, new_size);
+	if (new_buf == NULL)
+		return -1;
+	csv->buf_len = new_size;
+	if (csv->bufp != NULL)
+		csv->bufp = new_buf + used;
+	csv->buf = new_buf;
+	return 0;
+}
+
 /**
   * both of methods (emitting and iterating) are implementing by one function
   * firstonly == true means iteration method.
@@ -130,6 +194,14 @@ csv_parse_impl(struct csv *csv, const char *s, const char *end, bool firstonly)
 	assert(end - s > 0);
 	assert(csv->emit_field);
 	assert(csv->emit_row);
+	bool zero_copy = csv->zero_copy != 0 && !firstonly;
+	/*
+	 * In zero-copy mode: start of the current field in the input
+	 * chunk, while the field is still a plain byte run that can
+	 * be emitted straight from there. NULL once the field needed
+	 * unescaping or began in a previous chunk.
+	 */
+	const char *field_src = NULL;
 	for (const char *p = s; p != end; p++) {
 		bool is_line_end = (*p == '\n' || *p == '\r');
 		/* realloc buffer */
@@ -147,6 +219,51 @@ csv_parse_impl(struct csv *csv, const char *s, const char *end, bool firstonly)
 			csv->bufp = csv->bufp - csv->buf + new_buf;
 			csv->buf = new_buf;
 		}
+		/*
+		 * Fast-forward over runs of ordinary bytes: nothing
+		 * between two special characters can change the
+		 * state, so a run is copied (or, for a zero-copy
+		 * field, merely skipped) wholesale instead of being
+		 * pushed through the state machine byte by byte.
+		 */
+		if (csv->state == CSV_OUT_OF_QUOTES ||
+		    csv->state == CSV_IN_QUOTES) {
+			const char *q;
+			if (csv->state == CSV_OUT_OF_QUOTES) {
+				q = csv_scan_special(p, end, csv->delimiter,
+						     csv->quote_char,
+						     '\n', '\r');
+			} else {
+				q = csv_scan_special(p, end, csv->quote_char,
+						     csv->quote_char,
+						     csv->quote_char,
+						     csv->quote_char);
+			}
+			size_t run = q - p;
+			if (run > 1) {
+				if (field_src == NULL) {
+					if (csv_buf_reserve(csv, run) != 0) {
+						csv->error_status =
+							CSV_ER_MEMORY_ERROR;
+						return NULL;
+					}
+					memcpy(csv->bufp, p, run);
+					csv->bufp += run;
+				}
+				if (csv->state == CSV_OUT_OF_QUOTES) {
+					size_t spaces = 0;
+					while (spaces < run &&
+					       p[run - 1 - spaces] == ' ')
+						spaces++;
+					csv->ending_spaces = spaces == run ?
+						csv->ending_spaces +
+						(int)spaces : (int)spaces;
+				}
+				csv->prev_symbol = q[-1];
+				p = q - 1;
+				continue;
+			}
+		}
 		/* \r\n (or \n\r) linebreak, not in quotes */
 		if (is_line_end && csv->state != CSV_IN_QUOTES &&
 		   *p != csv->prev_symbol &&
@@ -161,6 +278,8 @@ csv_parse_impl(struct csv *csv, const char *s, const char *end, bool firstonly)
 			csv->bufp = csv->buf;
 			if (*p == ' ') /* skip spaces */
 				continue;
+			if (zero_copy)
+				field_src = p;
 			csv->state = CSV_OUT_OF_QUOTES;
 			/* symbol not handled, continue to the next switch */
 			break;
@@ -191,12 +310,22 @@ csv_parse_impl(struct csv *csv, const char *s, const char *end, bool firstonly)
 			if (is_line_end || *p == csv->delimiter) {
 				/* end of field */
 				csv->state = CSV_LEADING_SPACES;
-				csv->bufp -= csv->ending_spaces;
-				csv->ending_spaces = 0;
 				if (firstonly) {
+					csv->bufp -= csv->ending_spaces;
+					csv->ending_spaces = 0;
 					csv->state = CSV_NEWFIELD;
 					return p;
+				} else if (field_src != NULL) {
+					/* the field is still a plain
+					 * run inside this chunk */
+					csv->emit_field(csv->emit_ctx,
+							field_src,
+							p - csv->ending_spaces);
+					csv->ending_spaces = 0;
+					field_src = NULL;
 				} else {
+					csv->bufp -= csv->ending_spaces;
+					csv->ending_spaces = 0;
 					csv->emit_field(csv->emit_ctx,
 							csv->buf, csv->bufp);
 				}
@@ -204,8 +333,24 @@ csv_parse_impl(struct csv *csv, const char *s, const char *end, bool firstonly)
 				csv->bufp = csv->buf;
 
 			} else if (*p == csv->quote_char) {
+				if (field_src != NULL) {
+					/*
+					 * The field needs unescaping -
+					 * catch up the copy skipped so
+					 * far and take the usual path.
+					 */
+					size_t len = p - field_src;
+					if (csv_buf_reserve(csv, len) != 0) {
+						csv->error_status =
+							CSV_ER_MEMORY_ERROR;
+						return NULL;
+					}
+					memcpy(csv->bufp, field_src, len);
+					csv->bufp += len;
+					field_src = NULL;
+				}
 				csv->state = CSV_QUOTE_OPENING;
-			} else {
+			} else if (field_src == NULL) {
 				*csv->bufp++ = *p;
 			}
 
@@ -267,6 +412,20 @@ csv_parse_impl(struct csv *csv, const char *s, const char *end, bool firstonly)
 			break;
 		}
 	}
+	if (field_src != NULL && csv->bufp != NULL) {
+		/*
+		 * A zero-copy field spans the chunk boundary - the
+		 * input pointers die with this call, so stash the
+		 * bytes seen so far in the internal buffer.
+		 */
+		size_t len = end - field_src;
+		if (csv_buf_reserve(csv, len) != 0) {
+			csv->error_status = CSV_ER_MEMORY_ERROR;
+			return NULL;
+		}
+		memcpy(csv->bufp, field_src, len);
+		csv->bufp += len;
+	}
 	return end;
 }
 
@@ -50,6 +50,8 @@ struct csv
 	char prev_symbol;
 	int error_status;
 	int ending_spaces;
+	/** See CSV_OPT_ZERO_COPY. */
+	int zero_copy;
 
 	void *(*realloc)(void*, size_t);
 
@@ -65,7 +67,17 @@ enum csv_parser_option {
 	CSV_OPT_REALLOC,
 	CSV_OPT_EMIT_FIELD,
 	CSV_OPT_EMIT_ROW,
-	CSV_OPT_EMIT_CTX
+	CSV_OPT_EMIT_CTX,
+	/**
+	 * When set to a non-zero int, emit_field may be called with
+	 * pointers into the chunk given to csv_parse_chunk() instead
+	 * of the internal buffer, skipping the per-field copy. Such
+	 * pointers are only valid for the duration of the callback.
+	 * Fields containing quotes and fields spanning a chunk
+	 * boundary are still delivered from the internal buffer.
+	 * Ignored by the iterator interface.
+	 */
+	CSV_OPT_ZERO_COPY
 };
 
 enum csv_iteraion_state {
@@ -32,6 +32,7 @@
 #include "raft_ev.h"
 #include "exception.h"
 #include "fiber.h"
+#include "flightrec.h"
 #include "tt_static.h"
 
 /**
@@ -702,6 +703,20 @@ raft_sm_schedule_new_election_cb(struct ev_loop *loop, struct ev_timer *timer,
 	struct raft *raft = timer->data;
 	assert(timer == &raft->timer);
 	raft_ev_timer_stop(loop, timer);
+	if (!raft->is_quorum_reachable) {
+		/*
+		 * A pre-vote of sorts: don't bump the term while an
+		 * election quorum is out of reach. The election would
+		 * be lost anyway, but the new term would force the
+		 * connected part of the cluster to re-elect its
+		 * perfectly fine leader when this node gets back.
+		 */
+		say_info("RAFT: quorum is not reachable, postpone election");
+		raft_ev_timer_set(timer, raft->death_timeout,
+				  raft->death_timeout);
+		raft_ev_timer_start(loop, timer);
+		return;
+	}
 	raft_sm_schedule_new_election(raft);
 }
 
@@ -964,6 +979,17 @@ raft_cfg_death_timeout(struct raft *raft, double death_timeout)
 	}
 }
 
+void
+raft_cfg_is_quorum_reachable(struct raft *raft, bool is_reachable)
+{
+	/*
+	 * Nothing to kick when the flag raises: a postponed election
+	 * re-arms the timer instead of stopping it, so the state
+	 * machine stays live and re-checks the flag on expiration.
+	 */
+	raft->is_quorum_reachable = is_reachable;
+}
+
 void
 raft_cfg_instance_id(struct raft *raft, uint32_t instance_id)
 {
@@ -1000,6 +1026,13 @@ raft_schedule_broadcast(struct raft *raft)
 	trigger_run(&raft->on_update, raft);
 	assert(csw == fiber()->csw);
 	(void)csw;
+	/*
+	 * Every externally visible change passes through here, so
+	 * this one hook leaves a trace of the whole election
+	 * history in the flight recorder.
+	 */
+	flightrec_record(FLIGHTREC_STATE, FLIGHTREC_SUBSYS_RAFT,
+			 raft->state, raft->term);
 
 	raft->is_broadcast_scheduled = true;
 	raft_schedule_async(raft);
@@ -1015,6 +1048,7 @@ raft_create(struct raft *raft, const struct raft_vtab *vtab)
 		.election_quorum = 1,
 		.election_timeout = 5,
 		.death_timeout = 5,
+		.is_quorum_reachable = true,
 		.vtab = vtab,
 	};
 	raft_ev_timer_init(&raft->timer, raft_sm_schedule_new_election_cb,
@@ -216,6 +216,15 @@ struct raft {
 	 * elections can be started.
 	 */
 	double death_timeout;
+	/**
+	 * Whether the node can reach an election quorum of its peers. Raft
+	 * itself knows nothing about the transport, so the flag is fed by the
+	 * owner of the Raft instance. While it is false, leader death does not
+	 * trigger a new election: a vote this node can't win would only
+	 * inflate the term and force the connected majority into a needless
+	 * election round once connectivity returns.
+	 */
+	bool is_quorum_reachable;
 	/** Virtual table to perform application-specific actions. */
 	const struct raft_vtab *vtab;
 	/**
@@ -313,6 +322,14 @@ raft_cfg_election_quorum(struct raft *raft, int election_quorum);
 void
 raft_cfg_death_timeout(struct raft *raft, double death_timeout);
 
+/**
+ * Configure whether the node currently can reach an election quorum of its
+ * peers. Elections are not started while it can't, see the comment to the
+ * struct raft member.
+ */
+void
+raft_cfg_is_quorum_reachable(struct raft *raft, bool is_reachable);
+
 /**
  * Configure ID of the given Raft instance. The ID can't be changed after it is
  * assigned first time.
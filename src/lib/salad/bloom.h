@@ -182,6 +182,19 @@ bloom_add(struct bloom *bloom, bloom_hash_t hash)
 	}
 }
 
+/**
+ * Prefetch the cache-line-sized block the hash maps to. All
+ * probes for one value land in that single block, so issuing the
+ * prefetch ahead of bloom_maybe_has() hides the one cache miss a
+ * query costs - useful when several filters are probed in a row.
+ */
+static inline void
+bloom_prefetch(const struct bloom *bloom, bloom_hash_t hash)
+{
+	bloom_hash_t pos = hash % bloom->table_size;
+	__builtin_prefetch(bloom->table + pos, 0);
+}
+
 static inline bool
 bloom_maybe_has(const struct bloom *bloom, bloom_hash_t hash)
 {
@@ -2260,6 +2260,17 @@ bps_tree_collect_path(struct bps_tree *tree, bps_tree_elem_t new_elem,
 {
 	*exact = false;
 
+	/*
+	 * Append fast path: an element greater than the maximal
+	 * one descends along the rightmost spine, so all binary
+	 * searches on the way down can be skipped. Monotonically
+	 * growing keys (autoincrement, time series) take this
+	 * branch on every insert at the cost of one comparison
+	 * for everybody else.
+	 */
+	bool append = BPS_TREE_COMPARE(tree->max_elem, new_elem,
+				       tree->arg) < 0;
+
 	struct bps_inner_path_elem *prev_ext = 0;
 	bps_tree_pos_t prev_pos = 0;
 	struct bps_block *block = bps_tree_root(tree);
@@ -2270,7 +2281,7 @@ bps_tree_collect_path(struct bps_tree *tree, bps_tree_elem_t new_elem,
 	for (bps_tree_block_id_t i = 0; i < tree->depth - 1; i++) {
 		struct bps_inner *inner = (struct bps_inner *)block;
 		bps_tree_pos_t pos;
-		if (*exact)
+		if (append || *exact)
 			pos = inner->header.size - 1;
 		else
 			pos = bps_tree_find_ins_point_elem(tree, inner->elems,
@@ -2299,7 +2310,9 @@ bps_tree_collect_path(struct bps_tree *tree, bps_tree_elem_t new_elem,
 
 	struct bps_leaf *leaf = (struct bps_leaf *)block;
 	bps_tree_pos_t pos;
-	if (*exact)
+	if (append)
+		pos = leaf->header.size;
+	else if (*exact)
 		pos = leaf->header.size - 1;
 	else
 		pos = bps_tree_find_ins_point_elem(tree, leaf->elems,
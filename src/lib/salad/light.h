@@ -152,6 +152,13 @@ struct LIGHT(core) {
 	 */
 	uint32_t empty_slot;
 
+	/*
+	 * Total number of grow increments performed over the table
+	 * lifetime, both inline (from insert) and ahead of demand
+	 * (from grow_steps). Occupancy is count / table_size.
+	 */
+	uint32_t grow_count;
+
 	/* additional parameter for data comparison */
 	LIGHT_CMP_ARG_TYPE arg;
 
@@ -248,6 +255,17 @@ static inline uint32_t
 LIGHT(replace)(struct LIGHT(core) *ht, uint32_t hash,
 	       LIGHT_DATA_TYPE data, LIGHT_DATA_TYPE *replaced);
 
+/**
+ * @brief Grow the table ahead of demand in bounded increments.
+ * @param ht - pointer to a hash table struct
+ * @param target_count - grow until this many records fit
+ * @param max_steps - upper bound of grow increments to perform
+ * @return number of increments actually performed
+ */
+static inline uint32_t
+LIGHT(grow_steps)(struct LIGHT(core) *ht, uint32_t target_count,
+		  uint32_t max_steps);
+
 /**
  * @brief Delete a record from a hash table by given record ID
  * @param ht - pointer to a hash table struct
@@ -356,6 +374,7 @@ LIGHT(create)(struct LIGHT(core) *ht, size_t extent_size,
 	ht->count = 0;
 	ht->table_size = 0;
 	ht->empty_slot = LIGHT(end);
+	ht->grow_count = 0;
 	ht->arg = arg;
 	matras_create(&ht->mtable,
 		      extent_size, sizeof(struct LIGHT(record)),
@@ -650,12 +669,15 @@ LIGHT(prepare_first_insert)(struct LIGHT(core) *ht)
 }
 
 /*
- * Enlarge hash table to store more values
+ * Enlarge hash table to store more values.
+ * Historically only called from insert when the empty list was
+ * exhausted, but splitting is independent of the empty list, so
+ * it is equally correct to call it ahead of demand while empty
+ * slots remain - see grow_steps.
  */
 static inline int
 LIGHT(grow)(struct LIGHT(core) *ht)
 {
-	assert(ht->empty_slot == LIGHT(end));
 	uint32_t new_slot;
 	struct LIGHT(record) *new_record = (struct LIGHT(record) *)
 		matras_alloc_range(&ht->mtable, &new_slot, LIGHT_GROW_INCREMENT);
@@ -746,9 +768,40 @@ LIGHT(grow)(struct LIGHT(core) *ht)
 			matras_touch(&ht->mtable, last_empty_slot);
 		LIGHT(enqueue_empty)(ht, last_empty_slot, last_empty_record);
 	}
+	ht->grow_count++;
 	return 0;
 }
 
+/**
+ * @brief Grow the table ahead of demand in bounded increments.
+ * Splitting a slot with a long chain inline in insert is where
+ * rehash latency spikes come from; this lets a caller move that
+ * work to a maintenance point of its choosing, a bounded number
+ * of increments at a time, so inserts find pre-split slots and
+ * the per-insert cost stays strictly bounded.
+ * @param ht - pointer to a hash table struct
+ * @param target_count - grow until the table can address this
+ *  many records (no-op once table_size reaches it)
+ * @param max_steps - upper bound of grow increments to perform
+ * @return number of increments actually performed; stops early
+ *  on allocation failure
+ */
+static inline uint32_t
+LIGHT(grow_steps)(struct LIGHT(core) *ht, uint32_t target_count,
+		  uint32_t max_steps)
+{
+	uint32_t done = 0;
+	/* The very first insert bootstraps the table itself. */
+	if (ht->table_size == 0)
+		return 0;
+	while (done < max_steps && ht->table_size < target_count) {
+		if (LIGHT(grow)(ht) != 0)
+			break;
+		done++;
+	}
+	return done;
+}
+
 /**
  * @brief Insert a record with given hash and value
  * @param ht - pointer to a hash table struct
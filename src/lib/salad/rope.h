@@ -188,6 +188,17 @@ struct rope {
 	struct rope_node *root;
 	/** Rope context. */
 	rope_ctx_t ctx;
+	/**
+	 * The node returned by the last extract, NULL whenever the
+	 * cache is invalid. Extracts are frequently repeated for
+	 * the same offset - e.g. several update operations touching
+	 * one field - and the cache answers them without a
+	 * root-to-leaf descent. Any mutation invalidates it since
+	 * offsets shift.
+	 */
+	struct rope_node *last_node;
+	/** Rope offset at which last_node starts. */
+	rope_size_t last_offset;
 };
 
 struct rope_iter {
@@ -235,6 +246,8 @@ rope_create(struct rope *rope, rope_ctx_t ctx)
 {
 	rope->root = NULL;
 	rope->ctx = ctx;
+	rope->last_node = NULL;
+	rope->last_offset = 0;
 }
 
 /** Create a new empty rope.
@@ -280,6 +293,7 @@ rope_clear(struct rope *rope)
 	}
 #endif /* ROPE_FREE_F */
 	rope->root = NULL;
+	rope->last_node = NULL;
 }
 
 /** Delete a rope allocated with rope_new() */
@@ -351,6 +365,9 @@ rope_insert(struct rope *rope, rope_size_t offset, rope_data_t data,
 
 	assert(size);
 
+	/* Offsets of the following substrings shift. */
+	rope->last_node = NULL;
+
 	struct rope_node *new_node = rope_node_new(rope, data, size);
 
 	if (new_node == NULL)
@@ -413,13 +430,20 @@ rope_extract_node(struct rope *rope, rope_size_t offset)
 {
 	assert(offset < rope_size(rope));
 
+	if (rope->last_node != NULL && rope->last_offset == offset)
+		return rope->last_node;
+
+	rope_size_t start = offset;
 	struct rope_node **path[ROPE_HEIGHT_MAX];
 	path[0] = &rope->root;
 
 	struct rope_node ***p_end = (struct rope_node ***)
 		avl_route_to_offset((struct avl_node ***) path, &offset, 0);
-	if (offset == 0)
+	if (offset == 0) {
+		rope->last_node = **p_end;
+		rope->last_offset = start;
 		return **p_end;
+	}
 	struct rope_node *new_node = rope_node_split(rope, **p_end, offset);
 	if (new_node == NULL)
 		return NULL;
@@ -430,6 +454,8 @@ rope_extract_node(struct rope *rope, rope_size_t offset)
 	avl_rebalance_after_insert((struct avl_node ***) path,
 				   (struct avl_node ***) p_end,
 				   new_node->height);
+	rope->last_node = new_node;
+	rope->last_offset = start;
 	return new_node;
 }
 
@@ -462,6 +488,9 @@ rope_erase(struct rope *rope, rope_size_t offset)
 {
 	assert(offset < rope_size(rope));
 
+	/* Offsets of the following substrings shift. */
+	rope->last_node = NULL;
+
 	struct rope_node **path[ROPE_HEIGHT_MAX];
 	path[0] = &rope->root;
 
@@ -32,8 +32,10 @@
 #include <string.h>
 #include <assert.h>
 #include <limits.h>
+#include <math.h>
 #include <stddef.h>
 #include <sys/types.h>
+#include <third_party/qsort_arg.h>
 
 /*------------------------------------------------------------------------- */
 /* R-tree internal structures definition */
@@ -716,6 +718,114 @@ rtree_page_purge(struct rtree *tree, struct rtree_page *page, int level)
 	rtree_page_free(tree, page);
 }
 
+/*------------------------------------------------------------------------- */
+/* R-tree bulk loading methods */
+/*------------------------------------------------------------------------- */
+
+/* Compare two loaded elements by rectangle center on given axis */
+static int
+rtree_build_elem_cmp(const void *a, const void *b, void *arg)
+{
+	const struct rtree_build_elem *e1 = (const struct rtree_build_elem *)a;
+	const struct rtree_build_elem *e2 = (const struct rtree_build_elem *)b;
+	unsigned axis = *(unsigned *)arg;
+	/* Twice the center, the factor does not affect the order */
+	coord_t c1 = e1->rect.coords[2 * axis] + e1->rect.coords[2 * axis + 1];
+	coord_t c2 = e2->rect.coords[2 * axis] + e2->rect.coords[2 * axis + 1];
+	return c1 < c2 ? -1 : c1 > c2 ? 1 : 0;
+}
+
+/* Sort-tile-recursive ordering: sort the elements along the
+ * given axis, cut the array into slabs of whole leaves, one per
+ * k-th root of the leaf count where k is the number of axes
+ * left, and order every slab along the remaining axes the same
+ * way. After the recursion any run of page_max_fill consecutive
+ * elements forms a tight leaf page.
+ */
+static void
+rtree_str_sort(struct rtree *tree, struct rtree_build_elem *elems,
+	       unsigned count, unsigned axis)
+{
+	unsigned fill = tree->page_max_fill;
+	if (count <= fill)
+		return;
+	qsort_arg(elems, count, sizeof(*elems), rtree_build_elem_cmp, &axis);
+	if (axis + 1 == tree->dimension)
+		return;
+	unsigned n_leaves = (count + fill - 1) / fill;
+	unsigned n_slabs = (unsigned)ceil(pow(n_leaves,
+					  1.0 / (tree->dimension - axis)));
+	if (n_slabs <= 1)
+		return;
+	unsigned slab = (count + n_slabs - 1) / n_slabs;
+	/* Do not cut a slab in the middle of a leaf */
+	slab = (slab + fill - 1) / fill * fill;
+	for (unsigned i = 0; i < count; i += slab) {
+		unsigned n = count - i < slab ? count - i : slab;
+		rtree_str_sort(tree, elems + i, n, axis + 1);
+	}
+}
+
+unsigned
+rtree_build_pages(const struct rtree *tree, unsigned count)
+{
+	unsigned fill = tree->page_max_fill;
+	unsigned n_pages = 0;
+	if (count == 0)
+		return 0;
+	do {
+		count = (count + fill - 1) / fill;
+		n_pages += count;
+	} while (count > 1);
+	return n_pages;
+}
+
+void
+rtree_build(struct rtree *tree, struct rtree_build_elem *elems, unsigned count)
+{
+	assert(tree->root == NULL);
+	if (count == 0)
+		return;
+	rtree_str_sort(tree, elems, count, 0);
+	tree->n_records = count;
+	tree->version++;
+	/*
+	 * Pack the array into pages level by level. Once a level
+	 * is packed, the head of the array is reused to hold the
+	 * cover rectangle and the pointer of every created page,
+	 * and the next round packs those exactly the same way.
+	 * Pages of one level never hold pointers to elements of
+	 * the array head: by the time elems[p] is overwritten at
+	 * least p + 1 source elements have been consumed.
+	 */
+	unsigned d = tree->dimension;
+	do {
+		unsigned n_pages = (count + tree->page_max_fill - 1) /
+				   tree->page_max_fill;
+		/* Spread elements evenly not to underfill the tail page */
+		unsigned base = count / n_pages;
+		unsigned rem = count % n_pages;
+		unsigned src = 0;
+		for (unsigned p = 0; p < n_pages; p++) {
+			struct rtree_page *page = rtree_page_alloc(tree);
+			tree->n_pages++;
+			page->n = base + (p < rem ? 1 : 0);
+			for (unsigned i = 0; i < page->n; i++, src++) {
+				struct rtree_page_branch *b =
+					rtree_branch_get(tree, page, i);
+				b->data.record = elems[src].record;
+				rtree_rect_copy(&b->rect, &elems[src].rect, d);
+			}
+			rtree_page_cover(tree, page, &elems[p].rect);
+			elems[p].record = (record_t)page;
+		}
+		tree->height++;
+		count = n_pages;
+	} while (count > 1);
+	tree->root = (struct rtree_page *)elems[0].record;
+	assert(tree->height <= RTREE_MAX_HEIGHT);
+}
+
 /*------------------------------------------------------------------------- */
 /* R-tree iterator methods */
 /*------------------------------------------------------------------------- */
@@ -158,6 +158,24 @@ stailq_concat(struct stailq *dest, struct stailq *src)
 	}
 }
 
+/**
+ * Move all elements of list @src to the head of list @dest,
+ * preserving their order. Like stailq_concat(), the whole
+ * segment is transferred with a couple of pointer writes, no
+ * matter how long it is. @src is emptied.
+ */
+static inline void
+stailq_concat_head(struct stailq *dest, struct stailq *src)
+{
+	if (!stailq_empty(src)) {
+		*src->last = dest->first;
+		if (stailq_empty(dest))
+			dest->last = src->last;
+		dest->first = src->first;
+		stailq_create(src);
+	}
+}
+
 /* Reverse a list in-place. */
 static inline void
 stailq_reverse(struct stailq *head)
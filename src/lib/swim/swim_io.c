@@ -591,18 +591,28 @@ swim_begin_recv(struct swim_scheduler *scheduler, struct ev_loop *loop,
 	(void) loop;
 }
 
-/** Receive a packet from the network. */
-static ssize_t
-swim_do_recv(struct swim_scheduler *scheduler, char *buf, int size)
-{
-	struct sockaddr_in src;
-	socklen_t len = sizeof(src);
-	ssize_t rc = swim_transport_recv(&scheduler->transport, buf, size,
-					 (struct sockaddr *) &src, &len);
-	if (rc <= 0)
-		return rc;
-	say_verbose("SWIM %d: received from %s", swim_scheduler_fd(scheduler),
-		    swim_inaddr_str(&src));
+enum {
+	/**
+	 * How many packets at most are drained from the socket on
+	 * one EV_READ event. The batch amortizes the system call
+	 * during gossip bursts, and its size is the per-event CPU
+	 * budget: processing never monopolizes a loop iteration,
+	 * the rest of a burst waits for the next one.
+	 */
+	SWIM_RECV_BATCH_SIZE = 8,
+};
+
+/** Receive a batch of packets from the network. */
+static int
+swim_do_recv_batch(struct swim_scheduler *scheduler,
+		   struct swim_recv_msg *msgs, int count)
+{
+	int rc = swim_transport_recv_batch(&scheduler->transport, msgs, count);
+	for (int i = 0; i < rc; ++i) {
+		say_verbose("SWIM %d: received from %s",
+			    swim_scheduler_fd(scheduler),
+			    swim_inaddr_str(&msgs[i].src));
+	}
 	return rc;
 }
 
@@ -680,16 +690,24 @@ swim_on_encrypted_input(struct ev_loop *loop, struct ev_io *io, int events)
 	 * well and can accidentally rewrite the packet data.
 	 */
 	char buf[UDP_PACKET_SIZE];
+	char raw[SWIM_RECV_BATCH_SIZE][UDP_PACKET_SIZE];
+	struct swim_recv_msg msgs[SWIM_RECV_BATCH_SIZE];
 	swim_begin_recv(scheduler, loop, io, events);
-
-	char *ibuf = static_alloc(UDP_PACKET_SIZE);
-	assert(ibuf != NULL);
-	ssize_t size = swim_do_recv(scheduler, ibuf, UDP_PACKET_SIZE);
-	if (size > 0) {
-		size = swim_decrypt(scheduler->codec, ibuf, size,
-				    buf, UDP_PACKET_SIZE);
+	for (int i = 0; i < SWIM_RECV_BATCH_SIZE; ++i) {
+		msgs[i].buf = raw[i];
+		msgs[i].buf_size = UDP_PACKET_SIZE;
+	}
+	int rc = swim_do_recv_batch(scheduler, msgs, SWIM_RECV_BATCH_SIZE);
+	if (rc < 0) {
+		diag_log();
+		return;
+	}
+	for (int i = 0; i < rc; ++i) {
+		ssize_t size = swim_decrypt(scheduler->codec, msgs[i].buf,
+					    msgs[i].size, buf,
+					    UDP_PACKET_SIZE);
+		swim_complete_recv(scheduler, buf, size);
 	}
-	swim_complete_recv(scheduler, buf, size);
 }
 
 /** On a new EV_READ event receive a packet from the network. */
@@ -697,10 +715,20 @@ static void
 swim_on_plain_input(struct ev_loop *loop, struct ev_io *io, int events)
 {
 	struct swim_scheduler *scheduler = (struct swim_scheduler *) io->data;
-	char buf[UDP_PACKET_SIZE];
+	char buf[SWIM_RECV_BATCH_SIZE][UDP_PACKET_SIZE];
+	struct swim_recv_msg msgs[SWIM_RECV_BATCH_SIZE];
 	swim_begin_recv(scheduler, loop, io, events);
-	ssize_t size = swim_do_recv(scheduler, buf, UDP_PACKET_SIZE);
-	swim_complete_recv(scheduler, buf, size);
+	for (int i = 0; i < SWIM_RECV_BATCH_SIZE; ++i) {
+		msgs[i].buf = buf[i];
+		msgs[i].buf_size = UDP_PACKET_SIZE;
+	}
+	int rc = swim_do_recv_batch(scheduler, msgs, SWIM_RECV_BATCH_SIZE);
+	if (rc < 0) {
+		diag_log();
+		return;
+	}
+	for (int i = 0; i < rc; ++i)
+		swim_complete_recv(scheduler, msgs[i].buf, msgs[i].size);
 }
 
 int
@@ -63,6 +63,29 @@ ssize_t
 swim_transport_recv(struct swim_transport *transport, void *buffer, size_t size,
 		    struct sockaddr *addr, socklen_t *addr_size);
 
+/** One slot of a batched receive. */
+struct swim_recv_msg {
+	/** Buffer to store the packet data in. */
+	char *buf;
+	/** Capacity of @a buf. */
+	size_t buf_size;
+	/** Received packet size, filled by the transport. */
+	ssize_t size;
+	/** Source address, filled by the transport. */
+	struct sockaddr_in src;
+};
+
+/**
+ * Receive up to @a count packets in one call. On Linux the whole
+ * batch costs a single system call. A short result just means the
+ * socket ran out of pending datagrams.
+ * @retval >= 0 Number of packets received.
+ * @retval -1 Error, diag is set.
+ */
+int
+swim_transport_recv_batch(struct swim_transport *transport,
+			  struct swim_recv_msg *msgs, int count);
+
 /**
  * Bind @a transport to a new address. The old socket, if exists,
  * is closed. If @a addr is from INET family and has 0 port, then
@@ -33,6 +33,7 @@
 #include "diag.h"
 #include <ifaddrs.h>
 #include <net/if.h>
+#include <sys/socket.h>
 
 ssize_t
 swim_transport_send(struct swim_transport *transport, const void *data,
@@ -56,6 +57,58 @@ swim_transport_recv(struct swim_transport *transport, void *buffer, size_t size,
 	return ret;
 }
 
+#if defined(__linux__)
+
+int
+swim_transport_recv_batch(struct swim_transport *transport,
+			  struct swim_recv_msg *msgs, int count)
+{
+	struct mmsghdr hdrs[count];
+	struct iovec iovs[count];
+	memset(hdrs, 0, sizeof(hdrs));
+	for (int i = 0; i < count; ++i) {
+		iovs[i].iov_base = msgs[i].buf;
+		iovs[i].iov_len = msgs[i].buf_size;
+		hdrs[i].msg_hdr.msg_iov = &iovs[i];
+		hdrs[i].msg_hdr.msg_iovlen = 1;
+		hdrs[i].msg_hdr.msg_name = &msgs[i].src;
+		hdrs[i].msg_hdr.msg_namelen = sizeof(msgs[i].src);
+	}
+	int rc = recvmmsg(transport->fd, hdrs, count, 0, NULL);
+	if (rc < 0) {
+		if (sio_wouldblock(errno))
+			return 0;
+		diag_set(SocketError, sio_socketname(transport->fd),
+			 "recvmmsg");
+		return -1;
+	}
+	for (int i = 0; i < rc; ++i)
+		msgs[i].size = hdrs[i].msg_len;
+	return rc;
+}
+
+#else /* !defined(__linux__) */
+
+int
+swim_transport_recv_batch(struct swim_transport *transport,
+			  struct swim_recv_msg *msgs, int count)
+{
+	for (int i = 0; i < count; ++i) {
+		socklen_t len = sizeof(msgs[i].src);
+		ssize_t size = swim_transport_recv(
+			transport, msgs[i].buf, msgs[i].buf_size,
+			(struct sockaddr *)&msgs[i].src, &len);
+		if (size < 0)
+			return -1;
+		if (size == 0)
+			return i;
+		msgs[i].size = size;
+	}
+	return count;
+}
+
+#endif /* defined(__linux__) */
+
 int
 swim_transport_bind(struct swim_transport *transport,
 		    const struct sockaddr *addr, socklen_t addr_len)
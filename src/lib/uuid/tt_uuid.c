@@ -56,7 +56,7 @@ tt_uuid_create(struct tt_uuid *uu)
 void
 tt_uuid_create(struct tt_uuid *uu)
 {
-	random_bytes((char *) uu, sizeof(*uu));
+	random_bytes_buffered((char *) uu, sizeof(*uu));
 
 	uu->clock_seq_hi_and_reserved &= 0x3f;
 	uu->clock_seq_hi_and_reserved |= 0x80; /* variant 1 = RFC4122 */
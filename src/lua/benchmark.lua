@@ -0,0 +1,236 @@
+-- benchmark.lua -- internal file
+--
+-- Deterministic load generator. Drives a mixed workload against a
+-- space - either of the local instance or of a remote one via
+-- net.box - from a configurable number of fibers. All randomness
+-- comes from a seeded xorshift64* generator, so two runs with the
+-- same configuration issue exactly the same operation sequence,
+-- which makes before/after comparisons meaningful.
+--
+-- Example:
+--
+--     local results = require('benchmark').run({
+--         space = 'test',
+--         operations = {replace = 20, select = 80},
+--         fibers = 10,
+--         ops = 100000,
+--         seed = 42,
+--     })
+
+local bit = require('bit')
+local clock = require('clock')
+local fiber = require('fiber')
+
+local benchmark = {}
+
+-- Latency histogram: nine sub-steps per decade from 1 us to 10 s,
+-- the same resolution the server uses for its own latency
+-- counters.
+local function hist_new()
+    local bounds = {}
+    local scale = 1e-6
+    while scale < 10 do
+        for step = 1, 9 do
+            table.insert(bounds, step * scale)
+        end
+        scale = scale * 10
+    end
+    table.insert(bounds, 10)
+    local counts = {}
+    for i = 1, #bounds do
+        counts[i] = 0
+    end
+    return {bounds = bounds, counts = counts, total = 0, max = 0}
+end
+
+local function hist_collect(hist, value)
+    local bounds = hist.bounds
+    local lo, hi = 1, #bounds
+    while lo < hi do
+        local mid = math.floor((lo + hi) / 2)
+        if value <= bounds[mid] then
+            hi = mid
+        else
+            lo = mid + 1
+        end
+    end
+    hist.counts[lo] = hist.counts[lo] + 1
+    hist.total = hist.total + 1
+    if value > hist.max then
+        hist.max = value
+    end
+end
+
+local function hist_percentile(hist, pct)
+    local need = math.ceil(hist.total * pct / 100)
+    local seen = 0
+    for i = 1, #hist.bounds do
+        seen = seen + hist.counts[i]
+        if seen >= need then
+            return hist.bounds[i]
+        end
+    end
+    return hist.max
+end
+
+-- xorshift64* over uint64_t cdata: exact, fast and identical on
+-- every platform. Returns the new state and a non-negative Lua
+-- number.
+local function prng_next(state)
+    state = bit.bxor(state, bit.rshift(state, 12))
+    state = bit.bxor(state, bit.lshift(state, 25))
+    state = bit.bxor(state, bit.rshift(state, 27))
+    local r = bit.band(state * 2685821657736338717ULL, 0x7fffffffULL)
+    return state, tonumber(r)
+end
+
+local function check_cfg(cfg)
+    if type(cfg) ~= 'table' or type(cfg.space) ~= 'string' then
+        error("Usage: benchmark.run({space = '...', ...})")
+    end
+    local res = {
+        space = cfg.space,
+        uri = cfg.uri,
+        operations = cfg.operations or {replace = 20, select = 80},
+        keys = cfg.keys or 100000,
+        fibers = cfg.fibers or 10,
+        ops = cfg.ops or 100000,
+        seed = cfg.seed or 42,
+        value_size = cfg.value_size or 64,
+        quiet = cfg.quiet or false,
+    }
+    for op in pairs(res.operations) do
+        if op ~= 'select' and op ~= 'get' and op ~= 'replace' and
+           op ~= 'delete' and op ~= 'update' then
+            error('benchmark: unknown operation: ' .. tostring(op))
+        end
+    end
+    return res
+end
+
+-- Turn operation weights into a cumulative table for O(#ops)
+-- weighted choice. Sort the names so that iteration order - and
+-- with it the generated sequence - does not depend on table hash
+-- order.
+local function make_op_table(operations)
+    local names = {}
+    for name in pairs(operations) do
+        table.insert(names, name)
+    end
+    table.sort(names)
+    local cumulative = {}
+    local total = 0
+    for _, name in ipairs(names) do
+        total = total + operations[name]
+        table.insert(cumulative, {weight = total, op = name})
+    end
+    return cumulative, total
+end
+
+local function bench_fiber(space, cfg, fiber_no, n_ops, hist, counters)
+    local state = bit.bxor(0x9e3779b97f4a7c15ULL + cfg.seed,
+                           bit.lshift(1ULL, fiber_no))
+    local op_table, weight_total = make_op_table(cfg.operations)
+    local padding = string.rep('x', cfg.value_size)
+    local r
+    for _ = 1, n_ops do
+        state, r = prng_next(state)
+        local key = 1 + r % cfg.keys
+        state, r = prng_next(state)
+        local dice = r % weight_total
+        local op
+        for _, entry in ipairs(op_table) do
+            if dice < entry.weight then
+                op = entry.op
+                break
+            end
+        end
+        local start = clock.monotonic()
+        local ok, err
+        if op == 'select' then
+            ok, err = pcall(space.select, space, key)
+        elseif op == 'get' then
+            ok, err = pcall(space.get, space, key)
+        elseif op == 'replace' then
+            ok, err = pcall(space.replace, space, {key, padding})
+        elseif op == 'delete' then
+            ok, err = pcall(space.delete, space, key)
+        elseif op == 'update' then
+            ok, err = pcall(space.update, space, key,
+                            {{'=', 2, padding}})
+        end
+        hist_collect(hist, clock.monotonic() - start)
+        if ok then
+            counters.ops = counters.ops + 1
+        else
+            counters.errors = counters.errors + 1
+            counters.last_error = err
+        end
+    end
+end
+
+--
+-- Run the workload described by @a cfg and return a table with
+-- throughput and latency percentiles. See the file header for
+-- the configuration format.
+--
+benchmark.run = function(cfg)
+    cfg = check_cfg(cfg)
+    local space
+    local conn
+    if cfg.uri ~= nil then
+        conn = require('net.box').connect(cfg.uri)
+        space = conn.space[cfg.space]
+    else
+        space = box.space[cfg.space]
+    end
+    if space == nil then
+        error('benchmark: no such space: ' .. cfg.space)
+    end
+
+    local hist = hist_new()
+    local counters = {ops = 0, errors = 0}
+    local fibers = {}
+    local start = clock.monotonic()
+    for fiber_no = 1, cfg.fibers do
+        local n_ops = math.floor(cfg.ops / cfg.fibers)
+        if fiber_no <= cfg.ops % cfg.fibers then
+            n_ops = n_ops + 1
+        end
+        local f = fiber.new(bench_fiber, space, cfg, fiber_no, n_ops,
+                            hist, counters)
+        f:set_joinable(true)
+        table.insert(fibers, f)
+    end
+    for _, f in ipairs(fibers) do
+        f:join()
+    end
+    local seconds = clock.monotonic() - start
+    if conn ~= nil then
+        conn:close()
+    end
+
+    local results = {
+        ops = counters.ops,
+        errors = counters.errors,
+        last_error = counters.last_error,
+        seconds = seconds,
+        rps = counters.ops / seconds,
+        latency = {
+            p50 = hist_percentile(hist, 50),
+            p90 = hist_percentile(hist, 90),
+            p99 = hist_percentile(hist, 99),
+            max = hist.max,
+        },
+    }
+    if not cfg.quiet then
+        print(string.format(
+            'benchmark: %d ops in %.3f sec (%.0f ops/sec), ' ..
+            '%d errors, latency p50/p90/p99 %.6f/%.6f/%.6f sec',
+            results.ops, results.seconds, results.rps, results.errors,
+            results.latency.p50, results.latency.p90, results.latency.p99))
+    end
+    return results
+end
+
+return benchmark
@@ -85,6 +85,59 @@ local function worker_schedule_task(f, arg)
     worker_fiber:wakeup()
 end
 
+-- GC pacing: move LuaJIT collector work off request fibers. With
+-- the default settings every allocation may pay a GC step, so a
+-- collection can land in the middle of a latency-critical
+-- request. When pacing is on, the allocation-driven step size is
+-- dialed down to almost nothing and a background fiber drives the
+-- collector instead, scaling its step count by how much was
+-- allocated since it last ran - request fibers then almost never
+-- collect inline.
+local GC_PACE_INTERVAL = 0.01
+-- KBs of fresh allocations one paced step is expected to cover.
+local GC_PACE_KB_PER_STEP = 8
+local GC_PACE_MAX_STEPS = 200
+local gc_pace_fiber = nil
+
+local function gc_pace_f()
+    local prev_count = collectgarbage('count')
+    while gc_pace_fiber ~= nil do
+        local count = collectgarbage('count')
+        local steps = math.floor((count - prev_count) /
+                                 GC_PACE_KB_PER_STEP) + 1
+        if steps > GC_PACE_MAX_STEPS then
+            steps = GC_PACE_MAX_STEPS
+        end
+        prev_count = count
+        for _ = 1, steps do
+            if collectgarbage('step') then
+                break
+            end
+        end
+        fiber.sleep(GC_PACE_INTERVAL)
+    end
+end
+
+local function fiber_pace_gc(enable)
+    if enable == nil then
+        enable = true
+    end
+    if enable and gc_pace_fiber == nil then
+        -- Starve the inline stepper; the paced fiber takes over.
+        collectgarbage('setstepmul', 1)
+        gc_pace_fiber = fiber.new(gc_pace_f)
+        gc_pace_fiber:name('lua_gc', {truncate = true})
+    elseif not enable and gc_pace_fiber ~= nil then
+        collectgarbage('setstepmul', 200)
+        local f = gc_pace_fiber
+        gc_pace_fiber = nil
+        f:wakeup()
+    end
+    return gc_pace_fiber ~= nil
+end
+
+fiber.pace_gc = fiber_pace_gc
+
 -- Start from '_' to hide it from auto completion.
 fiber._internal = fiber._internal or {}
 fiber._internal.schedule_task = worker_schedule_task
@@ -119,6 +119,7 @@ extern char strict_lua[],
 	trigger_lua[],
 	string_lua[],
 	swim_lua[],
+	benchmark_lua[],
 	p_lua[], /* LuaJIT 2.1 profiler */
 	zone_lua[], /* LuaJIT 2.1 profiler */
 	/* tools.* libraries. */
@@ -150,19 +151,29 @@ static const char *lua_modules[] = {
 	"uri", uri_lua,
 	"fio", fio_lua,
 	"error", error_lua,
-	"csv", csv_lua,
 	"clock", clock_lua,
 	"socket", socket_lua,
 	"title", title_lua,
-	"tap", tap_lua,
-	"help.en_US", help_en_US_lua,
-	"help", help_lua,
 	"internal.argparse", argparse_lua,
 	"internal.trigger", trigger_lua,
 	"pwd", pwd_lua,
 	"http.client", httpc_lua,
 	"iconv", iconv_lua,
 	"swim", swim_lua,
+	NULL
+};
+
+/**
+ * Modules which no request path needs: test harness, interactive
+ * help, profiler tooling. They are registered in package.preload
+ * and compiled on first require() instead of prolonging boot.
+ */
+static const char *lua_modules_preload[] = {
+	"csv", csv_lua,
+	"tap", tap_lua,
+	"help.en_US", help_en_US_lua,
+	"help", help_lua,
+	"benchmark", benchmark_lua,
 	/* jit.* library */
 	"jit.vmdef", vmdef_lua,
 	"jit.bc", bc_lua,
@@ -446,6 +457,27 @@ luaopen_tarantool(lua_State *L)
 	return 1;
 }
 
+/**
+ * package.preload handler for a lazily loaded built-in module:
+ * compiles and runs the embedded source, kept in the closure
+ * upvalues, on the first require().
+ */
+static int
+tarantool_lua_preload_cb(struct lua_State *L)
+{
+	const char *modname = lua_tostring(L, lua_upvalueindex(1));
+	const char *modsrc = lua_tostring(L, lua_upvalueindex(2));
+	const char *modfile = lua_pushfstring(L,
+		"@builtin/%s.lua", modname);
+	if (luaL_loadbuffer(L, modsrc, strlen(modsrc), modfile))
+		panic("Error loading Lua module %s...: %s",
+		      modname, lua_tostring(L, -1));
+	lua_pushstring(L, modname);
+	lua_call(L, 1, 1);
+	lua_remove(L, -2); /* chunkname */
+	return 1;
+}
+
 void
 tarantool_lua_init(const char *tarantool_bin, int argc, char **argv)
 {
@@ -512,6 +544,15 @@ tarantool_lua_init(const char *tarantool_bin, int argc, char **argv)
 	}
 	lua_pop(L, 1); /* _LOADED */
 
+	lua_getfield(L, LUA_REGISTRYINDEX, "_PRELOAD");
+	for (const char **s = lua_modules_preload; *s; s += 2) {
+		lua_pushstring(L, *s);
+		lua_pushstring(L, *(s + 1));
+		lua_pushcclosure(L, tarantool_lua_preload_cb, 2);
+		lua_setfield(L, -2, *s); /* package.preload.modname = cb */
+	}
+	lua_pop(L, 1); /* _PRELOAD */
+
 	luaopen_tarantool(L);
 	lua_pop(L, 1);
 
@@ -303,6 +303,150 @@ local function encode(obj)
     return r
 end
 
+local function encode_any(buf, val)
+    encode_r(buf, val, 0)
+end
+
+-- Field encoders a compiled schema may pick from; each one writes
+-- its msgpack representation without inspecting the value type.
+local schema_encoders = {
+    unsigned = encode_int;
+    integer  = encode_int;
+    number   = encode_double;
+    double   = encode_double;
+    string   = encode_str;
+    str      = encode_str;
+    boolean  = encode_bool;
+    any      = encode_any;
+}
+
+-- Compile a flat field schema - an array of type names like
+-- {'unsigned', 'string', 'double'} - into a specialized encoder.
+-- The returned function encodes {v1, v2, ...} as a msgpack array
+-- by running the precompiled per-field encoders in order, with no
+-- per-value type dispatch; values are trusted to match the
+-- declared types, nil fields are encoded as msgpack nil. Called
+-- as enc(obj) it returns a string; called as enc(obj, ibuf) it
+-- appends to the given buffer instead, avoiding the copy.
+local function compile(schema)
+    local n = #schema
+    local fields = {}
+    for i = 1, n do
+        local field_encoder = schema_encoders[schema[i]]
+        if field_encoder == nil then
+            error("msgpackffi.compile: unknown field type '" ..
+                  tostring(schema[i]) .. "'")
+        end
+        fields[i] = field_encoder
+    end
+    return function(obj, ibuf)
+        local tmpbuf = ibuf
+        if tmpbuf == nil then
+            tmpbuf = cord_ibuf_take()
+        end
+        encode_array(tmpbuf, n)
+        for i = 1, n do
+            local val = obj[i]
+            if val == nil then
+                encode_nil(tmpbuf)
+            else
+                fields[i](tmpbuf, val)
+            end
+        end
+        if ibuf ~= nil then
+            return
+        end
+        local r = ffi.string(tmpbuf.rpos, tmpbuf:size())
+        cord_ibuf_drop(tmpbuf)
+        return r
+    end
+end
+
+-- Response templates: most procedures answer with the same shape
+-- and a few varying fields, yet re-encode the whole map per call.
+-- A template is compiled once from a sample structure in which a
+-- string of the form '$N' marks slot N; everything else - keys,
+-- constant values, array and map headers - is encoded at compile
+-- time into constant byte chunks. Filling splices freshly encoded
+-- slot values between the precomputed chunks, so each call pays
+-- only for the varying bytes.
+local function template_walk(buf, obj, chunks)
+    if type(obj) == 'string' then
+        local slot = string.match(obj, '^%$(%d+)$')
+        if slot ~= nil then
+            if buf:size() > 0 then
+                table.insert(chunks, ffi.string(buf.rpos, buf:size()))
+                buf:reset()
+            end
+            table.insert(chunks, tonumber(slot))
+            return
+        end
+        encode_str(buf, obj)
+    elseif type(obj) == 'table' then
+        local array_count, map_count = 0, 0
+        for key in pairs(obj) do
+            if type(key) == 'number' and key >= 1 and
+               key == math.floor(key) and key == array_count + 1 then
+                array_count = array_count + 1
+            else
+                map_count = map_count + 1
+            end
+        end
+        if map_count == 0 then
+            encode_array(buf, array_count)
+            for i = 1, array_count do
+                template_walk(buf, obj[i], chunks)
+            end
+        else
+            encode_map(buf, array_count + map_count)
+            for key, value in pairs(obj) do
+                encode_r(buf, key, 1)
+                template_walk(buf, value, chunks)
+            end
+        end
+    else
+        encode_r(buf, obj, 0)
+    end
+end
+
+-- Compile @a spec into a template. The returned object has one
+-- method: tpl:fill(values[, ibuf]) encodes values[N] into slot N
+-- and returns the msgpack as a string, or appends it to the given
+-- ibuf instead. Slots take any msgpack-encodable value.
+local function template(spec)
+    local chunks = {}
+    local tmpbuf = cord_ibuf_take()
+    template_walk(tmpbuf, spec, chunks)
+    if tmpbuf:size() > 0 then
+        table.insert(chunks, ffi.string(tmpbuf.rpos, tmpbuf:size()))
+    end
+    cord_ibuf_drop(tmpbuf)
+    local n = #chunks
+    return {
+        fill = function(self, values, ibuf)
+            local buf = ibuf
+            if buf == nil then
+                buf = cord_ibuf_take()
+            end
+            for i = 1, n do
+                local chunk = chunks[i]
+                if type(chunk) == 'string' then
+                    local p = buf:alloc(#chunk)
+                    ffi.copy(p, chunk, #chunk)
+                else
+                    encode_r(buf, values[chunk], 0)
+                end
+            end
+            if ibuf ~= nil then
+                return
+            end
+            local r = ffi.string(buf.rpos, buf:size())
+            cord_ibuf_drop(buf)
+            return r
+        end;
+    }
+end
+
 on_encode(ffi.typeof('uint8_t'), encode_int)
 on_encode(ffi.typeof('uint16_t'), encode_int)
 on_encode(ffi.typeof('uint32_t'), encode_int)
@@ -642,6 +786,8 @@ return {
     array_mt = msgpack.array_mt;
     map_mt = msgpack.map_mt;
     encode = encode;
+    compile = compile;
+    template = template;
     on_encode = on_encode;
     decode_unchecked = decode_unchecked;
     decode = decode_unchecked; -- just for tests
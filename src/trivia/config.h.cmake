@@ -76,6 +76,8 @@
 #define MAP_ANONYMOUS MAP_ANON
 #endif
 #cmakedefine HAVE_MADV_DONTNEED 1
+#cmakedefine HAVE_MADV_HUGEPAGE 1
+#cmakedefine HAVE_MADV_FREE 1
 /*
  * Defined if O_DSYNC mode exists for open(2).
  */
@@ -813,3 +813,43 @@ sq:current()
 sq:reset()
 sq:current()
 sq:drop()
+
+--
+-- The cache option leases whole blocks of values: the persistent
+-- state jumps to the block end in one step while next() serves
+-- the cached tail without touching _sequence_data.
+--
+sq = box.schema.sequence.create('test', {cache = 5})
+sq.cache
+sq:next() -- 1
+box.space._sequence_data:get(sq.id)[2] -- 5: the leased block end
+sq:next() -- 2
+sq:current() -- the last served value, not the block end
+box.space._sequence_data:get(sq.id)[2] -- still 5
+sq:next() -- 3
+sq:next() -- 4
+sq:next() -- 5
+sq:next() -- 6: a new block is leased
+box.space._sequence_data:get(sq.id)[2] -- 10
+-- An explicit set discards the cached tail.
+sq:set(100)
+sq:next() -- 101
+box.space._sequence_data:get(sq.id)[2] -- 105
+sq:drop()
+-- The leased block is clamped at the sequence boundary.
+sq = box.schema.sequence.create('test', {cache = 10, max = 3})
+sq:next() -- 1
+box.space._sequence_data:get(sq.id)[2] -- 3
+sq:next() -- 2
+sq:next() -- 3
+sq:next() -- overflow, same as without a cache
+sq:drop()
+-- A descending cached sequence leases towards min.
+sq = box.schema.sequence.create('test', {cache = 3, step = -2, start = 10, min = 0, max = 10})
+sq:next() -- 10
+box.space._sequence_data:get(sq.id)[2] -- 6
+sq:next() -- 8
+sq:next() -- 6
+sq:next() -- 4
+box.space._sequence_data:get(sq.id)[2] -- 0
+sq:drop()
@@ -783,3 +783,26 @@ s:drop()
 -- reversed order both on not specified fields.
 --
 box.tuple.new({1}):update({{'=', 4, 4}, {'=', 3, 3}})
+
+--
+-- Single terminal counter operations take a fast path that
+-- patches the value bytes in a plain copy of the tuple. The
+-- result must match the generic path exactly: same-width bumps,
+-- width changes, MessagePack type boundaries and sign crossings.
+--
+s = box.schema.create_space('test')
+_ = s:create_index('pk')
+_ = s:replace{1, 100, -100}
+s:update({1}, {{'+', 2, 1}})
+s:update({1}, {{'-', 2, 2}})
+s:update({1}, {{'+', 3, 1}})
+-- A wider result falls back to the generic path.
+s:update({1}, {{'+', 2, 1000000}})
+s:update({1}, {{'-', 2, 1000000}})
+-- Crossing zero changes the MessagePack type.
+s:update({1}, {{'-', 2, 200}})
+s:update({1}, {{'+', 2, 200}})
+-- Fixint boundary: 127 + 1 needs one more encoded byte.
+_ = s:replace{2, 127}
+s:update({2}, {{'+', 2, 1}})
+s:drop()
@@ -0,0 +1,43 @@
+env = require('test_run')
+test_run = env.new()
+
+--
+-- The applier decodes read-ahead transactions into an lsregion
+-- ahead of the committer. A dense stream of large multi-row
+-- transactions must come out unchanged, in order and atomic.
+--
+box.schema.user.grant('guest', 'replication')
+_ = box.schema.space.create('test')
+_ = box.space.test:create_index('pk')
+
+test_run:cmd('create server replica with rpl_master=default, script "replication/replica.lua"')
+test_run:cmd('start server replica with wait=True, wait_load=True')
+
+payload = string.rep('z', 1000)
+test_run:cmd("setopt delimiter ';'")
+function big_tx(first, count)
+    box.begin()
+    for i = first, first + count - 1 do
+        box.space.test:replace{i, payload}
+    end
+    box.commit()
+end;
+test_run:cmd("setopt delimiter ''");
+
+-- Ten 100-row transactions back to back, then a burst of small
+-- single-row ones.
+for t = 0, 9 do big_tx(t * 100 + 1, 100) end
+for i = 1001, 2000 do box.space.test:replace{i, i} end
+
+test_run:cmd('switch replica')
+test_run:wait_cond(function() return box.space.test:count() == 2000 end, 10)
+box.space.test:get{1}[2] == string.rep('z', 1000)
+box.space.test:get{1000}[2] == string.rep('z', 1000)
+box.space.test:get{2000}
+test_run:cmd('switch default')
+
+-- Cleanup.
+test_run:cmd('stop server replica')
+test_run:cmd('delete server replica')
+box.space.test:drop()
+box.schema.user.revoke('guest', 'replication')
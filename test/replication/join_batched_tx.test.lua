@@ -0,0 +1,31 @@
+env = require('test_run')
+test_run = env.new()
+
+--
+-- Initial join applies the snapshot stream in batched
+-- transactions instead of one WAL-less commit per row. The
+-- batching must not lose, reorder or duplicate rows, including
+-- the ones written after the join checkpoint.
+--
+box.schema.user.grant('guest', 'replication')
+_ = box.schema.space.create('test')
+_ = box.space.test:create_index('pk')
+for i = 1, 10000 do box.space.test:replace{i, i} end
+box.snapshot()
+-- These arrive through the final join stage.
+for i = 10001, 10100 do box.space.test:replace{i, i} end
+
+test_run:cmd('create server replica with rpl_master=default, script "replication/replica.lua"')
+test_run:cmd('start server replica with wait=True, wait_load=True')
+test_run:cmd('switch replica')
+test_run:wait_cond(function() return box.space.test:count() == 10100 end, 10)
+box.space.test:get{1}
+box.space.test:get{10000}
+box.space.test:get{10100}
+test_run:cmd('switch default')
+
+-- Cleanup.
+test_run:cmd('stop server replica')
+test_run:cmd('delete server replica')
+box.space.test:drop()
+box.schema.user.revoke('guest', 'replication')
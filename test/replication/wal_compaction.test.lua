@@ -0,0 +1,58 @@
+env = require('test_run')
+test_run = env.new()
+fio = require('fio')
+
+--
+-- WAL files held back by a lagging consumer are rewritten with
+-- replica-local transactions dropped: no consumer will ever be
+-- sent them, so they are pure dead weight in the retained files.
+--
+box.cfg{checkpoint_count = 1}
+box.schema.user.grant('guest', 'replication')
+_ = box.schema.space.create('loc', {is_local = true})
+_ = box.space.loc:create_index('pk')
+_ = box.schema.space.create('glob')
+_ = box.space.glob:create_index('pk')
+
+test_run:cmd('create server replica with rpl_master=default, script "replication/replica.lua"')
+test_run:cmd('start server replica with wait=True, wait_load=True')
+
+-- Stop the replica so its consumer pins the current xlog.
+test_run:cmd('stop server replica')
+
+-- Fill the pinned file mostly with local rows.
+payload = string.rep('x', 1000)
+for i = 1, 100 do box.space.loc:replace{i, payload} end
+_ = box.space.glob:replace{1}
+
+-- Seal the file and move the only checkpoint past it. The
+-- garbage collector then asks the WAL thread to compact it.
+box.snapshot()
+
+wal_dir = box.cfg.wal_dir
+test_run:cmd("setopt delimiter ';'")
+function wal_size()
+    local sz = 0
+    for _, f in pairs(fio.glob(fio.pathjoin(wal_dir, '*.xlog'))) do
+        sz = sz + fio.stat(f).size
+    end
+    return sz
+end;
+test_run:cmd("setopt delimiter ''");
+test_run:wait_cond(function() return wal_size() < 60000 end, 60)
+
+-- The replica catches up from the compacted file: the dropped
+-- transactions are exactly the ones the relay never sends.
+test_run:cmd('start server replica with wait=True, wait_load=True')
+test_run:cmd('switch replica')
+test_run:wait_cond(function() return box.space.glob:get{1} ~= nil end, 10)
+box.space.loc:count()
+test_run:cmd('switch default')
+
+-- Cleanup.
+test_run:cmd('stop server replica')
+test_run:cmd('delete server replica')
+box.space.loc:drop()
+box.space.glob:drop()
+box.schema.user.revoke('guest', 'replication')
+box.cfg{checkpoint_count = 2}
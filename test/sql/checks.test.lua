@@ -298,4 +298,29 @@ box.execute("ALTER TABLE check_naming ADD b INT CHECK (b > 0)")
 box.execute("ALTER TABLE check_naming DROP CONSTRAINT \"ck_unnamed_CHECK_NAMING_2\"")
 box.execute("DROP TABLE check_naming")
 
+--
+-- Simple check expressions are evaluated natively, without a
+-- VDBE run. The verdict must not depend on which path fires:
+-- NULL passes, boolean typing is strict and arithmetic edge
+-- cases fall back to the VDBE with its errors.
+--
+box.execute("CREATE TABLE tn(a INT PRIMARY KEY, b INT, CONSTRAINT CK CHECK(a + b > 0 AND b % 2 = 0))")
+box.execute("INSERT INTO tn VALUES(1, 2)")
+box.execute("INSERT INTO tn VALUES(2, 1)")
+box.execute("INSERT INTO tn VALUES(-5, 4)")
+-- NULL never fails a check.
+box.execute("INSERT INTO tn VALUES(3, NULL)")
+-- Overflow is out of the native subset and goes to the VDBE.
+box.execute("INSERT INTO tn VALUES(-9223372036854775808, -2)")
+box.execute("DROP TABLE tn")
+-- A non-boolean expression is a runtime type error on either path.
+box.execute("CREATE TABLE tb(a INT PRIMARY KEY CHECK(a))")
+box.execute("INSERT INTO tb VALUES(5)")
+box.execute("DROP TABLE tb")
+-- Division by zero follows the VDBE error as well.
+box.execute("CREATE TABLE td(a INT PRIMARY KEY CHECK(10 / a > 0))")
+box.execute("INSERT INTO td VALUES(2)")
+box.execute("INSERT INTO td VALUES(0)")
+box.execute("DROP TABLE td")
+
 test_run:cmd("clear filter")
@@ -78,8 +78,18 @@ end;
 test_run:cmd("setopt delimiter ''");
 unprepare(s.stmt_id)
 
+-- Statement is not referenced anymore, but it stays cached
+-- until the memory quota forces it out, so a repeated prepare
+-- of the same query is a cache hit.
+--
+assert(box.info.sql().cache.stmt_count ~= 0)
+assert(box.info.sql().cache.size ~= 0)
+-- Dropping the quota to zero evicts all unreferenced statements.
+--
+box.cfg{sql_cache_size = 0}
 assert(box.info.sql().cache.stmt_count == 0)
 assert(box.info.sql().cache.size == 0)
+box.cfg{sql_cache_size = 5 * 1024 * 1024}
 
 -- Test preparation of different types of queries.
 -- Let's start from DDL. It doesn't make much sense since
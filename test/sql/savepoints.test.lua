@@ -75,3 +75,35 @@ collision_sv_2 = function()
 end;
 collision_sv_2();
 box.commit();
+
+-- Make sure a re-declared savepoint shadows the older one:
+-- rollback must return to the newest position, and lookups keep
+-- working with many live savepoints (the per-transaction name
+-- hash).
+box.execute('CREATE TABLE sv (id INT PRIMARY KEY);');
+shadow_sv = function()
+    box.begin()
+    box.execute('INSERT INTO sv VALUES (1);')
+    box.execute('SAVEPOINT t1;')
+    box.execute('INSERT INTO sv VALUES (2);')
+    box.execute('SAVEPOINT t1;')
+    box.execute('INSERT INTO sv VALUES (3);')
+    local _, err = box.execute('ROLLBACK TO t1;')
+    assert(err == nil)
+    box.commit()
+end;
+shadow_sv();
+box.execute('SELECT * FROM sv;');
+many_sv = function()
+    box.begin()
+    for i = 1, 100 do
+        box.execute(string.format('SAVEPOINT s%d;', i))
+        box.execute(string.format('INSERT INTO sv VALUES (%d);', 100 + i))
+    end
+    local _, err = box.execute('ROLLBACK TO s51;')
+    assert(err == nil)
+    box.commit()
+end;
+many_sv();
+box.space.SV:count();
+box.execute('DROP TABLE sv;');
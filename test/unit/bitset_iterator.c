@@ -477,6 +477,47 @@ void test_disjunction()
 	footer();
 }
 
+static
+void test_count()
+{
+	header();
+
+	struct tt_bitset **bitsets = bitsets_create(2);
+
+	nums_shuffle(NUMS, NUMS_SIZE);
+	for (size_t i = 0; i < NUMS_SIZE; i++) {
+		tt_bitset_set(bitsets[0], NUMS[i]);
+		if (i % 3 == 0)
+			tt_bitset_set(bitsets[1], NUMS[i]);
+	}
+
+	struct tt_bitset_expr expr;
+	tt_bitset_expr_create(&expr, realloc);
+	fail_unless(tt_bitset_expr_add_conj(&expr) == 0);
+	fail_unless(tt_bitset_expr_add_param(&expr, 0, false) == 0);
+	fail_unless(tt_bitset_expr_add_param(&expr, 1, false) == 0);
+
+	struct tt_bitset_iterator it;
+	tt_bitset_iterator_create(&it, realloc);
+	fail_unless(tt_bitset_iterator_init(&it, &expr, bitsets, 2) == 0);
+	tt_bitset_expr_destroy(&expr);
+
+	size_t expected = 0;
+	while (tt_bitset_iterator_next(&it) != SIZE_MAX)
+		expected++;
+
+	tt_bitset_iterator_rewind(&it);
+	fail_unless(tt_bitset_iterator_count(&it) == expected);
+	/* The iterator is consumed by count() */
+	fail_unless(tt_bitset_iterator_next(&it) == SIZE_MAX);
+
+	tt_bitset_iterator_destroy(&it);
+
+	bitsets_destroy(bitsets, 2);
+
+	footer();
+}
+
 int main(void)
 {
 	setbuf(stdout, NULL);
@@ -492,6 +533,7 @@ int main(void)
 	test_not_empty();
 	test_not_last();
 	test_disjunction();
+	test_count();
 
 	return 0;
 }
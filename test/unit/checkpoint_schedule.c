@@ -17,7 +17,7 @@ int
 main()
 {
 	header();
-	plan(38);
+	plan(41);
 
 	srand(time(NULL));
 	double now = rand();
@@ -89,6 +89,25 @@ main()
 		   interval);
 	}
 
+	double interval = 100;
+	checkpoint_schedule_cfg(&sched, now, interval);
+	now += checkpoint_schedule_timeout(&sched, now);
+
+	checkpoint_schedule_stretch(&sched, now + interval / 8, interval / 8);
+	double t = checkpoint_schedule_timeout(&sched, now + interval / 8);
+	ok(feq(t, interval - interval / 8),
+	   "stretch - quick checkpoint keeps the schedule");
+
+	checkpoint_schedule_stretch(&sched, now + interval / 2, interval / 2);
+	t = checkpoint_schedule_timeout(&sched, now + interval / 2);
+	ok(feq(t, interval),
+	   "stretch - slow checkpoint postpones the next one");
+
+	checkpoint_schedule_cfg(&sched, now, 0);
+	checkpoint_schedule_stretch(&sched, now, 100);
+	is(checkpoint_schedule_timeout(&sched, now), 0,
+	   "stretch - checkpointing disabled");
+
 	check_plan();
 	footer();
 
@@ -4,7 +4,9 @@
 #include <string.h>
 #include <assert.h>
 #include <msgpuck.h>
+#include <unicode/ucol.h>
 #include <diag.h>
+#include <trivia/util.h>
 #include <fiber.h>
 #include <memory.h>
 #include "coll/coll_def.h"
@@ -184,6 +186,74 @@ cache_test()
 	footer();
 }
 
+static int
+sign(int v)
+{
+	return v > 0 ? 1 : v < 0 ? -1 : 0;
+}
+
+/** Concatenate a few random pieces into @a buf, return the length. */
+static int
+gen_string(char *buf, const char **parts, int nparts)
+{
+	int len = 0;
+	int count = rand() % 40;
+	for (int i = 0; i < count; i++) {
+		const char *p = parts[rand() % nparts];
+		int plen = strlen(p);
+		memcpy(buf + len, p, plen);
+		len += plen;
+	}
+	return len;
+}
+
+/**
+ * The comparator materializes sort keys into a per-thread cache
+ * and compares them with memcmp(); its verdict must match a
+ * direct ucol_strcollUTF8() call for any pair of strings. Each
+ * pair is compared twice so that the second call goes through
+ * cached keys. Strings longer than the cache limit fall back to
+ * the direct call and must agree too.
+ */
+void
+sortkey_test()
+{
+	header();
+	plan(1);
+
+	struct coll_def def;
+	memset(&def, 0, sizeof(def));
+	snprintf(def.locale, sizeof(def.locale), "%s", "ru_RU");
+	def.type = COLL_TYPE_ICU;
+	def.icu.strength = COLL_ICU_STRENGTH_SECONDARY;
+	struct coll *coll = coll_new(&def);
+	assert(coll != NULL);
+
+	const char *parts[] = {"a", "A", "b", "z", "е", "Е", "ё", "Ё",
+			       "и", "И", "1", "2"};
+	/* Fixed seed: the test must be reproducible. */
+	srand(71);
+	int mismatch = 0;
+	for (int i = 0; i < 20000; i++) {
+		char a[128], b[128];
+		int alen = gen_string(a, parts, lengthof(parts));
+		int blen = gen_string(b, parts, lengthof(parts));
+		UErrorCode status = U_ZERO_ERROR;
+		int ref = sign(ucol_strcollUTF8(coll->collator, a, alen,
+						b, blen, &status));
+		assert(!U_FAILURE(status));
+		if (sign(coll->cmp(a, alen, b, blen, coll)) != ref)
+			mismatch++;
+		if (sign(coll->cmp(a, alen, b, blen, coll)) != ref)
+			mismatch++;
+	}
+	is(mismatch, 0, "cmp matches ucol_strcollUTF8 on random strings");
+	coll_unref(coll);
+
+	check_plan();
+	footer();
+}
+
 int
 main(int, const char**)
 {
@@ -193,6 +263,7 @@ main(int, const char**)
 	manual_test();
 	hash_test();
 	cache_test();
+	sortkey_test();
 	fiber_free();
 	memory_free();
 	coll_free();
@@ -0,0 +1,133 @@
+#include "memory.h"
+#include "fiber.h"
+#include "field_map.h"
+#include "small/region.h"
+#include "unit.h"
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+	/** Max offset slots used by one generated field map. */
+	TEST_SLOT_MAX = 8,
+};
+
+/**
+ * Build randomized field maps in both the wide and the compact
+ * layout and check that field_map_get_offset() reads the same
+ * offsets from either one.
+ */
+static void
+test_layout_equivalence(void)
+{
+	header();
+	plan(1);
+
+	struct region *region = &fiber()->gc;
+	/* Fixed seed: the test must be reproducible. */
+	srand(29);
+	int mismatch = 0;
+	for (int iter = 0; iter < 1000; iter++) {
+		size_t region_svp = region_used(region);
+		uint32_t slot_count = 1 + rand() % TEST_SLOT_MAX;
+		struct field_map_builder builder;
+		if (field_map_builder_create(&builder,
+					     slot_count * sizeof(uint32_t),
+					     region) != 0) {
+			mismatch++;
+			break;
+		}
+		uint32_t offsets[TEST_SLOT_MAX];
+		for (uint32_t i = 0; i < slot_count; i++) {
+			/* 0 stands for a missing field. */
+			offsets[i] = rand() % 2 == 0 ? 0 :
+				     1 + rand() % UINT8_MAX;
+			if (offsets[i] == 0)
+				continue;
+			if (field_map_builder_set_slot(&builder,
+						       -(int32_t)i - 1,
+						       offsets[i],
+						       MULTIKEY_NONE, 0,
+						       region) != 0) {
+				mismatch++;
+				break;
+			}
+		}
+		if (!field_map_can_be_compact(&builder, UINT8_MAX))
+			mismatch++;
+		char wide_buf[TEST_SLOT_MAX * sizeof(uint32_t)];
+		char compact_buf[TEST_SLOT_MAX];
+		field_map_build(&builder, wide_buf);
+		field_map_build_compact(&builder, compact_buf);
+		const uint32_t *wide_map = (const uint32_t *)
+			(wide_buf + field_map_build_size(&builder));
+		const uint32_t *compact_map = (const uint32_t *)
+			(compact_buf + field_map_build_size_compact(&builder));
+		for (uint32_t i = 0; i < slot_count; i++) {
+			int32_t slot = -(int32_t)i - 1;
+			uint32_t wide = field_map_get_offset(wide_map, slot,
+							     MULTIKEY_NONE,
+							     false);
+			uint32_t compact = field_map_get_offset(compact_map,
+								slot,
+								MULTIKEY_NONE,
+								true);
+			if (wide != offsets[i] || compact != offsets[i])
+				mismatch++;
+		}
+		region_truncate(region, region_svp);
+	}
+	is(mismatch, 0, "wide and compact layouts agree");
+
+	footer();
+	check_plan();
+}
+
+/**
+ * The compact layout is only usable when every offset fits into
+ * a byte and there are no multikey extents.
+ */
+static void
+test_compact_predicate(void)
+{
+	header();
+	plan(3);
+
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct field_map_builder builder;
+	fail_if(field_map_builder_create(&builder, 2 * sizeof(uint32_t),
+					 region) != 0);
+	fail_if(field_map_builder_set_slot(&builder, -1, UINT8_MAX,
+					   MULTIKEY_NONE, 0, region) != 0);
+	ok(field_map_can_be_compact(&builder, UINT8_MAX),
+	   "255-byte tuple can be compact");
+	ok(!field_map_can_be_compact(&builder, UINT8_MAX + 1),
+	   "256-byte tuple can not be compact");
+	fail_if(field_map_builder_set_slot(&builder, -2, 1, 0, 2,
+					   region) != 0);
+	ok(!field_map_can_be_compact(&builder, UINT8_MAX),
+	   "a multikey extent disables the compact layout");
+	region_truncate(region, region_svp);
+
+	footer();
+	check_plan();
+}
+
+int
+main(void)
+{
+	header();
+	plan(2);
+
+	memory_init();
+	fiber_init(fiber_c_invoke);
+
+	test_layout_equivalence();
+	test_compact_predicate();
+
+	fiber_free();
+	memory_free();
+
+	footer();
+	return check_plan();
+}
@@ -276,11 +276,78 @@ neighbor_test()
 }
 
 
+static void
+bulk_build_check()
+{
+	header();
+
+	const unsigned count = 10000;
+	struct rtree_build_elem *elems = (struct rtree_build_elem *)
+		malloc(count * sizeof(*elems));
+	for (size_t i = 0; i < count; i++) {
+		/* A grid of 100x100 small boxes */
+		coord_t x = i % 100, y = i / 100;
+		rtree_set2d(&elems[i].rect, x, y, x + 0.5, y + 0.5);
+		elems[i].record = (record_t)(i + 1);
+	}
+
+	struct rtree tree;
+	rtree_init(&tree, 2, extent_size,
+		   extent_alloc, extent_free, &page_count,
+		   RTREE_EUCLID);
+	rtree_build(&tree, elems, count);
+
+	if (rtree_number_of_records(&tree) != count) {
+		fail("Tree count mismatch (5)", "true");
+	}
+	if (tree.n_pages != rtree_build_pages(&tree, count)) {
+		fail("page count prediction", "false");
+	}
+
+	struct rtree_rect rect;
+	struct rtree_iterator iterator;
+	rtree_iterator_init(&iterator);
+	for (size_t i = 0; i < count; i++) {
+		record_t rec = (record_t)(i + 1);
+		coord_t x = i % 100, y = i / 100;
+		rtree_set2d(&rect, x, y, x + 0.5, y + 0.5);
+		if (!rtree_search(&tree, &rect, SOP_EQUALS, &iterator)) {
+			fail("element in tree (5)", "false");
+		}
+		if (rtree_iterator_next(&iterator) != rec) {
+			fail("right search result (5)", "true");
+		}
+		if (rtree_iterator_next(&iterator)) {
+			fail("single search result (5)", "true");
+		}
+	}
+
+	/* The packed tree must remain an ordinary r-tree */
+	for (size_t i = 0; i < count; i++) {
+		record_t rec = (record_t)(i + 1);
+		coord_t x = i % 100, y = i / 100;
+		rtree_set2d(&rect, x, y, x + 0.5, y + 0.5);
+		if (!rtree_remove(&tree, &rect, rec)) {
+			fail("delete element in tree (5)", "false");
+		}
+	}
+	if (rtree_number_of_records(&tree) != 0) {
+		fail("Tree count mismatch (5)", "true");
+	}
+
+	rtree_iterator_destroy(&iterator);
+	rtree_destroy(&tree);
+	free(elems);
+
+	footer();
+}
+
 int
 main(void)
 {
 	simple_check();
 	neighbor_test();
+	bulk_build_check();
 	if (page_count != 0) {
 		fail("memory leak!", "true");
 	}
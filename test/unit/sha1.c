@@ -0,0 +1,112 @@
+#include <third_party/sha1.h>
+#include "unit.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void
+sha1_oneshot(const unsigned char *data, uint32_t len, unsigned char digest[20])
+{
+	SHA1_CTX ctx;
+	SHA1Init(&ctx);
+	SHA1Update(&ctx, data, len);
+	SHA1Final(digest, &ctx);
+}
+
+static void
+sha1_hex(const unsigned char digest[20], char hex[41])
+{
+	for (int i = 0; i < 20; i++)
+		sprintf(hex + 2 * i, "%02x", digest[i]);
+}
+
+static void
+sha1_vector_test(const char *title, const unsigned char *data, uint32_t len,
+		 const char *expected)
+{
+	unsigned char digest[20];
+	char hex[41];
+	sha1_oneshot(data, len, digest);
+	sha1_hex(digest, hex);
+	is(strcmp(hex, expected), 0, "FIPS 180-1 vector %s", title);
+}
+
+/**
+ * The FIPS 180-1 test vectors. The third one (a million 'a') runs
+ * the block function back to back and so covers the hardware
+ * dispatch on machines that have it.
+ */
+static void
+sha1_fips_test(void)
+{
+	plan(3);
+
+	sha1_vector_test("\"abc\"", (const unsigned char *)"abc", 3,
+			 "a9993e364706816aba3e25717850c26c9cd0d89d");
+	const char *two_blocks =
+		"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+	sha1_vector_test("two blocks", (const unsigned char *)two_blocks,
+			 strlen(two_blocks),
+			 "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+	unsigned char *million = malloc(1000000);
+	memset(million, 'a', 1000000);
+	sha1_vector_test("a million 'a'", million, 1000000,
+			 "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+	free(million);
+
+	check_plan();
+}
+
+/**
+ * Feed random messages through SHA1Update() in random-sized
+ * chunks and check that the digest matches the one-shot
+ * computation: the buffering around the 64-byte block boundary
+ * must not depend on how the input is split.
+ */
+static void
+sha1_streaming_test(void)
+{
+	plan(1);
+
+	/* Fixed seed: the test must be reproducible. */
+	srand(83);
+	int mismatch = 0;
+	unsigned char data[4096];
+	for (int i = 0; i < 300; i++) {
+		uint32_t len = rand() % sizeof(data);
+		for (uint32_t j = 0; j < len; j++)
+			data[j] = rand() & 0xff;
+		unsigned char expected[20];
+		sha1_oneshot(data, len, expected);
+
+		SHA1_CTX ctx;
+		SHA1Init(&ctx);
+		uint32_t pos = 0;
+		while (pos < len) {
+			uint32_t chunk = 1 + rand() % 200;
+			if (chunk > len - pos)
+				chunk = len - pos;
+			SHA1Update(&ctx, data + pos, chunk);
+			pos += chunk;
+		}
+		unsigned char digest[20];
+		SHA1Final(digest, &ctx);
+		if (memcmp(digest, expected, 20) != 0)
+			mismatch++;
+	}
+	is(mismatch, 0, "streaming splits match one-shot");
+
+	check_plan();
+}
+
+int main(int argc, char *argv[])
+{
+	plan(2);
+	header();
+
+	sha1_fips_test();
+	sha1_streaming_test();
+
+	footer();
+	return check_plan();
+}
@@ -3,7 +3,7 @@
 #include <stdarg.h>
 #include "unit.h"
 
-#define PLAN		75
+#define PLAN		87
 
 #define ITEMS		7
 
@@ -112,6 +112,23 @@ main(void)
 		i++;
 	}
 
+	stailq_cut_tail(&head, &items[3].next, &tail);
+	stailq_concat_head(&tail, &head);
+	ok(stailq_empty(&head), "head is empty after concat_head");
+	i = 0;
+	stailq_foreach_entry(it, &tail, next) {
+		is(it, items + i, "element after concat_head %d", i);
+		i++;
+	}
+	is(stailq_last(&tail), &items[6].next, "last item after concat_head");
+	stailq_concat_head(&tail, &head);
+	is(stailq_first(&tail), &items[0].next,
+	   "first item after concat_head of empty list");
+	stailq_concat_head(&head, &tail);
+	ok(stailq_empty(&tail), "src is empty after concat_head into empty");
+	is(stailq_last(&head), &items[6].next,
+	   "last item after concat_head into empty");
+
 	stailq_create(&head);
 	stailq_add_entry(&head, &items[0], next);
 	stailq_insert(&head, &items[2].next, &items[0].next);
@@ -402,16 +402,93 @@ test_fromstring_invalid()
 
 #undef test
 
+/**
+ * Reference comparison: the straightforward per-component
+ * definition the optimized linear scan in
+ * vclock_compare_generic() must agree with.
+ */
+static int
+test_compare_ref(const struct vclock *a, const struct vclock *b,
+		 bool ignore_zero)
+{
+	bool le = true, ge = true;
+	for (unsigned int replica_id = ignore_zero ? 1 : 0;
+	     replica_id < VCLOCK_MAX; replica_id++) {
+		int64_t lsn_a = vclock_get(a, replica_id);
+		int64_t lsn_b = vclock_get(b, replica_id);
+		le = le && lsn_a <= lsn_b;
+		ge = ge && lsn_a >= lsn_b;
+	}
+	if (!ge && !le)
+		return VCLOCK_ORDER_UNDEFINED;
+	if (ge && !le)
+		return 1;
+	if (le && !ge)
+		return -1;
+	return 0;
+}
+
+/**
+ * Fill a vclock with a few random components. Small ids and lsns
+ * are used so that random pairs collide often enough to exercise
+ * all four verdicts; an occasional component with the highest id
+ * covers the map boundary.
+ */
+static void
+test_compare_random_fill(struct vclock *vclock)
+{
+	vclock_create(vclock);
+	int used = rand() % 6;
+	for (int i = 0; i < used; i++) {
+		uint32_t replica_id = rand() % 6;
+		int64_t lsn = 1 + rand() % 4;
+		if (lsn > vclock_get(vclock, replica_id))
+			vclock_follow(vclock, replica_id, lsn);
+	}
+	if (rand() % 8 == 0)
+		vclock_follow(vclock, VCLOCK_MAX - 1, 1 + rand() % 4);
+}
+
+static int
+test_compare_random()
+{
+	plan(2);
+	header();
+
+	/* Fixed seed: the test must be reproducible. */
+	srand(42);
+	int mismatch = 0;
+	int mismatch_ignore0 = 0;
+	for (int i = 0; i < 100000; i++) {
+		struct vclock a, b;
+		test_compare_random_fill(&a);
+		test_compare_random_fill(&b);
+		if (vclock_compare(&a, &b) !=
+		    test_compare_ref(&a, &b, false))
+			mismatch++;
+		if (vclock_compare_ignore0(&a, &b) !=
+		    test_compare_ref(&a, &b, true))
+			mismatch_ignore0++;
+	}
+	is(mismatch, 0, "vclock_compare agrees with the reference");
+	is(mismatch_ignore0, 0,
+	   "vclock_compare_ignore0 agrees with the reference");
+
+	footer();
+	return check_plan();
+}
+
 int
 main(void)
 {
-	plan(5);
+	plan(6);
 
 	test_compare();
 	test_isearch();
 	test_tostring();
 	test_fromstring();
 	test_fromstring_invalid();
+	test_compare_random();
 
 	return check_plan();
 }
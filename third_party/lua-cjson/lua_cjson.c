@@ -234,6 +234,53 @@ static void json_create_tokens()
 
 /* ===== ENCODING ===== */
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+/* Return the number of leading bytes of str[0..len) which need no
+ * escaping, 16 bytes per step. The set tested here must mirror the
+ * non-NULL entries of char2escape: control characters, '"', '/',
+ * '\\' and DEL; bytes >= 0x80 pass through untouched. */
+static size_t json_clean_prefix(const char *str, size_t len)
+{
+    const __m128i ctrl = _mm_set1_epi8(0x1f);
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i slash = _mm_set1_epi8('/');
+    const __m128i bslash = _mm_set1_epi8('\\');
+    const __m128i del = _mm_set1_epi8(0x7f);
+    size_t i = 0;
+
+    while (i + 16 <= len) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(str + i));
+        /* min(x, 0x1f) == x <=> x <= 0x1f unsigned. */
+        __m128i esc = _mm_cmpeq_epi8(_mm_min_epu8(x, ctrl), x);
+        esc = _mm_or_si128(esc, _mm_cmpeq_epi8(x, quote));
+        esc = _mm_or_si128(esc, _mm_cmpeq_epi8(x, slash));
+        esc = _mm_or_si128(esc, _mm_cmpeq_epi8(x, bslash));
+        esc = _mm_or_si128(esc, _mm_cmpeq_epi8(x, del));
+        int mask = _mm_movemask_epi8(esc);
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+        i += 16;
+    }
+    while (i < len && char2escape[(unsigned char)str[i]] == NULL)
+        i++;
+    return i;
+}
+
+#else /* !__SSE2__ */
+
+static size_t json_clean_prefix(const char *str, size_t len)
+{
+    size_t i = 0;
+
+    while (i < len && char2escape[(unsigned char)str[i]] == NULL)
+        i++;
+    return i;
+}
+
+#endif /* __SSE2__ */
+
 /* json_append_string args:
  * - lua_State
  * - JSON strbuf
@@ -244,7 +291,6 @@ static void json_append_string(struct luaL_serializer *cfg, strbuf_t *json,
                    const char *str, size_t len)
 {
     (void) cfg;
-    const char *escstr;
     size_t i;
 
     /* Worst case is len * 6 (all unicode escapes).
@@ -254,12 +300,17 @@ static void json_append_string(struct luaL_serializer *cfg, strbuf_t *json,
     strbuf_ensure_empty_length(json, len * 6 + 2);
 
     strbuf_append_char_unsafe(json, '\"');
-    for (i = 0; i < len; i++) {
-        escstr = char2escape[(unsigned char)str[i]];
-        if (escstr)
-            strbuf_append_string(json, escstr);
-        else
-            strbuf_append_char_unsafe(json, str[i]);
+    /* Copy runs of clean bytes wholesale, escape one byte at a
+     * time in between. */
+    i = 0;
+    while (i < len) {
+        size_t run = json_clean_prefix(str + i, len - i);
+        strbuf_append_mem_unsafe(json, str + i, run);
+        i += run;
+        if (i < len) {
+            strbuf_append_string(json, char2escape[(unsigned char)str[i]]);
+            i++;
+        }
     }
     strbuf_append_char_unsafe(json, '\"');
 }